@@ -68,6 +68,10 @@ void ANIMALS::Execute(uint32_t _dTime)
 {
     seagulls->Execute(_dTime);
     fishSchools->Execute(_dTime);
+}
+
+void ANIMALS::FinishParallelExecute(uint32_t _dTime)
+{
     butterflies->Execute(_dTime);
 }
 
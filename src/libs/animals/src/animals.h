@@ -23,6 +23,13 @@ class ANIMALS : public Entity
     virtual void Execute(uint32_t dTime);
     uint32_t AttributeChanged(ATTRIBUTES *pA) override;
 
+    // seagulls and fish only move themselves, butterflies trace the scene and fill their buffers afterwards
+    [[nodiscard]] ExecutePolicy GetExecutePolicy() const override
+    {
+        return ExecutePolicy::parallel;
+    }
+    void FinishParallelExecute(uint32_t dTime) override;
+
     void ProcessStage(Stage stage, uint32_t delta) override
     {
         switch (stage)
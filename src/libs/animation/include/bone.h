@@ -19,6 +19,10 @@
 
 #define ANI_COMPRESS_ENABLE
 
+// Blend the poses of two actions with normalized lerp instead of slerp,
+// faster but less exact when the poses are far from each other
+// #define ANI_BLEND_NLERP
+
 //============================================================================================
 
 class Bone
@@ -54,23 +58,30 @@ class Bone
     // Working with a bone
     // --------------------------------------------------------------------------------------------
   public:
-    // Add animation frames
-    void BlendFrame(int32_t frame, float kBlend, Quaternion &res);
+    // Add animation frames, the bone is not changed, so it can be done for many animations at once
+    void BlendFrame(int32_t frame, float kBlend, Quaternion &res) const;
     // void BlendFrame(float frame);
-    // Create a matrix for the resulting position
-    void BuildMatrix();
     // Create matrix for frame 0
     // void BuildMatrixZero();
-    // Get position matrix
-    CMatrix &GetMatrix();
     // Get the starting position matrix
     CMatrix &StartMatrix();
 
+    // --------------------------------------------------------------------------------------------
+    // Working with a skeleton, the bones are processed in groups of 4 with SSE
+    // --------------------------------------------------------------------------------------------
+  public:
+    // Add animation frames for count bones, the same as BlendFrame for every bone
+    static void BlendFrames(const Bone *bones, int32_t count, int32_t frame, float kBlend, Quaternion *res);
+    // Blend the bone rotations of two poses, res can be one of the poses
+    static void BlendPoses(const Quaternion *q1, const Quaternion *q2, float kBlend, Quaternion *res, int32_t count);
+    // Create rotation matrices
+    static void BuildRotations(const Quaternion *q, Matrix *mtx, int32_t count);
+
     // --------------------------------------------------------------------------------------------
     // Encapsulation
     // --------------------------------------------------------------------------------------------
   private:
-    void GetFrame(int32_t f, Quaternion &qt);
+    void GetFrame(int32_t f, Quaternion &qt) const;
     float Clamp(float v, const char *str);
     // Linear position interpolation
     float LerpPos(float a, float b, float k);
@@ -90,9 +101,6 @@ class Bone
     int32_t numFrames; // Number of animation frames
     CVECTOR pos0;   // Bone position if there are no animation frame positions
 
-    CVECTOR p;        // Bone position in local coordinates
-    Quaternion a;     // Bone rotation angles in local coordinates
-    CMatrix matrix;   // Bone position matrix
     CMatrix start;    // Frame 0 matrix
 };
 
@@ -106,12 +114,6 @@ inline void Bone::SetParent(Bone *parentBone)
     parent = parentBone;
 }
 
-// Get position matrix
-inline CMatrix &Bone::GetMatrix()
-{
-    return matrix;
-}
-
 // Get the starting position matrix
 inline CMatrix &Bone::StartMatrix()
 {
@@ -11,7 +11,6 @@
 #include "animation_imp.h"
 #include "animation_service_imp.h"
 #include "core.h"
-#include "debug-trap.h"
 
 //============================================================================================
 
@@ -34,6 +33,10 @@ AnimationImp::AnimationImp(int32_t id, AnimationInfo *animationInfo)
         timer[i].SetAnimation(this);
     }
     matrix = new CMatrix[aniInfo->NumBones()];
+    pose.resize(aniInfo->NumBones());
+    rotation0.resize(aniInfo->NumBones());
+    rotation1.resize(aniInfo->NumBones());
+    rotationMatrix.resize(aniInfo->NumBones());
     memset(ae_listeners, 0, sizeof(ae_listeners));
     ae_listenersExt = nullptr;
     // Auto normalization
@@ -53,7 +56,9 @@ AnimationImp::AnimationImp(int32_t id, AnimationInfo *animationInfo)
 AnimationImp::~AnimationImp()
 {
     aniInfo->RelRef();
-    aniService->DeleteAnimation(this);
+    // animations made without the service, as the testsuite does, are not in its list
+    if (aniService)
+        aniService->DeleteAnimation(this);
     delete[] matrix;
 }
 
@@ -214,13 +219,12 @@ void AnimationImp::Execute(int32_t dltTime)
     // execute the timers
     for (int32_t i = 0; i < ANI_MAX_ACTIONS; i++)
         timer[i].Execute(dltTime);
-    // Calculate animation matrices
-    BuildAnimationMatrices();
 }
 
 // Calculate animation matrices
-void AnimationImp::BuildAnimationMatrices()
+bool AnimationImp::BuildAnimationMatrices()
 {
+    auto isSupported = true;
     auto nFrames = aniInfo->GetAniNumFrames();
     auto nbones = aniInfo->NumBones();
     // see how many players are playing, calculate the current blending coefficients
@@ -236,7 +240,7 @@ void AnimationImp::BuildAnimationMatrices()
             normBlend += action[i].kBlendCurrent;
         }
     if (!plCnt)
-        return;
+        return true;
 
     // Auto normalization
     if (normBlend != 0.0f)
@@ -265,17 +269,16 @@ void AnimationImp::BuildAnimationMatrices()
 
             auto kBlend = 1.0f - action[0].kBlendCurrent * normBlend;
             //-------------------------------------------------------------------------
+            const auto *bones = &aniInfo->GetBone(0);
+            Bone::BlendFrames(bones, nbones, f0, ki0, rotation0.data());
+            Bone::BlendFrames(bones, nbones, f1, ki1, rotation1.data());
+            Bone::BlendPoses(rotation0.data(), rotation1.data(), kBlend, rotation0.data(), nbones);
+            Bone::BuildRotations(rotation0.data(), rotationMatrix.data(), nbones);
             for (int32_t j = 0; j < nbones; j++)
             {
                 auto &bn = aniInfo->GetBone(j);
-                Matrix tmpMtx;
                 CMatrix inmtx;
-                Quaternion qt0, qt1, qt;
-                bn.BlendFrame(f0, ki0, qt0);
-                bn.BlendFrame(f1, ki1, qt1);
-                qt.SLerp(qt0, qt1, kBlend);
-                qt.GetMatrix(tmpMtx);
-                inmtx = tmpMtx;
+                inmtx = rotationMatrix[j];
                 inmtx.Pos() = bn.pos0;
                 if (j == 0)
                 {
@@ -291,10 +294,10 @@ void AnimationImp::BuildAnimationMatrices()
                     inmtx.RotateY(customHeadAY);
                 }
 
-                if (bn.parent)
-                    bn.matrix.EqMultiply(inmtx, CMatrix(bn.parent->matrix));
+                if (const auto parent = aniInfo->GetParentIndex(j); parent >= 0)
+                    pose[j].EqMultiply(inmtx, CMatrix(pose[parent]));
                 else
-                    bn.matrix = inmtx;
+                    pose[j] = inmtx;
             }
         }
         else if (action[0].IsPlaying())
@@ -309,15 +312,13 @@ void AnimationImp::BuildAnimationMatrices()
             }
 
             //-------------------------------------------------------------------------
+            Bone::BlendFrames(&aniInfo->GetBone(0), nbones, f, ki, rotation0.data());
+            Bone::BuildRotations(rotation0.data(), rotationMatrix.data(), nbones);
             for (int32_t j = 0; j < nbones; j++)
             {
                 auto &bn = aniInfo->GetBone(j);
-                Matrix tmpMtx;
                 CMatrix inmtx;
-                Quaternion qt;
-                bn.BlendFrame(f, ki, qt);
-                qt.GetMatrix(tmpMtx);
-                inmtx = tmpMtx;
+                inmtx = rotationMatrix[j];
                 inmtx.Pos() = bn.pos0;
                 if (j == 0)
                     inmtx.Pos() = bn.pos[f] + ki * (bn.pos[f + 1] - bn.pos[f]);
@@ -329,10 +330,10 @@ void AnimationImp::BuildAnimationMatrices()
                     inmtx.RotateY(customHeadAY);
                 }
 
-                if (bn.parent)
-                    bn.matrix.EqMultiply(inmtx, CMatrix(bn.parent->matrix));
+                if (const auto parent = aniInfo->GetParentIndex(j); parent >= 0)
+                    pose[j].EqMultiply(inmtx, CMatrix(pose[parent]));
                 else
-                    bn.matrix = inmtx;
+                    pose[j] = inmtx;
             }
         }
         else if (action[1].IsPlaying())
@@ -347,15 +348,13 @@ void AnimationImp::BuildAnimationMatrices()
             }
 
             //-------------------------------------------------------------------------
+            Bone::BlendFrames(&aniInfo->GetBone(0), nbones, f, ki, rotation0.data());
+            Bone::BuildRotations(rotation0.data(), rotationMatrix.data(), nbones);
             for (int32_t j = 0; j < nbones; j++)
             {
                 auto &bn = aniInfo->GetBone(j);
-                Matrix tmpMtx;
                 CMatrix inmtx;
-                Quaternion qt;
-                bn.BlendFrame(f, ki, qt);
-                qt.GetMatrix(tmpMtx);
-                inmtx = tmpMtx;
+                inmtx = rotationMatrix[j];
                 inmtx.Pos() = bn.pos0;
                 if (j == 0)
                     inmtx.Pos() = bn.pos[f] + ki * (bn.pos[f + 1] - bn.pos[f]);
@@ -367,16 +366,16 @@ void AnimationImp::BuildAnimationMatrices()
                     inmtx.RotateY(customHeadAY);
                 }
 
-                if (bn.parent)
-                    bn.matrix.EqMultiply(inmtx, CMatrix(bn.parent->matrix));
+                if (const auto parent = aniInfo->GetParentIndex(j); parent >= 0)
+                    pose[j].EqMultiply(inmtx, CMatrix(pose[parent]));
                 else
-                    bn.matrix = inmtx;
+                    pose[j] = inmtx;
             }
         }
         else
         {
-            core.Trace("AnimationImp::BuildAnimationMatrices -> Not support mode");
-            psnip_trap();
+            // traced by the caller, core.Trace is not for the worker threads
+            isSupported = false;
             /*_asm int 3;*/
             //    float frame = 0.0f;
             //    for(int32_t j = 0; j < nbones; j++)
@@ -386,7 +385,7 @@ void AnimationImp::BuildAnimationMatrices()
     for (int32_t j = 0; j < nbones; j++)
     {
         auto &bn = aniInfo->GetBone(j);
-        matrix[j] = CMatrix(bn.start) * CMatrix(bn.matrix);
+        matrix[j] = CMatrix(bn.start) * CMatrix(pose[j]);
 #ifdef _WIN32 // FIX_LINUX DirectXMath
         // inverse first column in advance
         matrix[j].matrix[0] = -matrix[j].matrix[0];
@@ -395,6 +394,7 @@ void AnimationImp::BuildAnimationMatrices()
         matrix[j].matrix[12] = -matrix[j].matrix[12];
 #endif
     }
+    return isSupported;
 }
 
 // Events
@@ -15,6 +15,8 @@
 #include "animation_info.h"
 #include "animation_timer_imp.h"
 
+#include <vector>
+
 #define ANIIMP_MAXLISTENERS 8
 
 class AnimationServiceImp;
@@ -80,10 +82,11 @@ class AnimationImp final : public Animation
     AnimationInfo *GetAnimationInfo();
     // Find action by name
     ActionInfo *GetActionInfo(const char *actionName);
-    // Take a step in time
+    // Take a step in time, the players and the timers send their events from here
     void Execute(int32_t dltTime);
-    // Calculate animation matrices
-    void BuildAnimationMatrices();
+    // Calculate animation matrices, touches only this animation and can run in parallel with the others,
+    // false if the players are in a mode without a pose
+    bool BuildAnimationMatrices();
     // Get a pointer to the animation srvis
     static AnimationServiceImp *GetAniService();
     // AnimationPlayer events
@@ -133,6 +136,12 @@ class AnimationImp final : public Animation
     bool isUserBlend;
     // Skeleton matrices
     CMatrix *matrix;
+    // Bone matrices of the current pose, the skeleton in AnimationInfo is shared and is only read
+    std::vector<CMatrix> pose;
+    // Bone rotations of the actions and their matrices, kept between frames to not allocate them
+    std::vector<Quaternion> rotation0;
+    std::vector<Quaternion> rotation1;
+    std::vector<Matrix> rotationMatrix;
     // Internal event subscribers
     AnimationEventListener *ae_listeners[ae_numevents][ANIIMP_MAXLISTENERS];
     // Subscribers to external events
@@ -41,6 +41,8 @@ class AnimationInfo final
     int32_t NumBones();
     // Access to the bone
     Bone &GetBone(int32_t iBone);
+    // Index of the parent bone, -1 for the root
+    int32_t GetParentIndex(int32_t iBone);
     // Compare with current name
     bool operator==(const char *animationName);
     // Increment reference count
@@ -117,6 +119,13 @@ inline Bone &AnimationInfo::GetBone(int32_t iBone)
     return bone[iBone];
 }
 
+// Index of the parent bone, -1 for the root
+inline int32_t AnimationInfo::GetParentIndex(int32_t iBone)
+{
+    Assert(iBone >= 0 && iBone < numBones);
+    return bone[iBone].parent ? static_cast<int32_t>(bone[iBone].parent - bone) : -1;
+}
+
 // Increment reference count
 inline void AnimationInfo::AddRef()
 {
@@ -11,12 +11,17 @@
 #include "animation_service_imp.h"
 
 #include "core.h"
+#include "debug-trap.h"
 
 #include "animation_imp.h"
 #include "an_file.h"
 #include "string_compare.hpp"
 #include "file_service.h"
 
+#include <algorithm>
+#include <atomic>
+#include <execution>
+
 CREATE_SERVICE(AnimationServiceImp)
 
 //============================================================================================
@@ -122,6 +127,18 @@ void AnimationServiceImp::RunStart()
                 animations[i]->Execute(dt);
             // core.Trace("Animation: 0x%.8x Time: %f", animation[i], animation[i]->Player(0).GetPosition());
         }
+    // the events are sent, now the poses are calculated for all animations at once
+    std::atomic<bool> isSupported = true;
+    std::for_each(std::execution::par, std::begin(animations), std::end(animations),
+                  [&isSupported](AnimationImp *animation) {
+                      if (animation && !animation->BuildAnimationMatrices())
+                          isSupported.store(false, std::memory_order_relaxed);
+                  });
+    if (!isSupported)
+    {
+        core.Trace("AnimationImp::BuildAnimationMatrices -> Not support mode");
+        psnip_trap();
+    }
 }
 
 void AnimationServiceImp::RunEnd()
@@ -14,6 +14,8 @@
 #include "storm_assert.h"
 #include "vma.hpp"
 
+#include <emmintrin.h>
+
 // ============================================================================================
 // Construction, destruction
 // ============================================================================================
@@ -28,15 +30,15 @@ Bone::Bone()
 
 Bone::~Bone()
 {
-    delete ang;
-    delete pos;
+    delete[] ang;
+    delete[] pos;
 }
 
 // how many frames of animation there will be
 void Bone::SetNumFrames(int32_t num, CVECTOR &sPos, bool isRoot)
 {
-    delete ang;
-    delete pos;
+    delete[] ang;
+    delete[] pos;
     ang = nullptr;
     pos = nullptr;
     numFrames = num;
@@ -101,7 +103,7 @@ void Bone::SetAngles(const Quaternion *aArray, int32_t numAng)
     }
 }
 
-inline void Bone::GetFrame(int32_t f, Quaternion &qt)
+inline void Bone::GetFrame(int32_t f, Quaternion &qt) const
 {
     qt.x = sinf((ang[f].x * (1.0f / 32767.0f)) * PI * 0.5f);
     qt.y = sinf((ang[f].y * (1.0f / 32767.0f)) * PI * 0.5f);
@@ -124,7 +126,7 @@ void Bone::SetAngles(const Quaternion *aArray, int32_t numAng)
     memcpy(ang, aArray, numFrames * sizeof(*ang));
 }
 
-inline void Bone::GetFrame(int32_t f, Quaternion &qt)
+inline void Bone::GetFrame(int32_t f, Quaternion &qt) const
 {
     qt = ang[f];
 }
@@ -174,7 +176,7 @@ void Bone::BuildStartMatrix()
 // --------------------------------------------------------------------------------------------
 
 // Add animation frames
-void Bone::BlendFrame(int32_t frame, float kBlend, Quaternion &res)
+void Bone::BlendFrame(int32_t frame, float kBlend, Quaternion &res) const
 {
     if (numFrames <= 0)
         return;
@@ -195,16 +197,217 @@ void Bone::BlendFrame(int32_t frame, float kBlend, Quaternion &res)
     res.SLerp(q0, q1, kBlend);
 }
 
-// Create a matrix for the resulting position
-void Bone::BuildMatrix()
+// --------------------------------------------------------------------------------------------
+// Working with a skeleton
+// --------------------------------------------------------------------------------------------
+
+namespace
 {
-    // Turns
-    // matrix = a.BuildMatrix();
-    Matrix tmpMtx;
-    a.GetMatrix(tmpMtx);
-    matrix = tmpMtx;
-    matrix.Pos() = p;
-    // Multiply by the parent matrix
-    if (parent)
-        matrix.EqMultiply(CMatrix(matrix), parent->matrix);
+
+// 4 quaternions, a component in a register
+struct Quaternion4
+{
+    __m128 x, y, z, w;
+};
+
+Quaternion4 LoadQuaternions(const Quaternion *q)
+{
+    Quaternion4 r{_mm_loadu_ps(q[0].q), _mm_loadu_ps(q[1].q), _mm_loadu_ps(q[2].q), _mm_loadu_ps(q[3].q)};
+    _MM_TRANSPOSE4_PS(r.x, r.y, r.z, r.w);
+    return r;
+}
+
+void StoreQuaternions(Quaternion4 r, Quaternion *q)
+{
+    _MM_TRANSPOSE4_PS(r.x, r.y, r.z, r.w);
+    _mm_storeu_ps(q[0].q, r.x);
+    _mm_storeu_ps(q[1].q, r.y);
+    _mm_storeu_ps(q[2].q, r.z);
+    _mm_storeu_ps(q[3].q, r.w);
+}
+
+#ifdef ANI_COMPRESS_ENABLE
+
+// sinf for -PI/2..PI/2, the error is below the float precision there
+__m128 SinHalfPi(__m128 v)
+{
+    const auto v2 = _mm_mul_ps(v, v);
+    auto p = _mm_set1_ps(-2.5052108e-8f);
+    p = _mm_add_ps(_mm_mul_ps(p, v2), _mm_set1_ps(2.7557319e-6f));
+    p = _mm_add_ps(_mm_mul_ps(p, v2), _mm_set1_ps(-1.9841270e-4f));
+    p = _mm_add_ps(_mm_mul_ps(p, v2), _mm_set1_ps(8.3333333e-3f));
+    p = _mm_add_ps(_mm_mul_ps(p, v2), _mm_set1_ps(-1.6666667e-1f));
+    return _mm_add_ps(v, _mm_mul_ps(_mm_mul_ps(v, v2), p));
+}
+
+// Decompress the frame of 4 bones, as GetFrame does
+Quaternion4 GetFrames(const Bone *bones, int32_t f)
+{
+    const auto b01 = _mm_unpacklo_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(&bones[0].ang[f])),
+                                        _mm_loadl_epi64(reinterpret_cast<const __m128i *>(&bones[1].ang[f])));
+    const auto b23 = _mm_unpacklo_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(&bones[2].ang[f])),
+                                        _mm_loadl_epi64(reinterpret_cast<const __m128i *>(&bones[3].ang[f])));
+    // sign extension of the shorts
+    Quaternion4 r{_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(b01, b01), 16)),
+                  _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(b01, b01), 16)),
+                  _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(b23, b23), 16)),
+                  _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(b23, b23), 16))};
+    _MM_TRANSPOSE4_PS(r.x, r.y, r.z, r.w);
+
+    const auto k = _mm_set1_ps(1.0f / 32767.0f);
+    const auto halfPi = _mm_set1_ps(PI * 0.5f);
+    r.x = SinHalfPi(_mm_mul_ps(_mm_mul_ps(r.x, k), halfPi));
+    r.y = SinHalfPi(_mm_mul_ps(_mm_mul_ps(r.y, k), halfPi));
+    r.z = SinHalfPi(_mm_mul_ps(_mm_mul_ps(r.z, k), halfPi));
+    r.w = SinHalfPi(_mm_mul_ps(_mm_mul_ps(r.w, k), halfPi));
+    return r;
+}
+
+#else
+
+Quaternion4 GetFrames(const Bone *bones, int32_t f)
+{
+    Quaternion4 r{_mm_loadu_ps(bones[0].ang[f].q), _mm_loadu_ps(bones[1].ang[f].q), _mm_loadu_ps(bones[2].ang[f].q),
+                  _mm_loadu_ps(bones[3].ang[f].q)};
+    _MM_TRANSPOSE4_PS(r.x, r.y, r.z, r.w);
+    return r;
+}
+
+#endif
+
+// Lerp branch of Quaternion::SLerp for 4 quaternions, returns the mask of the quaternions too far from
+// each other for it, they must be blended with Quaternion::SLerp
+int32_t LerpQuaternions(const Quaternion4 &q1, const Quaternion4 &q2, float kBlend, Quaternion4 &res)
+{
+    const auto cosomega = _mm_add_ps(_mm_add_ps(_mm_mul_ps(q1.x, q2.x), _mm_mul_ps(q1.y, q2.y)),
+                                     _mm_add_ps(_mm_mul_ps(q1.z, q2.z), _mm_mul_ps(q1.w, q2.w)));
+    // Nearest direction
+    const auto sign = _mm_and_ps(cosomega, _mm_set1_ps(-0.0f));
+    const auto k0 = _mm_xor_ps(_mm_set1_ps(1.0f - kBlend), sign);
+    const auto k1 = _mm_set1_ps(kBlend);
+    res.x = _mm_add_ps(_mm_mul_ps(q1.x, k0), _mm_mul_ps(q2.x, k1));
+    res.y = _mm_add_ps(_mm_mul_ps(q1.y, k0), _mm_mul_ps(q2.y, k1));
+    res.z = _mm_add_ps(_mm_mul_ps(q1.z, k0), _mm_mul_ps(q2.z, k1));
+    res.w = _mm_add_ps(_mm_mul_ps(q1.w, k0), _mm_mul_ps(q2.w, k1));
+
+    const auto delta = _mm_sub_ps(_mm_set1_ps(1.0f), _mm_xor_ps(cosomega, sign));
+    return _mm_movemask_ps(_mm_cmpgt_ps(delta, _mm_set1_ps(0.1f)));
+}
+
+} // namespace
+
+// Add animation frames for count bones, the same as BlendFrame for every bone
+void Bone::BlendFrames(const Bone *bones, int32_t count, int32_t frame, float kBlend, Quaternion *res)
+{
+    if (kBlend < 0.0f)
+        kBlend = 0.0f;
+    if (kBlend > 1.0f)
+        kBlend = 1.0f;
+
+    int32_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        const auto *b = bones + i;
+        auto isFrames = frame >= 0;
+        for (int32_t n = 0; n < 4; n++)
+            isFrames = isFrames && b[n].ang && frame + 1 < b[n].numFrames;
+        if (!isFrames)
+            break;
+
+        const auto q0 = GetFrames(b, frame);
+        const auto q1 = GetFrames(b, frame + 1);
+        Quaternion4 r;
+        auto slerpMask = LerpQuaternions(q0, q1, kBlend, r);
+        StoreQuaternions(r, res + i);
+        for (int32_t n = 0; slerpMask; n++, slerpMask >>= 1)
+            if (slerpMask & 1)
+                b[n].BlendFrame(frame, kBlend, res[i + n]);
+    }
+
+    // bones without frames and the rest
+    for (; i < count; i++)
+    {
+        res[i] = Quaternion();
+        bones[i].BlendFrame(frame, kBlend, res[i]);
+    }
+}
+
+// Blend the bone rotations of two poses, res can be one of the poses
+void Bone::BlendPoses(const Quaternion *q1, const Quaternion *q2, float kBlend, Quaternion *res, int32_t count)
+{
+    int32_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        const auto a = LoadQuaternions(q1 + i);
+        const auto b = LoadQuaternions(q2 + i);
+        Quaternion4 r;
+        auto slerpMask = LerpQuaternions(a, b, kBlend, r);
+#ifdef ANI_BLEND_NLERP
+        slerpMask = 0;
+        auto len = _mm_add_ps(_mm_add_ps(_mm_mul_ps(r.x, r.x), _mm_mul_ps(r.y, r.y)),
+                              _mm_add_ps(_mm_mul_ps(r.z, r.z), _mm_mul_ps(r.w, r.w)));
+        len = _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(len));
+        r.x = _mm_mul_ps(r.x, len);
+        r.y = _mm_mul_ps(r.y, len);
+        r.z = _mm_mul_ps(r.z, len);
+        r.w = _mm_mul_ps(r.w, len);
+#endif
+        // keep the sources of the far ones, res may be in place of them
+        Quaternion from[4], to[4];
+        for (int32_t n = 0; n < 4; n++)
+            if (slerpMask & (1 << n))
+            {
+                from[n] = q1[i + n];
+                to[n] = q2[i + n];
+            }
+        StoreQuaternions(r, res + i);
+        for (int32_t n = 0; slerpMask; n++, slerpMask >>= 1)
+            if (slerpMask & 1)
+                res[i + n].SLerp(from[n], to[n], kBlend);
+    }
+
+    for (; i < count; i++)
+    {
+        const auto from = q1[i];
+        const auto to = q2[i];
+        res[i].SLerp(from, to, kBlend);
+    }
+}
+
+// Create rotation matrices, the same as Quaternion::GetMatrix
+void Bone::BuildRotations(const Quaternion *q, Matrix *mtx, int32_t count)
+{
+    int32_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        const auto r = LoadQuaternions(q + i);
+        const auto two = _mm_set1_ps(2.0f);
+        const auto one = _mm_set1_ps(1.0f);
+        const auto x2 = _mm_mul_ps(r.x, two), y2 = _mm_mul_ps(r.y, two), z2 = _mm_mul_ps(r.z, two);
+        const auto xx = _mm_mul_ps(r.x, x2), xy = _mm_mul_ps(r.x, y2), xz = _mm_mul_ps(r.x, z2);
+        const auto yy = _mm_mul_ps(r.y, y2), yz = _mm_mul_ps(r.y, z2);
+        const auto zz = _mm_mul_ps(r.z, z2);
+        const auto wx = _mm_mul_ps(r.w, x2), wy = _mm_mul_ps(r.w, y2), wz = _mm_mul_ps(r.w, z2);
+
+        // the rows of 4 matrices, transposed to the matrix order
+        __m128 rows[3][4] = {
+            {_mm_sub_ps(one, _mm_add_ps(yy, zz)), _mm_add_ps(xy, wz), _mm_sub_ps(xz, wy), _mm_setzero_ps()},
+            {_mm_sub_ps(xy, wz), _mm_sub_ps(one, _mm_add_ps(xx, zz)), _mm_add_ps(yz, wx), _mm_setzero_ps()},
+            {_mm_add_ps(xz, wy), _mm_sub_ps(yz, wx), _mm_sub_ps(one, _mm_add_ps(xx, yy)), _mm_setzero_ps()}};
+        for (auto &row : rows)
+            _MM_TRANSPOSE4_PS(row[0], row[1], row[2], row[3]);
+
+        const auto lastRow = _mm_set_ps(1.0f, 0.0f, 0.0f, 0.0f);
+        for (int32_t n = 0; n < 4; n++)
+        {
+            auto *m = mtx[i + n].matrix;
+            _mm_store_ps(m, rows[0][n]);
+            _mm_store_ps(m + 4, rows[1][n]);
+            _mm_store_ps(m + 8, rows[2][n]);
+            _mm_store_ps(m + 12, lastRow);
+        }
+    }
+
+    for (; i < count; i++)
+        q[i].GetMatrix(mtx[i]);
 }
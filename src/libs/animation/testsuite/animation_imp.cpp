@@ -0,0 +1,122 @@
+#include "../src/animation_imp.h"
+#include "../src/animation_info.h"
+#include "stopwatch.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <execution>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace
+{
+
+constexpr int32_t kBones = 50;
+constexpr int32_t kFrames = 400;
+
+// A character-sized skeleton with a walk and a run action, every bone has a parent before it
+std::unique_ptr<AnimationInfo> MakeSkeleton(std::mt19937 &gen)
+{
+    std::uniform_real_distribution<float> any(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> step(-0.05f, 0.05f);
+
+    auto info = std::make_unique<AnimationInfo>("character");
+    info->SetNumFrames(kFrames);
+    info->SetFPS(30.0f);
+    info->CreateBones(kBones);
+    for (int32_t b = 1; b < kBones; b++)
+        info->GetBone(b).SetParent(&info->GetBone(std::uniform_int_distribution<int32_t>(0, b - 1)(gen)));
+
+    std::vector<CVECTOR> rootPos(kFrames);
+    std::vector<Quaternion> angles(kFrames);
+    for (int32_t b = 0; b < kBones; b++)
+    {
+        CVECTOR pos0(any(gen), any(gen), any(gen));
+        info->GetBone(b).SetNumFrames(kFrames, pos0, b == 0);
+        Quaternion q(any(gen), any(gen), any(gen), any(gen));
+        q.Normalize();
+        for (auto &angle : angles)
+        {
+            q *= Quaternion(step(gen), step(gen), step(gen), 1.0f);
+            q.Normalize();
+            angle = q;
+        }
+        info->GetBone(b).SetAngles(angles.data(), kFrames);
+    }
+    for (int32_t f = 0; f < kFrames; f++)
+        rootPos[f] = CVECTOR(0.0f, 0.0f, f * 0.01f);
+    info->GetBone(0).SetPositions(rootPos.data(), kFrames);
+    for (int32_t b = 0; b < kBones; b++)
+        info->GetBone(b).BuildStartMatrix();
+
+    info->AddAction("walk", 0, kFrames / 2 - 1)->SetLoop(true);
+    info->AddAction("run", kFrames / 2, kFrames - 1)->SetLoop(true);
+    return info;
+}
+
+// Characters blending the walk into the run, each at its own position and blend
+std::vector<std::unique_ptr<AnimationImp>> MakeCharacters(AnimationInfo *info, uint32_t count)
+{
+    std::mt19937 gen(count);
+    std::uniform_real_distribution<float> k01(0.0f, 1.0f);
+    std::vector<std::unique_ptr<AnimationImp>> characters;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        auto &animation = characters.emplace_back(std::make_unique<AnimationImp>(i, info));
+        animation->Player(0).SetAction("walk");
+        animation->Player(0).Play();
+        animation->Player(0).SetPosition(k01(gen));
+        animation->Player(1).SetAction("run");
+        animation->Player(1).Play();
+        animation->Player(1).SetPosition(k01(gen));
+        animation->Player(1).SetBlend(k01(gen));
+    }
+    return characters;
+}
+
+} // namespace
+
+TEST_CASE("Character poses built serially and in parallel", "[animation][.benchmark]")
+{
+    constexpr int32_t frames = 200;
+    std::mt19937 gen(5);
+    const auto info = MakeSkeleton(gen);
+
+    for (const uint32_t count : {50u, 100u, 200u, 400u})
+    {
+        auto serial = MakeCharacters(info.get(), count);
+        auto parallel = MakeCharacters(info.get(), count);
+
+        // the players step serially in both runs, as AnimationServiceImp::RunStart does, only the poses are timed
+        storm::Stopwatch serialTime, parallelTime;
+        for (int32_t frame = 0; frame < frames; frame++)
+        {
+            for (auto &animation : serial)
+                animation->Execute(16);
+            serialTime.measure([&] {
+                for (auto &animation : serial)
+                    animation->BuildAnimationMatrices();
+            });
+
+            for (auto &animation : parallel)
+                animation->Execute(16);
+            parallelTime.measure([&] {
+                std::for_each(std::execution::par, parallel.begin(), parallel.end(),
+                              [](const auto &animation) { animation->BuildAnimationMatrices(); });
+            });
+        }
+
+        // every instance keeps its own pose, so the order of the builds changes nothing
+        for (uint32_t i = 0; i < count; i++)
+            for (int32_t b = 0; b < kBones; b++)
+                REQUIRE(std::equal(std::begin(serial[i]->GetAnimationMatrix(b).matrix),
+                                   std::end(serial[i]->GetAnimationMatrix(b).matrix),
+                                   std::begin(parallel[i]->GetAnimationMatrix(b).matrix)));
+
+        WARN(count << " characters of " << kBones << " bones, us/frame serial: " << serialTime.microseconds(frames)
+                   << ", parallel: " << parallelTime.microseconds(frames));
+    }
+}
@@ -0,0 +1,210 @@
+#include "bone.h"
+#include "stopwatch.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace
+{
+
+constexpr float kTolerance = 1e-5f;
+
+// Skeleton with random animations, every jumpEvery frame the rotation jumps to a random one so the
+// neighbouring frames are too far from each other for the lerp branch
+struct TestSkeleton
+{
+    std::unique_ptr<Bone[]> bones;
+    int32_t count;
+    int32_t numFrames;
+
+    TestSkeleton(int32_t count, int32_t numFrames, int32_t jumpEvery, std::mt19937 &gen)
+        : bones(std::make_unique<Bone[]>(count)), count(count), numFrames(numFrames)
+    {
+        std::uniform_real_distribution<float> any(-1.0f, 1.0f);
+        std::uniform_real_distribution<float> step(-0.05f, 0.05f);
+        CVECTOR pos0(0.0f, 0.0f, 0.0f);
+        for (int32_t b = 0; b < count; b++)
+        {
+            bones[b].SetNumFrames(numFrames, pos0, b == 0);
+            std::vector<Quaternion> angles(numFrames);
+            Quaternion q(any(gen), any(gen), any(gen), any(gen));
+            q.Normalize();
+            for (int32_t f = 0; f < numFrames; f++)
+            {
+                Quaternion delta(step(gen), step(gen), step(gen), 1.0f);
+                if (f % jumpEvery == jumpEvery - 1)
+                    delta = Quaternion(any(gen), any(gen), any(gen), any(gen));
+                q *= delta;
+                q.Normalize();
+                angles[f] = q;
+            }
+            bones[b].SetAngles(angles.data(), numFrames);
+        }
+    }
+};
+
+Quaternion RandomQuaternion(std::mt19937 &gen)
+{
+    std::uniform_real_distribution<float> any(-1.0f, 1.0f);
+    Quaternion q(any(gen), any(gen), any(gen), any(gen));
+    q.Normalize();
+    return q;
+}
+
+void CheckEqual(const Quaternion &a, const Quaternion &b)
+{
+    for (int32_t c = 0; c < 4; c++)
+        REQUIRE(a.q[c] == Approx(b.q[c]).margin(kTolerance));
+}
+
+} // namespace
+
+TEST_CASE("Batched bone kernels match the scalar path", "[animation]")
+{
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<float> k01(0.0f, 1.0f);
+
+    // bone counts around the batch width, 4 bones are processed at once
+    const auto count = GENERATE(1, 3, 4, 5, 7, 8, 67);
+
+    SECTION("BlendFrames equals BlendFrame for every bone")
+    {
+        constexpr int32_t numFrames = 40;
+        TestSkeleton skeleton(count, numFrames, 7, gen);
+        std::vector<Quaternion> batched(count), scalar(count);
+        std::uniform_int_distribution<int32_t> anyFrame(0, numFrames + 2);
+        for (int32_t i = 0; i < 200; i++)
+        {
+            const auto frame = anyFrame(gen);
+            // out of range blend factors are clamped
+            const auto kBlend = k01(gen) * 1.4f - 0.2f;
+            Bone::BlendFrames(skeleton.bones.get(), count, frame, kBlend, batched.data());
+            for (int32_t b = 0; b < count; b++)
+            {
+                skeleton.bones[b].BlendFrame(frame, kBlend, scalar[b]);
+                CheckEqual(batched[b], scalar[b]);
+            }
+        }
+    }
+
+    SECTION("The last frame and frames past it are clamped to the last frame")
+    {
+        constexpr int32_t numFrames = 12;
+        TestSkeleton skeleton(count, numFrames, 5, gen);
+        std::vector<Quaternion> last(count), batched(count);
+        for (int32_t b = 0; b < count; b++)
+            skeleton.bones[b].BlendFrame(numFrames - 1, 0.0f, last[b]);
+        for (const auto frame : {numFrames - 1, numFrames, numFrames + 10})
+        {
+            Bone::BlendFrames(skeleton.bones.get(), count, frame, 0.5f, batched.data());
+            for (int32_t b = 0; b < count; b++)
+                CheckEqual(batched[b], last[b]);
+        }
+    }
+
+    SECTION("BlendPoses equals SLerp, also for far rotations and in place")
+    {
+        std::vector<Quaternion> q1(count), q2(count), batched(count), inPlace(count);
+        for (int32_t i = 0; i < 200; i++)
+        {
+            for (int32_t b = 0; b < count; b++)
+            {
+                q1[b] = RandomQuaternion(gen);
+                // every other bone is close to the first pose and takes the lerp branch
+                if (b % 2)
+                {
+                    q2[b] = RandomQuaternion(gen);
+                }
+                else
+                {
+                    q2[b] = q1[b];
+                    q2[b] *= Quaternion(0.02f, -0.01f, 0.03f, 1.0f);
+                    q2[b].Normalize();
+                }
+            }
+            const auto kBlend = k01(gen);
+            Bone::BlendPoses(q1.data(), q2.data(), kBlend, batched.data(), count);
+            inPlace = q1;
+            Bone::BlendPoses(inPlace.data(), q2.data(), kBlend, inPlace.data(), count);
+            for (int32_t b = 0; b < count; b++)
+            {
+                Quaternion scalar;
+                scalar.SLerp(q1[b], q2[b], kBlend);
+                CheckEqual(batched[b], scalar);
+                CheckEqual(inPlace[b], scalar);
+            }
+        }
+    }
+
+    SECTION("BuildRotations equals Quaternion::GetMatrix")
+    {
+        std::vector<Quaternion> q(count);
+        std::vector<Matrix> batched(count);
+        for (auto &r : q)
+            r = RandomQuaternion(gen);
+        Bone::BuildRotations(q.data(), batched.data(), count);
+        for (int32_t b = 0; b < count; b++)
+        {
+            Matrix scalar;
+            q[b].GetMatrix(scalar);
+            for (int32_t c = 0; c < 16; c++)
+                REQUIRE(batched[b].matrix[c] == Approx(scalar.matrix[c]).margin(kTolerance));
+        }
+    }
+}
+
+TEST_CASE("Bone kernels against the scalar path", "[animation][.benchmark]")
+{
+    constexpr int32_t numFrames = 400;
+    constexpr int32_t rounds = 2000;
+    std::mt19937 gen(7);
+
+    for (const int32_t count : {16, 50, 128})
+    {
+        // two actions blended into one pose, as AnimationImp::BuildAnimationMatrices does for two players
+        TestSkeleton walk(count, numFrames, 50, gen);
+        TestSkeleton run(count, numFrames, 50, gen);
+        std::vector<Quaternion> q1(count), q2(count), scalar(count), batched(count);
+        std::vector<Matrix> scalarMtx(count), batchedMtx(count);
+
+        storm::Stopwatch scalarTime, batchedTime;
+        scalarTime.measure([&] {
+            for (int32_t i = 0; i < rounds; i++)
+            {
+                const auto frame = i % (numFrames - 1);
+                const auto kBlend = (i % 100) * 0.01f;
+                for (int32_t b = 0; b < count; b++)
+                {
+                    walk.bones[b].BlendFrame(frame, kBlend, q1[b]);
+                    run.bones[b].BlendFrame(frame, kBlend, q2[b]);
+                    scalar[b].SLerp(q1[b], q2[b], 0.3f);
+                    scalar[b].GetMatrix(scalarMtx[b]);
+                }
+            }
+        });
+
+        batchedTime.measure([&] {
+            for (int32_t i = 0; i < rounds; i++)
+            {
+                const auto frame = i % (numFrames - 1);
+                const auto kBlend = (i % 100) * 0.01f;
+                Bone::BlendFrames(walk.bones.get(), count, frame, kBlend, q1.data());
+                Bone::BlendFrames(run.bones.get(), count, frame, kBlend, q2.data());
+                Bone::BlendPoses(q1.data(), q2.data(), 0.3f, batched.data(), count);
+                Bone::BuildRotations(batched.data(), batchedMtx.data(), count);
+            }
+        });
+
+        // both paths end on the same frame
+        for (int32_t b = 0; b < count; b++)
+            for (int32_t c = 0; c < 16; c++)
+                REQUIRE(batchedMtx[b].matrix[c] == Approx(scalarMtx[b].matrix[c]).margin(kTolerance));
+
+        const auto bones = static_cast<size_t>(rounds) * count;
+        WARN(count << " bones, ns/bone scalar: " << scalarTime.nanoseconds(bones)
+                   << ", batched: " << batchedTime.nanoseconds(bones));
+    }
+}
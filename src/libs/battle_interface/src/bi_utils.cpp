@@ -24,6 +24,16 @@ float BIUtils::GetFloatFromAttr(ATTRIBUTES *pA, const char *name, float defVal)
     return pA->GetAttributeAsFloat(name, defVal);
 }
 
+float BIUtils::GetFloatFromAttr(ATTRIBUTES *pA, const AttributePath &path, float defVal)
+{
+    if (pA == nullptr)
+        return defVal;
+    pA = path.Find(pA);
+    if (pA == nullptr || !pA->HasValue())
+        return defVal;
+    return pA->GetAttributeAsFloat(nullptr, defVal);
+}
+
 bool BIUtils::ReadStringFromAttr(ATTRIBUTES *pA, const char *name, char *buf, int32_t bufSize, const char *defVal)
 {
     if (buf == nullptr || bufSize < 1)
@@ -362,29 +362,27 @@ void BATTLE_NAVIGATOR::UpdateFireRangeBuffer() const
     auto *const pAttr = g_ShipList.GetMainCharacterShipAttr();
     if (psd != nullptr && pAttr != nullptr)
     {
-        FillOneSideFireRange(&pv[0], pAttr, psd->pAttr, "cannonf");
-        FillOneSideFireRange(&pv[(BI_ONESIDE_SIZE + 1)], pAttr, psd->pAttr, "cannonr");
-        FillOneSideFireRange(&pv[2 * (BI_ONESIDE_SIZE + 1)], pAttr, psd->pAttr, "cannonb");
-        FillOneSideFireRange(&pv[3 * (BI_ONESIDE_SIZE + 1)], pAttr, psd->pAttr, "cannonl");
+        for (int32_t side = 0; side < BI_SIDE_QUANTITY; side++)
+            FillOneSideFireRange(&pv[side * (BI_ONESIDE_SIZE + 1)], pAttr, psd->pAttr, side);
     }
     rs->UnLockVertexBuffer(m_idFireZoneVBuf);
 }
 
 void BATTLE_NAVIGATOR::FillOneSideFireRange(BI_NOTEXTURE_VERTEX *pv, ATTRIBUTES *pShip, ATTRIBUTES *pChar,
-                                            const char *pstr) const
+                                            int32_t side) const
 {
-    if (pv == nullptr || pShip == nullptr || pChar == nullptr || pstr == nullptr)
+    if (pv == nullptr || pShip == nullptr || pChar == nullptr)
         return;
 
     auto fDirAng = 0.f, fSizeAng = 0.f, fFireZone = 0.f;
     ATTRIBUTES *pA;
-    if ((pA = BIUtils::GetAttributesFromPath(pShip, "Cannons", "Borts", pstr, 0)) != nullptr)
+    if ((pA = m_pathShipBorts[side].Find(pShip)) != nullptr)
     {
         fSizeAng = pA->GetAttributeAsFloat("FireZone", 0.f);
         fDirAng = pA->GetAttributeAsFloat("FireDir", 0.f);
     }
 
-    if ((pA = BIUtils::GetAttributesFromPath(pChar, "Cannons", "Borts", pstr, 0)) != nullptr)
+    if ((pA = m_pathCharBorts[side].Find(pChar)) != nullptr)
         fFireZone = pA->GetAttributeAsFloat("MaxFireDistance", 0.f);
     fFireZone *= m_fMapRadius / (m_fWorldRad * m_fCurScale);
     if (fFireZone > m_fMapRadius)
@@ -960,13 +958,12 @@ void BATTLE_NAVIGATOR::SetMainCharacterData()
     m_fCurAnglRightCharge = m_fBegAnglRightCharge;
     m_fCurAnglForwardCharge = m_fBegAnglForwardCharge;
     m_fCurAnglBackCharge = m_fBegAnglBackCharge;
-    auto *pBortsAttr = BIUtils::GetAttributesFromPath(psd->pAttr, "cannons", "borts", 0);
-    if (pBortsAttr != nullptr)
+    if (psd->pAttr != nullptr)
     {
         ATTRIBUTES *pTmpAttr;
         float fCharge, fDamage;
         // left cannons
-        if ((pTmpAttr = pBortsAttr->GetAttributeClass("cannonl")) != nullptr)
+        if ((pTmpAttr = m_pathCharBorts[BI_CANNON_LEFT].Find(psd->pAttr)) != nullptr)
         {
             fCharge = pTmpAttr->GetAttributeAsFloat("ChargeRatio", 0);
             fDamage = pTmpAttr->GetAttributeAsFloat("DamageRatio", 0);
@@ -974,7 +971,7 @@ void BATTLE_NAVIGATOR::SetMainCharacterData()
             m_fCurAnglLeftCharge = GetBetwinFloat(m_fBegAnglLeftCharge, m_fCurAnglLeftDamage, fCharge);
         }
         // right cannons
-        if ((pTmpAttr = pBortsAttr->GetAttributeClass("cannonr")) != nullptr)
+        if ((pTmpAttr = m_pathCharBorts[BI_CANNON_RIGHT].Find(psd->pAttr)) != nullptr)
         {
             fCharge = pTmpAttr->GetAttributeAsFloat("ChargeRatio", 0);
             fDamage = pTmpAttr->GetAttributeAsFloat("DamageRatio", 0);
@@ -982,7 +979,7 @@ void BATTLE_NAVIGATOR::SetMainCharacterData()
             m_fCurAnglRightCharge = GetBetwinFloat(m_fBegAnglRightCharge, m_fCurAnglRightDamage, fCharge);
         }
         // forward cannons
-        if ((pTmpAttr = pBortsAttr->GetAttributeClass("cannonf")) != nullptr)
+        if ((pTmpAttr = m_pathCharBorts[BI_CANNON_FRONT].Find(psd->pAttr)) != nullptr)
         {
             fCharge = pTmpAttr->GetAttributeAsFloat("ChargeRatio", 0);
             fDamage = pTmpAttr->GetAttributeAsFloat("DamageRatio", 0);
@@ -990,7 +987,7 @@ void BATTLE_NAVIGATOR::SetMainCharacterData()
             m_fCurAnglForwardCharge = GetBetwinFloat(m_fBegAnglForwardCharge, m_fCurAnglForwardDamage, fCharge);
         }
         // backward cannons
-        if ((pTmpAttr = pBortsAttr->GetAttributeClass("cannonb")) != nullptr)
+        if ((pTmpAttr = m_pathCharBorts[BI_CANNON_BACK].Find(psd->pAttr)) != nullptr)
         {
             fCharge = pTmpAttr->GetAttributeAsFloat("ChargeRatio", 0);
             fDamage = pTmpAttr->GetAttributeAsFloat("DamageRatio", 0);
@@ -10,6 +10,15 @@
 #define FIRERANGE_QUANTITY (BI_ONESIDE_SIZE + 1) * BI_SIDE_QUANTITY
 #define MAX_ENEMY_SHIP_QUANTITY 20
 
+// cannon sides in the order of the fire range buffer
+enum BI_CANNON_SIDE
+{
+    BI_CANNON_FRONT,
+    BI_CANNON_RIGHT,
+    BI_CANNON_BACK,
+    BI_CANNON_LEFT
+};
+
 class BATTLE_NAVIGATOR
 {
     VDX9RENDER *rs{};
@@ -68,7 +77,7 @@ class BATTLE_NAVIGATOR
     void ReleaseAll();
     void UpdateMiniMap();
     void UpdateFireRangeBuffer() const;
-    void FillOneSideFireRange(BI_NOTEXTURE_VERTEX *pv, ATTRIBUTES *pShip, ATTRIBUTES *pChar, const char *pstr) const;
+    void FillOneSideFireRange(BI_NOTEXTURE_VERTEX *pv, ATTRIBUTES *pShip, ATTRIBUTES *pChar, int32_t side) const;
     void UpdateCurrentCharge();
 
     void UpdateWindParam();
@@ -202,6 +211,14 @@ class BATTLE_NAVIGATOR
     WEATHER_BASE *m_wb{};
     ATTRIBUTES *m_pAWeather{};
 
+    // cannon sides of the main character read every frame, from its ship attributes and from its ship type
+    AttributePath m_pathCharBorts[BI_SIDE_QUANTITY]{
+        AttributePath{"Cannons.Borts.cannonf"}, AttributePath{"Cannons.Borts.cannonr"},
+        AttributePath{"Cannons.Borts.cannonb"}, AttributePath{"Cannons.Borts.cannonl"}};
+    AttributePath m_pathShipBorts[BI_SIDE_QUANTITY]{
+        AttributePath{"Cannons.Borts.cannonf"}, AttributePath{"Cannons.Borts.cannonr"},
+        AttributePath{"Cannons.Borts.cannonb"}, AttributePath{"Cannons.Borts.cannonl"}};
+
     // icon of the current cannon charge type
     POINT m_ChargeGreed{};
     POINT m_ChargePos{};
@@ -746,7 +746,7 @@ float BIShipIcon::GetProgressShipHP(int32_t nShipNum) const
 {
     if (m_Ship[nShipNum].nMaxHP <= 0.f && !m_Ship[nShipNum].pAShip)
         return 0.f;
-    float f = m_Ship[nShipNum].pAShip->GetAttributeAsFloat("HP", 0.f) / m_Ship[nShipNum].nMaxHP;
+    float f = BIUtils::GetFloatFromAttr(m_Ship[nShipNum].pAShip, m_Ship[nShipNum].pathHP, 0.f) / m_Ship[nShipNum].nMaxHP;
     if (f < 0.f)
         f = 0.f;
     if (f > 1.f)
@@ -758,7 +758,7 @@ float BIShipIcon::GetProgressShipSP(int32_t nShipNum)
 {
     if (m_Ship[nShipNum].nMaxSP <= 0.f && !m_Ship[nShipNum].pAShip)
         return 0.f;
-    float f = m_Ship[nShipNum].pAShip->GetAttributeAsFloat("SP", 0.f) / m_Ship[nShipNum].nMaxSP;
+    float f = BIUtils::GetFloatFromAttr(m_Ship[nShipNum].pAShip, m_Ship[nShipNum].pathSP, 0.f) / m_Ship[nShipNum].nMaxSP;
     if (f < 0.f)
         f = 0.f;
     if (f > 1.f)
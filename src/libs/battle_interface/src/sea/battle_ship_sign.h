@@ -123,6 +123,9 @@ class BIShipIcon
         FRECT rUV;
         std::string sShipName;
         int32_t nShipClass;
+        // read from pAShip every frame
+        AttributePath pathHP{"HP"};
+        AttributePath pathSP{"SP"};
     } m_Ship[MAX_SHIP_QUANTITY];
 
     int32_t m_nShipQuantity;
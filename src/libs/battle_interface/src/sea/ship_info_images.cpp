@@ -316,7 +316,7 @@ float ShipInfoImages::GetProgressHull(SHIP_DESCRIBE_LIST::SHIP_DESCR *pSD)
         return 0.f;
     if (pSD->maxHP <= 0)
         return 0.f;
-    auto f = pSD->pAttr->GetAttributeAsFloat("HP", 0.f) / static_cast<float>(pSD->maxHP);
+    auto f = BIUtils::GetFloatFromAttr(pSD->pAttr, pSD->pathHP, 0.f) / static_cast<float>(pSD->maxHP);
     if (f < 0.f)
         f = 0.f;
     if (f > 1.f)
@@ -330,7 +330,7 @@ float ShipInfoImages::GetProgressSail(SHIP_DESCRIBE_LIST::SHIP_DESCR *pSD)
         return 0.f;
     if (pSD->maxSP <= 0)
         return 0.f;
-    auto f = pSD->pAttr->GetAttributeAsFloat("SP", 0.f) / static_cast<float>(pSD->maxSP);
+    auto f = BIUtils::GetFloatFromAttr(pSD->pAttr, pSD->pathSP, 0.f) / static_cast<float>(pSD->maxSP);
     if (f < 0.f)
         f = 0.f;
     if (f > 1.f)
@@ -344,10 +344,7 @@ float ShipInfoImages::GetProgressCrew(SHIP_DESCRIBE_LIST::SHIP_DESCR *pSD)
         return 0.f;
     if (pSD->maxCrew <= 0)
         return 0.f;
-    auto *pA = pSD->pAttr->GetAttributeClass("crew");
-    if (!pA)
-        return 0.f;
-    auto f = pA->GetAttributeAsFloat("quantity", 0.f) / static_cast<float>(pSD->maxCrew);
+    auto f = BIUtils::GetFloatFromAttr(pSD->pAttr, pSD->pathCrew, 0.f) / static_cast<float>(pSD->maxCrew);
     if (f < 0.f)
         f = 0.f;
     if (f > 1.f)
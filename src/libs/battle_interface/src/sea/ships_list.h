@@ -23,6 +23,11 @@ class SHIP_DESCRIBE_LIST
         VAI_OBJBASE *pShip;
         uint32_t dwShipColor;
 
+        // read from pAttr every frame
+        AttributePath pathHP{"HP"};
+        AttributePath pathSP{"SP"};
+        AttributePath pathCrew{"crew.quantity"};
+
         SHIP_DESCR *next;
     };
 
@@ -350,36 +350,17 @@ void Blots::LoadBlot(int32_t i)
     }
 }
 
-// Update
-void Blots::Realize(uint32_t delta_time)
+// Lifetime of the blots
+void Blots::Execute(uint32_t delta_time)
 {
-    // Updating the state
-    blotsInfo = pCharAttributeRoot->FindAClass(pCharAttributeRoot, "ship.blots");
-    updateBlot++;
-    if (updateBlot >= BLOTS_MAX)
-        updateBlot = 0;
-    SaveBlot(updateBlot);
-    // Model of a ship
+    // Blots of the ships out of sight stay as they are, the same as Realize skips them
     auto *m = static_cast<MODEL *>(core.GetEntityPointer(model));
     if (!m)
         return;
-    // Distance from camera
     CVECTOR pos, ang;
     rs->GetCamera(pos, ang, ang.x);
-    auto dist = ~(pos - m->mtx.Pos());
-    if (dist >= BLOTS_DIST * BLOTS_DIST)
+    if (~(pos - m->mtx.Pos()) >= BLOTS_DIST * BLOTS_DIST)
         return;
-    // Transparency according to the distance to the ship
-    dist = (sqrtf(dist / (BLOTS_DIST * BLOTS_DIST)) - 0.5f) / 0.5f;
-    if (dist <= 0.0f)
-        dist = 0.0f;
-    dist = (1.0f - dist) * 255.0f;
-    auto color = static_cast<int32_t>(dist);
-    rs->SetRenderState(D3DRS_TEXTUREFACTOR, (color << 24) | (color << 16) | (color << 8) | color);
-    // Settings
-    rs->SetTransform(D3DTS_WORLD, m->mtx);
-    rs->TextureSet(0, textureID);
-    // Draw all the added blots
     for (int32_t i = 0; i < BLOTS_MAX; i++)
     {
         // Skip unused
@@ -396,22 +377,8 @@ void Blots::Realize(uint32_t delta_time)
             const auto startIndex = blot[i].startIndex;
             const int32_t numDelVerts = blot[i].numTrgs * 3;
 
-            // -----------------------------------------------
-            // !!! begin Checks
             blot[i].startIndex = -10000;
             blot[i].numTrgs = 0;
-            static Vertex vr[3 * BLOTS_NTRGS * BLOTS_MAX];
-            for (int32_t n = 0; n < BLOTS_MAX; n++)
-            {
-                if (!blot[n].isUsed)
-                    continue;
-                auto *const v1 = vr + n * BLOTS_NTRGS * 3;
-                auto *const v2 = vrt + blot[n].startIndex;
-                for (int32_t v = 0; v < blot[n].numTrgs * 3; v++)
-                    v1[v] = v2[v];
-            }
-            // !!! end Checks
-            // -----------------------------------------------
 
             // Remove triangles from the array
             int32_t j;
@@ -424,7 +391,7 @@ void Blots::Realize(uint32_t delta_time)
             }
             j = useVrt - (startIndex + numDelVerts);
             if (j > 0)
-                memcpy(vrt + startIndex, vrt + startIndex + numDelVerts, j * sizeof(Vertex));
+                memmove(vrt + startIndex, vrt + startIndex + numDelVerts, j * sizeof(Vertex));
             useVrt -= numDelVerts;
             Assert(useVrt >= 0);
 
@@ -440,22 +407,6 @@ void Blots::Realize(uint32_t delta_time)
                 Assert(blot[j].startIndex + blot[j].numTrgs * 3 <= useVrt);
             }
             Assert(nnn == useVrt);
-            for (int32_t n = 0; n < BLOTS_MAX; n++)
-            {
-                if (!blot[n].isUsed)
-                    continue;
-                auto *const v1 = vr + n * BLOTS_NTRGS * 3;
-                auto *const v2 = vrt + blot[n].startIndex;
-                for (int32_t v = 0; v < blot[n].numTrgs * 3; v++)
-                {
-                    Assert(v1[v].pos.x == v2[v].pos.x);
-                    Assert(v1[v].pos.y == v2[v].pos.y);
-                    Assert(v1[v].pos.z == v2[v].pos.z);
-                    Assert(v1[v].c == v2[v].c);
-                    Assert(v1[v].u == v2[v].u);
-                    Assert(v1[v].v == v2[v].v);
-                }
-            }
             // !!! end Checks
             // -----------------------------------------------
 
@@ -468,7 +419,7 @@ void Blots::Realize(uint32_t delta_time)
             k = 0.0f;
         if (k > 1.0f)
             k = 1.0f;
-        color = static_cast<int32_t>((1.0f - k) * 255.0f);
+        auto color = static_cast<int32_t>((1.0f - k) * 255.0f);
         if (color != blot[i].lastAlpha)
         {
             // Update the vertices
@@ -482,6 +433,37 @@ void Blots::Realize(uint32_t delta_time)
                 v[j].c = color;
         }
     }
+}
+
+// Update
+void Blots::Realize(uint32_t delta_time)
+{
+    // Updating the state
+    blotsInfo = pCharAttributeRoot->FindAClass(pCharAttributeRoot, "ship.blots");
+    updateBlot++;
+    if (updateBlot >= BLOTS_MAX)
+        updateBlot = 0;
+    SaveBlot(updateBlot);
+    // Model of a ship
+    auto *m = static_cast<MODEL *>(core.GetEntityPointer(model));
+    if (!m)
+        return;
+    // Distance from camera
+    CVECTOR pos, ang;
+    rs->GetCamera(pos, ang, ang.x);
+    auto dist = ~(pos - m->mtx.Pos());
+    if (dist >= BLOTS_DIST * BLOTS_DIST)
+        return;
+    // Transparency according to the distance to the ship
+    dist = (sqrtf(dist / (BLOTS_DIST * BLOTS_DIST)) - 0.5f) / 0.5f;
+    if (dist <= 0.0f)
+        dist = 0.0f;
+    dist = (1.0f - dist) * 255.0f;
+    auto color = static_cast<int32_t>(dist);
+    rs->SetRenderState(D3DRS_TEXTUREFACTOR, (color << 24) | (color << 16) | (color << 8) | color);
+    // Settings
+    rs->SetTransform(D3DTS_WORLD, m->mtx);
+    rs->TextureSet(0, textureID);
     // Draw
     if (useVrt > 3)
         rs->DrawPrimitiveUP(D3DPT_TRIANGLELIST, D3DFVF_XYZ | D3DFVF_DIFFUSE | D3DFVF_TEX1, useVrt / 3, vrt,
@@ -59,8 +59,9 @@ class Blots : public Entity
     {
         switch (stage)
         {
-            // case Stage::execute:
-            //    Execute(delta); break;
+        case Stage::execute:
+            Execute(delta);
+            break;
         case Stage::realize:
             Realize(delta);
             break;
@@ -72,6 +73,13 @@ class Blots : public Entity
     }
 
     // Work
+    // execute only expires and fades own blots, the ship adds it to the execute layer
+    [[nodiscard]] ExecutePolicy GetExecutePolicy() const override
+    {
+        return ExecutePolicy::parallel;
+    }
+
+    void Execute(uint32_t delta_time);
     void Realize(uint32_t delta_time);
 
     // --------------------------------------------------------------------------------------------
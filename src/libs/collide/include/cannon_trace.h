@@ -8,4 +8,11 @@ class CANNON_TRACE_BASE : public COLLISION_OBJECT
     ~CANNON_TRACE_BASE() override = default;
 
     virtual float Cannon_Trace(int32_t iBallOwner, const CVECTOR &src, const CVECTOR &dst) = 0;
+
+    // world space sphere around everything Cannon_Trace can hit,
+    // objects without bounds return false and get traced by every ball
+    virtual bool GetCannonTraceBounds(CVECTOR &center, float &radius)
+    {
+        return false;
+    }
 };
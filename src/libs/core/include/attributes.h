@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <cstdint>
 #include <functional>
 #include <optional>
@@ -20,6 +21,12 @@ class VSTRING_CODEC
     virtual uint32_t Convert(const char *pString, int32_t iLen) = 0;
     virtual const char *Convert(uint32_t code) = 0;
 
+    // code of an already known string, unlike Convert never adds a new one
+    virtual std::optional<uint32_t> Find(const char *pString, int32_t iLen)
+    {
+        return Convert(pString, iLen);
+    }
+
     virtual void VariableChanged() = 0;
 };
 
@@ -27,6 +34,34 @@ class ATTRIBUTES;
 
 bool MatchAttributePath(const std::string_view &pattern, const ATTRIBUTES &attribute);
 
+// Pre-parsed access path like "ship.speed.z" for attributes looked up every frame.
+// Name codes are converted once, the found attribute is cached until an attribute
+// that some path has resolved through gets destroyed, or any attribute is renamed or reordered.
+class AttributePath final
+{
+  public:
+    explicit AttributePath(const std::string_view &path);
+
+    // same as root->FindAClass(root, path)
+    [[nodiscard]] ATTRIBUTES *Find(ATTRIBUTES *root) const;
+    // same as root->CreateSubAClass(root, path)
+    ATTRIBUTES *Create(ATTRIBUTES *root) const;
+
+    [[nodiscard]] const std::string &GetPath() const noexcept;
+
+  private:
+    void ResolveNameCodes(VSTRING_CODEC &string_codec) const;
+    // flags every node from root to the cached result, destroying any of them invalidates the cache
+    void MarkCached(const ATTRIBUTES *root) const;
+
+    std::string path_;
+    mutable VSTRING_CODEC *stringCodec_{};
+    mutable std::vector<uint32_t> nameCodes_;
+    mutable ATTRIBUTES *cachedRoot_{};
+    mutable ATTRIBUTES *cachedResult_{};
+    mutable uint64_t cachedEpoch_{};
+};
+
 class ATTRIBUTES final
 {
     class LegacyProxy;
@@ -50,7 +85,11 @@ class ATTRIBUTES final
     [[deprecated("Pass attribute value by string_view instead")]]
     void SetValue(const char *new_value);
     void SetValue(const std::string_view &new_value);
+    // no value at all, HasValue is false afterwards
+    void ResetValue();
     [[nodiscard]] size_t GetAttributesNum() const;
+    // room for count more children, for trees built in bulk like loaded saves
+    void ReserveAttributes(size_t count);
     [[nodiscard]] ATTRIBUTES *GetAttributeClass(const std::string_view &name) const;
     [[nodiscard]] ATTRIBUTES *GetAttributeClass(uint32_t n) const;
     [[nodiscard]] ATTRIBUTES *VerifyAttributeClass(const std::string_view &name);
@@ -63,6 +102,12 @@ class ATTRIBUTES final
     [[nodiscard]] float GetAttributeAsFloat(const char *name = nullptr, float def = 0) const;
     bool SetAttributeUseDword(const char *name, uint32_t val);
     bool SetAttributeUseFloat(const char *name, float val);
+    // numbers are kept as is and only formatted when the value is read as a string
+    void SetValueUseInteger(int64_t value);
+    // fixed is formatted like a script assignment ("%.7f"), otherwise like SetAttributeUseFloat ("%g")
+    void SetValueUseFloat(float value, bool fixed = false);
+    // value set as an integer, nothing for string and float values
+    [[nodiscard]] std::optional<int64_t> GetIntegerValue() const noexcept;
     ATTRIBUTES &CreateAttribute(const std::string_view &name);
     ATTRIBUTES *CreateAttribute(const std::string_view &name, const char *attribute);
     [[deprecated("Pass attribute value by string_view instead")]]
@@ -79,23 +124,73 @@ class ATTRIBUTES final
     size_t SetAttribute(uint32_t name_code, const char *attribute);
     size_t SetAttribute(uint32_t name_code, const std::string_view &attribute);
     [[nodiscard]] uint32_t GetThisNameCode() const noexcept;
-    void SetNameCode(uint32_t n) noexcept;
+    void SetNameCode(uint32_t n);
     [[nodiscard]] VSTRING_CODEC &GetStringCodec() const noexcept;
 
     void Sort(const std::function<bool(const std::unique_ptr<ATTRIBUTES> &lhs, const std::unique_ptr<ATTRIBUTES> &rhs)>& pred);
 
+    struct MemoryUsage
+    {
+        size_t nodes;
+        size_t bytes;
+    };
+
+    // nodes and heap bytes owned by this attribute and all of its children
+    [[nodiscard]] MemoryUsage GetMemoryUsage() const;
+
+    // child nodes come from a shared pool instead of separate heap allocations
+    static void *operator new(size_t size);
+    static void operator delete(void *ptr, size_t size);
+
 private:
+    friend class AttributePath;
+
+    // children lookup by name code is hashed starting from this number of children
+    static constexpr size_t kChildIndexThreshold = 16;
+
     ATTRIBUTES(VSTRING_CODEC &string_codec, ATTRIBUTES *parent, const std::string_view &name);
     ATTRIBUTES(VSTRING_CODEC &string_codec, ATTRIBUTES *parent, uint32_t name_code);
 
     ATTRIBUTES *CreateNewAttribute(uint32_t name_code);
+    // child with given name code, created if there is none
+    ATTRIBUTES *GetOrCreateChild(uint32_t name_code);
+    void CopyValue(const ATTRIBUTES &source);
+    // value_ with a numeric value formatted into it
+    [[nodiscard]] const std::optional<std::string> &GetFormattedValue() const;
+    void CopyChildren(const ATTRIBUTES &source);
+    // takes over the children moved from other
+    void AdoptChildren(const ATTRIBUTES &other);
+
+    // returns position of the first child with given name code, or GetAttributesNum() if there is none
+    [[nodiscard]] size_t FindChildPosition(uint32_t name_code) const;
+    void InsertChildIndex(size_t position);
+    void RebuildChildIndex();
+
+    enum class ValueType : uint8_t
+    {
+        String,
+        Integer,
+        Float,
+        FixedFloat,
+    };
 
     VSTRING_CODEC &stringCodec_;
     uint32_t nameCode_{};
-    std::optional<std::string> value_;
+    ValueType valueType_{ValueType::String};
+    // false until a numeric value is formatted into value_
+    mutable std::atomic<bool> valueFormatted_{true};
+    union {
+        int64_t integer;
+        float real;
+    } number_{};
+    mutable std::optional<std::string> value_;
     std::vector<std::unique_ptr<ATTRIBUTES>> attributes_;
+    // open addressing table of child positions + 1 (0 is a free slot), empty for small nodes
+    std::vector<uint32_t> childIndex_;
     ATTRIBUTES *parent_{nullptr};
     bool break_{false};
+    // set once an AttributePath cached a result through this node
+    mutable std::atomic<bool> cachedByPath_{false};
     
     class LegacyProxy
     {
@@ -18,6 +18,12 @@
 
 struct IFUNCINFO;
 
+// pre-resolved script event name, see Core::GetEventHandle
+enum class event_handle_t : uint32_t
+{
+    invalid = 0xffffffff
+};
+
 struct ScreenSize
 {
     size_t width{};
@@ -83,6 +89,9 @@ class Core
     virtual bool SaveState(const char *file_name) = 0;
     // force core to load state file at the start of next game loop, return false if no state file
     virtual bool InitiateStateLoading(const char *file_name) = 0;
+    // wait until the state file of the last SaveState is written, before touching save files;
+    // false if it could not be written, the old file of that name is kept then
+    virtual bool WaitStateSaving() = 0;
 
     // return current fps
     virtual uint32_t EngineFps() = 0;
@@ -93,13 +102,23 @@ class Core
     //
     virtual VDATA *Event(const std::string_view &event_name) = 0;
     template <typename... Args>
-    VDATA *Event(const std::string_view &event_name, const std::string_view &format, Args... args)
+    VDATA *Event(const std::string_view &event_name, storm::message_format_t<Args...> format, Args... args)
     {
         MESSAGE message;
         message.Reset(format, args...);
         return Event(event_name, message);
     }
     virtual VDATA *Event(const std::string_view &event_name, MESSAGE &message) = 0;
+    // resolves event name once for events fired every frame, handle stays valid for the whole run
+    virtual event_handle_t GetEventHandle(const std::string_view &event_name) = 0;
+    template <typename... Args>
+    VDATA *Event(event_handle_t event, storm::message_format_t<Args...> format, Args... args)
+    {
+        MESSAGE message;
+        message.Reset(format, args...);
+        return Event(event, message);
+    }
+    virtual VDATA *Event(event_handle_t event, MESSAGE &message) = 0;
     virtual uint32_t PostEvent(const char *Event_name, uint32_t post_time, const char *Format, ...) = 0;
 
     virtual void *GetSaveData(const char *file_name, int32_t &data_size) = 0;
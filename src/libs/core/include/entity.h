@@ -42,6 +42,15 @@ class Entity
         restore_render
     };
 
+    enum class ExecutePolicy : uint_fast8_t
+    {
+        // runs in layer order, nothing else executes at the same time
+        sequential,
+        // touches only own state during execute, may run concurrently with
+        // neighbouring parallel entities of the same execute layers
+        parallel
+    };
+
     ATTRIBUTES *AttributesPointer = nullptr; // TODO: CHANGE!
 
     [[nodiscard]] auto GetId() const
@@ -68,6 +77,17 @@ class Entity
         return {};
     }
 
+    [[nodiscard]] virtual ExecutePolicy GetExecutePolicy() const
+    {
+        return ExecutePolicy::sequential;
+    }
+
+    // called for parallel entities on the main thread, in layer order, once their batch has executed;
+    // the part of execute that fires events, erases entities or uses shared services goes here
+    virtual void FinishParallelExecute(uint32_t delta)
+    {
+    }
+
     virtual void ShowEditor();
 
   private:
@@ -1,20 +1,21 @@
 #pragma once
 
 #include "ifs.h"
+#include "storm/file_watcher.hpp"
+#include "string_compare.hpp"
 #include "v_file_service.h"
+#include <list>
 #include <memory>
 #include <unordered_map>
 
-#define _MAX_OPEN_INI_FILES 1024
-
 class INIFILE_T : public INIFILE
 {
   public:
     INIFILE_T(IFS *iR)
     {
         ifs_PTR = iR;
-        Search.Section = nullptr;
-        Search.Key = nullptr;
+        Search.Section = INI_NONE;
+        Search.Key = INI_NONE;
     }
 
     ~INIFILE_T() override;
@@ -84,10 +85,20 @@ class INIFILE_T : public INIFILE
 class FILE_SERVICE final
 {
   private:
-    // INIFILE_R * OpenFiles[_MAX_OPEN_INI_FILES];
-    IFS *OpenFiles[_MAX_OPEN_INI_FILES];
-    uint32_t Files_Num;
-    uint32_t Max_File_Index;
+    // Parsed ini files stay here after the last INIFILE is closed and are reused
+    // while the file on disk isn't changed, the least recently closed are dropped first
+    static constexpr size_t MaxIdleIniFiles = 256;
+    static constexpr size_t MaxIdleIniFilesSize = 32 * 1024 * 1024;
+
+    std::unordered_map<std::string, std::unique_ptr<IFS>, storm::iStrHasher, storm::iStrComparator>
+        IniFiles;
+    std::list<IFS *> IdleIniFiles; // not referenced, the most recently closed first
+    size_t IdleIniFilesSize;
+
+    void TrimIdleIniFiles();
+
+    storm::FileWatcher Watcher;
+
     // Resource paths
     bool ResourcePathsFirstScan = true; // Since some code may call this statically, we use a flag to know if this is the first time
     std::unordered_map<std::string, std::string> ResourcePaths;
@@ -99,6 +110,8 @@ class FILE_SERVICE final
     void _CloseFile(std::fstream &fileS);
     void _SetFilePointer(std::fstream &fileS, std::streamoff off, std::ios::seekdir dir);
     bool _DeleteFile(const char *filename);
+    // replaces newName if it exists
+    bool _RenameFile(const char *oldName, const char *newName);
     bool _WriteFile(std::fstream &fileS, const void *s, std::streamsize count);
     bool _ReadFile(std::fstream &fileS, void *s, std::streamsize count);
     bool _FileOrDirectoryExists(const char *p);
@@ -109,6 +122,7 @@ class FILE_SERVICE final
                                                          bool onlyDirs = false, bool onlyFiles = true,
                                                          bool recursive = false);
     std::filesystem::file_time_type _GetLastWriteTime(const char *filename);
+    std::filesystem::file_time_type _GetLastWriteTime(const char *filename, std::error_code &ec);
     void _FlushFileBuffers(std::fstream &fileS);
     std::string _GetCurrentDirectory();
     std::string _GetExecutableDirectory();
@@ -124,6 +138,12 @@ class FILE_SERVICE final
     void RefDec(INIFILE *ini_obj);
     void FlushIniFiles();
 
+    // file watches, the callback is called by ProcessFileWatches when the file is changed, created or removed
+    uint32_t WatchFile(const char *file_name, std::function<void()> callback);
+    void UnwatchFile(uint32_t id);
+    // called once per frame on the main thread
+    void ProcessFileWatches();
+
     // Resource paths
     void AddEntryToResourcePaths(const std::filesystem::directory_entry &entry, std::string &CheckingPath);
     void ScanResourcePaths();
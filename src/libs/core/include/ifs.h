@@ -1,80 +1,65 @@
 #pragma once
 
+#include "string_compare.hpp"
 #include "v_file_service.h"
+
+#include <memory>
 #include <stdexcept>
+#include <string_view>
+#include <unordered_map>
 
 #define KNF_KEY 0x1
 #define KNF_COMMENTARY 0x2
 
+// Index of a section or a key, INI_NONE if there is none
+constexpr uint32_t INI_NONE = 0xffffffff;
+
 class FILE_SERVICE;
+class IFS;
 
-class KEY_NODE
+struct INI_KEY
 {
-    char *key_name;
-    char *key_val;
-
-    int32_t name_size;
-    int32_t val_size;
-
-    KEY_NODE *l_PTR;
-    KEY_NODE *r_PTR;
-
+    const char *name; // whole line for a commentary
+    const char *value; // nullptr if the key has no value
     uint32_t flags;
-
-  public:
-    KEY_NODE();
-    ~KEY_NODE();
-    void SetName(const char *name);
-    void SetValue(const char *value);
-    char *GetName();
-    char *GetValue();
-    KEY_NODE *GetLeftNode();
-    KEY_NODE *GetRightNode();
-    void SetLeftNode(KEY_NODE *node);
-    void SetRightNode(KEY_NODE *node);
-    void Add(KEY_NODE **Root, KEY_NODE **Top);
-    void AttachTo(KEY_NODE *node, KEY_NODE **Top); // left - root, order - from left to right
-    void Deattach(KEY_NODE **Root, KEY_NODE **Top);
-    uint32_t SetFlags(uint32_t flags);
+    uint32_t next; // next key of the section with the same name
 };
 
-class SECTION
+class INI_SECTION
 {
-    KEY_NODE *Root;
-    KEY_NODE *Top;
+    friend IFS;
 
-    SECTION *l_PTR;
-    SECTION *r_PTR;
+    // first and last keys with the name, KNF_KEY only
+    struct CHAIN
+    {
+        uint32_t first;
+        uint32_t last;
+    };
 
-    char *Name;
+    const char *Name; // nullptr for the unnamed section at the file start
+    std::vector<INI_KEY> Keys;
+    std::unordered_map<std::string_view, CHAIN, storm::iStrViewHasher, storm::iStrViewComparator> Index;
 
   public:
-    SECTION();
-    ~SECTION();
-
-    KEY_NODE *AddNode();
-    void DelNode(KEY_NODE *);
-
-    KEY_NODE *FindKey(KEY_NODE *from, const char *key_name, const char *key_value);
-    KEY_NODE *FindKey(const char *key_name, const char *key_value);
-    KEY_NODE *FindKey(const char *key_name);
-    KEY_NODE *GetRoot();
-
-    void SetName(const char *name);
-    char *GetName();
-
-    SECTION *GetLeftNode();
-    SECTION *GetRightNode();
-    void SetLeftNode(SECTION *node);
-    void SetRightNode(SECTION *node);
-    void Add(SECTION **SRoot, SECTION **STop);
-    void Deattach(SECTION **SRoot, SECTION **STop);
+    explicit INI_SECTION(const char *name);
+
+    const char *GetName() const;
+    const std::vector<INI_KEY> &GetKeys() const;
+
+    uint32_t AddKey(const char *key_name, const char *key_value, uint32_t flags);
+    void DelKey(uint32_t key);
+    void RebuildIndex();
+
+    // first key with the name and the value if it isn't nullptr
+    uint32_t FindKey(const char *key_name, const char *key_value) const;
+    // key with the name after key
+    uint32_t FindNextKey(uint32_t key, const char *key_name) const;
 };
 
 typedef struct
 {
-    SECTION *Section;
-    KEY_NODE *Key;
+    uint32_t Section;
+    uint32_t Key;
 } SEARCH_DATA;
 
 class IFS : public INIFILE
@@ -82,22 +67,36 @@ class IFS : public INIFILE
     friend FILE_SERVICE;
 
   protected:
-    SECTION *SectionSNode;
-
-    SECTION *SectionRoot;
-    SECTION *SectionTop;
-
-    // KEY_NODE * FindKey(KEY_NODE * from, char * section_name, char * key_name, char * key_value);
-    KEY_NODE *FindKey(const char *section_name, const char *key_name, const char *key_value);
-    KEY_NODE *FindKey(const char *section_name, const char *key_name);
-    SECTION *FindSection(const char *section_name);
-    SECTION *FindSection(const char *section_name, SECTION *snode);
+    uint32_t SectionSNode;
+
+    // Section 0 is the unnamed one, SectionIndex gives the first section with the name
+    std::vector<INI_SECTION> Sections;
+    std::unordered_map<std::string_view, uint32_t, storm::iStrViewHasher, storm::iStrViewComparator> SectionIndex;
+
+    // Names and values point here: the loaded file split in place, then blocks of written strings
+    std::vector<std::unique_ptr<char[]>> StringBlocks;
+    char *StringFree;
+    size_t StringFreeSize;
+    size_t StringsSize;
+    size_t DeadStringsSize; // replaced and deleted strings
+
+    const char *StoreString(const char *str);
+    void ReleaseString(const char *str);
+    void CollectStrings();
+    void RebuildSectionIndex();
+    void Clear();
+
+    uint32_t FindKey(const char *section_name, const char *key_name, const char *key_value);
+    uint32_t FindKey(const char *section_name, const char *key_name);
+    uint32_t FindSection(const char *section_name);
+    uint32_t FindSection(const char *section_name, uint32_t snode);
 
     void Format(char *file_data, int32_t file_size);
     bool VoidSym(char symbol);
 
     FILE_SERVICE *fs;
-    char *FileName;
+    std::string FileName;
+    std::filesystem::file_time_type WriteTime; // of the file when it was loaded or flushed
     bool bDataChanged;
     uint32_t Reference;
     uint32_t CompareStrings(const char *s1, const char *s2);
@@ -138,13 +137,15 @@ class IFS : public INIFILE
 
     char *GetFileName()
     {
-        return FileName;
+        return FileName.data();
     };
     void IncReference();
     void DecReference();
     int32_t GetReference();
+    // approximate, for the cache of parsed files
+    size_t GetMemoryUsage() const;
 
-    SECTION *CreateSection(const char *section_name);
+    uint32_t CreateSection(const char *section_name);
     void DeleteSection(const char *section_name) override;
 
     bool TestKey(const char *section_name, const char *key_name, const char *key_value) override;
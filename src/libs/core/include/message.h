@@ -1,8 +1,13 @@
 #pragma once
 
+#include <array>
+#include <concepts>
 #include <cstdarg>
 #include <cstring>
+#include <string_view>
+#include <type_traits>
 #include <variant>
+#include <vector>
 
 #include "c_vector.h"
 #include "entity.h"
@@ -16,26 +21,108 @@ using MessageParam = std::variant<uint8_t, uint16_t, uint32_t, int32_t, float, d
 
 namespace detail {
 
-template<typename T>
-MessageParam convertMessageParam(T value)
+// Store the argument as the exact type the reader of the format char gets
+template <typename T> MessageParam convertMessageParam(const char c, T value)
 {
-    return MessageParam(value);
+    if constexpr (std::is_arithmetic_v<T> || std::is_enum_v<T>)
+    {
+        switch (c)
+        {
+        case 'b':
+            return static_cast<uint8_t>(value);
+        case 'w':
+            return static_cast<uint16_t>(value);
+        case 'l':
+            return static_cast<int32_t>(value);
+        case 'u':
+            return static_cast<uint32_t>(value);
+        case 'f':
+            return static_cast<float>(value);
+        case 'd':
+            return static_cast<double>(value);
+        case 'p':
+            return static_cast<uintptr_t>(value);
+        case 'i':
+            return static_cast<entid_t>(value);
+        default:
+            break;
+        }
+    }
+    if constexpr (std::is_enum_v<T>)
+        return static_cast<int32_t>(value);
+    else
+        return MessageParam(value);
 }
 
-template<>
-inline MessageParam convertMessageParam(const bool value)
+template <typename T>
+consteval bool isMessageParamCompatible(const char c)
 {
-    return {value ? 1 : 0};
+    using U = std::remove_cvref_t<T>;
+    switch (c)
+    {
+    case 'b':
+    case 'w':
+    case 'l':
+    case 'u':
+    case 'p':
+        return std::is_integral_v<U> || std::is_enum_v<U>;
+    case 'i':
+        return std::is_same_v<U, entid_t>;
+    case 'f':
+    case 'd':
+        return std::is_floating_point_v<U>;
+    case 'a':
+        return std::is_convertible_v<U, ATTRIBUTES *>;
+    case 'e':
+        return std::is_convertible_v<U, VDATA *>;
+    case 'c':
+        return std::is_convertible_v<U, CVECTOR>;
+    case 's':
+        return std::is_convertible_v<U, std::string_view>;
+    default:
+        return false;
+    }
 }
 
-// Convert uint32_t to int32_t to prevent conversion issues
-template<>
-inline MessageParam convertMessageParam(const uint32_t value)
+} // namespace detail
+
+// Message format checked against argument types at compile time when given as a literal,
+// formats built at runtime are only checked for length when the message is filled
+template <typename... Args>
+class MessageFormat
 {
-    return MessageParam(static_cast<int32_t>(value));
-}
+  public:
+    template <size_t N>
+    consteval MessageFormat(const char (&format)[N]) : format_(format, N - 1)
+    {
+        if (N - 1 != sizeof...(Args))
+        {
+            throw "message format length doesn't match number of arguments";
+        }
+        size_t n = 0;
+        if (!(detail::isMessageParamCompatible<Args>(format[n++]) && ...))
+        {
+            throw "message argument type doesn't match format";
+        }
+    }
 
-} // namespace detail
+    template <typename T>
+        requires(!std::is_array_v<std::remove_cvref_t<T>> && std::convertible_to<const T &, std::string_view>)
+    MessageFormat(const T &format) : format_(format)
+    {
+    }
+
+    [[nodiscard]] constexpr std::string_view Get() const noexcept
+    {
+        return format_;
+    }
+
+  private:
+    std::string_view format_;
+};
+
+template <typename... Args>
+using message_format_t = MessageFormat<std::type_identity_t<Args>...>;
 
 } // namespace storm
 
@@ -69,16 +156,16 @@ class MESSAGE final
     void Reset(const std::string_view &format);
 
     template<typename... Args>
-    void Reset(const std::string_view &format, Args... args)
+    void Reset(storm::message_format_t<Args...> format, Args... args)
     {
-        Assert(format.size() == sizeof...(args));
-        index = 0;
-        format_ = format;
-        params_ = {storm::detail::convertMessageParam(args)...};
+        Assert(format.Get().size() == sizeof...(args));
+        Reset(format.Get());
+        size_t n = 0;
+        ((GetParam(n) = storm::detail::convertMessageParam(format_[n], args), n++), ...);
     }
 
     void ResetVA(const std::string_view &format, va_list &args);
-    char GetCurrentFormatType();;
+    char GetCurrentFormatType();
     const char *StringPointer();
 
     [[nodiscard]] std::string_view GetFormat() const;
@@ -87,7 +174,13 @@ class MESSAGE final
 private:
     static storm::MessageParam GetParamValue(const char c, va_list &args);
 
+    storm::MessageParam &GetParam(size_t n);
+
+    // messages rarely carry more params than this, they are stored without heap allocation
+    static constexpr size_t kInlineParams = 10;
+
     std::string format_;
-    std::vector<storm::MessageParam> params_;
+    std::array<storm::MessageParam, kInlineParams> inlineParams_;
+    std::vector<storm::MessageParam> extraParams_;
     int32_t index{};
 };
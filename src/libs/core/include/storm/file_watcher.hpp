@@ -0,0 +1,91 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace storm
+{
+
+// Watches files on a background thread and collects their changes until Dispatch is called.
+// On Linux the directories of the files are watched with inotify, files of directories that can't be
+// watched and files on other platforms are polled by their write time and size.
+class FileWatcher
+{
+  public:
+    using Callback = std::function<void()>;
+
+    explicit FileWatcher(std::chrono::milliseconds pollInterval = std::chrono::milliseconds(500),
+                         bool useNative = true);
+    FileWatcher(const FileWatcher &) = delete;
+    FileWatcher &operator=(const FileWatcher &) = delete;
+    ~FileWatcher();
+
+    // Call callback from Dispatch when the file is changed, created or removed, the id is never 0
+    uint32_t Watch(const std::filesystem::path &path, Callback callback);
+    void Unwatch(uint32_t id);
+
+    // Call the callbacks of the files changed since the previous call on the calling thread,
+    // returns the number of calls. Cheap when nothing is changed, so it can be called every frame
+    size_t Dispatch();
+
+    // Number of the watched files which are polled
+    [[nodiscard]] size_t GetPolledCount() const;
+
+  private:
+    struct File
+    {
+        std::filesystem::path path;
+        bool exists = false;
+        std::filesystem::file_time_type writeTime{};
+        uintmax_t size = 0;
+        int32_t directory = -1; // inotify watch of the directory, -1 if the file is polled
+        bool changed = false;
+        std::vector<uint32_t> watches;
+    };
+
+    struct Watcher
+    {
+        std::string file;
+        Callback callback;
+    };
+
+    struct Directory
+    {
+        std::string path;
+        uint32_t files = 0;
+    };
+
+    void Start();
+    void Work();
+    void ReadEvents();
+    void Poll();
+    void MarkChanged(File &file);
+    static bool Stat(File &file);
+
+    const std::chrono::milliseconds pollInterval_;
+    const bool useNative_;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, File> files_;
+    std::unordered_map<uint32_t, Watcher> watchers_;
+    std::unordered_map<int32_t, Directory> directories_;
+    uint32_t nextId_ = 1;
+    std::atomic<bool> pending_{};
+
+    std::thread worker_;
+    std::condition_variable wakeup_;
+    bool stop_ = false;
+    int inotify_ = -1;
+    int wake_ = -1;
+};
+
+} // namespace storm
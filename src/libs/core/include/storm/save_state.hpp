@@ -0,0 +1,157 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ATTRIBUTES;
+
+namespace storm::save_state
+{
+
+// Framed container of the compiler state, written after EXTDATA_HEADER instead of the legacy
+// [raw size][packed size][zlib stream]. Chunks are independent zlib streams, so they are packed
+// and can be unpacked in parallel:
+// [Header][packed size 0][chunk 0][packed size 1][chunk 1]...
+// The magic is above any legacy raw size, so both layouts are told apart by the first dword.
+constexpr uint32_t kMagic = 0x32535453; // "STS2"
+constexpr uint32_t kVersion = 1;
+constexpr uint32_t kLegacyMaxSize = 0x8000000;
+constexpr uint32_t kMaxSize = 0x40000000;
+constexpr uint32_t kDefaultChunkSize = 1024 * 1024;
+
+struct Header
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t raw_size;
+    uint32_t chunk_size;
+    uint32_t chunk_count;
+};
+
+struct Options
+{
+    int32_t level = 9; // zlib compression level, 0..9
+    uint32_t chunk_size = kDefaultChunkSize;
+    uint32_t threads = 0; // 0 - hardware concurrency
+};
+
+// Time spent in each phase of a save, milliseconds
+struct Timings
+{
+    double snapshot = 0.0; // serialization on the main thread
+    double compress = 0.0; // sum over chunks, the wall time is lower with several threads
+    double write = 0.0;
+    double total = 0.0; // from the end of the snapshot to the last written byte
+    uint32_t raw_size = 0;
+    uint32_t packed_size = 0;
+    uint32_t chunks = 0;
+};
+
+using Sink = std::function<bool(const void *data, size_t size)>;
+using Source = std::function<bool(void *data, size_t size)>;
+
+// Compress data chunk by chunk on worker threads and pass the container to sink in order
+bool Write(const char *data, uint32_t size, const Options &options, const Sink &sink, Timings &timings);
+
+// Reads the container on its own thread and unpacks it on worker threads while the loader goes through
+// the part already unpacked
+class Reader
+{
+  public:
+    Reader() = default;
+    Reader(const Reader &) = delete;
+    Reader &operator=(const Reader &) = delete;
+    ~Reader();
+
+    // Read the header, the first dword (the magic) was already consumed by the caller.
+    // The chunks are read from source after Start, it must stay usable until Stop()
+    bool Open(const Source &source);
+    [[nodiscard]] uint32_t GetSize() const;
+
+    // Start reading and unpacking into data of GetSize() bytes, it must stay alive until Stop()
+    void Start(char *data, uint32_t threads = 0);
+    // Wait until data[0, end) is unpacked, the waiting thread unpacks chunks too; false if one is broken
+    bool WaitFor(uint32_t end);
+    // Size of the unpacked beginning of data
+    [[nodiscard]] uint32_t GetReadySize() const;
+    // Let the threads finish their chunks and leave the rest, WaitFor can't be called after that
+    void Stop();
+
+    // milliseconds
+    [[nodiscard]] double GetReadTime() const;
+    [[nodiscard]] double GetUnpackTime() const;
+    [[nodiscard]] double GetWaitTime() const;
+
+  private:
+    enum class ChunkState : uint8_t
+    {
+        Pending,
+        Read,
+        Unpacked,
+        Broken,
+    };
+
+    void ReadChunks();
+    void Work();
+    bool UnpackNext();
+
+    Header header_{};
+    Source source_;
+    std::vector<std::vector<char>> packed_; // freed when unpacked
+    char *data_{};
+
+    std::vector<ChunkState> chunkState_;
+    std::atomic<uint32_t> nextChunk_{};
+    uint32_t readyChunks_{};
+    bool stopping_{};
+    std::mutex mutex_;
+    std::condition_variable changed_;
+    std::thread reading_;
+    std::vector<std::thread> workers_;
+
+    uint64_t readTime_{};                // microseconds
+    std::atomic<uint64_t> unpackTime_{}; // microseconds
+    uint64_t waitTime_{};
+};
+
+// Goes through the unpacked state the way COMPILER::LoadState does. It waits for the Reader only past the part
+// already unpacked, strings are used right from the load buffer.
+class StateReader
+{
+  public:
+    // reader is null when data is unpacked already
+    StateReader(const char *data, uint32_t size, Reader *reader);
+
+    // size bytes into data, a null data skips them; false past the end or on a broken chunk
+    bool Read(void *data, uint32_t size);
+    uint32_t ReadVDword();
+    // Points into the load buffer, null for an empty or a broken string
+    const char *ReadStringInPlace();
+
+    // Fill root with the name code, value and subtree written by COMPILER::SaveAttributesData
+    void ReadAttributes(ATTRIBUTES *root);
+    // Such a tree as a new child of parent
+    ATTRIBUTES *ReadAttributeClass(ATTRIBUTES *parent);
+
+    // a chunk the loader needed could not be read or unpacked
+    [[nodiscard]] bool IsBroken() const;
+    [[nodiscard]] uint32_t GetPosition() const;
+
+  private:
+    bool Reach(uint32_t end);
+
+    const char *data_;
+    uint32_t size_;
+    Reader *reader_;
+    uint32_t position_{};
+    uint32_t readySize_;
+    bool broken_{};
+};
+
+} // namespace storm::save_state
@@ -1,13 +1,51 @@
 #include "attributes.h"
 
+#include <atomic>
 #include <execution>
+#include <memory_resource>
+#include <mutex>
 
 #include "string_compare.hpp"
 
+namespace
+{
+// bumped when an attribute some AttributePath went through is destroyed, or any attribute is renamed or
+// reordered, invalidates AttributePath caches
+std::atomic<uint64_t> layout_epoch{1};
+
+void InvalidateAttributePaths()
+{
+    layout_epoch.fetch_add(1, std::memory_order_relaxed);
+}
+
+size_t HashNameCode(uint32_t name_code)
+{
+    // codes are (bucket << 16 | index), mix both halves before masking
+    name_code ^= name_code >> 16;
+    name_code *= 0x45d9f3bu;
+    name_code ^= name_code >> 16;
+    return name_code;
+}
+
+std::pmr::memory_resource &GetAttributesPool()
+{
+    // never destroyed, attributes owned by static objects may outlive it otherwise
+    static auto *pool = new std::pmr::synchronized_pool_resource(
+        std::pmr::pool_options{.max_blocks_per_chunk = 4096, .largest_required_pool_block = sizeof(ATTRIBUTES)});
+    return *pool;
+}
+
+// numeric values read as strings from several threads are formatted one at a time
+std::mutex value_format_mutex;
+} // namespace
+
 ATTRIBUTES::ATTRIBUTES(ATTRIBUTES &&other) noexcept
-    : stringCodec_(other.stringCodec_), nameCode_(other.stringCodec_.Convert("root")), value_(std::move(other.value_)),
-      attributes_(std::move(other.attributes_)), break_(other.break_)
+    : stringCodec_(other.stringCodec_), nameCode_(other.stringCodec_.Convert("root")), valueType_(other.valueType_),
+      valueFormatted_(other.valueFormatted_.load(std::memory_order_relaxed)), number_(other.number_),
+      value_(std::move(other.value_)), attributes_(std::move(other.attributes_)),
+      childIndex_(std::move(other.childIndex_)), break_(other.break_)
 {
+    AdoptChildren(other);
 }
 
 ATTRIBUTES & ATTRIBUTES::operator=(ATTRIBUTES &&other) noexcept
@@ -16,8 +54,13 @@ ATTRIBUTES & ATTRIBUTES::operator=(ATTRIBUTES &&other) noexcept
     // Do not update name code
     // nameCode_ = other.nameCode_;
     other.nameCode_ = 1337;
+    valueType_ = other.valueType_;
+    valueFormatted_.store(other.valueFormatted_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    number_ = other.number_;
     value_ = std::move(other.value_);
     attributes_ = std::move(other.attributes_);
+    childIndex_ = std::move(other.childIndex_);
+    AdoptChildren(other);
     // Do not update parent
     // parent_ = other.parent_;
     other.parent_ = (ATTRIBUTES*)0x1;
@@ -25,8 +68,20 @@ ATTRIBUTES & ATTRIBUTES::operator=(ATTRIBUTES &&other) noexcept
     return *this;
 }
 
+void ATTRIBUTES::AdoptChildren(const ATTRIBUTES &other)
+{
+    for (const auto &child : attributes_)
+        child->parent_ = this;
+    // paths cached through other now lead out of its tree
+    if (other.cachedByPath_.load(std::memory_order_relaxed))
+        InvalidateAttributePaths();
+}
+
 ATTRIBUTES::~ATTRIBUTES()
 {
+    // children replaced by move assignment or deleted with their parent end up here too
+    if (cachedByPath_.load(std::memory_order_relaxed))
+        InvalidateAttributePaths();
     if (break_)
         stringCodec_.VariableChanged();
 }
@@ -55,54 +110,133 @@ const char *ATTRIBUTES::GetThisName() const
 
 bool ATTRIBUTES::HasValue() const noexcept
 {
-    return value_.has_value();
+    return valueType_ != ValueType::String || value_.has_value();
 }
 
 const std::string & ATTRIBUTES::GetValue() const
 {
-    return *value_;
+    return *GetFormattedValue();
 }
 
 ATTRIBUTES::LegacyProxy ATTRIBUTES::GetThisAttr() const
 {
-    return value_;
+    return GetFormattedValue();
+
+}
 
+const std::optional<std::string> &ATTRIBUTES::GetFormattedValue() const
+{
+    if (valueFormatted_.load(std::memory_order_acquire))
+        return value_;
+
+    std::lock_guard lock(value_format_mutex);
+    if (!valueFormatted_.load(std::memory_order_relaxed))
+    {
+        char buffer[128];
+        switch (valueType_)
+        {
+        case ValueType::Integer:
+            value_ = std::to_string(number_.integer);
+            break;
+        case ValueType::Float:
+            sprintf_s(buffer, "%g", number_.real);
+            value_ = buffer;
+            break;
+        case ValueType::FixedFloat:
+            sprintf_s(buffer, "%.7f", number_.real);
+            value_ = buffer;
+            break;
+        default: ;
+        }
+        valueFormatted_.store(true, std::memory_order_release);
+    }
+    return value_;
 }
 
 void ATTRIBUTES::SetName(const std::string_view &new_name)
 {
-    nameCode_ = stringCodec_.Convert(new_name.data());
+    SetNameCode(stringCodec_.Convert(new_name.data()));
 }
 
 void ATTRIBUTES::SetValue(const char *new_value)
 {
     if (new_value == nullptr)
     {
-        value_.reset();
+        ResetValue();
     }
-    else {
-        value_ = new_value;
+    else
+    {
+        SetValue(std::string_view(new_value));
     }
+}
+
+void ATTRIBUTES::SetValue(const std::string_view &new_value)
+{
+    valueType_ = ValueType::String;
+    valueFormatted_.store(true, std::memory_order_relaxed);
+    value_ = new_value;
 
     if (break_)
         stringCodec_.VariableChanged();
 }
 
-void ATTRIBUTES::SetValue(const std::string_view &new_value)
+void ATTRIBUTES::ResetValue()
 {
-    value_ = new_value;
+    valueType_ = ValueType::String;
+    valueFormatted_.store(true, std::memory_order_relaxed);
+    value_.reset();
 
     if (break_)
         stringCodec_.VariableChanged();
 }
 
+void ATTRIBUTES::SetValueUseInteger(int64_t value)
+{
+    valueType_ = ValueType::Integer;
+    valueFormatted_.store(false, std::memory_order_relaxed);
+    number_.integer = value;
+
+    if (break_)
+        stringCodec_.VariableChanged();
+}
+
+void ATTRIBUTES::SetValueUseFloat(float value, bool fixed)
+{
+    valueType_ = fixed ? ValueType::FixedFloat : ValueType::Float;
+    valueFormatted_.store(false, std::memory_order_relaxed);
+    number_.real = value;
+
+    if (break_)
+        stringCodec_.VariableChanged();
+}
+
+std::optional<int64_t> ATTRIBUTES::GetIntegerValue() const noexcept
+{
+    if (valueType_ == ValueType::Integer)
+        return number_.integer;
+    return {};
+}
+
 size_t ATTRIBUTES::GetAttributesNum() const
 {
     return attributes_.size();
 }
 
+void ATTRIBUTES::ReserveAttributes(size_t count)
+{
+    attributes_.reserve(attributes_.size() + count);
+}
+
 ATTRIBUTES * ATTRIBUTES::GetAttributeClass(const std::string_view &name) const
 {
+    // string codec is case insensitive, so for big nodes one conversion replaces comparing every child name
+    if (!childIndex_.empty() && name.size() < 1024)
+    {
+        // a name the codec never saw can't be a child name, and looking it up must not grow the codec
+        const auto name_code = stringCodec_.Find(name.data(), static_cast<int32_t>(name.size()));
+        return name_code ? GetAttributeClassByCode(*name_code) : nullptr;
+    }
+
     for (const auto &attribute : attributes_)
         if (storm::iEquals(name, attribute->GetThisName()))
             return attribute.get();
@@ -135,7 +269,7 @@ const char *ATTRIBUTES::GetAttributeName(size_t n) const
 ATTRIBUTES::LegacyProxy ATTRIBUTES::GetAttribute(size_t n) const
 {
     if (n < attributes_.size()) {
-        return attributes_[n]->value_;
+        return attributes_[n]->GetFormattedValue();
     }
     else {
         return {};
@@ -145,18 +279,15 @@ ATTRIBUTES::LegacyProxy ATTRIBUTES::GetAttribute(size_t n) const
 
 ATTRIBUTES::LegacyProxy ATTRIBUTES::GetAttribute(const std::string_view &name) const
 {
-    for (const auto &attribute : attributes_)
-        if (storm::iEquals(name, attribute->GetThisName())) {
-            return attribute->value_;
-        }
+    if (const auto *attribute = GetAttributeClass(name)) {
+        return attribute->GetFormattedValue();
+    }
     return {};
 }
 
 bool ATTRIBUTES::HasAttribute(const std::string_view &name) const
 {
-    return std::any_of(begin(attributes_), end(attributes_), [&name] (const auto &attribute) -> bool {
-        return storm::iEquals(name, attribute->GetThisName());
-    });
+    return GetAttributeClass(name) != nullptr;
 }
 
 uint32_t ATTRIBUTES::GetAttributeAsDword(const char *name, uint32_t def) const
@@ -164,13 +295,16 @@ uint32_t ATTRIBUTES::GetAttributeAsDword(const char *name, uint32_t def) const
     uint32_t vDword = def;
     if (name)
     {
-        const char *pAttribute = GetAttribute(name);
-        if (pAttribute)
-            vDword = atol(pAttribute);
+        if (const auto *attribute = GetAttributeClass(name); attribute && attribute->HasValue())
+            vDword = attribute->GetAttributeAsDword();
+    }
+    else if (valueType_ == ValueType::Integer)
+    {
+        vDword = static_cast<uint32_t>(number_.integer);
     }
     else
     {
-        vDword = atol( value_->c_str());
+        vDword = atol(GetFormattedValue()->c_str());
     }
     return vDword;
 }
@@ -180,13 +314,16 @@ uintptr_t ATTRIBUTES::GetAttributeAsPointer(const char *name, uintptr_t def) con
     uintptr_t ptr = def;
     if (name)
     {
-        const char *pAttribute = GetAttribute(name);
-        if (pAttribute)
-            ptr = atoll(pAttribute);
+        if (const auto *attribute = GetAttributeClass(name); attribute && attribute->HasValue())
+            ptr = attribute->GetAttributeAsPointer();
+    }
+    else if (valueType_ == ValueType::Integer)
+    {
+        ptr = static_cast<uintptr_t>(number_.integer);
     }
     else
     {
-        ptr = atoll(value_->c_str());
+        ptr = atoll(GetFormattedValue()->c_str());
     }
     return ptr;
 }
@@ -196,8 +333,17 @@ float ATTRIBUTES::GetAttributeAsFloat(const char *name, float def) const
     float vFloat = def;
     if (name)
     {
-        if (const char *pAttribute = GetAttribute(name))
-            vFloat = static_cast<float>(atof(pAttribute));
+        if (const auto *attribute = GetAttributeClass(name); attribute && attribute->HasValue())
+            vFloat = attribute->GetAttributeAsFloat();
+    }
+    else if (valueType_ == ValueType::Integer)
+    {
+        vFloat = static_cast<float>(static_cast<double>(number_.integer));
+    }
+    else if (valueType_ != ValueType::String)
+    {
+        // the stored float, not the one parsed back from its rounded text
+        vFloat = number_.real;
     }
     else
     {
@@ -208,41 +354,45 @@ float ATTRIBUTES::GetAttributeAsFloat(const char *name, float def) const
 
 bool ATTRIBUTES::SetAttributeUseDword(const char *name, uint32_t val)
 {
-    std::string buffer;
-    buffer = std::to_string(val);
     if (name)
-        return SetAttribute(name, buffer) != 0;
-    SetValue(buffer);
+    {
+        auto *attribute = GetOrCreateChild(stringCodec_.Convert(name));
+        attribute->SetValueUseInteger(val);
+        // position of the attribute, as SetAttribute returns it
+        return attribute != attributes_.front().get();
+    }
+    SetValueUseInteger(val);
     return true;
 }
 
 bool ATTRIBUTES::SetAttributeUseFloat(const char *name, float val)
 {
-    char buffer[128];
-    sprintf_s(buffer, "%g", val);
     if (name)
-        return SetAttribute(name, buffer) != 0;
-    SetValue(buffer);
+    {
+        auto *attribute = GetOrCreateChild(stringCodec_.Convert(name));
+        attribute->SetValueUseFloat(val);
+        return attribute != attributes_.front().get();
+    }
+    SetValueUseFloat(val);
 
     return true;
 }
 
 ATTRIBUTES & ATTRIBUTES::CreateAttribute(const std::string_view &name)
 {
-    const auto &attr = attributes_.emplace_back(new ATTRIBUTES(stringCodec_, this, name));
-    return *attr;
+    return *CreateNewAttribute(stringCodec_.Convert(name.data()));
 }
 
 ATTRIBUTES * ATTRIBUTES::CreateAttribute(const std::string_view &name, const char *attribute)
 {
-    const auto &attr = attributes_.emplace_back(new ATTRIBUTES(stringCodec_, this, name));
+    auto *attr = CreateNewAttribute(stringCodec_.Convert(name.data()));
 
     if (attribute)
     {
-        attr->value_ = attribute;
+        attr->SetValue(std::string_view(attribute));
     }
 
-    return attr.get();
+    return attr;
 }
 
 size_t ATTRIBUTES::SetAttribute(const std::string_view &name, const char *attribute)
@@ -262,6 +412,7 @@ bool ATTRIBUTES::DeleteAttributeClassX(ATTRIBUTES *pA)
     if (pA == this)
     {
         attributes_.clear();
+        RebuildChildIndex();
     }
     else
     {
@@ -273,6 +424,7 @@ bool ATTRIBUTES::DeleteAttributeClassX(ATTRIBUTES *pA)
             if (it != attributes_.end() )
             {
                 attributes_.erase(it);
+                RebuildChildIndex();
                 return true;
             }
             if (attributes_[n]->DeleteAttributeClassX(pA))
@@ -349,10 +501,8 @@ ATTRIBUTES * ATTRIBUTES::FindAClass(ATTRIBUTES *pRoot, const char *access_string
 
 ATTRIBUTES * ATTRIBUTES::GetAttributeClassByCode(uint32_t name_code) const
 {
-    for (const auto &attribute : attributes_)
-        if (name_code == attribute->nameCode_)
-            return attribute.get();
-    return nullptr;
+    const size_t n = FindChildPosition(name_code);
+    return n < attributes_.size() ? attributes_[n].get() : nullptr;
 }
 
 ATTRIBUTES * ATTRIBUTES::VerifyAttributeClassByCode(uint32_t name_code)
@@ -365,65 +515,43 @@ ATTRIBUTES * ATTRIBUTES::VerifyAttributeClassByCode(uint32_t name_code)
 
 ATTRIBUTES * ATTRIBUTES::CreateAttribute(uint32_t name_code, const char *attribute)
 {
-    const auto &attr = attributes_.emplace_back(new ATTRIBUTES(stringCodec_, this, name_code));
+    auto *attr = CreateNewAttribute(name_code);
 
     if (attribute)
     {
-        attr->value_ = attribute;
+        attr->SetValue(std::string_view(attribute));
     }
 
-    return attr.get();
+    return attr;
 }
 
 size_t ATTRIBUTES::SetAttribute(uint32_t name_code, const char *attribute)
 {
-    size_t n;
-    for (n = 0; n < attributes_.size(); n++)
+    size_t n = FindChildPosition(name_code);
+    if (n == attributes_.size())
     {
-        if (attributes_[n]->nameCode_ == name_code)
-        {
-            if (attribute)
-            {
-                attributes_[n]->value_ = attribute;
-            }
-            else
-            {
-                attributes_[n]->value_.reset();
-            }
-            return n;
-        }
+        CreateNewAttribute(name_code);
     }
 
-    auto &attr = attributes_.emplace_back(new ATTRIBUTES(stringCodec_, this, name_code));
-
     if (attribute)
-    {
-        attributes_[n]->value_ = attribute;
-    }
-    else {
-        attributes_[n]->value_.reset();
-    }
+        attributes_[n]->SetValue(std::string_view(attribute));
+    else
+        attributes_[n]->ResetValue();
 
-    return attributes_.size() - 1;
+    return n;
 }
 
 size_t ATTRIBUTES::SetAttribute(uint32_t name_code, const std::string_view &attribute)
 {
-    size_t n;
-    for (n = 0; n < attributes_.size(); n++)
+    size_t n = FindChildPosition(name_code);
+    if (n == attributes_.size())
     {
-        if (attributes_[n]->nameCode_ == name_code)
-        {
-            attributes_[n]->value_ = attribute;
-            return n;
-        }
+        CreateNewAttribute(name_code);
     }
 
-    auto &attr = attributes_.emplace_back(new ATTRIBUTES(stringCodec_, this, name_code));
-
-    attributes_[n]->value_ = attribute;
+    attributes_[n]->SetValue(attribute);
 
-    return attributes_.size() - 1;
+    return n;
 }
 
 uint32_t ATTRIBUTES::GetThisNameCode() const noexcept
@@ -431,9 +559,14 @@ uint32_t ATTRIBUTES::GetThisNameCode() const noexcept
     return nameCode_;
 }
 
-void ATTRIBUTES::SetNameCode(uint32_t n) noexcept
+void ATTRIBUTES::SetNameCode(uint32_t n)
 {
     nameCode_ = n;
+    InvalidateAttributePaths();
+    if (parent_ && !parent_->childIndex_.empty())
+    {
+        parent_->RebuildChildIndex();
+    }
 }
 
 VSTRING_CODEC & ATTRIBUTES::GetStringCodec() const noexcept
@@ -445,14 +578,91 @@ void ATTRIBUTES::Sort(
     const std::function<bool(const std::unique_ptr<ATTRIBUTES> &, const std::unique_ptr<ATTRIBUTES> &)>& pred)
 {
     std::sort(std::execution::seq, std::begin(attributes_), std::end(attributes_), pred);
+    RebuildChildIndex();
+    InvalidateAttributePaths();
+}
+
+ATTRIBUTES *ATTRIBUTES::GetOrCreateChild(uint32_t name_code)
+{
+    const size_t n = FindChildPosition(name_code);
+    return n < attributes_.size() ? attributes_[n].get() : CreateNewAttribute(name_code);
 }
 
 ATTRIBUTES * ATTRIBUTES::CreateNewAttribute(uint32_t name_code)
 {
     const std::unique_ptr<ATTRIBUTES> &attr = attributes_.emplace_back(new ATTRIBUTES(stringCodec_, this, name_code));
+
+    if (childIndex_.empty() ? attributes_.size() >= kChildIndexThreshold
+                            : attributes_.size() * 2 > childIndex_.size())
+    {
+        RebuildChildIndex();
+    }
+    else if (!childIndex_.empty())
+    {
+        InsertChildIndex(attributes_.size() - 1);
+    }
+
     return attr.get();
 }
 
+size_t ATTRIBUTES::FindChildPosition(uint32_t name_code) const
+{
+    if (childIndex_.empty())
+    {
+        for (size_t n = 0; n < attributes_.size(); n++)
+            if (attributes_[n]->nameCode_ == name_code)
+                return n;
+        return attributes_.size();
+    }
+
+    const size_t mask = childIndex_.size() - 1;
+    for (size_t slot = HashNameCode(name_code) & mask;; slot = (slot + 1) & mask)
+    {
+        const uint32_t entry = childIndex_[slot];
+        if (entry == 0)
+            return attributes_.size();
+        if (attributes_[entry - 1]->nameCode_ == name_code)
+            return entry - 1;
+    }
+}
+
+void ATTRIBUTES::InsertChildIndex(size_t position)
+{
+    const uint32_t name_code = attributes_[position]->nameCode_;
+    const size_t mask = childIndex_.size() - 1;
+    for (size_t slot = HashNameCode(name_code) & mask;; slot = (slot + 1) & mask)
+    {
+        uint32_t &entry = childIndex_[slot];
+        if (entry == 0)
+        {
+            entry = static_cast<uint32_t>(position + 1);
+            return;
+        }
+        // keep the first child with this name, same as the linear lookup does
+        if (attributes_[entry - 1]->nameCode_ == name_code)
+            return;
+    }
+}
+
+void ATTRIBUTES::RebuildChildIndex()
+{
+    childIndex_.clear();
+    if (attributes_.size() < kChildIndexThreshold)
+    {
+        childIndex_.shrink_to_fit();
+        return;
+    }
+
+    // keep load factor under 0.5
+    size_t capacity = kChildIndexThreshold * 2;
+    while (capacity < attributes_.size() * 4)
+        capacity *= 2;
+    childIndex_.resize(capacity);
+
+    for (size_t n = 0; n < attributes_.size(); n++)
+        InsertChildIndex(n);
+}
+
 ATTRIBUTES::ATTRIBUTES(VSTRING_CODEC &p) : ATTRIBUTES(p, nullptr, "root")
 {
 }
@@ -470,15 +680,63 @@ ATTRIBUTES::ATTRIBUTES(VSTRING_CODEC &string_codec, ATTRIBUTES *parent, const ui
 ATTRIBUTES ATTRIBUTES::Copy() const
 {
     ATTRIBUTES result(stringCodec_, nullptr, nameCode_);
-    result.value_ = value_;
+    result.CopyValue(*this);
+    result.CopyChildren(*this);
+    return result;
+}
+
+void ATTRIBUTES::CopyChildren(const ATTRIBUTES &source)
+{
+    // children keep their positions, so the name index can be copied as is
+    attributes_.reserve(source.attributes_.size());
+    for (const auto &attribute : source.attributes_)
+    {
+        const auto &new_child = attributes_.emplace_back(new ATTRIBUTES(stringCodec_, this, attribute->nameCode_));
+        new_child->CopyValue(*attribute);
+        new_child->CopyChildren(*attribute);
+    }
+    childIndex_ = source.childIndex_;
+}
+
+void ATTRIBUTES::CopyValue(const ATTRIBUTES &source)
+{
+    valueType_ = source.valueType_;
+    number_ = source.number_;
+    // a value formatted meanwhile by another thread is formatted again on the copy
+    const bool formatted = source.valueFormatted_.load(std::memory_order_acquire);
+    valueFormatted_.store(formatted, std::memory_order_relaxed);
+    if (formatted)
+        value_ = source.value_;
+}
+
+ATTRIBUTES::MemoryUsage ATTRIBUTES::GetMemoryUsage() const
+{
+    MemoryUsage usage{1, sizeof(ATTRIBUTES)};
+    if (value_ && value_->capacity() > std::string{}.capacity())
+    {
+        // only count strings that spilled out of the small string buffer
+        usage.bytes += value_->capacity() + 1;
+    }
+    usage.bytes += attributes_.capacity() * sizeof(decltype(attributes_)::value_type);
+    usage.bytes += childIndex_.capacity() * sizeof(decltype(childIndex_)::value_type);
 
     for (const auto &attribute : attributes_)
     {
-        auto &new_child = result.CreateAttribute(attribute->GetThisName());
-        new_child = attribute->Copy();
+        const MemoryUsage child_usage = attribute->GetMemoryUsage();
+        usage.nodes += child_usage.nodes;
+        usage.bytes += child_usage.bytes;
     }
+    return usage;
+}
 
-    return result;
+void *ATTRIBUTES::operator new(size_t size)
+{
+    return GetAttributesPool().allocate(size, alignof(ATTRIBUTES));
+}
+
+void ATTRIBUTES::operator delete(void *ptr, size_t size)
+{
+    GetAttributesPool().deallocate(ptr, size, alignof(ATTRIBUTES));
 }
 
 // MatchAttributePath("equipment.*.locator", attribute)
@@ -503,3 +761,91 @@ bool MatchAttributePath(const std::string_view &pattern, const ATTRIBUTES &attri
     }
     return current_attribute != nullptr && current_attribute->GetParent() == nullptr;
 }
+
+AttributePath::AttributePath(const std::string_view &path) : path_(path)
+{
+}
+
+const std::string &AttributePath::GetPath() const noexcept
+{
+    return path_;
+}
+
+void AttributePath::ResolveNameCodes(VSTRING_CODEC &string_codec) const
+{
+    stringCodec_ = &string_codec;
+    nameCodes_.clear();
+    cachedResult_ = nullptr;
+
+    if (path_.empty())
+        return;
+
+    size_t start = 0;
+    while (true)
+    {
+        const size_t end = path_.find('.', start);
+        const std::string name = path_.substr(start, end == std::string::npos ? std::string::npos : end - start);
+        nameCodes_.push_back(string_codec.Convert(name.c_str()));
+        if (end == std::string::npos)
+            break;
+        start = end + 1;
+    }
+}
+
+void AttributePath::MarkCached(const ATTRIBUTES *root) const
+{
+    const ATTRIBUTES *attribute = root;
+    attribute->cachedByPath_.store(true, std::memory_order_relaxed);
+    for (const uint32_t name_code : nameCodes_)
+    {
+        attribute = attribute->GetAttributeClassByCode(name_code);
+        attribute->cachedByPath_.store(true, std::memory_order_relaxed);
+    }
+}
+
+ATTRIBUTES *AttributePath::Find(ATTRIBUTES *root) const
+{
+    if (root == nullptr)
+        return nullptr;
+
+    const uint64_t epoch = layout_epoch.load(std::memory_order_relaxed);
+    if (cachedResult_ && cachedRoot_ == root && cachedEpoch_ == epoch)
+        return cachedResult_;
+
+    if (stringCodec_ != &root->GetStringCodec())
+        ResolveNameCodes(root->GetStringCodec());
+
+    ATTRIBUTES *attribute = root;
+    for (const uint32_t name_code : nameCodes_)
+    {
+        attribute = attribute->GetAttributeClassByCode(name_code);
+        if (attribute == nullptr)
+            return nullptr;
+    }
+
+    MarkCached(root);
+    cachedRoot_ = root;
+    cachedResult_ = attribute;
+    cachedEpoch_ = epoch;
+    return attribute;
+}
+
+ATTRIBUTES *AttributePath::Create(ATTRIBUTES *root) const
+{
+    if (root == nullptr)
+        return nullptr;
+
+    if (ATTRIBUTES *attribute = Find(root))
+        return attribute;
+
+    ATTRIBUTES *attribute = root;
+    for (const uint32_t name_code : nameCodes_)
+        attribute = attribute->VerifyAttributeClassByCode(name_code);
+
+    // creation doesn't change the layout epoch, result is valid for later Find calls
+    MarkCached(root);
+    cachedRoot_ = root;
+    cachedResult_ = attribute;
+    cachedEpoch_ = layout_epoch.load(std::memory_order_relaxed);
+    return attribute;
+}
@@ -1,7 +1,9 @@
 #include "compiler.h"
 
+#include <algorithm>
 #include <chrono>
 #include <cstdio>
+#include <vector>
 
 #include <zlib.h>
 
@@ -14,6 +16,7 @@
 #include "fs.h"
 #include "logging.hpp"
 #include "script_cache.h"
+#include "stage_profiler.hpp"
 #include "storm/engine_settings.hpp"
 #include "storm_assert.h"
 
@@ -89,6 +92,34 @@ void WipeCache(const uint64_t fingerprint)
     }
 }
 
+// Append packed ext data to a state file and point its header at it
+bool AppendSaveData(const char *file_name, EXTDATA_HEADER exdh, const std::vector<char> &packed)
+{
+    auto fileS = fio->_CreateFile(file_name, std::ios::binary | std::ios::in | std::ios::out);
+    if (!fileS.is_open())
+    {
+        return false;
+    }
+
+    try
+    {
+        exdh.dwExtDataOffset = static_cast<uint32_t>(fio->_GetFileSize(file_name));
+        fio->_WriteFile(fileS, &exdh, sizeof(exdh));
+        fio->_SetFilePointer(fileS, exdh.dwExtDataOffset, std::ios::beg);
+
+        const uint32_t uiPackLen = static_cast<uint32_t>(packed.size());
+        fio->_WriteFile(fileS, &uiPackLen, sizeof(uiPackLen));
+        fio->_WriteFile(fileS, packed.data(), uiPackLen);
+        fio->_CloseFile(fileS);
+    }
+    catch (const std::fstream::failure &e)
+    {
+        spdlog::error("Failed to write save data to {}: {}", file_name, e.what());
+        return false;
+    }
+    return true;
+}
+
 } // namespace
 
 // extern char * FuncNameTable[];
@@ -109,7 +140,8 @@ COMPILER::COMPILER()
       nRuntimeLogEventsBufferSize(0), nRuntimeLogEventsNum(0), nRuntimeTicks(0), bFirstRun(true), bWriteCodeFile(false),
       bDebugInfo(false), DebugSourceLine(0), pCompileTokenTempBuffer(nullptr), bDebugExpressionRun(false),
       bTraceMode(true), nDebugTraceLineCode(0), nIOBufferSize(0), pIOBuffer(nullptr), rAP(nullptr),
-      script_cache_mode_(kCacheDisabled)
+      script_cache_mode_(kCacheDisabled), save_compression_level_(Z_BEST_COMPRESSION), save_result_(true),
+      state_reader_(nullptr)
 
 {
     LabelTable.SetStringDataSize(sizeof(uint32_t));
@@ -144,6 +176,7 @@ COMPILER::COMPILER()
 
 COMPILER::~COMPILER()
 {
+    WaitStateSaving();
     Release();
 }
 
@@ -460,12 +493,17 @@ void COMPILER::LoadPreprocess()
         else
             bRuntimeLog = true;
 
+        scriptProfiler_.SetEnabled(engine_ini->GetInt("script", "profiler", 0) != 0);
+
         script_cache_mode_ = engine_ini->GetInt("script", "cache_mode", kCacheDisabled);
         if (script_cache_mode_ < kCacheDisabled || script_cache_mode_ > kCacheEnabledNoRuntimeCheck)
         {
             script_cache_mode_ = kCacheDisabled;
         }
 
+        save_compression_level_ = std::clamp(
+            engine_ini->GetInt("script", "save_compression", Z_BEST_COMPRESSION), Z_NO_COMPRESSION, Z_BEST_COMPRESSION);
+
         // if(engine_ini->GetInt("script","tracefiles",0) == 0) bScriptTrace = false;
         // else bScriptTrace = true;
     }
@@ -677,17 +715,40 @@ void COMPILER::DelEventHandler(const char *event_name, const char *func_name)
 
 VDATA *COMPILER::ProcessEvent(const char *event_name)
 {
+    if (event_name == nullptr)
+    {
+        SetError("Invalid event name in ProcessEvent");
+        return nullptr;
+    }
+
+    const uint32_t event_code = EventTab.FindEvent(event_name);
+    if (event_code == INVALID_EVENT_CODE)
+        return nullptr; // no handlers
+
+    return ProcessEventByCode(event_code);
+}
+
+uint32_t COMPILER::RegisterEvent(const char *event_name)
+{
+    return EventTab.RegisterEvent(event_name);
+}
+
+VDATA *COMPILER::ProcessEventByCode(uint32_t event_code)
+{
+    const EVENTINFO *event = EventTab.GetEventInfo(event_code);
+    if (event == nullptr || event->elements == 0)
+        return nullptr; // no handlers
+    const char *event_name = event->name.c_str();
+
     // TODO: only do if stack debug if enabled (should be runtime configurable)
     // push event name to call stack
     storm::ringbuffer_stack_push_guard push_guard(callStack_);
     push_guard.push(std::make_tuple("", 0U, event_name));
 
-    uint32_t event_code;
     uint32_t func_code;
     VDATA *pVD;
     DATA *pResult;
     MESSAGE *pMem;
-    EVENTINFO ei;
 #ifdef _WIN32 // S_DEBUG
     uint32_t current_debug_mode;
 #endif
@@ -704,20 +765,18 @@ VDATA *COMPILER::ProcessEvent(const char *event_name)
 #endif
 
     pVD = nullptr;
-    if (event_name == nullptr)
-    {
-        SetError("Invalid event name in ProcessEvent");
-        return nullptr;
-    }
 
-    event_code = EventTab.FindEvent(event_name);
-    if (event_code == INVALID_EVENT_CODE)
-        return nullptr; // no handlers
-    EventTab.GetEvent(ei, event_code);
-    for (uint32_t n = 0; n < ei.elements; n++)
+    // time of nested events is included into the outer one
+    const storm::diag::StageProfiler::Scope profile_scope(storm::diag::getStageProfiler(),
+                                                          storm::diag::StageProfiler::Category::script_event, event_code,
+                                                          [event_name] { return std::string(event_name); });
+    const ScriptProfiler::Scope script_profile_scope(scriptProfiler_, event_name);
+
+    // handlers are read in place, the list may change while handlers run
+    for (uint32_t n = 0; n < event->elements; n++)
     {
-        func_code = ei.pFuncInfo[n].func_code;
-        if (ei.pFuncInfo[n].status != FSTATUS_NORMAL)
+        func_code = event->pFuncInfo[n].func_code;
+        if (event->pFuncInfo[n].status != FSTATUS_NORMAL)
             continue;
         pMem = pEventMessage;
         if (pMem)
@@ -727,27 +786,19 @@ VDATA *COMPILER::ProcessEvent(const char *event_name)
 
         const uint32_t nStackVars = SStack.GetDataNum(); // remember stack elements num
         RDTSC_B(nTicks);
-        BC_Execute(ei.pFuncInfo[n].func_code, pResult);
-        RDTSC_E(nTicks);
-
-        FuncInfo fi;
-        // if(FuncTab.GetFuncX(fi,ei.pFuncInfo[n].func_code))
-        if (FuncTab.GetFuncX(fi, func_code))
         {
-            if (fi.return_type != TVOID)
-            {
-                fi.return_type = TVOID;
-            }
-        } //*/
+            const FuncInfo *handler_fi = scriptProfiler_.IsEnabled() ? FuncTab.GetFuncInfo(func_code) : nullptr;
+            const ScriptProfiler::Scope handler_profile_scope(
+                scriptProfiler_, handler_fi ? std::string_view(handler_fi->name) : std::string_view("?"));
+            BC_Execute(func_code, pResult);
+        }
+        RDTSC_E(nTicks);
 
-        if (EventTab.GetEvent(ei, event_code)) // to be sure event still exist
+        if (n < event->elements)
         {
-            if (n < ei.elements)
+            if (!FuncTab.AddTime(event->pFuncInfo[n].func_code, nTicks))
             {
-                if (!FuncTab.AddTime(ei.pFuncInfo[n].func_code, nTicks))
-                {
-                    core_internal.Trace("Invalid func_code = %u for AddTime", ei.pFuncInfo[n].func_code);
-                }
+                core_internal.Trace("Invalid func_code = %u for AddTime", event->pFuncInfo[n].func_code);
             }
         }
 
@@ -799,7 +850,7 @@ void COMPILER::ProcessEvent(const char *event_name, MESSAGE *pMs)
     pEventMessage = nullptr;
 }
 
-VDATA *COMPILER::ProcessEvent(const char *event_name, MESSAGE message)
+VDATA *COMPILER::ProcessEvent(const char *event_name, MESSAGE &message)
 {
     pEventMessage = &message;
     VDATA *pVD = ProcessEvent(event_name);
@@ -807,6 +858,14 @@ VDATA *COMPILER::ProcessEvent(const char *event_name, MESSAGE message)
     return pVD;
 }
 
+VDATA *COMPILER::ProcessEventByCode(uint32_t event_code, MESSAGE &message)
+{
+    pEventMessage = &message;
+    VDATA *pVD = ProcessEventByCode(event_code);
+    pEventMessage = nullptr;
+    return pVD;
+}
+
 uint32_t COMPILER::GetSegmentIndex(uint32_t segment_id)
 {
     for (uint32_t n = 0; n < SegmentsNum; n++)
@@ -1023,7 +1082,7 @@ bool COMPILER::ProcessDebugExpression0(const char *pExpression, DATA &Result)
 
     if (pRun_fi)
     {
-        CurrentFuncCode = FuncTab.FindFunc(pRun_fi->name);
+        CurrentFuncCode = pRun_fi->func_code;
     }
 
     try
@@ -1047,7 +1106,7 @@ bool COMPILER::ProcessDebugExpression0(const char *pExpression, DATA &Result)
     // save current pointers values
     const uint32_t mem_InstructionPointer = InstructionPointer;
     // mem_ip = ip;
-    FuncInfo *mem_pfi = pRun_fi;
+    FuncFrame *mem_pfi = pRun_fi;
     const char *mem_codebase = pRunCodeBase;
     // mem_CurrentFuncCode = CurrentFuncCode;
 
@@ -1115,6 +1174,13 @@ void COMPILER::ProcessFrame(uint32_t DeltaTime)
         n = 0;
     }
 
+    // the save written in the background replaces its file as soon as it is done, scripts hear about a failure
+    if (save_task_.valid() && save_task_.wait_for(std::chrono::seconds(0)) == std::future_status::ready &&
+        !WaitStateSaving())
+    {
+        core.Event("SaveStateFailed", "s", save_file_name_.c_str());
+    }
+
     EventTab.ProcessFrame();
 
     for (int32_t ln = 0; ln < static_cast<int32_t>(EventMsg.GetClassesNum()); ln++)
@@ -3645,10 +3711,10 @@ S_TOKEN_TYPE COMPILER::NextTokenType()
 
 bool COMPILER::BC_CallFunction(uint32_t func_code, uint32_t &ip, DATA *&pVResult)
 {
-    FuncInfo call_fi;
+    const FuncInfo *call_fi;
     uint32_t mem_ip;
     uint32_t mem_InstructionPointer;
-    FuncInfo *mem_pfi;
+    FuncFrame *mem_pfi;
     //    DATA * pV;
     const char *mem_codebase;
     uint32_t arguments;
@@ -3660,7 +3726,8 @@ bool COMPILER::BC_CallFunction(uint32_t func_code, uint32_t &ip, DATA *&pVResult
     CompilerStage = CS_RUNTIME;
 
     // get func info
-    if (!FuncTab.GetFunc(call_fi, func_code))
+    call_fi = FuncTab.GetFuncInfo(func_code);
+    if (call_fi == nullptr)
     {
         SetError("Invalid function call");
         return false;
@@ -3669,7 +3736,8 @@ bool COMPILER::BC_CallFunction(uint32_t func_code, uint32_t &ip, DATA *&pVResult
     // TODO: only do if stack debug if enabled (should be runtime configurable)
     // push function details to call stack
     storm::ringbuffer_stack_push_guard push_guard(callStack_);
-    push_guard.push(std::make_tuple(call_fi.decl_file_name.c_str(), call_fi.decl_line, call_fi.name.c_str()));
+    push_guard.push(std::make_tuple(call_fi->decl_file_name.c_str(), call_fi->decl_line, call_fi->name.c_str()));
+    const ScriptProfiler::Scope profile_scope(scriptProfiler_, call_fi->name);
 
     // number f arguments pushed into stack for this function call
     if (BC_TokenGet() != ARGS_NUM)
@@ -3731,7 +3799,7 @@ bool COMPILER::BC_CallFunction(uint32_t func_code, uint32_t &ip, DATA *&pVResult
     nDebugEnterMode = CDebug->GetTraceMode();
 #endif
     uint64_t nTicks;
-    if (call_fi.segment_id == INTERNAL_SEGMENT_ID)
+    if (call_fi->segment_id == INTERNAL_SEGMENT_ID)
     {
         if (bRuntimeLog)
         {
@@ -3751,14 +3819,14 @@ bool COMPILER::BC_CallFunction(uint32_t func_code, uint32_t &ip, DATA *&pVResult
             core_internal.Trace("Invalid func_code = %u for AddTime", func_code);
         }
     }
-    else if (call_fi.segment_id == IMPORTED_SEGMENT_ID)
+    else if (call_fi->segment_id == IMPORTED_SEGMENT_ID)
     {
         pVResult = nullptr;
         RDTSC_B(nTicks);
-        const uint32_t nResult = call_fi.imported_func(&SStack);
+        const uint32_t nResult = call_fi->imported_func(&SStack);
         if (nResult == IFUNCRESULT_OK)
         {
-            if (call_fi.return_type != TVOID)
+            if (call_fi->return_type != TVOID)
             {
                 pVResult = SStack.Read();
             }
@@ -3791,7 +3859,7 @@ bool COMPILER::BC_CallFunction(uint32_t func_code, uint32_t &ip, DATA *&pVResult
     {
         if (check_sp != (SStack.GetDataNum() - 1))
         {
-            SetError("function '%s' stack error", call_fi.name.c_str());
+            SetError("function '%s' stack error", call_fi->name.c_str());
 
             pRun_fi = mem_pfi;
             InstructionPointer = mem_InstructionPointer;
@@ -3807,7 +3875,7 @@ bool COMPILER::BC_CallFunction(uint32_t func_code, uint32_t &ip, DATA *&pVResult
     {
         if (check_sp != SStack.GetDataNum())
         {
-            SetError("function '%s' stack error", call_fi.name.c_str());
+            SetError("function '%s' stack error", call_fi->name.c_str());
             pRun_fi = mem_pfi;
             InstructionPointer = mem_InstructionPointer;
             ip = mem_ip;
@@ -3844,7 +3912,8 @@ bool COMPILER::BC_Execute(uint32_t function_code, DATA *&pVReturnResult, const c
     uint32_t bLeftOperandType;
     int32_t nLeftOperandIndex;
     S_TOKEN_TYPE Token_type;
-    FuncInfo fi;
+    const FuncInfo *pfi;
+    FuncFrame frame;
     const VarInfo *real_var;
     DATA *pV;
     DATA *pVResult;
@@ -3886,34 +3955,31 @@ bool COMPILER::BC_Execute(uint32_t function_code, DATA *&pVReturnResult, const c
 
     if (pDbgExpSource == nullptr)
     {
-        if (!FuncTab.GetFunc(fi, function_code))
-        {
-            SetError("Invalid function: %s", fi.name.c_str());
-            return false;
-        }
-
-        if (fi.offset == INVALID_FUNC_OFFSET)
+        pfi = FuncTab.GetFuncInfo(function_code);
+        if (pfi == nullptr)
         {
+            FuncInfo fi;
+            FuncTab.GetFuncX(fi, function_code);
             SetError("Function (%s) isnt loaded", fi.name.c_str());
             return false;
         }
 
-        if (fi.segment_id == INTERNAL_SEGMENT_ID)
+        if (pfi->segment_id == INTERNAL_SEGMENT_ID)
         {
-            SetError("Function (%s) is internal", fi.name.c_str());
+            SetError("Function (%s) is internal", pfi->name.c_str());
             return false;
         }
 
-        if (fi.segment_id == IMPORTED_SEGMENT_ID)
+        if (pfi->segment_id == IMPORTED_SEGMENT_ID)
         {
-            SetError("Function (%s) is imported", fi.name.c_str());
+            SetError("Function (%s) is imported", pfi->name.c_str());
             return false;
         }
 
-        segment_index = GetSegmentIndex(fi.segment_id);
+        segment_index = GetSegmentIndex(pfi->segment_id);
         if (segment_index == INVALID_SEGMENT_INDEX)
         {
-            SetError("Function (%s) segment not loaded", fi.name.c_str());
+            SetError("Function (%s) segment not loaded", pfi->name.c_str());
             return false;
         }
         if (SegmentTable[segment_index].pCode == nullptr)
@@ -3925,16 +3991,16 @@ bool COMPILER::BC_Execute(uint32_t function_code, DATA *&pVReturnResult, const c
         // Trace("-----------------------------------------------------------------");
         // Trace("Execute function: %s",fi.name);
 
-        RunningSegmentID = fi.segment_id;
-        fi.stack_offset = SStack.GetDataNum() - fi.arguments; // set stack offset
+        RunningSegmentID = pfi->segment_id;
+        frame.stack_offset = SStack.GetDataNum() - pfi->arguments; // set stack offset
 
         // check arguments types
-        for (n = 0; n < fi.arguments; n++)
+        for (n = 0; n < pfi->arguments; n++)
         {
-            if (fi.local_vars[n].type == VAR_REFERENCE)
+            if (pfi->local_vars[n].type == VAR_REFERENCE)
                 continue;
-            pV = SStack.Read(fi.stack_offset, n);
-            if (pV->GetType() != fi.local_vars[n].type)
+            pV = SStack.Read(frame.stack_offset, n);
+            if (pV->GetType() != pfi->local_vars[n].type)
             {
                 pV = pV->GetVarPointer();
                 if (!pV)
@@ -3943,33 +4009,39 @@ bool COMPILER::BC_Execute(uint32_t function_code, DATA *&pVReturnResult, const c
                     return false;
                 }
 
-                if (fi.local_vars[n].type == VAR_AREFERENCE && pV->GetType() == VAR_OBJECT)
+                if (pfi->local_vars[n].type == VAR_AREFERENCE && pV->GetType() == VAR_OBJECT)
                     continue;
 
                 // TODO: remove and fix
-                if (false && pV->GetType() != fi.local_vars[n].type)
+                if (false && pV->GetType() != pfi->local_vars[n].type)
                 {
-                    SetWarning("wrong type of argument %d  %s(%s) <-- [%s]", n, fi.name.c_str(),
-                               Token.GetTypeName(fi.local_vars[n].type), Token.GetTypeName(pV->GetType()));
+                    SetWarning("wrong type of argument %d  %s(%s) <-- [%s]", n, pfi->name.c_str(),
+                               Token.GetTypeName(pfi->local_vars[n].type), Token.GetTypeName(pV->GetType()));
                 }
             }
         }
 
-        for (n = fi.arguments; n < fi.local_vars.size(); n++)
+        for (n = pfi->arguments; n < pfi->local_vars.size(); n++)
         {
             pV = SStack.Push();
-            pV->SetType(fi.local_vars[n].type, fi.local_vars[n].elements);
+            pV->SetType(pfi->local_vars[n].type, pfi->local_vars[n].elements);
         }
 
-        pRun_fi = &fi; // set pointer to 'this' function info
+        frame.func_code = function_code;
+        frame.segment_id = pfi->segment_id;
+        frame.return_type = pfi->return_type;
+        pRun_fi = &frame; // set pointer to 'this' function frame
 
-        InstructionPointer = fi.offset;
+        InstructionPointer = pfi->offset;
 
         pCodeBase = SegmentTable[segment_index].pCode;
         pRunCodeBase = pCodeBase;
     }
     else
     {
+        // debug expression has no function of its own, locals are read through pRun_fi of the debugged one
+        frame = {INVALID_FUNC_CODE, 0, 0, TVOID};
+
         InstructionPointer = 0;
         pCodeBase = pDbgExpSource;
         pRunCodeBase = pCodeBase;
@@ -4357,7 +4429,7 @@ bool COMPILER::BC_Execute(uint32_t function_code, DATA *&pVReturnResult, const c
                     ShowWindow(CDebug->GetWindowHandle(), SW_NORMAL);
 
                     CDebug->SetTraceLine(nDebugTraceLineCode);
-                    CDebug->BreakOn(fi.decl_file_name.c_str(), nDebugTraceLineCode);
+                    CDebug->BreakOn(FuncTab.GetFuncDeclFileName(frame.func_code).c_str(), nDebugTraceLineCode);
                     CDebug->SetTraceMode(TMODE_WAIT);
                     while (CDebug->GetTraceMode() == TMODE_WAIT)
                     {
@@ -4371,7 +4443,7 @@ bool COMPILER::BC_Execute(uint32_t function_code, DATA *&pVReturnResult, const c
                 else if (CDebug->Breaks.CanBreak())
                 {
                     // check for breakpoint
-                    if (CDebug->Breaks.Find(fi.decl_file_name.c_str(), nDebugTraceLineCode))
+                    if (CDebug->Breaks.Find(FuncTab.GetFuncDeclFileName(frame.func_code).c_str(), nDebugTraceLineCode))
                     {
                         if (!CDebug->IsDebug())
                             CDebug->OpenDebugWindow(core_internal.GetAppInstance());
@@ -4379,7 +4451,7 @@ bool COMPILER::BC_Execute(uint32_t function_code, DATA *&pVReturnResult, const c
                         ShowWindow(CDebug->GetWindowHandle(), SW_NORMAL);
                         // CDebug->OpenDebugWindow(core_impl.hInstance);
                         CDebug->SetTraceMode(TMODE_WAIT);
-                        CDebug->BreakOn(fi.decl_file_name.c_str(), nDebugTraceLineCode);
+                        CDebug->BreakOn(FuncTab.GetFuncDeclFileName(frame.func_code).c_str(), nDebugTraceLineCode);
 
                         while (CDebug->GetTraceMode() == TMODE_WAIT)
                         {
@@ -4474,17 +4546,17 @@ bool COMPILER::BC_Execute(uint32_t function_code, DATA *&pVReturnResult, const c
             // if(pVResult) SStack.Pop();
             break;
         case FUNCTION_RETURN_VOID:
-            if (fi.return_type != TVOID)
+            if (frame.return_type != TVOID)
             {
                 SetError("function must return value");
                 return false;
             }
             // for(n=0;n<fi.var_num;n++) SStack.Pop();
-            SStack.InvalidateFrom(fi.stack_offset);
+            SStack.InvalidateFrom(frame.stack_offset);
 
             return true;
         case FUNCTION_RETURN:
-            if (fi.return_type == TVOID)
+            if (frame.return_type == TVOID)
             {
                 SetError("void function return value");
 
@@ -4493,7 +4565,7 @@ bool COMPILER::BC_Execute(uint32_t function_code, DATA *&pVReturnResult, const c
             // at this moment result expression placed in EX register
 
             if (pDbgExpSource == nullptr) // skip stack unwind for dbg expression process    // ????????
-                SStack.InvalidateFrom(fi.stack_offset);
+                SStack.InvalidateFrom(frame.stack_offset);
 
             // copy result into stack
             pV = SStack.Push();
@@ -4502,15 +4574,15 @@ bool COMPILER::BC_Execute(uint32_t function_code, DATA *&pVReturnResult, const c
 
             // check return type
             if (pDbgExpSource == nullptr) // skip test for dbg expression process
-                if (fi.return_type != pV->GetType())
+                if (frame.return_type != pV->GetType())
                 {
-                    if (fi.return_type == VAR_INTEGER && pV->GetType() == VAR_PTR)
+                    if (frame.return_type == VAR_INTEGER && pV->GetType() == VAR_PTR)
                     {
                         pV->Convert(VAR_INTEGER);
                         return true;
                     }
 
-                    SetError("%s function return %s value", Token.GetTypeName(fi.return_type),
+                    SetError("%s function return %s value", Token.GetTypeName(frame.return_type),
                              Token.GetTypeName(pV->GetType()));
                     return false;
                 }
@@ -5285,19 +5357,26 @@ bool COMPILER::BC_Execute(uint32_t function_code, DATA *&pVReturnResult, const c
                 ExpressionResult.ClearType();
                 ExpressionResult.Copy(pVSrc);
 
-                // 2 signs precision --------------------------------
+                // numbers are formatted by the attribute when they are read as strings
                 if (ExpressionResult.GetType() == VAR_FLOAT)
                 {
                     float fV1;
                     ExpressionResult.Get(fV1);
-                    sprintf_s(gs, "%.7f", fV1);
-                    ExpressionResult.Set(gs);
+                    pLeftOperandAClass->SetValueUseFloat(fV1, true);
+                }
+                else if (ExpressionResult.GetType() == VAR_INTEGER)
+                {
+                    int32_t lV1;
+                    ExpressionResult.Get(lV1);
+                    pLeftOperandAClass->SetValueUseInteger(lV1);
+                }
+                else
+                {
+                    ExpressionResult.Convert(VAR_STRING);
+                    if (!ExpressionResult.Get(pChar))
+                        break;
+                    pLeftOperandAClass->SetValue(pChar);
                 }
-                // 2 signs precision --------------------------------
-                ExpressionResult.Convert(VAR_STRING);
-                if (!ExpressionResult.Get(pChar))
-                    break;
-                pLeftOperandAClass->SetValue(pChar);
 
                 if (nLeftOperandIndex != INVALID_ARRAY_INDEX)
                     pVDst = pVDst->GetArrayElement(nLeftOperandIndex);
@@ -5998,10 +6077,11 @@ void COMPILER::SaveData(const void *data_PTR, uint32_t data_size)
 
     if (dwCurPointer + data_size > dwMaxSize)
     {
-        const uint32_t dwNewAllocate = (1 + (dwCurPointer + data_size) / (1024 * 1024)) * (1024 * 1024);
+        // grow geometrically, big saves were copied over and over in 1 MB steps
+        const uint32_t dwNewAllocate = std::max({dwCurPointer + data_size, dwMaxSize * 2, 1024u * 1024u});
         // pBuffer = (char*)RESIZE(pBuffer, dwNewAllocate);
         auto *const newPtr = new char[dwNewAllocate];
-        memcpy(newPtr, pBuffer, dwMaxSize);
+        memcpy(newPtr, pBuffer, dwCurPointer);
         delete[] pBuffer;
         pBuffer = newPtr;
 
@@ -6028,31 +6108,16 @@ void COMPILER::SaveData(const void *data_PTR, uint32_t data_size)
 
 bool COMPILER::ReadData(void *data_PTR, uint32_t data_size)
 {
-    if (data_PTR == nullptr)
+    if (state_reader_ == nullptr)
     {
-        dwCurPointer += data_size;
-        return true;
+        return false;
     }
-    if (dwCurPointer + data_size > dwMaxSize)
+    if (!state_reader_->Read(data_PTR, data_size))
+    {
+        if (state_reader_->IsBroken())
+            SetError("invalid save state");
         return false;
-
-    /*    if (data_size < 16)
-      {
-        char * pReadBuffer = &pBuffer[dwCurPointer];
-        _asm
-        {
-          mov ecx, data_size
-          mov edi, data_PTR
-          mov esi, pReadBuffer
-
-          rep movsb
-        }
-      }
-      else*/
-    memcpy(data_PTR, &pBuffer[dwCurPointer], data_size);
-
-    dwCurPointer += data_size;
-
+    }
     return true;
 }
 
@@ -6206,21 +6271,7 @@ void COMPILER::WriteVDword(uint32_t v)
 
 uint32_t COMPILER::ReadVDword()
 {
-    uint8_t nbv;
-    uint16_t nwv;
-    uint32_t v;
-    ReadData(&nbv, 1);
-    if (nbv < 0xfe)
-    {
-        return nbv;
-    }
-    if (nbv == 0xfe)
-    {
-        ReadData(&nwv, sizeof(nwv));
-        return nwv;
-    }
-    ReadData(&v, sizeof(uint32_t));
-    return v;
+    return state_reader_ ? state_reader_->ReadVDword() : 0;
 }
 
 void COMPILER::SaveString(const char *pS)
@@ -6235,27 +6286,35 @@ void COMPILER::SaveString(const char *pS)
     SaveData(pS, n);
 }
 
+const char *COMPILER::ReadStringInPlace()
+{
+    if (state_reader_ == nullptr)
+        return nullptr;
+
+    const auto *pString = state_reader_->ReadStringInPlace();
+    if (pString == nullptr && state_reader_->IsBroken())
+        SetError("invalid save state");
+    return pString;
+}
+
 char *COMPILER::ReadString()
 {
-    const uint32_t n = ReadVDword();
-    if (n == 0)
+    const auto *pString = ReadStringInPlace();
+    if (pString == nullptr)
         return nullptr;
 
-    char *pBuffer = new char[n];
-    ReadData(pBuffer, n);
-    if (!utf8::IsValidUtf8(pBuffer))
-    {
-        spdlog::warn("Deserializing invalid utf8 string: {}", pBuffer);
-    }
-    return pBuffer;
+    const auto n = strlen(pString) + 1;
+    auto *pCopy = new char[n];
+    memcpy(pCopy, pString, n);
+    return pCopy;
 }
 
-bool COMPILER::ReadVariable(char *name, /* DWORD code,*/ bool bDim, uint32_t a_index)
+bool COMPILER::ReadVariable(const char *name, /* DWORD code,*/ bool bDim, uint32_t a_index)
 {
     int32_t nLongValue;
     uintptr_t ptrValue;
     float fFloatValue;
-    char *pString;
+    const char *pString;
     uint32_t var_index;
     uint32_t array_index;
     uint32_t nElementsNum;
@@ -6339,7 +6398,7 @@ bool COMPILER::ReadVariable(char *name, /* DWORD code,*/ bool bDim, uint32_t a_i
                 else if (eType == S_TOKEN_TYPE::VAR_FLOAT)
                     ReadData(nullptr, sizeof(float));
                 else if (eType == S_TOKEN_TYPE::VAR_STRING)
-                    ReadString();
+                    ReadStringInPlace();
                 else if (eType == S_TOKEN_TYPE::VAR_OBJECT)
                 {
                     ReadData(nullptr, sizeof(uint64_t));
@@ -6378,12 +6437,11 @@ bool COMPILER::ReadVariable(char *name, /* DWORD code,*/ bool bDim, uint32_t a_i
         pV->Set(fFloatValue);
         break;
     case VAR_STRING:
-        pString = ReadString();
+        pString = ReadStringInPlace();
         if (pString)
         {
             if (!bSkipVariable)
                 pV->Set(pString);
-            delete[] pString;
         }
         break;
     case VAR_OBJECT:
@@ -6430,17 +6488,15 @@ bool COMPILER::ReadVariable(char *name, /* DWORD code,*/ bool bDim, uint32_t a_i
         if (var_index == 0xffffffff)
             break;
         array_index = ReadVDword();
-        pString = ReadString();
+        pString = ReadStringInPlace();
         if (bSkipVariable)
         {
-            delete[] pString;
             break;
         }
 
         real_var_ref = VarTab.GetVarX(var_index);
         if (real_var_ref == nullptr)
         {
-            delete[] pString;
             SetError("State read error");
             return false;
         }
@@ -6456,7 +6512,6 @@ bool COMPILER::ReadVariable(char *name, /* DWORD code,*/ bool bDim, uint32_t a_i
         if (pString)
         {
             pA = pVRef->AttributesClass->CreateSubAClass(pVRef->AttributesClass, pString);
-            delete[] pString;
         }
         pV->SetAReference(pA);
 
@@ -6607,9 +6662,12 @@ bool COMPILER::OnLoad()
     return true;
 }
 
-bool COMPILER::SaveState(std::fstream &fileS)
+bool COMPILER::SaveState(std::fstream &&fileS, std::string tmp_name, std::string file_name)
 {
     uint32_t n;
+    WaitStateSaving();
+    const auto snapshotStart = std::chrono::steady_clock::now();
+
     delete[] pBuffer;
     pBuffer = nullptr;
 
@@ -6679,55 +6737,138 @@ bool COMPILER::SaveState(std::fstream &fileS)
         SaveVariable(real_var->value.get());
     }
 
-    uint64_t dw2;
-    if (dwCurPointer)
-    {
-        char *pDst = new char[dwCurPointer * 2];
-        uLongf ulPackLen = dwCurPointer * 2;
-        RDTSC_B(dw2);
-        compress2((Bytef *)pDst, &ulPackLen, (Bytef *)pBuffer, dwCurPointer, Z_BEST_COMPRESSION);
-        RDTSC_E(dw2);
-        uint32_t uiPackLen = ulPackLen;
+    // the snapshot is ready, the game goes on while it is packed and written
+    storm::save_state::Timings timings;
+    timings.snapshot =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - snapshotStart).count();
 
-        fio->_WriteFile(fileS, &dwCurPointer, sizeof(dwCurPointer));
-        fio->_WriteFile(fileS, &uiPackLen, sizeof(uiPackLen));
-        fio->_WriteFile(fileS, pDst, uiPackLen);
+    storm::save_state::Options options;
+    options.level = save_compression_level_;
 
-        delete[] pDst;
-    }
-
-    delete[] pBuffer;
+    std::unique_ptr<char[]> snapshot(pBuffer);
+    const uint32_t snapshotSize = dwCurPointer;
     pBuffer = nullptr;
+    dwCurPointer = 0;
+    dwMaxSize = 0;
+
+    save_tmp_name_ = std::move(tmp_name);
+    save_file_name_ = std::move(file_name);
+    save_task_ = std::async(std::launch::async, [snapshot = std::move(snapshot), snapshotSize, options, timings,
+                                                 fileS = std::move(fileS)]() mutable {
+        bool result = true;
+        if (snapshotSize)
+        {
+            result = storm::save_state::Write(
+                snapshot.get(), snapshotSize, options,
+                [&fileS](const void *data, size_t size) { return fio->_WriteFile(fileS, data, size); }, timings);
+        }
+        // the stream throws since _WriteFile, closing writes the last buffered bytes
+        try
+        {
+            fio->_CloseFile(fileS);
+        }
+        catch (const std::fstream::failure &e)
+        {
+            spdlog::error("Failed to close save state: {}", e.what());
+            result = false;
+        }
+        if (!result)
+        {
+            return false;
+        }
+        spdlog::info("Save state: {} bytes packed to {} in {} chunks, snapshot {:.1f} ms, compress {:.1f} ms, "
+                     "write {:.1f} ms, background {:.1f} ms",
+                     timings.raw_size, timings.packed_size, timings.chunks, timings.snapshot, timings.compress,
+                     timings.write, timings.total);
+        return true;
+    });
 
     return true;
 }
 
-bool COMPILER::LoadState(std::fstream &fileS)
+bool COMPILER::WaitStateSaving()
 {
-    uint32_t n;
-    char *pString;
+    if (save_task_.valid())
+    {
+        // the old save stays untouched unless the new one is completely written
+        save_result_ = save_task_.get() && fio->_RenameFile(save_tmp_name_.c_str(), save_file_name_.c_str());
+        if (!save_result_)
+        {
+            spdlog::error("Failed to write save state {}", save_file_name_);
+            fio->_DeleteFile(save_tmp_name_.c_str());
+        }
+    }
+    return save_result_;
+}
 
+bool COMPILER::LoadState(std::fstream &fileS)
+{
+    WaitStateSaving();
+    const auto loadStart = std::chrono::steady_clock::now();
     delete[] pBuffer;
     pBuffer = nullptr;
 
     EXTDATA_HEADER exdh;
     fio->_ReadFile(fileS, &exdh, sizeof(exdh));
 
-    uint32_t dwPackLen;
+    storm::save_state::Reader reader;
+    storm::save_state::Reader *pReader = nullptr;
     fio->_ReadFile(fileS, &dwMaxSize, sizeof(dwMaxSize));
-    fio->_ReadFile(fileS, &dwPackLen, sizeof(dwPackLen));
-    if (dwPackLen == 0 || dwPackLen > 0x8000000 || dwMaxSize == 0 || dwMaxSize > 0x8000000)
+    if (dwMaxSize == storm::save_state::kMagic)
     {
-        return false;
+        // the chunks are read after Start, the file stays open until the reader stops
+        if (!reader.Open([&fileS](void *data, size_t size) { return fio->_ReadFile(fileS, data, size); }))
+        {
+            SetError("invalid save state");
+            return false;
+        }
+        // chunks are read and unpacked in the background, ReadData waits only for the ones it gets to
+        dwMaxSize = reader.GetSize();
+        pBuffer = new char[dwMaxSize];
+        reader.Start(pBuffer);
+        pReader = &reader;
     }
-    char *pCBuffer = new char[dwPackLen];
-    pBuffer = new char[dwMaxSize];
-    fio->_ReadFile(fileS, pCBuffer, dwPackLen);
-    uLongf ulMaxSize = dwMaxSize;
-    uncompress((Bytef *)pBuffer, &ulMaxSize, (Bytef *)pCBuffer, dwPackLen);
-    dwMaxSize = ulMaxSize;
-    delete[] pCBuffer;
-    dwCurPointer = 0;
+    else
+    {
+        // saves of previous versions, a single zlib stream
+        uint32_t dwPackLen;
+        fio->_ReadFile(fileS, &dwPackLen, sizeof(dwPackLen));
+        if (dwPackLen == 0 || dwPackLen > storm::save_state::kLegacyMaxSize || dwMaxSize == 0 ||
+            dwMaxSize > storm::save_state::kLegacyMaxSize)
+        {
+            return false;
+        }
+        char *pCBuffer = new char[dwPackLen];
+        pBuffer = new char[dwMaxSize];
+        fio->_ReadFile(fileS, pCBuffer, dwPackLen);
+        uLongf ulMaxSize = dwMaxSize;
+        uncompress((Bytef *)pBuffer, &ulMaxSize, (Bytef *)pCBuffer, dwPackLen);
+        dwMaxSize = ulMaxSize;
+        delete[] pCBuffer;
+    }
+    const auto openTime = std::chrono::steady_clock::now() - loadStart;
+
+    storm::save_state::StateReader stateReader(pBuffer, dwMaxSize, pReader);
+    state_reader_ = &stateReader;
+    const bool bResult = LoadStateData();
+
+    state_reader_ = nullptr;
+    reader.Stop();
+    delete[] pBuffer;
+    pBuffer = nullptr;
+
+    using ms = std::chrono::duration<double, std::milli>;
+    spdlog::info("Load state: {} bytes, open {:.1f} ms, read {:.1f} ms, unpack {:.1f} ms, waited for unpacking "
+                 "{:.1f} ms, total {:.1f} ms",
+                 dwMaxSize, ms(openTime).count(), reader.GetReadTime(), reader.GetUnpackTime(),
+                 reader.GetWaitTime(), ms(std::chrono::steady_clock::now() - loadStart).count());
+    return bResult;
+}
+
+bool COMPILER::LoadStateData()
+{
+    uint32_t n;
+    const char *pString;
 
     // Release all data
     Release();
@@ -6743,15 +6884,14 @@ bool COMPILER::LoadState(std::fstream &fileS)
     // 1. Program Directory
     ProgramDirectory = ReadString();
 
-    // 4. SCodec data
+    // 4. SCodec data, name codes of all attributes depend on this order
     const uint32_t nSCStringsNum = ReadVDword();
     for (n = 0; n < nSCStringsNum; n++)
     {
-        pString = ReadString();
+        pString = ReadStringInPlace();
         if (pString)
         {
             SCodec.Convert(pString);
-            delete[] pString;
         }
     }
 
@@ -6775,68 +6915,30 @@ bool COMPILER::LoadState(std::fstream &fileS)
     const uint32_t nVarNum = ReadVDword();
     for (n = 0; n < nVarNum; n++)
     {
-        pString = ReadString();
+        pString = ReadStringInPlace();
         if (pString == nullptr || strcmp(pString, "") == 0)
         {
             SetError("missing variable name");
             return false;
         }
         ReadVariable(pString /*,n*/);
-
-        delete[] pString;
     }
 
     // call to script function "OnLoad()"
     OnLoad();
 
-    delete[] pBuffer;
-    pBuffer = nullptr;
-
     return true;
 }
 
 void COMPILER::ReadAttributesData(ATTRIBUTES *pRoot, ATTRIBUTES *pParent)
 {
-    uint32_t nSubClassesNum;
-    uint32_t n;
-    uint32_t nNameCode;
-    // char * pName;
-    char *pValue;
-
-    if (pRoot == nullptr)
-    {
-        nSubClassesNum = ReadVDword();
-        nNameCode = ReadVDword();
-
-        // DTrace(SCodec.Convert(nNameCode));
-        pValue = ReadString();
-        pParent->SetAttribute(nNameCode, pValue);
-        pRoot = pParent->GetAttributeClassByCode(nNameCode);
-        delete[] pValue;
-        for (n = 0; n < nSubClassesNum; n++)
-        {
-            ReadAttributesData(nullptr, pRoot);
-        }
-
+    if (state_reader_ == nullptr)
         return;
-    }
-
-    nSubClassesNum = ReadVDword();
-    nNameCode = ReadVDword();
-    pValue = ReadString();
-    // pRoot->SetAttribute(nNameCode,pValue);
-
-    pRoot->SetNameCode(nNameCode);
-    pRoot->SetValue(pValue);
 
-    for (n = 0; n < nSubClassesNum; n++)
-    {
-        // ReadAttributesData(pRoot->GetAttributeClass(n));
-        ReadAttributesData(nullptr, pRoot);
-    }
-
-    // if(pName) delete pName;
-    delete[] pValue;
+    if (pRoot == nullptr)
+        state_reader_->ReadAttributeClass(pParent);
+    else
+        state_reader_->ReadAttributes(pRoot);
 }
 
 void COMPILER::SaveAttributesData(ATTRIBUTES *pRoot)
@@ -6871,36 +6973,35 @@ bool COMPILER::SetSaveData(const char *file_name, void *save_data, int32_t data_
 {
     EXTDATA_HEADER exdh;
 
-    auto fileS = fio->_CreateFile(file_name, std::ios::binary | std::ios::in | std::ios::out);
-    if (!fileS.is_open())
-    {
-        return false;
-    }
-
-    const uint32_t dwFileSize = fio->_GetFileSize(file_name);
     auto *pVDat = static_cast<VDATA *>(core_internal.GetScriptVariable("savefile_info"));
     if (pVDat && pVDat->GetString())
         sprintf_s(exdh.sFileInfo, sizeof(exdh.sFileInfo), "%s", pVDat->GetString());
     else
         sprintf_s(exdh.sFileInfo, sizeof(exdh.sFileInfo), "save");
-    exdh.dwExtDataOffset = dwFileSize;
+    exdh.dwExtDataOffset = 0;
     exdh.dwExtDataSize = data_size;
 
-    fio->_WriteFile(fileS, &exdh, sizeof(exdh));
-    fio->_SetFilePointer(fileS, dwFileSize, std::ios::beg);
-
-    char *pDst = new char[data_size * 2];
+    std::vector<char> packed(data_size * 2);
     uLongf ulPackLen = data_size * 2;
-    compress2((Bytef *)pDst, &ulPackLen, static_cast<Bytef *>(save_data), data_size, Z_BEST_COMPRESSION);
-    uint32_t uiPackLen = ulPackLen;
-
-    fio->_WriteFile(fileS, &uiPackLen, sizeof(uiPackLen));
-    fio->_WriteFile(fileS, pDst, uiPackLen);
-    fio->_CloseFile(fileS);
+    compress2(reinterpret_cast<Bytef *>(packed.data()), &ulPackLen, static_cast<Bytef *>(save_data), data_size,
+              Z_BEST_COMPRESSION);
+    packed.resize(ulPackLen);
 
-    delete[] pDst;
+    // the state of this file is still being written, ext data is appended to it in the background
+    if (save_task_.valid() && save_file_name_ == file_name)
+    {
+        save_task_ = std::async(std::launch::async, [state = std::move(save_task_), file = save_tmp_name_, exdh,
+                                                     packed = std::move(packed)]() mutable {
+            if (!state.get())
+            {
+                return false;
+            }
+            return AppendSaveData(file.c_str(), exdh, packed);
+        });
+        return true;
+    }
 
-    return true;
+    return AppendSaveData(file_name, exdh, packed);
 }
 
 /*bool COMPILER::SetSaveData(char * file_name, void * save_data, int32_t data_size)
@@ -6991,6 +7092,7 @@ bool COMPILER::SetSaveData(const char *file_name, void *save_data, int32_t data_
 
 void *COMPILER::GetSaveData(const char *file_name, int32_t &data_size)
 {
+    WaitStateSaving();
     auto fileS = fio->_CreateFile(file_name, std::ios::binary | std::ios::in);
     if (!fileS.is_open())
     {
@@ -7308,6 +7410,22 @@ void COMPILER::PrintoutUsage()
             logTrace_->debug("  {} : {}", n, pRuntimeLogEvent[n]);
         }
     }
+
+    // dump once per key press, not every frame while the keys are held
+    const bool bProfileKeysDown = scriptProfiler_.IsEnabled() && core.Controls->GetDebugAsyncKeyState(VK_BACK) < 0 &&
+                                  core.Controls->GetDebugAsyncKeyState(VK_SHIFT) < 0;
+    const bool bProfileKeysPressed = bProfileKeysDown && !bProfileKeysWereDown;
+    bProfileKeysWereDown = bProfileKeysDown;
+    if (bProfileKeysPressed)
+    {
+        const auto logs_path = storm::GetEngineSettings().GetEnginePath(storm::EngineSettingsPathType::Logs);
+        if (scriptProfiler_.DumpFoldedStacks(logs_path / "script_profile.folded") &&
+            scriptProfiler_.DumpFunctions(logs_path / "script_profile.csv"))
+        {
+            logTrace_->debug("Script profile saved to {}", logs_path.string());
+        }
+        scriptProfiler_.Reset();
+    }
 }
 
 void COMPILER::LoadVariablesFromCache(storm::script_cache::BufferReader &reader, SEGMENT_DESC &segment)
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <future>
 #include <string_view>
 #include <tuple>
 
@@ -18,9 +19,11 @@
 #include "token.h"
 #include "logging.hpp"
 #include "script_cache.h"
+#include "script_profiler.h"
 #include "platform/platform.hpp"
 
 #include "ringbuffer_stack.hpp"
+#include "storm/save_state.hpp"
 
 #define BCODE_BUFFER_BLOCKSIZE 4096
 #define IOBUFFER_SIZE 65535
@@ -125,8 +128,12 @@ class COMPILER : public VIRTUAL_COMPILER
     bool Run();
     void Release();
     void SetProgramDirectory(const char *dir_name);
-    VDATA *ProcessEvent(const char *event_name, MESSAGE message);
+    VDATA *ProcessEvent(const char *event_name, MESSAGE &message);
     VDATA *ProcessEvent(const char *event_name);
+    // event code comes from RegisterEvent and stays valid for the whole run
+    uint32_t RegisterEvent(const char *event_name);
+    VDATA *ProcessEventByCode(uint32_t event_code, MESSAGE &message);
+    VDATA *ProcessEventByCode(uint32_t event_code);
     void SetEventHandler(const char *event_name, const char *func_name, int32_t flag, bool bStatic = false);
     void DelEventHandler(const char *event_name, const char *func_name);
 
@@ -209,17 +216,23 @@ class COMPILER : public VIRTUAL_COMPILER
     bool CreateMessage(MESSAGE *pMs, uint32_t stack_offset, uint32_t vindex, bool s2s = false);
     void ProcessEvent(const char *event_name, MESSAGE *pMs);
 
-    bool SaveState(std::fstream &fileS);
+    // Takes fileS opened for tmp_name, compression and writing go on in the background,
+    // tmp_name replaces file_name only when it is completely written, see WaitStateSaving
+    bool SaveState(std::fstream &&fileS, std::string tmp_name, std::string file_name);
     bool LoadState(std::fstream &fileS);
+    bool LoadStateData();
+    // Wait for the background save and replace its file, false if the last save failed
+    bool WaitStateSaving();
     bool OnLoad();
     void SaveDataDebug(char *data_PTR, ...);
     void SaveData(const void *data_PTR, uint32_t data_size);
     bool ReadData(void *data_PTR, uint32_t data_size);
     void SaveString(const char *pS);
     char *ReadString();
+    const char *ReadStringInPlace(); // points into the load buffer
 
     void SaveVariable(DATA *pV, bool bdim = false);
-    bool ReadVariable(char *name, /*DWORD code,*/ bool bdim = false, uint32_t a_index = 0);
+    bool ReadVariable(const char *name, /*DWORD code,*/ bool bdim = false, uint32_t a_index = 0);
     bool FindReferencedVariable(DATA *pRef, uint32_t &var_index, uint32_t &array_index);
     bool FindReferencedVariableByRootA(ATTRIBUTES *pA, uint32_t &var_index, uint32_t &array_index);
     ATTRIBUTES *TraceARoot(ATTRIBUTES *pA, const char *&pAccess);
@@ -240,6 +253,7 @@ class COMPILER : public VIRTUAL_COMPILER
     // bool SetSaveData(const char * file_name, const char * save_data);
     // bool GetSaveData(const char * file_name, DATA * pV);
 
+    // Ext data of a save still being written is appended in the background, a failed append fails WaitStateSaving
     bool SetSaveData(const char *file_name, void *save_data, int32_t data_size);
     void *GetSaveData(const char *file_name, int32_t &data_size);
 
@@ -308,7 +322,7 @@ private:
     char *pDebExpBuffer;
     uint32_t nDebExpBufferSize;
 
-    FuncInfo *pRun_fi; // running function info
+    FuncFrame *pRun_fi; // running function frame
     FuncTable FuncTab;
     VarTable VarTab;
     S_DEFTAB DefTab;
@@ -360,6 +374,10 @@ private:
     storm::logging::logger_ptr logError_;
     storm::logging::logger_ptr logStack_;
 
+    // call tree profiler of script functions and events, [script] profiler = 1 in engine.ini
+    ScriptProfiler scriptProfiler_;
+    bool bProfileKeysWereDown = false;
+
     // backtrace stack
     // NB: pointers are safe as long as we pop elements before they expire
     static constexpr size_t CALLSTACK_SIZE = 64U;
@@ -368,4 +386,14 @@ private:
     // attempt to read/write script cache?
     int script_cache_mode_;
     storm::ScriptCache script_cache_;
+
+    // zlib level of saves, [script] save_compression in engine.ini
+    int32_t save_compression_level_;
+    // background compression and writing of the last save into save_tmp_name_
+    std::future<bool> save_task_;
+    std::string save_tmp_name_;
+    std::string save_file_name_;
+    bool save_result_;
+    // goes through the state being loaded, ReadData waits for the part not unpacked yet
+    storm::save_state::StateReader *state_reader_;
 };
@@ -3,8 +3,12 @@
 #include "compiler.h"
 #include "controls.h"
 #include "fs.h"
+#include "stage_profiler.hpp"
 #include "steam_api.hpp"
+#include "storm/engine_settings.hpp"
 
+#include <algorithm>
+#include <execution>
 #include <fstream>
 
 #include "string_compare.hpp"
@@ -155,8 +159,11 @@ bool CoreImpl::Run()
     stopFrameProcessing_ = false;
 
     const auto bDebugWindow = true;
-    if (bDebugWindow && core_internal.Controls && core_internal.Controls->GetDebugAsyncKeyState(VK_F7) < 0)
+    // dump once per key press, not every frame while the key is held
+    const bool bDumpKeyDown = core_internal.Controls && core_internal.Controls->GetDebugAsyncKeyState(VK_F7) < 0;
+    if (bDebugWindow && bDumpKeyDown && !bDumpKeyWasDown)
         DumpEntitiesInfo();
+    bDumpKeyWasDown = bDumpKeyDown;
     dwNumberScriptCommandsExecuted = 0;
 
     if (Exit_flag)
@@ -202,10 +209,14 @@ bool CoreImpl::Run()
         ProcessEngineIniFile();
 
     Compiler->ProcessFrame(Timer.GetDeltaTime());
-    Compiler->ProcessEvent("frame");
+    if (frameEvent_ == INVALID_EVENT_CODE)
+        frameEvent_ = Compiler->RegisterEvent("frame");
+    Compiler->ProcessEventByCode(frameEvent_);
 
     ProcessStateLoading();
 
+    fio->ProcessFileWatches();
+
     ProcessRunStart(SECTION_ALL);
     if (stopFrameProcessing_)
     {
@@ -299,6 +310,7 @@ void CoreImpl::ProcessEngineIniFile()
     }
 
     loadCompatibilitySettings(*engine_ini);
+    storm::diag::getStageProfiler().setEnabled(engine_ini->GetInt(nullptr, "stage_profiler", 0) != 0);
     determineScreenSize(*engine_ini);
 
     res = engine_ini->ReadString(nullptr, "run", String, sizeof(String), "");
@@ -462,6 +474,16 @@ VDATA *CoreImpl::Event(const std::string_view &event_name, MESSAGE &message)
     return Compiler->ProcessEvent(event_name.data(), message);
 }
 
+event_handle_t CoreImpl::GetEventHandle(const std::string_view &event_name)
+{
+    return static_cast<event_handle_t>(Compiler->RegisterEvent(std::string(event_name).c_str()));
+}
+
+VDATA *CoreImpl::Event(const event_handle_t event, MESSAGE &message)
+{
+    return Compiler->ProcessEventByCode(static_cast<uint32_t>(event), message);
+}
+
 void *CoreImpl::MakeClass(const char *class_name)
 {
     const int32_t hash = MakeHashValue(class_name);
@@ -559,13 +581,58 @@ void CoreImpl::ProcessExecute()
     {
         if (auto *ptr = core.GetEntityPointerSafe(id))
         {
-            ptr->ProcessStage(Entity::Stage::execute, deltatime);
+            if (ptr->GetExecutePolicy() == Entity::ExecutePolicy::parallel)
+            {
+                // entity registered in several execute layers must not run concurrently with itself
+                if (std::ranges::find(parallelExecuteBatch_, ptr) != parallelExecuteBatch_.end())
+                {
+                    FlushParallelExecute(deltatime);
+                }
+                parallelExecuteBatch_.push_back(ptr);
+            }
+            else
+            {
+                // sequential entity is a barrier, everything before it has to be done
+                FlushParallelExecute(deltatime);
+                ProcessEntityStage(*ptr, Entity::Stage::execute, deltatime);
+            }
         }
     }
+    FlushParallelExecute(deltatime);
 
     ProcessRunEnd(SECTION_EXECUTE);
 }
 
+void CoreImpl::FlushParallelExecute(const uint32_t delta_time)
+{
+    if (parallelExecuteBatch_.size() == 1)
+    {
+        ProcessEntityStage(*parallelExecuteBatch_.front(), Entity::Stage::execute, delta_time);
+    }
+    else if (!parallelExecuteBatch_.empty())
+    {
+        // the batch goes to the standard library scheduler (the MSVC thread pool on Windows), there is no task
+        // pool of our own; libstdc++ without TBB runs std::execution::par serially
+        std::for_each(std::execution::par, std::begin(parallelExecuteBatch_), std::end(parallelExecuteBatch_),
+                      [this, delta_time](Entity *entity) {
+                          ProcessEntityStage(*entity, Entity::Stage::execute, delta_time);
+                      });
+    }
+
+    // what must not run concurrently follows in layer order, an earlier entity may have erased a later one
+    for (auto *entity : parallelExecuteBatch_)
+    {
+        if (GetEntityPointerSafe(entity->GetId()) == entity)
+        {
+            const storm::diag::StageProfiler::Scope scope(storm::diag::getStageProfiler(),
+                                                          storm::diag::StageProfiler::Category::execute,
+                                                          entity->GetId());
+            entity->FinishParallelExecute(delta_time);
+        }
+    }
+    parallelExecuteBatch_.clear();
+}
+
 void CoreImpl::ProcessRealize()
 {
     uint64_t ticks;
@@ -577,13 +644,26 @@ void CoreImpl::ProcessRealize()
     {
         if (auto *ptr = core.GetEntityPointerSafe(id))
         {
-            ptr->ProcessStage(Entity::Stage::realize, deltatime);
+            ProcessEntityStage(*ptr, Entity::Stage::realize, deltatime);
         }
     }
 
     ProcessRunEnd(SECTION_REALIZE);
 }
 
+void CoreImpl::ProcessEntityStage(Entity &entity, const Entity::Stage stage, const uint32_t delta_time)
+{
+    using storm::diag::StageProfiler;
+
+    auto &profiler = storm::diag::getStageProfiler();
+    const auto category = stage == Entity::Stage::execute ? StageProfiler::Category::execute
+                                                          : StageProfiler::Category::realize;
+    // the entity may delete itself in the stage, so the name is built from the id
+    const StageProfiler::Scope scope(profiler, category, entity.GetId(),
+                                     [this, id = entity.GetId()] { return GetEntityDebugName(id); });
+    entity.ProcessStage(stage, delta_time);
+}
+
 // save core state
 bool CoreImpl::SaveState(const char *file_name)
 {
@@ -592,22 +672,24 @@ bool CoreImpl::SaveState(const char *file_name)
         throw std::logic_error("Bad file name of save");
     }
 
-    auto fileS = fio->_CreateFile(file_name, std::ios::binary | std::ios::out);
+    Compiler->WaitStateSaving();
+    // the state goes to a temporary file first, so a failed save can't destroy the one it overwrites
+    auto tmp_name = std::string(file_name) + ".tmp";
+    auto fileS = fio->_CreateFile(tmp_name.c_str(), std::ios::binary | std::ios::out);
 
     if (!fileS.is_open())
     {
         return false;
     }
 
-    Compiler->SaveState(fileS);
-    fio->_CloseFile(fileS);
-
-    return true;
+    // the compiler closes the file when the state is written, WaitStateSaving tells if that succeeded
+    return Compiler->SaveState(std::move(fileS), std::move(tmp_name), file_name);
 }
 
 // force core to load state file at the start of next game loop, return false if no state file
 bool CoreImpl::InitiateStateLoading(const char *file_name)
 {
+    Compiler->WaitStateSaving();
     auto fileS = fio->_CreateFile(file_name, std::ios::binary | std::ios::in);
     if (!fileS.is_open())
     {
@@ -622,6 +704,11 @@ bool CoreImpl::InitiateStateLoading(const char *file_name)
     return true;
 }
 
+bool CoreImpl::WaitStateSaving()
+{
+    return Compiler->WaitStateSaving();
+}
+
 void CoreImpl::ProcessStateLoading()
 {
     if (!State_file_name)
@@ -632,6 +719,7 @@ void CoreImpl::ProcessStateLoading()
     State_loading = true;
     EraseEntities();
 
+    Compiler->WaitStateSaving();
     auto fileS = fio->_CreateFile(State_file_name, std::ios::binary | std::ios::in);
     if (!fileS.is_open())
     {
@@ -830,69 +918,59 @@ uint32_t CoreImpl::MakeHashValue(const char *string)
 // end
 //==========================================================================================================================
 
-void CoreImpl::DumpEntitiesInfo()
+std::string CoreImpl::GetEntityDebugName(const entid_t id)
 {
-    /*LARGE_INTEGER li;
-    if (!QueryPerformanceFrequency(&li))
-      throw std::runtime_error();
-
-    const auto freq = double(li.QuadPart)/1000.0;
-
-    uint32_t n;
-    char * ptr;
-    VMA * pClass;
-
-    Trace("Script commands executed: %" PRIu32, dwNumberScriptCommandsExecuted);
-    Trace("Entity Dump -----------------------------------");
+    auto *vma = FindVMA(static_cast<int32_t>(entity_manager_.GetClassCode(id)));
+    return std::string(vma ? vma->GetName() : "unknown") + "#" + std::to_string(id & 0xffffffff);
+}
 
-    for(n=0;n<=CoreState.Atoms_max_orbit;n++)
+void CoreImpl::DumpEntitiesAttributes()
+{
+    struct EntityAttributes
     {
-      if(Atoms_PTR[n] == nullptr) continue;
+        entid_t id;
+        ATTRIBUTES::MemoryUsage usage;
+    };
+    std::vector<EntityAttributes> entities;
+    entity_manager_.ForEachEntity([&entities](const entptr_t entity) {
+        if (entity->AttributesPointer)
+            entities.push_back({entity->GetId(), entity->AttributesPointer->GetMemoryUsage()});
+    });
+    std::sort(entities.begin(), entities.end(),
+              [](const EntityAttributes &a, const EntityAttributes &b) { return a.usage.bytes > b.usage.bytes; });
 
-      pClass = FindVMA(Atoms_PTR[n]->atom_id.class_code);
-      if(pClass)
-      {
-        ptr = pClass->GetName();
-        if(ptr)
-        {
-          Trace("Class: %s", ptr);
-          Trace("     : Realize:  Cur( %fms ) Max( %fms )", Atoms_PTR[n]->as.Realize_ticks_av/freq,
-    Atoms_PTR[n]->as.Realize_ticks_max/freq); Trace("     : Execute:  Cur( %fms ) Max( %fms )",
-    Atoms_PTR[n]->as.Execute_ticks_av/freq, Atoms_PTR[n]->as.Execute_ticks_max/freq);
-        }
-      }
+    ATTRIBUTES::MemoryUsage total{};
+    for (const auto &entity : entities)
+    {
+        total.nodes += entity.usage.nodes;
+        total.bytes += entity.usage.bytes;
     }
+    Trace("Entity attributes: %zu nodes, %zu bytes", total.nodes, total.bytes);
 
-    Trace(" ------- Running objects ------- ");
-    for(n=0;n<=CommonLayers.lss.Layer_max_index;n++)
+    constexpr size_t kLargestNum = 10;
+    for (size_t i = 0; i < std::min(entities.size(), kLargestNum); i++)
     {
-      LAYER* l_PTR = CommonLayers.Layer_Table[n];
-      if(l_PTR == nullptr) continue;
-
-      uint32_t flags = l_PTR->ls.Flags & LRFLAG_FROZEN;
-      if(flags != 0)
-      {
-        Trace("LAYER: %s frozen -------------------------------------",l_PTR->Name);
-        continue;
-      }
-      Trace("LAYER: %s --------------------------------------",l_PTR->Name);
-      entid_t  eid_PTR = l_PTR->GetId();
-      while(eid_PTR)
-      {
-        Trace("Entity:");
-        if(ValidateEntity(eid_PTR))
-        {
-          pClass = FindVMA(Atoms_PTR[eid_PTR->atom_position]->atom_id.class_code);
-          if(pClass) ptr = pClass->GetName();
-          Trace("        %s",ptr);
-          if(Atoms_PTR[eid_PTR->atom_position]->as.Deleted) Trace("        deleted");
+        Trace("  %s: %zu nodes, %zu bytes", GetEntityDebugName(entities[i].id).c_str(), entities[i].usage.nodes,
+              entities[i].usage.bytes);
+    }
+}
 
-        }
-        eid_PTR = l_PTR->GetNextID();
-      }
+void CoreImpl::DumpEntitiesInfo()
+{
+    DumpEntitiesAttributes();
+
+    auto &profiler = storm::diag::getStageProfiler();
+    if (!profiler.isEnabled())
+    {
+        Trace("Stage profiler is disabled, set stage_profiler = 1 in engine.ini");
+        return;
     }
 
-    std::this_thread::sleep_for(std::chrono::milliseconds(200));*/
+    const auto logs_path = storm::GetEngineSettings().GetEnginePath(storm::EngineSettingsPathType::Logs);
+    if (profiler.dumpCsv(logs_path / "stage_profile.csv") && profiler.dumpChromeTrace(logs_path / "stage_profile.json"))
+    {
+        Trace("Stage profile saved to %s", logs_path.string().c_str());
+    }
 }
 
 void *CoreImpl::GetSaveData(const char *file_name, int32_t &data_size)
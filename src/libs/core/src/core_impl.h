@@ -30,6 +30,8 @@ class CoreImpl final : public CorePrivate
     bool LoadClassesTable();
 
     void ProcessExecute();
+    void FlushParallelExecute(uint32_t delta_time);
+    void ProcessEntityStage(Entity &entity, Entity::Stage stage, uint32_t delta_time);
     void ProcessRealize();
     void ProcessStateLoading();
     void ProcessRunStart(uint32_t section_code);
@@ -43,6 +45,8 @@ class CoreImpl final : public CorePrivate
 
 
     void DumpEntitiesInfo();
+    void DumpEntitiesAttributes();
+    std::string GetEntityDebugName(entid_t id);
     void EraseEntities();
     void ClearEvents();
     void *MakeClass(const char *class_name);
@@ -90,6 +94,7 @@ class CoreImpl final : public CorePrivate
     bool SaveState(const char *file_name) override;
     // force core to load state file at the start of next game loop, return false if no state file
     bool InitiateStateLoading(const char *file_name) override;
+    bool WaitStateSaving() override;
 
     // return current fps
     uint32_t EngineFps() override;
@@ -100,6 +105,8 @@ class CoreImpl final : public CorePrivate
     //    
     VDATA *Event(const std::string_view &event_name) override;
     VDATA *Event(const std::string_view &event_name, MESSAGE& message) override;
+    event_handle_t GetEventHandle(const std::string_view &event_name) override;
+    VDATA *Event(event_handle_t event, MESSAGE &message) override;
     uint32_t PostEvent(const char *Event_name, uint32_t post_time, const char *Format, ...) override;
 
     void *GetSaveData(const char *file_name, int32_t &data_size) override;
@@ -163,6 +170,7 @@ private:
     ScreenSize screenSize_;
 
     bool stopFrameProcessing_ = false;
+    bool bDumpKeyWasDown = false;
 
     bool bAppActive{};
     bool Memory_Leak_flag; // true if core detected memory leak
@@ -177,6 +185,9 @@ private:
 
     SERVICES_LIST Services_List; // list for subsequent calls RunStart/RunEnd service functions
 
+    uint32_t frameEvent_ = INVALID_EVENT_CODE;
+    std::vector<Entity *> parallelExecuteBatch_; // parallel entities collected between two sequential ones
+
 #ifdef _WIN32 // HINSTANCE
     HINSTANCE hInstance{};
 #endif
@@ -1,6 +1,7 @@
 #include "data.h"
 
 #include <charconv>
+#include <limits>
 
 #include "core_impl.h"
 #include "string_compare.hpp"
@@ -982,6 +983,30 @@ void DATA::ClearType()
     sValue.clear();
 }
 
+void DATA::ResetType()
+{
+    if (AttributesClass)
+    {
+        if (Data_type != VAR_AREFERENCE)
+        {
+            delete AttributesClass;
+        }
+        AttributesClass = nullptr;
+    }
+    Data_type = UNKNOWN;
+    pReference = nullptr;
+    if (!sValue.empty())
+    {
+        sValue.clear();
+    }
+    if (!ArrayPTR.empty())
+    {
+        ArrayPTR.clear();
+    }
+    bArray = false;
+    Number_of_elements = 1;
+}
+
 void DATA::SetType(S_TOKEN_TYPE _element_type, uint32_t array_size)
 {
     ClearType();
@@ -1131,6 +1156,17 @@ bool DATA::Convert(S_TOKEN_TYPE type)
         case VAR_INTEGER:
             if (!AttributesClass)
                 break;
+            if (const auto integer = AttributesClass->GetIntegerValue())
+            {
+                AttributesClass = nullptr;
+                Data_type = VAR_INTEGER;
+                // same as parsing its text, which leaves 0 for numbers out of range
+                lValue = *integer >= std::numeric_limits<int32_t>::min() &&
+                                 *integer <= std::numeric_limits<int32_t>::max()
+                             ? static_cast<int32_t>(*integer)
+                             : 0;
+                return true;
+            }
             if (!AttributesClass->GetThisAttr())
                 break;
             Set(to_string(AttributesClass->GetThisAttr()));
@@ -126,6 +126,8 @@ class DATA : public VDATA
     bool IsAReference() override;
     DATA *GetVarPointer() override;
     void ClearType();
+    // same as ClearType() + SetType(UNKNOWN), but skips work on already clean data (used for stack slots reuse)
+    void ResetType();
 
     entid_t GetObjectIDPTR() override
     {
@@ -6,6 +6,7 @@
 #include <ranges>
 #include <type_traits>
 
+#include "stage_profiler.hpp"
 #include "storm/editor/storm_imgui.hpp"
 #include "storm/layers.hpp"
 #include "string_compare.hpp"
@@ -211,6 +212,7 @@ void EntityManager::EraseAll()
 
     // clear cache
     cache_.Clear();
+    storm::diag::getStageProfiler().eraseEntities();
 
     previousStamp_ = 0;
 }
@@ -393,6 +395,8 @@ void EntityManager::NewLifecycle()
         deletedIndices_.pop();
 
         auto &data = entities_[entity_idx];
+        // the stages of this frame are done, the profiler won't see the id again
+        storm::diag::getStageProfiler().eraseEntity(data.id);
         // release
         EraseAndFree(data);
         // erase entity data
@@ -4,6 +4,7 @@
 #include "platform/platform.hpp"
 
 #include <SDL2/SDL.h>
+#include <algorithm>
 #include <exception>
 #include <string>
 
@@ -24,20 +25,13 @@ extern FILE_SERVICE *fio = &file_service;
 
 void FILE_SERVICE::FlushIniFiles()
 {
-    for (uint32_t n = 0; n <= Max_File_Index; n++)
-    {
-        if (OpenFiles[n] == nullptr)
-            continue;
-        OpenFiles[n]->FlushFile();
-    }
+    for (auto &[name, ifs] : IniFiles)
+        ifs->FlushFile();
 }
 
 FILE_SERVICE::FILE_SERVICE()
 {
-    Files_Num = 0;
-    Max_File_Index = 0;
-    for (uint32_t n = 0; n < _MAX_OPEN_INI_FILES; n++)
-        OpenFiles[n] = nullptr;
+    IdleIniFilesSize = 0;
     if (ResourcePathsFirstScan)
         ScanResourcePaths();
 }
@@ -70,6 +64,21 @@ bool FILE_SERVICE::_DeleteFile(const char *filename)
     return std::filesystem::remove(path);
 }
 
+bool FILE_SERVICE::_RenameFile(const char *oldName, const char *newName)
+{
+    const auto oldPath = std::filesystem::u8path(ConvertPathResource(oldName));
+    const auto newPath = std::filesystem::u8path(ConvertPathResource(newName));
+    auto ec = std::error_code{};
+    std::filesystem::rename(oldPath, newPath, ec);
+    if (ec)
+    {
+        spdlog::error("Failed to rename {} to {}: {}", oldName, newName, ec.message());
+        return false;
+    }
+
+    return true;
+}
+
 bool FILE_SERVICE::_WriteFile(std::fstream &fileS, const void *s, std::streamsize count)
 {
     fileS.exceptions(std::fstream::failbit | std::fstream::badbit);
@@ -204,6 +213,12 @@ std::filesystem::file_time_type FILE_SERVICE::_GetLastWriteTime(const char *file
     return std::filesystem::last_write_time(path);
 }
 
+std::filesystem::file_time_type FILE_SERVICE::_GetLastWriteTime(const char *filename, std::error_code &ec)
+{
+    std::filesystem::path path = std::filesystem::u8path(ConvertPathResource(filename));
+    return std::filesystem::last_write_time(path, ec);
+}
+
 void FILE_SERVICE::_FlushFileBuffers(std::fstream &fileS)
 {
     fileS.flush();
@@ -271,86 +286,102 @@ std::unique_ptr<INIFILE> FILE_SERVICE::CreateIniFile(const char *file_name, bool
 
 std::unique_ptr<INIFILE> FILE_SERVICE::OpenIniFile(const char *file_name)
 {
-    for (auto n = 0; n <= Max_File_Index; n++)
-    {
-        if (OpenFiles[n] == nullptr || OpenFiles[n]->GetFileName() == nullptr)
-            continue;
-        if (storm::iEquals(OpenFiles[n]->GetFileName(), file_name))
-        {
-            OpenFiles[n]->IncReference();
-
-            auto v = std::make_unique<INIFILE_T>(OpenFiles[n]);
-            if (!v)
-                throw std::runtime_error("Failed to create INIFILE_T");
-            return v;
-        }
-    }
+    if (file_name == nullptr)
+        return nullptr;
 
-    for (auto n = 0; n < _MAX_OPEN_INI_FILES; n++)
+    if (const auto it = IniFiles.find(file_name); it != IniFiles.end())
     {
-        if (OpenFiles[n] != nullptr)
-            continue;
-
-        OpenFiles[n] = new IFS(this);
-        if (OpenFiles[n] == nullptr)
-            throw std::runtime_error("Failed to create IFS");
-        if (!OpenFiles[n]->LoadFile(file_name))
+        auto *ifs = it->second.get();
+        if (ifs->GetReference() == 0)
         {
-            delete OpenFiles[n];
-            OpenFiles[n] = nullptr;
-            return nullptr;
+            // closed before, parse it again only if the file was changed since
+            IdleIniFiles.remove(ifs);
+            IdleIniFilesSize -= ifs->GetMemoryUsage();
+            std::error_code ec;
+            const auto write_time = _GetLastWriteTime(file_name, ec);
+            if ((ec || write_time != ifs->WriteTime) && !ifs->Reload())
+            {
+                IniFiles.erase(it);
+                return nullptr;
+            }
         }
-        if (Max_File_Index < n)
-            Max_File_Index = n;
-        OpenFiles[n]->IncReference();
-        //        POP_CONTROL(0)
-        // INIFILE_T object belonged to entity and must be deleted by entity
-        // OpenFiles[n]->inifile_T = new INIFILE_T(OpenFiles[n]);
-        // if(OpenFiles[n]->inifile_T == null) throw std::runtime_error();
-        // return OpenFiles[n]->inifile_T;
-
-        auto v = std::make_unique<INIFILE_T>(OpenFiles[n]);
+        ifs->IncReference();
+
+        auto v = std::make_unique<INIFILE_T>(ifs);
         if (!v)
             throw std::runtime_error("Failed to create INIFILE_T");
         return v;
     }
-    //    POP_CONTROL(0)
-    ////UNGUARD
-    return nullptr;
+
+    auto ifs = std::make_unique<IFS>(this);
+    if (!ifs->LoadFile(file_name))
+        return nullptr;
+    ifs->IncReference();
+    // INIFILE_T object belonged to entity and must be deleted by entity
+    auto v = std::make_unique<INIFILE_T>(ifs.get());
+    if (!v)
+        throw std::runtime_error("Failed to create INIFILE_T");
+    IniFiles.emplace(file_name, std::move(ifs));
+    return v;
 }
 
 void FILE_SERVICE::RefDec(INIFILE *ini_obj)
 {
-    for (uint32_t n = 0; n <= Max_File_Index; n++)
+    // by pointer, the object may be gone after Close()
+    const auto it =
+        std::ranges::find_if(IniFiles, [ini_obj](const auto &file) { return file.second.get() == ini_obj; });
+    if (it == IniFiles.end())
+        throw std::runtime_error("bad inifile object");
+    auto *const ifs = it->second.get();
+    if (ifs->GetReference() == 0)
+        throw std::runtime_error("Reference error");
+    ifs->DecReference();
+    if (ifs->GetReference() == 0)
     {
-        if (OpenFiles[n] != ini_obj)
-            continue;
-        // OpenFiles[n]->SearchData = &OpenFiles[n]->Search;
-        if (OpenFiles[n]->GetReference() == 0)
-            throw std::runtime_error("Reference error");
-        OpenFiles[n]->DecReference();
-        if (OpenFiles[n]->GetReference() == 0)
-        {
-            delete OpenFiles[n];
-            OpenFiles[n] = nullptr;
-        }
-        return;
+        // write the changes now as before, the parsed data stays for the next OpenIniFile
+        ifs->FlushFile();
+        IdleIniFiles.push_front(ifs);
+        IdleIniFilesSize += ifs->GetMemoryUsage();
+        TrimIdleIniFiles();
     }
-    throw std::runtime_error("bad inifile object");
-    // UNGUARD
 }
 
-void FILE_SERVICE::Close()
+void FILE_SERVICE::TrimIdleIniFiles()
 {
-    for (uint32_t n = 0; n < _MAX_OPEN_INI_FILES; n++)
+    while (!IdleIniFiles.empty() &&
+           (IdleIniFiles.size() > MaxIdleIniFiles || IdleIniFilesSize > MaxIdleIniFilesSize))
     {
-        if (OpenFiles[n] == nullptr)
-            continue;
-        delete OpenFiles[n];
-        OpenFiles[n] = nullptr;
+        auto *const ifs = IdleIniFiles.back();
+        IdleIniFiles.pop_back();
+        IdleIniFilesSize -= ifs->GetMemoryUsage();
+        IniFiles.erase(ifs->GetFileName());
     }
 }
 
+void FILE_SERVICE::Close()
+{
+    IdleIniFiles.clear();
+    IdleIniFilesSize = 0;
+    IniFiles.clear();
+}
+
+uint32_t FILE_SERVICE::WatchFile(const char *file_name, std::function<void()> callback)
+{
+    if (file_name == nullptr)
+        return 0;
+    return Watcher.Watch(std::filesystem::u8path(ConvertPathResource(file_name)), std::move(callback));
+}
+
+void FILE_SERVICE::UnwatchFile(uint32_t id)
+{
+    Watcher.Unwatch(id);
+}
+
+void FILE_SERVICE::ProcessFileWatches()
+{
+    Watcher.Dispatch();
+}
+
 bool FILE_SERVICE::LoadFile(const char *file_name, char **ppBuffer, uint32_t *dwSize)
 {
     if (ppBuffer == nullptr)
@@ -10,342 +10,220 @@
 const char INI_LINEFEED[3] = {0xd, 0xa, 0};
 const char INI_VOIDSYMS[VOIDSYMS_NUM] = {0x20, 0x9};
 
-KEY_NODE::KEY_NODE()
-{
-    key_name = nullptr;
-    key_val = nullptr;
-    name_size = 0;
-    val_size = 0;
-    l_PTR = nullptr;
-    r_PTR = nullptr;
-    flags = 0;
-}
+// Smallest block for written strings
+constexpr size_t INI_STRING_BLOCK_SIZE = 4096;
+// Strings are repacked when more than a half of them and at least this size are dead
+constexpr size_t INI_MIN_DEAD_STRINGS_SIZE = 64 * 1024;
 
-KEY_NODE::~KEY_NODE()
+INI_SECTION::INI_SECTION(const char *name) : Name(name)
 {
-    delete[] key_name;
-    delete[] key_val;
-    // if(l_PTR) delete l_PTR;
-    // if(r_PTR) delete r_PTR;
 }
 
-void KEY_NODE::SetName(const char *name)
+const char *INI_SECTION::GetName() const
 {
-    if (name == nullptr)
-        return;
-    delete[] key_name;
-    key_name = nullptr;
-    name_size = strlen(name) + 1;
-
-    key_name = new char[name_size];
-    if (key_name == nullptr)
-        throw std::runtime_error("Failed to allocate memory");
-    strcpy_s(key_name, name_size, name);
-}
-
-void KEY_NODE::SetValue(const char *value)
-{
-    if (value == nullptr)
-        return;
-    delete[] key_val;
-    key_val = nullptr;
-    val_size = strlen(value) + 1;
-
-    key_val = new char[val_size];
-    if (key_val == nullptr)
-        throw std::runtime_error("Failed to allocate memory");
-    strcpy_s(key_val, val_size, value);
-}
-
-char *KEY_NODE::GetName()
-{
-    return key_name;
-}
-
-char *KEY_NODE::GetValue()
-{
-    return key_val;
-}
-
-KEY_NODE *KEY_NODE::GetLeftNode()
-{
-    return l_PTR;
-}
-
-KEY_NODE *KEY_NODE::GetRightNode()
-{
-    return r_PTR;
-}
-
-void KEY_NODE::SetLeftNode(KEY_NODE *node)
-{
-    l_PTR = node;
+    return Name;
 }
 
-void KEY_NODE::SetRightNode(KEY_NODE *node)
+const std::vector<INI_KEY> &INI_SECTION::GetKeys() const
 {
-    r_PTR = node;
+    return Keys;
 }
 
-void KEY_NODE::Add(KEY_NODE **Root, KEY_NODE **Top)
+uint32_t INI_SECTION::AddKey(const char *key_name, const char *key_value, uint32_t flags)
 {
-    if (*Root == nullptr)
+    const auto key = static_cast<uint32_t>(Keys.size());
+    Keys.push_back({key_name, key_value, flags, INI_NONE});
+    if (flags & KNF_KEY)
     {
-        // first node, root and top pointed to this node
-        *Root = this;
-        *Top = this;
-        return;
+        const auto [it, inserted] = Index.try_emplace(key_name, CHAIN{key, key});
+        if (!inserted)
+        {
+            Keys[it->second.last].next = key;
+            it->second.last = key;
+        }
     }
-    // attach node to the topmost node
-    (*Top)->SetRightNode(this);
-    // set node left link to previous top node
-    SetLeftNode(*Top);
-    // set new top node
-    *Top = this;
+    return key;
 }
 
-void KEY_NODE::AttachTo(KEY_NODE *node, KEY_NODE **Top)
+void INI_SECTION::DelKey(uint32_t key)
 {
-    if (node == nullptr)
-        throw std::runtime_error("invalid node");
-    // save right node for object
-    auto *RNode = node->GetRightNode();
-    // attach this node
-    node->SetRightNode(this);
-    // set left link for this node
-    SetLeftNode(node);
-    // set right link from previous node
-    SetRightNode(RNode);
-    // if there is node from the right - set left link for it
-    if (RNode != nullptr)
-        RNode->SetLeftNode(this);
-    // else this is new top node
-    else
-        *Top = this;
+    Keys.erase(Keys.begin() + key);
+    RebuildIndex();
 }
 
-void KEY_NODE::Deattach(KEY_NODE **Root, KEY_NODE **Top)
+void INI_SECTION::RebuildIndex()
 {
-    if (l_PTR)
-        l_PTR->SetRightNode(r_PTR);
-    if (r_PTR)
-        r_PTR->SetLeftNode(l_PTR);
-    if (*Root == this)
-        *Root = r_PTR;
-    if (*Top == this)
-        *Top = l_PTR;
-}
-
-uint32_t KEY_NODE::SetFlags(uint32_t _flags)
-{
-    flags = flags | _flags;
-    return flags;
-}
-
-//=============================================================================================================
-
-SECTION::SECTION()
-{
-    Root = nullptr;
-    Top = nullptr;
-    Name = nullptr;
-    l_PTR = nullptr;
-    r_PTR = nullptr;
-}
-
-SECTION::~SECTION()
-{
-    while (Root)
-    {
-        auto *const old_root = Root;
-        Root->Deattach(&Root, &Top);
-        delete old_root;
-    }
-    delete[] Name;
-}
-
-void SECTION::SetName(const char *name)
-{
-    delete[] Name;
-    if (name == nullptr)
+    Index.clear();
+    for (uint32_t n = 0; n < Keys.size(); n++)
     {
-        Name = nullptr;
-    }
-    else
-    {
-        const auto len = strlen(name) + 1;
-        Name = new char[len];
-        if (Name == nullptr)
-            throw std::runtime_error("Failed to allocate memory");
-        strcpy_s(Name, len, name);
+        auto &key = Keys[n];
+        key.next = INI_NONE;
+        if ((key.flags & KNF_KEY) == 0)
+            continue;
+        const auto [it, inserted] = Index.try_emplace(key.name, CHAIN{n, n});
+        if (!inserted)
+        {
+            Keys[it->second.last].next = n;
+            it->second.last = n;
+        }
     }
 }
 
-char *SECTION::GetName()
+uint32_t INI_SECTION::FindKey(const char *key_name, const char *key_value) const
 {
-    return Name;
-}
+    if (key_name == nullptr)
+        return INI_NONE;
 
-KEY_NODE *SECTION::AddNode()
-{
-    auto *node = new KEY_NODE;
-    if (node == nullptr)
-        throw std::runtime_error("node creation error");
-    node->Add(&Root, &Top);
-    return node;
-}
+    const auto it = Index.find(key_name);
+    if (it == Index.end())
+        return INI_NONE;
+    if (key_value == nullptr)
+        return it->second.first;
 
-void SECTION::DelNode(KEY_NODE *_node)
-{
-    auto *node = Root;
-    while (node)
+    for (auto key = it->second.first; key != INI_NONE; key = Keys[key].next)
     {
-        if (node == _node)
-        {
-            node->Deattach(&Root, &Top);
-            delete node;
-            return;
-        }
-        node = node->GetRightNode();
+        if (Keys[key].value != nullptr && storm::iEquals(key_value, Keys[key].value))
+            return key;
     }
+    return INI_NONE;
 }
 
-KEY_NODE *SECTION::FindKey(KEY_NODE *from, const char *key_name, const char *key_value)
+uint32_t INI_SECTION::FindNextKey(uint32_t key, const char *key_name) const
 {
-    KEY_NODE *node;
+    if (key >= Keys.size() || key_name == nullptr)
+        return INI_NONE;
 
-    if (Root == nullptr)
-        return nullptr;
+    // usual case, going through the keys with the same name
+    if ((Keys[key].flags & KNF_KEY) && storm::iEquals(key_name, Keys[key].name))
+        return Keys[key].next;
 
-    if (key_name == nullptr)
-        return nullptr;
-
-    if (from == nullptr)
-        node = Root;
-    else
-        node = from;
-
-    while (node)
+    const auto it = Index.find(key_name);
+    if (it == Index.end())
+        return INI_NONE;
+    for (auto next = it->second.first; next != INI_NONE; next = Keys[next].next)
     {
-        const auto flags = node->SetFlags(0);
-        if (flags & KNF_KEY)
-        {
-            if (storm::iEquals(key_name, node->GetName()))
-            {
-                if (key_value == nullptr)
-                    return node;
-
-                auto *const char_PTR = node->GetValue();
-                if (char_PTR != nullptr)
-                {
-                    if (storm::iEquals(key_value, char_PTR))
-                        return node;
-                }
-            }
-        }
-        node = node->GetRightNode();
+        if (next > key)
+            return next;
     }
-    return nullptr;
+    return INI_NONE;
 }
 
-KEY_NODE *SECTION::FindKey(const char *key_name, const char *key_value)
+//=============================================================================================================
+
+IFS::IFS(FILE_SERVICE *_fs)
 {
-    return FindKey(Root, key_name, key_value);
+    fs = _fs;
+    bDataChanged = false;
+    Reference = 0;
+    SectionSNode = INI_NONE;
+    StringFree = nullptr;
+    StringFreeSize = 0;
+    StringsSize = 0;
+    DeadStringsSize = 0;
 }
 
-KEY_NODE *SECTION::FindKey(const char *key_name)
+IFS::~IFS()
 {
-    return FindKey(Root, key_name, nullptr);
+    FlushFile();
 }
 
-SECTION *SECTION::GetLeftNode()
+void IFS::Clear()
 {
-    return l_PTR;
+    Sections.clear();
+    SectionIndex.clear();
+    StringBlocks.clear();
+    StringFree = nullptr;
+    StringFreeSize = 0;
+    StringsSize = 0;
+    DeadStringsSize = 0;
+    SectionSNode = INI_NONE;
 }
 
-SECTION *SECTION::GetRightNode()
+void IFS::IncReference()
 {
-    return r_PTR;
+    Reference++;
 }
 
-void SECTION::SetLeftNode(SECTION *node)
+void IFS::DecReference()
 {
-    l_PTR = node;
+    Reference--;
 }
 
-void SECTION::SetRightNode(SECTION *node)
+int32_t IFS::GetReference()
 {
-    r_PTR = node;
+    return Reference;
 }
 
-void SECTION::Add(SECTION **SRoot, SECTION **STop)
+size_t IFS::GetMemoryUsage() const
 {
-    if (*SRoot == nullptr)
+    auto size = sizeof(IFS) + StringsSize + Sections.capacity() * sizeof(INI_SECTION);
+    for (const auto &section : Sections)
     {
-        *SRoot = this;
-        *STop = this;
-        return;
+        size += section.Keys.capacity() * sizeof(INI_KEY);
+        size += section.Index.size() * (sizeof(std::string_view) + sizeof(INI_SECTION::CHAIN) + 2 * sizeof(void *));
     }
-    (*STop)->SetRightNode(this);
-    SetLeftNode(*STop);
-    *STop = this;
+    return size;
 }
 
-void SECTION::Deattach(SECTION **SRoot, SECTION **STop)
+const char *IFS::StoreString(const char *str)
 {
-    if (l_PTR)
-        l_PTR->SetRightNode(r_PTR);
-    if (r_PTR)
-        r_PTR->SetLeftNode(l_PTR);
-    if (*SRoot == this)
-        *SRoot = r_PTR;
-    if (*STop == this)
-        *STop = l_PTR;
+    const auto size = strlen(str) + 1;
+    if (size > StringFreeSize)
+    {
+        const auto block_size = std::max(size, INI_STRING_BLOCK_SIZE);
+        StringBlocks.push_back(std::make_unique<char[]>(block_size));
+        StringFree = StringBlocks.back().get();
+        StringFreeSize = block_size;
+        StringsSize += block_size;
+    }
+    auto *const result = StringFree;
+    memcpy(result, str, size);
+    StringFree += size;
+    StringFreeSize -= size;
+    return result;
 }
 
-KEY_NODE *SECTION::GetRoot()
+void IFS::ReleaseString(const char *str)
 {
-    return Root;
+    if (str != nullptr)
+        DeadStringsSize += strlen(str) + 1;
 }
 
-//=============================================================================================================
-
-IFS::IFS(FILE_SERVICE *_fs)
+void IFS::CollectStrings()
 {
-    fs = _fs;
-    FileName = nullptr;
-    bDataChanged = false;
-    Reference = 0;
-    SectionRoot = nullptr;
-    SectionTop = nullptr;
-    SectionSNode = nullptr;
-}
+    if (DeadStringsSize < INI_MIN_DEAD_STRINGS_SIZE || DeadStringsSize * 2 < StringsSize)
+        return;
 
-IFS::~IFS()
-{
-    FlushFile();
-    delete FileName;
-    while (SectionRoot)
+    // move the live strings to a single new block
+    auto blocks = std::move(StringBlocks);
+    StringBlocks.clear();
+    StringFree = nullptr;
+    StringFreeSize = 0;
+    StringsSize = 0;
+    DeadStringsSize = 0;
+    for (auto &section : Sections)
     {
-        auto *const old_root = SectionRoot;
-        SectionRoot->Deattach(&SectionRoot, &SectionTop);
-        delete old_root;
+        if (section.Name != nullptr)
+            section.Name = StoreString(section.Name);
+        for (auto &key : section.Keys)
+        {
+            key.name = StoreString(key.name);
+            if (key.value != nullptr)
+                key.value = StoreString(key.value);
+        }
+        section.RebuildIndex();
     }
+    RebuildSectionIndex();
 }
 
-void IFS::IncReference()
-{
-    Reference++;
-}
-
-void IFS::DecReference()
+void IFS::RebuildSectionIndex()
 {
-    Reference--;
-}
-
-int32_t IFS::GetReference()
-{
-    return Reference;
+    SectionIndex.clear();
+    for (uint32_t n = 0; n < Sections.size(); n++)
+    {
+        if (Sections[n].Name != nullptr)
+            SectionIndex.try_emplace(Sections[n].Name, n);
+    }
 }
 
 bool IFS::VoidSym(char symbol)
@@ -371,40 +249,30 @@ bool IFS::LoadFile(const char *_file_name)
         return false;
     }
 
+    // taken before reading, so a change made meanwhile isn't missed by the cache
+    std::error_code ec;
+    WriteTime = fs->_GetLastWriteTime(_file_name, ec);
+
     const auto file_size = fs->_GetFileSize(_file_name);
 
-    auto *const file_data = new char[file_size + 1]; // +1 for zero at the end
-    if (file_data == nullptr)
-    {
-        fs->_CloseFile(fileS);
-        return false;
-    }
+    // the file text is kept, names and values point into it
+    auto file_data = std::make_unique<char[]>(file_size + 1); // +1 for zero at the end
     file_data[file_size] = 0;
 
-    if (!fs->_ReadFile(fileS, file_data, file_size))
+    if (!fs->_ReadFile(fileS, file_data.get(), file_size))
     {
-        delete[] file_data;
         fs->_CloseFile(fileS);
         return false;
     }
 
     fs->_CloseFile(fileS);
 
-    const uint32_t name_size = strlen(_file_name) + 1;
-
-    FileName = new char[name_size];
-
-    if (FileName == nullptr)
-    {
-        delete[] file_data;
-        fs->_CloseFile(fileS);
-        return false;
-    }
-    strcpy_s(FileName, name_size, _file_name);
+    FileName = _file_name;
 
-    Format(file_data, file_size + 1);
+    Format(file_data.get(), file_size + 1);
 
-    delete[] file_data;
+    StringBlocks.push_back(std::move(file_data));
+    StringsSize += file_size + 1;
 
     return true;
 }
@@ -415,21 +283,16 @@ void IFS::Format(char *file_data, int32_t file_size)
     int32_t backcount;
     int32_t forecount;
 
-    auto *Current_Section = new SECTION;
-    Current_Section->Add(&SectionRoot, &SectionTop);
+    Sections.emplace_back(nullptr);
+    auto *Current_Section = &Sections.back();
 
     char *data_PTR = nullptr;
-    int32_t lines = 0;
 
     // terminate each line by zero symbol
     for (n = 0; n < file_size; n++)
     {
         if (file_data[n] == INI_LINEFEED[0] || file_data[n] == INI_LINEFEED[1] || file_data[n] == INI_LINEFEED[2])
-        {
             file_data[n] = 0;
-            if (n > 0 && file_data[n - 1] != 0)
-                lines++;
-        }
     }
 
     int32_t offset = 0;
@@ -460,35 +323,25 @@ void IFS::Format(char *file_data, int32_t file_size)
                     if (data_PTR[z] == SECTION_B)
                     {
                         data_PTR[z] = 0;
-                        // node->SetName(&data_PTR[i+1]);
-                        // node->SetFlags(KNF_SECTION);
-
-                        Current_Section = new SECTION;
-                        Current_Section->Add(&SectionRoot, &SectionTop);
-                        Current_Section->SetName(&data_PTR[i + 1]);
+                        SectionIndex.try_emplace(&data_PTR[i + 1], static_cast<uint32_t>(Sections.size()));
+                        Sections.emplace_back(&data_PTR[i + 1]);
+                        Current_Section = &Sections.back();
                         break;
                     }
                 }
                 break;
             }
 
-            auto *node = Current_Section->AddNode();
-            // node = new KEY_NODE;
-            // if(node == 0) throw std::runtime_error("node creation error");
-            // node->Add(&Root,&Top);
-
             if (data_PTR[i] == COMMENT)
             {
                 // add as commentary
-                node->SetName(&data_PTR[i]);
-                node->SetFlags(KNF_COMMENTARY);
+                Current_Section->AddKey(&data_PTR[i], nullptr, KNF_COMMENTARY);
                 break;
             }
 
-            auto keyname_set = false;
-
             // this is real key
-            node->SetFlags(KNF_KEY);
+            const char *key_name = nullptr;
+            const char *key_value = nullptr;
 
             for (z = 0; data_PTR[z]; z++)
             {
@@ -502,8 +355,7 @@ void IFS::Format(char *file_data, int32_t file_size)
                         else
                             break;
                     }
-                    node->SetName(&data_PTR[i]); // set key name
-                    keyname_set = true;
+                    key_name = &data_PTR[i];
 
                     auto keyval_found = false;
                     z++;
@@ -525,14 +377,13 @@ void IFS::Format(char *file_data, int32_t file_size)
                             break;
                     }
                     if (keyval_found)
-                    {
-                        node->SetValue(&data_PTR[z]);
-                    }
+                        key_value = &data_PTR[z];
                     break;
                 }
             }
-            if (!keyname_set)
-                node->SetName(&data_PTR[i]); // key without value
+            if (key_name == nullptr)
+                key_name = &data_PTR[i]; // key without value
+            Current_Section->AddKey(key_name, key_value, KNF_KEY);
             break;
         }
     }
@@ -549,20 +400,17 @@ bool IFS::FlushFile()
         return true;
     }
 
-    fs->_DeleteFile(FileName);
-    auto fileS = fio->_CreateFile(FileName, std::ios::binary | std::ios::out);
+    fs->_DeleteFile(FileName.c_str());
+    auto fileS = fs->_CreateFile(FileName.c_str(), std::ios::binary | std::ios::out);
     if (!fileS.is_open())
     {
         /*trace("file: (%s)",FileName);*/
         throw std::runtime_error("cant create file");
     }
 
-    // node = Root;
-
-    auto *section_node = SectionRoot;
-    while (section_node)
+    for (const auto &section_node : Sections)
     {
-        if (section_node->GetName() != nullptr)
+        if (section_node.GetName() != nullptr)
         {
             // write section name -----------------------------------------------------------------
             buff[0] = SECTION_A;
@@ -571,8 +419,8 @@ bool IFS::FlushFile()
                 throw std::runtime_error("Failed to write to file");
             }
 
-            write_size = strlen(section_node->GetName());
-            if (!fs->_WriteFile(fileS, section_node->GetName(), write_size))
+            write_size = strlen(section_node.GetName());
+            if (!fs->_WriteFile(fileS, section_node.GetName(), write_size))
             {
                 throw std::runtime_error("Failed to write to file");
             }
@@ -591,15 +439,13 @@ bool IFS::FlushFile()
             }
         }
 
-        auto *node = section_node->GetRoot();
-        while (node)
+        for (const auto &node : section_node.GetKeys())
         {
-            const auto flags = node->SetFlags(0);
-            if (flags & KNF_COMMENTARY)
+            if (node.flags & KNF_COMMENTARY)
             {
                 // write commented line ---------------------------------------------------------------
-                write_size = strlen(node->GetName());
-                if (!fs->_WriteFile(fileS, node->GetName(), write_size))
+                write_size = strlen(node.name);
+                if (!fs->_WriteFile(fileS, node.name, write_size))
                 {
                     throw std::runtime_error("Failed to write to file");
                 }
@@ -610,15 +456,15 @@ bool IFS::FlushFile()
                     throw std::runtime_error("Failed to write to file");
                 }
             }
-            else if (flags & KNF_KEY)
+            else if (node.flags & KNF_KEY)
             {
                 // write key -------------------------------------------------------------------------
-                write_size = strlen(node->GetName());
-                if (!fs->_WriteFile(fileS, node->GetName(), write_size))
+                write_size = strlen(node.name);
+                if (!fs->_WriteFile(fileS, node.name, write_size))
                 {
                     throw std::runtime_error("Failed to write to file");
                 }
-                if (node->GetValue() != nullptr)
+                if (node.value != nullptr)
                 {
                     if (!fs->_WriteFile(fileS, &INI_VOIDSYMS[0], 1))
                     {
@@ -633,8 +479,8 @@ bool IFS::FlushFile()
                     {
                         throw std::runtime_error("Failed to write to file");
                     }
-                    write_size = strlen(node->GetValue());
-                    if (!fs->_WriteFile(fileS, node->GetValue(), write_size))
+                    write_size = strlen(node.value);
+                    if (!fs->_WriteFile(fileS, node.value, write_size))
                     {
                         throw std::runtime_error("Failed to write to file");
                     }
@@ -650,9 +496,7 @@ bool IFS::FlushFile()
             {
                 throw std::runtime_error("invalid key flag");
             }
-            node = node->GetRightNode();
         }
-        section_node = section_node->GetRightNode();
 
         buff[0] = INI_LINEFEED[0];
         buff[1] = INI_LINEFEED[1];
@@ -664,148 +508,111 @@ bool IFS::FlushFile()
 
     fs->_CloseFile(fileS);
 
+    // the file matches the data now, the cache of parsed files may keep it
+    bDataChanged = false;
+    std::error_code ec;
+    WriteTime = fs->_GetLastWriteTime(FileName.c_str(), ec);
+
     // UNGUARD
     return false;
 }
 
-KEY_NODE *IFS::FindKey(const char *section_name, const char *key_name)
+uint32_t IFS::FindKey(const char *section_name, const char *key_name)
 {
     return FindKey(section_name, key_name, nullptr);
 }
 
-KEY_NODE *IFS::FindKey(const char *section_name, const char *key_name, const char *key_value)
+uint32_t IFS::FindKey(const char *section_name, const char *key_name, const char *key_value)
 {
-    if (SectionRoot == nullptr)
-        return nullptr;
-    auto *snode = FindSection(section_name);
-    if (snode == nullptr)
-        return nullptr;
-    return snode->FindKey(key_name, key_value);
-
-    // return FindKey(0,section_name,key_name,key_value);
+    const auto snode = FindSection(section_name);
+    if (snode == INI_NONE)
+        return INI_NONE;
+    return Sections[snode].FindKey(key_name, key_value);
 }
 
-/*KEY_NODE * IFS::FindKey(KEY_NODE * from, char * section_name, char * key_name, char * key_value)
+uint32_t IFS::FindSection(const char *section_name)
 {
-    SECTION * snode;
-    if(SectionRoot == 0) return false;
-    snode = FindSection(section_name);
-    if(snode == 0) return false;
-    return snode->FindKey(from,key_name,key_value);
-}*/
-
-SECTION *IFS::FindSection(const char *section_name)
-{
-    if (SectionRoot == nullptr)
-        return nullptr;
-    auto *node = SectionRoot;
-
-    while (node)
+    if (section_name == nullptr)
     {
-        if (section_name == nullptr)
-        {
-            if (node->GetName() == nullptr)
-                return node;
-            return nullptr;
-        }
-        if (node->GetName() != nullptr)
-            if (storm::iEquals(section_name, node->GetName()))
-                return node;
-        node = node->GetRightNode();
+        if (!Sections.empty() && Sections.front().GetName() == nullptr)
+            return 0;
+        return INI_NONE;
     }
-    return nullptr;
+
+    const auto it = SectionIndex.find(section_name);
+    if (it == SectionIndex.end())
+        return INI_NONE;
+    return it->second;
 }
 
-SECTION *IFS::FindSection(const char *section_name, SECTION *snode)
+uint32_t IFS::FindSection(const char *section_name, uint32_t snode)
 {
-    if (SectionRoot == nullptr)
-        return nullptr;
-
-    // atempt to search by section node pointer
-    auto *node = SectionRoot;
-    while (node)
+    // atempt to search by section index
+    if (snode < Sections.size())
     {
-        if (node == snode)
+        // if node exist and name is correct return ok
+        const auto *name = Sections[snode].GetName();
+        if (section_name != nullptr)
         {
-            // if node exist and name is correct return ok
-            if (section_name != nullptr)
-            {
-                if (storm::iEquals(section_name, node->GetName()))
-                    return node;
-            }
-            else
-            {
-                if (node->GetName() == nullptr)
-                    return node;
-            }
-            break;
+            if (name != nullptr && storm::iEquals(section_name, name))
+                return snode;
         }
-
-        node = node->GetRightNode();
-    }
-
-    // full search by name
-    node = SectionRoot;
-    while (node)
-    {
-        if (section_name == nullptr)
+        else
         {
-            if (node->GetName() == nullptr)
-                return node;
+            if (name == nullptr)
+                return snode;
         }
-        if (node->GetName() != nullptr)
-            if (storm::iEquals(section_name, node->GetName()))
-                return node;
-        node = node->GetRightNode();
     }
-    return nullptr;
+
+    return FindSection(section_name);
 }
 
-SECTION *IFS::CreateSection(const char *section_name)
+uint32_t IFS::CreateSection(const char *section_name)
 {
-    auto *node = FindSection(section_name);
-    if (node)
+    const auto node = FindSection(section_name);
+    if (node != INI_NONE)
         return node;
 
-    node = new SECTION;
-    if (node == nullptr)
-        throw std::runtime_error("section creation error");
-    node->Add(&SectionRoot, &SectionTop);
-    node->SetName(section_name);
+    const auto *name = section_name ? StoreString(section_name) : nullptr;
+    const auto section = static_cast<uint32_t>(Sections.size());
+    Sections.emplace_back(name);
+    if (name != nullptr)
+        SectionIndex.try_emplace(name, section);
     bDataChanged = true;
-    return node;
+    return section;
 }
 
 void IFS::DeleteSection(const char *section_name)
 {
-    auto *node = FindSection(section_name);
-    if (!node)
+    const auto node = FindSection(section_name);
+    if (node == INI_NONE)
         return;
-    if (SectionSNode == node)
+
+    // iteration goes on from the section after the deleted one
+    if (SectionSNode != INI_NONE && SectionSNode > node)
+        SectionSNode--;
+
+    auto &section = Sections[node];
+    ReleaseString(section.Name);
+    for (const auto &key : section.Keys)
     {
-        SectionSNode = SectionSNode->GetRightNode();
+        ReleaseString(key.name);
+        ReleaseString(key.value);
     }
-    node->Deattach(&SectionRoot, &SectionTop);
-    delete node;
+    Sections.erase(Sections.begin() + node);
+    RebuildSectionIndex();
     bDataChanged = true;
+    CollectStrings();
 }
 
 bool IFS::TestSection(const char *section_name)
 {
-    auto *const node = FindSection(section_name);
-    if (node)
-        return true;
-    return false;
+    return FindSection(section_name) != INI_NONE;
 }
 
 bool IFS::TestKey(const char *section_name, const char *key_name, const char *key_value)
 {
-    auto *node = FindSection(section_name);
-    if (node == nullptr)
-        return false;
-    if (node->FindKey(key_name, key_value) != nullptr)
-        return true;
-    return false;
+    return FindKey(section_name, key_name, key_value) != INI_NONE;
 }
 
 void IFS::DeleteKey(const char *section_name, const char *key_name)
@@ -815,15 +622,19 @@ void IFS::DeleteKey(const char *section_name, const char *key_name)
 
 void IFS::DeleteKey(const char *section_name, const char *key_name, const char *key_value)
 {
-    auto *node = FindSection(section_name);
-    if (node)
+    const auto node = FindSection(section_name);
+    if (node == INI_NONE)
+        return;
+
+    auto &section = Sections[node];
+    const auto knode = section.FindKey(key_name, key_value);
+    if (knode != INI_NONE)
     {
-        auto *const knode = node->FindKey(key_name, key_value);
-        if (knode)
-        {
-            node->DelNode(knode);
-            bDataChanged = true;
-        }
+        ReleaseString(section.Keys[knode].name);
+        ReleaseString(section.Keys[knode].value);
+        section.DelKey(knode);
+        bDataChanged = true;
+        CollectStrings();
     }
 }
 
@@ -836,11 +647,12 @@ void IFS::ReadString(SEARCH_DATA *sd, const char *section_name, const char *key_
 bool IFS::ReadString(SEARCH_DATA *sd, const char *section_name, const char *key_name, char *buffer,
                      uint32_t buffer_size, const char *def_string)
 {
-    auto *node = FindKey(section_name, key_name);
-    if (node == nullptr)
+    const auto snode = FindSection(section_name);
+    const auto node = snode != INI_NONE ? Sections[snode].FindKey(key_name, nullptr) : INI_NONE;
+    if (node == INI_NONE)
     {
-        sd->Key = nullptr;
-        sd->Section = nullptr;
+        sd->Key = INI_NONE;
+        sd->Section = INI_NONE;
         if (def_string == nullptr)
         {
             core_internal.Trace("Warning! IniFile Read String: section=%s, key=%s", section_name, key_name);
@@ -854,11 +666,11 @@ bool IFS::ReadString(SEARCH_DATA *sd, const char *section_name, const char *key_
     }
 
     sd->Key = node;
-    sd->Section = FindSection(section_name);
+    sd->Section = snode;
 
     if (buffer == nullptr)
         throw std::runtime_error("zero buffer");
-    auto *const char_PTR = node->GetValue();
+    const auto *const char_PTR = Sections[snode].Keys[node].value;
     if (char_PTR == nullptr)
     {
         if (def_string == nullptr)
@@ -867,60 +679,49 @@ bool IFS::ReadString(SEARCH_DATA *sd, const char *section_name, const char *key_
         return false;
     }
 
-    uint32_t write_size = strlen(char_PTR) + 1;
     // commented out because it didn't let to load new ani
     // if(write_size > buffer_size) throw std::runtime_error(buffer size too small);
 
-    strcpy_s(buffer, buffer_size, node->GetValue());
+    strcpy_s(buffer, buffer_size, char_PTR);
     return true;
 }
 
 bool IFS::ReadStringNext(SEARCH_DATA *sd, const char *section_name, const char *key_name, char *buffer,
                          uint32_t buffer_size)
 {
-    auto *snode = FindSection(section_name, sd->Section);
-    // snode = sd->Section;
-    if (snode == nullptr)
+    const auto snode = FindSection(section_name, sd->Section);
+    if (snode == INI_NONE)
         return false;
 
-    auto start = false;
-    auto *node = snode->GetRoot();
-    // node = sd->Key;
-    while (node)
+    // the previous key has to be from the same section
+    const auto node = sd->Section == snode ? Sections[snode].FindNextKey(sd->Key, key_name) : INI_NONE;
+    if (node == INI_NONE)
     {
-        if (start == true)
-        {
-            // if(CompareStrings(node->GetName(),key_name) == 0)
-            if (storm::iEquals(node->GetName(), key_name))
-            {
-                if (buffer == nullptr)
-                    throw std::runtime_error("zero buffer");
+        sd->Key = INI_NONE;
+        sd->Section = INI_NONE;
+        return false;
+    }
 
-                auto *const char_PTR = node->GetValue();
-                if (char_PTR == nullptr)
-                {
-                    buffer[0] = 0;
-                    return true;
-                    // throw std::runtime_error(no key value);
-                }
+    if (buffer == nullptr)
+        throw std::runtime_error("zero buffer");
 
-                const uint32_t write_size = strlen(char_PTR) + 1;
-                if (write_size > buffer_size)
-                    throw std::runtime_error("buffer size too small");
+    sd->Key = node;
+    sd->Section = snode;
 
-                strcpy_s(buffer, buffer_size, node->GetValue());
-                sd->Key = node;
-                sd->Section = snode;
-                return true;
-            }
-        }
-        if (sd->Key == node)
-            start = true;
-        node = node->GetRightNode();
+    const auto *const char_PTR = Sections[snode].Keys[node].value;
+    if (char_PTR == nullptr)
+    {
+        buffer[0] = 0;
+        return true;
+        // throw std::runtime_error(no key value);
     }
-    sd->Key = nullptr;
-    sd->Section = nullptr;
-    return false;
+
+    const uint32_t write_size = strlen(char_PTR) + 1;
+    if (write_size > buffer_size)
+        throw std::runtime_error("buffer size too small");
+
+    strcpy_s(buffer, buffer_size, char_PTR);
+    return true;
 }
 
 int32_t IFS::GetInt(SEARCH_DATA *sd, const char *section_name, const char *key_name)
@@ -1001,22 +802,14 @@ bool IFS::GetFloatNext(SEARCH_DATA *sd, const char *section_name, const char *ke
     return false;
 }
 
+
 void IFS::AddString(const char *section_name, const char *key_name, const char *string)
 {
     if (key_name == nullptr)
         throw std::runtime_error("zero key");
-    auto *snode = FindSection(section_name);
-    if (snode == nullptr)
-        CreateSection(section_name);
-    snode = FindSection(section_name);
-    if (snode == nullptr)
-        throw std::runtime_error("section create error");
-
-    auto *node = snode->AddNode();
-    node->SetName(key_name);
-    if (string)
-        node->SetValue(string);
-    node->SetFlags(KNF_KEY);
+    const auto snode = CreateSection(section_name);
+
+    Sections[snode].AddKey(StoreString(key_name), string ? StoreString(string) : nullptr, KNF_KEY);
     bDataChanged = true;
 }
 
@@ -1025,16 +818,20 @@ void IFS::WriteString(const char *section_name, const char *key_name, const char
     if (string == nullptr)
         throw std::runtime_error("zero key value");
 
-    auto *snode = CreateSection(section_name);
-    // do not free it. it gets linked to root node
-    if (snode == nullptr)
-        throw std::runtime_error("section create error");
-    auto *node = snode->FindKey(key_name);
-    if (node != nullptr)
+    const auto snode = CreateSection(section_name);
+    auto &section = Sections[snode];
+    const auto node = section.FindKey(key_name, nullptr);
+    if (node != INI_NONE)
     {
-        node->SetValue(string);
+        auto &key = section.Keys[node];
+        if (key.value == nullptr || strcmp(key.value, string) != 0)
+        {
+            ReleaseString(key.value);
+            key.value = StoreString(string);
+        }
         bDataChanged = true;
-        return; //-V773
+        CollectStrings();
+        return;
     }
     AddString(section_name, key_name, string);
 }
@@ -1076,50 +873,42 @@ uint32_t IFS::CompareStrings(const char *s1, const char *s2)
 
 bool IFS::GetSectionName(char *section_name_buffer, int32_t buffer_size)
 {
-    if (SectionRoot == nullptr)
-        return false;
-    auto *node = SectionRoot;
-    node = node->GetRightNode(); // skip zero section (unnamed)
-    if (node == nullptr)
+    // skip zero section (unnamed)
+    if (Sections.size() < 2)
         return false;
 
     if (section_name_buffer == nullptr)
         throw std::runtime_error("zero buffer");
-    const int32_t len = strlen(node->GetName());
+    const auto *name = Sections[1].GetName();
+    const int32_t len = strlen(name);
     if (len > buffer_size)
         throw std::runtime_error("buffer too small");
-    strcpy_s(section_name_buffer, buffer_size, node->GetName());
-    SectionSNode = node;
+    strcpy_s(section_name_buffer, buffer_size, name);
+    SectionSNode = 1;
     return true;
 }
 
 bool IFS::GetSectionNameNext(char *section_name_buffer, int32_t buffer_size)
 {
-    if (SectionRoot == nullptr)
+    if (Sections.empty())
         return false;
     if (section_name_buffer == nullptr)
         throw std::runtime_error("zero buffer");
-    auto *node = SectionRoot;
-    while (node)
+    if (SectionSNode == INI_NONE)
+        return false;
+    if (SectionSNode + 1 >= Sections.size())
     {
-        if (node == SectionSNode)
-        {
-            node = node->GetRightNode();
-            if (node == nullptr)
-            {
-                SectionSNode = nullptr;
-                return false;
-            }
-            const int32_t len = strlen(node->GetName());
-            if (len > buffer_size)
-                throw std::runtime_error("buffer too small");
-            strcpy_s(section_name_buffer, buffer_size, node->GetName());
-            SectionSNode = node;
-            return true;
-        }
-        node = node->GetRightNode();
+        SectionSNode = INI_NONE;
+        return false;
     }
-    return false;
+
+    const auto *name = Sections[SectionSNode + 1].GetName();
+    const int32_t len = strlen(name);
+    if (len > buffer_size)
+        throw std::runtime_error("buffer too small");
+    strcpy_s(section_name_buffer, buffer_size, name);
+    SectionSNode++;
+    return true;
 }
 
 void IFS::Flush()
@@ -1129,18 +918,11 @@ void IFS::Flush()
 
 bool IFS::Reload()
 {
-    while (SectionRoot)
-    {
-        auto *const old_root = SectionRoot;
-        SectionRoot->Deattach(&SectionRoot, &SectionTop);
-        delete old_root;
-    }
+    Clear();
     bDataChanged = false;
     // Reference = 0;
-    SectionRoot = nullptr;
-    SectionTop = nullptr;
-    SectionSNode = nullptr;
-    return LoadFile(FileName);
+    const auto file_name = FileName;
+    return LoadFile(file_name.c_str());
 }
 
 namespace {
@@ -1241,14 +1023,13 @@ storm::Data IFS::ToData()
 {
     storm::Data result;
 
-    auto *section_node = SectionRoot;
-    while (section_node)
+    for (const auto &section_node : Sections)
     {
         auto &section = ([&]() -> storm::Data& {
-            const bool in_section = section_node->GetName() != nullptr;
+            const bool in_section = section_node.GetName() != nullptr;
             if (in_section)
             {
-                const auto section_name = std::string(section_node->GetName());
+                const auto section_name = std::string(section_node.GetName());
                 if (result.contains(section_name) && !result[section_name].is_object() ) {
                     result.erase(section_name);
                 }
@@ -1260,21 +1041,17 @@ storm::Data IFS::ToData()
                 return result;
             }
         })();
-        auto *node = section_node->GetRoot();
-        while (node)
+        for (const auto &node : section_node.GetKeys())
         {
-            const auto flags = node->SetFlags(0);
-            if (flags & KNF_KEY)
+            if (node.flags & KNF_KEY)
             {
-                if (node->GetValue() != nullptr)
+                if (node.value != nullptr)
                 {
-                    const auto str = std::string(node->GetValue());
-                    section.emplace(node->GetName(), parseValue(str) );
+                    const auto str = std::string(node.value);
+                    section.emplace(node.name, parseValue(str) );
                 }
             }
-            node = node->GetRightNode();
         }
-        section_node = section_node->GetRightNode();
     }
 
     return result;
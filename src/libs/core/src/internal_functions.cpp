@@ -1713,8 +1713,7 @@ DATA *COMPILER::BC_CallIntFunction(uint32_t func_code, DATA *&pVResult, uint32_t
             return pResult;
         case 's':
             pResult = SStack.Push();
-            Message_string = pEventMessage->String();
-            pResult->Set(Message_string.c_str());
+            pResult->Set(pEventMessage->String());
             pVResult = pResult;
             return pResult;
         case 'i':
@@ -12,121 +12,121 @@ void MESSAGE::Move2Start()
 uint8_t MESSAGE::Byte()
 {
     ValidateFormat('b');
-    return get<uint8_t>(params_[index - 1]);
+    return get<uint8_t>(GetParam(index - 1));
 }
 
 uint16_t MESSAGE::Word()
 {
     ValidateFormat('w');
-    return get<uint16_t>(params_[index - 1]);
+    return get<uint16_t>(GetParam(index - 1));
 }
 
 int32_t MESSAGE::Long()
 {
     ValidateFormat('l');
-    return get<int32_t>(params_[index - 1]);
+    return get<int32_t>(GetParam(index - 1));
 }
 
 int32_t MESSAGE::Dword()
 {
     ValidateFormat('u');
-    return static_cast<int32_t>(get<uint32_t>(params_[index - 1]));
+    return static_cast<int32_t>(get<uint32_t>(GetParam(index - 1)));
 }
 
 float MESSAGE::Float()
 {
     ValidateFormat('f');
-    return get<float>(params_[index - 1]);
+    return get<float>(GetParam(index - 1));
 }
 
 double MESSAGE::Double()
 {
     ValidateFormat('d');
-    return get<double>(params_[index - 1]);
+    return get<double>(GetParam(index - 1));
 }
 
 uintptr_t MESSAGE::Pointer()
 {
     ValidateFormat('p');
-    return get<uintptr_t>(params_[index - 1]);
+    return get<uintptr_t>(GetParam(index - 1));
 }
 
 ATTRIBUTES * MESSAGE::AttributePointer()
 {
     ValidateFormat('a');
-    return get<ATTRIBUTES *>(params_[index - 1]);
+    return get<ATTRIBUTES *>(GetParam(index - 1));
 }
 
 entid_t MESSAGE::EntityID()
 {
     ValidateFormat('i');
-    return get<entid_t>(params_[index - 1]);
+    return get<entid_t>(GetParam(index - 1));
 }
 
 VDATA * MESSAGE::ScriptVariablePointer()
 {
     ValidateFormat('e');
-    return get<VDATA *>(params_[index - 1]);
+    return get<VDATA *>(GetParam(index - 1));
 }
 
 CVECTOR MESSAGE::CVector()
 {
     ValidateFormat('c');
-    return get<CVECTOR>(params_[index - 1]);
+    return get<CVECTOR>(GetParam(index - 1));
 }
 
 const std::string & MESSAGE::String()
 {
     ValidateFormat('s');
-    return get<std::string>(params_[index - 1]);
+    return get<std::string>(GetParam(index - 1));
 }
 
 bool MESSAGE::Set(int32_t value)
 {
     ValidateFormat('l');
-    params_[index - 1] = value;
+    GetParam(index - 1) = value;
     return true;
 }
 
 bool MESSAGE::Set(uintptr_t value)
 {
     ValidateFormat('p');
-    params_[index - 1] = value;
+    GetParam(index - 1) = value;
     return true;
 }
 
 bool MESSAGE::Set(float value)
 {
     ValidateFormat('f');
-    params_[index - 1] = value;
+    GetParam(index - 1) = value;
     return true;
 }
 
 bool MESSAGE::Set(std::string value)
 {
     ValidateFormat('s');
-    params_[index - 1] = std::move(value);
+    GetParam(index - 1) = std::move(value);
     return true;
 }
 
 bool MESSAGE::SetEntity(entid_t value)
 {
     ValidateFormat('i');
-    params_[index - 1] = value;
+    GetParam(index - 1) = value;
     return true;
 }
 
 bool MESSAGE::Set(VDATA *value)
 {
     ValidateFormat('e');
-    params_[index - 1] = value;
+    GetParam(index - 1) = value;
     return true;
 }
 
 bool MESSAGE::Set(ATTRIBUTES *value)
 {
     ValidateFormat('a');
-    params_[index - 1] = value;
+    GetParam(index - 1) = value;
     return true;
 }
 
@@ -142,17 +142,17 @@ void MESSAGE::ValidateFormat(char c)
 void MESSAGE::Reset(const std::string_view &format)
 {
     format_ = format;
-    params_.resize(format_.size());
+    extraParams_.resize(format_.size() > kInlineParams ? format_.size() - kInlineParams : 0);
     index = 0;
 }
 
 void MESSAGE::ResetVA(const std::string_view &format, va_list&args)
 {
-    index = 0;
-    format_ = format;
-    params_.resize(format_.size());
-    std::transform(format_.begin(), format_.end(), params_.begin(),
-                   [&](const char c) { return GetParamValue(c, args); });
+    Reset(format);
+    for (size_t n = 0; n < format_.size(); n++)
+    {
+        GetParam(n) = GetParamValue(format_[n], args);
+    }
 }
 
 char MESSAGE::GetCurrentFormatType()
@@ -175,6 +175,11 @@ bool MESSAGE::ParamValid() const
     return index < format_.length();
 }
 
+storm::MessageParam &MESSAGE::GetParam(size_t n)
+{
+    return n < kInlineParams ? inlineParams_[n] : extraParams_[n - kInlineParams];
+}
+
 storm::MessageParam MESSAGE::GetParamValue(const char c, va_list&args)
 {
     switch (c)
@@ -1,18 +1,8 @@
 #include "s_eventtab.h"
 
 #include "string_compare.hpp"
-#define HASHT_INDEX(x) (uint8_t)(x >> 24)
-#define HASHT_CODE(x) (x & 0xffffff)
-#define HASH2INDEX(x) (uint8_t)(x & 0x2f)
 
-S_EVENTTAB::S_EVENTTAB()
-{
-    for (uint32_t n = 0; n < HASHTABLE_SIZE; n++)
-    {
-        Buffer_size[n] = 0;
-        Event_num[n] = 0;
-    }
-}
+S_EVENTTAB::S_EVENTTAB() = default;
 
 S_EVENTTAB::~S_EVENTTAB()
 {
@@ -21,130 +11,90 @@ S_EVENTTAB::~S_EVENTTAB()
 
 void S_EVENTTAB::Clear()
 {
-    for (uint32_t i = 0; i < HASHTABLE_SIZE; i++)
+    for (auto &event : events_)
     {
-        for (uint32_t n = 0; n < Event_num[i]; n++)
+        for (uint32_t m = 0; m < event.elements; m++)
         {
-            for (uint32_t m = 0; m < pTable[i][n].elements; m++)
-            {
-                if (!pTable[i][n].pFuncInfo[m].bStatic)
-                    pTable[i][n].pFuncInfo[m].status = FSTATUS_DELETED;
-            }
-
-            // if(pTable[n].pFuncInfo) delete pTable[n].pFuncInfo;
-            // if(pTable[n].name) delete pTable[n].name;
+            if (!event.pFuncInfo[m].bStatic)
+                event.pFuncInfo[m].status = FSTATUS_DELETED;
         }
-        // delete pTable; pTable = 0;
-        // Buffer_size = 0;
-        // Event_num = 0;
     }
     ProcessFrame();
 }
 
 void S_EVENTTAB::Release()
 {
-    for (uint32_t i = 0; i < HASHTABLE_SIZE; i++)
+    // keep registered events, their codes may be cached outside of the table
+    for (auto &event : events_)
     {
-        for (uint32_t n = 0; n < Event_num[i]; n++)
-        {
-            delete[] pTable[i][n].name;
-        }
-
-        Buffer_size[i] = 0;
-        Event_num[i] = 0;
+        event.pFuncInfo.clear();
+        event.elements = 0;
     }
 }
 
 bool S_EVENTTAB::GetEvent(EVENTINFO &ei, uint32_t event_code)
 {
-    const auto ti = HASHT_INDEX(event_code);
-    const auto tc = HASHT_CODE(event_code);
-    if (tc >= Event_num[ti])
+    const auto *event = GetEventInfo(event_code);
+    if (event == nullptr)
         return false;
-    ei = pTable[ti][tc];
+    ei = *event;
     return true;
 }
 
+const EVENTINFO *S_EVENTTAB::GetEventInfo(uint32_t event_code) const
+{
+    if (event_code >= events_.size())
+        return nullptr;
+    return &events_[event_code];
+}
+
 uint32_t S_EVENTTAB::AddEventHandler(const char *event_name, uint32_t func_code, uint32_t func_segment_id, int32_t flag,
                                      bool bStatic)
 {
-    uint32_t i;
-
-    const auto hash = MakeHashValue(event_name);
-
-    const auto ti = HASH2INDEX(hash);
+    const auto event_code = RegisterEvent(event_name);
+    if (event_code == INVALID_EVENT_CODE)
+        return INVALID_EVENT_CODE;
 
-    for (uint32_t n = 0; n < Event_num[ti]; n++)
+    auto &event = events_[event_code];
+    for (uint32_t i = 0; i < event.elements; i++)
     {
-        if (pTable[ti][n].hash == hash)
+        // event handler function already set
+        if (event.pFuncInfo[i].func_code == func_code)
         {
-            if (!storm::iEquals(event_name, pTable[ti][n].name))
-                continue;
-            // event already in list
-            for (i = 0; i < pTable[ti][n].elements; i++)
-            {
-                // event handler function already set
-                if (pTable[ti][n].pFuncInfo[i].func_code == func_code)
-                {
-                    /*if(pTable[ti][n].pFuncInfo[i].status == FSTATUS_DELETED)
-                    {
-                      trace("pTable[ti][n].pFuncInfo[i].status == FSTATUS_DELETED : %s",pTable[ti][n].name);
-                    }*/
-                    // return n;
-                    pTable[ti][n].pFuncInfo[i].status = FSTATUS_NORMAL;
-
-                    return (((ti << 24) & 0xff000000) | (n & 0xffffff));
-                }
-            }
-            // add function
-            i = pTable[ti][n].elements;
-            pTable[ti][n].elements++;
-            pTable[ti][n].pFuncInfo.resize(pTable[ti][n].elements);
-
-            pTable[ti][n].pFuncInfo[i].func_code = func_code;
-            pTable[ti][n].pFuncInfo[i].segment_id = func_segment_id;
-            if (flag)
-                pTable[ti][n].pFuncInfo[i].status = FSTATUS_NEW;
-            else
-                pTable[ti][n].pFuncInfo[i].status = FSTATUS_NORMAL;
-            pTable[ti][n].pFuncInfo[i].bStatic = bStatic;
-            // return n;
-            return (((ti << 24) & 0xff000000) | (n & 0xffffff));
+            event.pFuncInfo[i].status = FSTATUS_NORMAL;
+            return event_code;
         }
     }
 
-    // add new event
-    if (Event_num[ti] >= Buffer_size[ti])
-    {
-        Buffer_size[ti] += BUFFER_BLOCK_SIZE;
-        pTable[ti].resize(Buffer_size[ti]);
-    }
+    // add function
+    EVENT_FUNC_INFO &fi = event.pFuncInfo.emplace_back();
+    fi.func_code = func_code;
+    fi.segment_id = func_segment_id;
+    fi.status = flag ? FSTATUS_NEW : FSTATUS_NORMAL;
+    fi.bStatic = bStatic;
+    event.elements++;
 
-    pTable[ti][Event_num[ti]].elements = 1;
-    pTable[ti][Event_num[ti]].hash = hash;
-    pTable[ti][Event_num[ti]].name = nullptr;
+    return event_code;
+}
 
-    pTable[ti][Event_num[ti]].pFuncInfo.push_back(EVENT_FUNC_INFO{});
-    pTable[ti][Event_num[ti]].pFuncInfo[0].func_code = func_code;
-    pTable[ti][Event_num[ti]].pFuncInfo[0].segment_id = func_segment_id;
-    if (flag)
-        pTable[ti][Event_num[ti]].pFuncInfo[0].status = FSTATUS_NEW;
-    else
-        pTable[ti][Event_num[ti]].pFuncInfo[0].status = FSTATUS_NORMAL;
-    pTable[ti][Event_num[ti]].pFuncInfo[0].bStatic = bStatic;
+uint32_t S_EVENTTAB::RegisterEvent(const char *event_name)
+{
+    if (event_name == nullptr)
+        return INVALID_EVENT_CODE;
 
-    if constexpr (true) // bKeepName)
-    {
-        if (event_name)
-        {
-            const auto len = strlen(event_name) + 1;
-            pTable[ti][Event_num[ti]].name = new char[len];
-            memcpy(pTable[ti][Event_num[ti]].name, event_name, len);
-        }
-    }
-    Event_num[ti]++;
-    // return (Event_num[ti] - 1);
-    return (((ti << 24) & 0xff000000) | ((Event_num[ti] - 1) & 0xffffff));
+    const auto event_code = FindEvent(event_name);
+    if (event_code != INVALID_EVENT_CODE)
+        return event_code;
+
+    const auto hash = MakeHashValue(event_name);
+    auto &event = events_.emplace_back();
+    event.hash = hash;
+    event.name = event_name;
+    event.elements = 0;
+
+    const auto new_code = static_cast<uint32_t>(events_.size() - 1);
+    index_.emplace(hash, new_code);
+    return new_code;
 }
 
 uint32_t S_EVENTTAB::MakeHashValue(const char *string)
@@ -168,82 +118,59 @@ uint32_t S_EVENTTAB::MakeHashValue(const char *string)
 
 bool S_EVENTTAB::DelEventHandler(const char *event_name, uint32_t func_code)
 {
-    if (event_name == nullptr)
+    const auto event_code = FindEvent(event_name);
+    if (event_code == INVALID_EVENT_CODE)
         return false;
-    const auto hash = MakeHashValue(event_name);
-
-    const auto ti = HASH2INDEX(hash);
 
-    for (uint32_t n = 0; n < Event_num[ti]; n++)
+    const auto &event = events_[event_code];
+    for (uint32_t i = 0; i < event.elements; i++)
     {
-        if (pTable[ti][n].hash == hash)
-            if (storm::iEquals(pTable[ti][n].name, event_name))
-            {
-                return DelEventHandler(ti, n, func_code);
-                // return;
-            }
+        if (event.pFuncInfo[i].func_code == func_code)
+            return DelEventHandler(event_code, i);
     }
     return false;
 }
 
 void S_EVENTTAB::SetStatus(const char *event_name, uint32_t func_code, uint32_t status)
 {
-    if (event_name == nullptr)
+    const auto event_code = FindEvent(event_name);
+    if (event_code == INVALID_EVENT_CODE)
         return;
 
-    const auto hash = MakeHashValue(event_name);
-    const auto ti = HASH2INDEX(hash);
-
-    for (uint32_t n = 0; n < Event_num[ti]; n++)
+    auto &event = events_[event_code];
+    for (uint32_t i = 0; i < event.elements; i++)
     {
-        if (pTable[ti][n].hash == hash)
-            if (storm::iEquals(pTable[ti][n].name, event_name))
-            {
-                for (uint32_t i = 0; i < pTable[ti][n].elements; i++)
-                {
-                    if (pTable[ti][n].pFuncInfo[i].func_code == func_code)
-                    {
-                        pTable[ti][n].pFuncInfo[i].status = status;
-                        return;
-                    }
-                }
-            }
+        if (event.pFuncInfo[i].func_code == func_code)
+        {
+            event.pFuncInfo[i].status = status;
+            return;
+        }
     }
 }
 
-bool S_EVENTTAB::DelEventHandler(uint8_t ti, uint32_t event_code, uint32_t func_code, bool bDelStatic)
+bool S_EVENTTAB::DelEventHandler(uint32_t event_code, uint32_t func_index, bool bDelStatic)
 {
-    if (!bDelStatic)
-    {
-        if (pTable[ti][event_code].pFuncInfo[func_code].bStatic)
-        {
-            return false;
-        }
-    }
+    auto &event = events_[event_code];
+    if (func_index >= event.elements)
+        return false;
 
-    for (auto n = func_code; n < (pTable[ti][event_code].elements - 1); n++)
-    {
-        pTable[ti][event_code].pFuncInfo[n] = pTable[ti][event_code].pFuncInfo[n + 1];
-    }
-    pTable[ti][event_code].elements--;
-    pTable[ti][event_code].pFuncInfo.resize(pTable[ti][event_code].elements);
+    if (!bDelStatic && event.pFuncInfo[func_index].bStatic)
+        return false;
+
+    event.pFuncInfo.erase(event.pFuncInfo.begin() + func_index);
+    event.elements--;
     return true;
 }
 
 void S_EVENTTAB::InvalidateBySegmentID(uint32_t segment_id)
 {
-    for (uint32_t ti = 0; ti < HASHTABLE_SIZE; ti++)
+    for (uint32_t n = 0; n < events_.size(); n++)
     {
-        for (uint32_t n = 0; n < Event_num[ti]; n++)
+        for (uint32_t i = 0; i < events_[n].elements;)
         {
-            for (uint32_t i = 0; i < pTable[ti][n].elements; i++)
-            {
-                if (pTable[ti][n].pFuncInfo[i].segment_id == segment_id)
-                {
-                    if (DelEventHandler(static_cast<uint8_t>(ti), n, i, true))
-                        i = 0;
-                }
-            }
+            if (events_[n].pFuncInfo[i].segment_id == segment_id && DelEventHandler(n, i, true))
+                continue;
+            i++;
         }
     }
 }
@@ -253,31 +180,26 @@ uint32_t S_EVENTTAB::FindEvent(const char *event_name)
     if (event_name == nullptr)
         return INVALID_EVENT_CODE;
     const auto hash = MakeHashValue(event_name);
-    const auto ti = HASH2INDEX(hash);
-    for (uint32_t n = 0; n < Event_num[ti]; n++)
+    const auto [begin, end] = index_.equal_range(hash);
+    for (auto it = begin; it != end; ++it)
     {
-        if (pTable[ti][n].hash == hash)
-            if (storm::iEquals(pTable[ti][n].name, event_name))
-                return (((ti << 24) & 0xff000000) | (n & 0xffffff));
+        if (storm::iEquals(events_[it->second].name, event_name))
+            return it->second;
     }
     return INVALID_EVENT_CODE;
 }
 
 void S_EVENTTAB::ProcessFrame()
 {
-    for (uint32_t ti = 0; ti < HASHTABLE_SIZE; ti++)
-        for (uint32_t n = 0; n < Event_num[ti]; n++)
+    for (uint32_t n = 0; n < events_.size(); n++)
+    {
+        // delete old handlers
+        for (uint32_t i = 0; i < events_[n].elements;)
         {
-            // delete old handlers
-            for (uint32_t i = 0; i < pTable[ti][n].elements; i++)
-            {
-                if (pTable[ti][n].pFuncInfo[i].status == FSTATUS_DELETED)
-                {
-                    DelEventHandler(static_cast<uint8_t>(ti), n, i);
-                    i = 0;
-                }
-                else
-                    pTable[ti][n].pFuncInfo[i].status = FSTATUS_NORMAL;
-            }
+            if (events_[n].pFuncInfo[i].status == FSTATUS_DELETED && DelEventHandler(n, i))
+                continue;
+            events_[n].pFuncInfo[i].status = FSTATUS_NORMAL;
+            i++;
         }
+    }
 }
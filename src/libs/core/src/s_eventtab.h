@@ -1,8 +1,11 @@
 #pragma once
 
+#include <deque>
+#include <string>
+#include <unordered_map>
+
 #include "data.h"
 
-#define BUFFER_BLOCK_SIZE 4
 #define INVALID_EVENT_CODE 0xffffffff
 #define INVALID_SEGMENT_ID 0xffffffff
 
@@ -22,33 +25,35 @@ struct EVENTINFO
 {
     uint32_t hash;
     std::vector<EVENT_FUNC_INFO> pFuncInfo;
-    char *name;
+    std::string name;
     uint32_t elements;
 };
 
-#define HASHTABLE_SIZE 64
-
+// Event codes are indices of registered events. Events are never removed, so a code resolved once
+// (see RegisterEvent) stays valid for the whole run, handlers are added and removed in place.
 class S_EVENTTAB
 {
-    uint32_t Buffer_size[HASHTABLE_SIZE];
-    uint32_t Event_num[HASHTABLE_SIZE];
-    std::vector<EVENTINFO> pTable[HASHTABLE_SIZE];
-    // bool bKeepName;
+    std::deque<EVENTINFO> events_; // deque keeps references stable while new events are added
+    std::unordered_multimap<uint32_t, uint32_t> index_; // name hash -> event code
+
   public:
     S_EVENTTAB();
     ~S_EVENTTAB();
-    // uint32_t GetEventNum(){return Event_num;};
     void SetStatus(const char *event_name, uint32_t func_code, uint32_t status);
     uint32_t AddEventHandler(const char *event_name, uint32_t func_code, uint32_t func_segment_id, int32_t flag,
                              bool bStatic = false);
     bool DelEventHandler(const char *event_name, uint32_t func_code);
-    bool DelEventHandler(uint8_t ti, uint32_t event_code, uint32_t func_code, bool bDelStatic = false);
+    bool DelEventHandler(uint32_t event_code, uint32_t func_index, bool bDelStatic = false);
     bool GetEvent(EVENTINFO &ei, uint32_t event_code); // return true if var registred and loaded
+    // get event by code without copying, returns nullptr for invalid code
+    // pointer stays valid for the table lifetime
+    const EVENTINFO *GetEventInfo(uint32_t event_code) const;
     uint32_t MakeHashValue(const char *string);
-    //    void  KeepNameMode(bool on){bKeepName = on;};
     void Release();
     void Clear();
     void InvalidateBySegmentID(uint32_t segment_id);
     uint32_t FindEvent(const char *event_name);
+    // returns code of the event, registers it without handlers if needed
+    uint32_t RegisterEvent(const char *event_name);
     void ProcessFrame();
 };
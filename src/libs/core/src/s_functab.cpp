@@ -62,29 +62,43 @@ size_t FuncTable::AddFunc(const FuncInfo &fi)
 
 bool FuncTable::GetFunc(FuncInfo &fi, size_t func_index) const
 {
-    if (func_index >= funcs_.size())
+    const auto *func = GetFuncInfo(func_index);
+
+    if (func == nullptr)
     {
         return false;
     }
 
-    if (funcs_[func_index].segment_id == IMPORTED_SEGMENT_ID)
+    fi = *func; // copy func info
+    return true;
+}
+
+const FuncInfo *FuncTable::GetFuncInfo(size_t func_index) const
+{
+    if (func_index >= funcs_.size())
     {
-        if (funcs_[func_index].imported_func == nullptr)
-        {
-            return false;
-        }
+        return nullptr;
+    }
 
-        fi = funcs_[func_index]; // copy func info
-        return true;
+    const auto &func = funcs_[func_index];
+
+    if (func.segment_id == IMPORTED_SEGMENT_ID)
+    {
+        return func.imported_func == nullptr ? nullptr : &func;
     }
 
-    if (funcs_[func_index].offset == INVALID_FUNC_OFFSET)
+    if (func.offset == INVALID_FUNC_OFFSET)
     {
-        return false;
+        return nullptr;
     }
 
-    fi = funcs_[func_index]; // copy func info
-    return true;
+    return &func;
+}
+
+const std::string &FuncTable::GetFuncDeclFileName(size_t func_index) const
+{
+    static const std::string empty;
+    return func_index < funcs_.size() ? funcs_[func_index].decl_file_name : empty;
 }
 
 bool FuncTable::GetFuncX(FuncInfo &fi, size_t func_index) const
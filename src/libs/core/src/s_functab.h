@@ -3,6 +3,7 @@
 #include "s_import_func.h"
 #include "s_vartab.h"
 #include "string_compare.hpp"
+#include <deque>
 #include <unordered_map>
 #include <vector>
 
@@ -59,6 +60,16 @@ struct FuncInfo
     uint32_t extern_arguments;
 };
 
+// state of a single script function invocation
+// keeps what the running code needs from FuncInfo, the table entry may be reloaded or invalidated meanwhile
+struct FuncFrame
+{
+    uint32_t func_code;
+    uint32_t segment_id;
+    uint32_t stack_offset;
+    S_TOKEN_TYPE return_type;
+};
+
 class FuncTable
 {
   public:
@@ -75,6 +86,11 @@ class FuncTable
     bool GetFunc(FuncInfo &fi, size_t func_index) const;
     // get func by index, returns true if func is registered
     bool GetFuncX(FuncInfo &fi, size_t func_index) const;
+    // get func by index without copying, returns nullptr if func isnt registered or loaded
+    // pointer stays valid until Release()
+    const FuncInfo *GetFuncInfo(size_t func_index) const;
+    // get func's declaration file, empty if func isnt registered or its segment is unloaded
+    const std::string &GetFuncDeclFileName(size_t func_index) const;
     // invalidate all segment's functions
     void InvalidateBySegmentID(uint32_t segment_id);
 
@@ -96,7 +112,7 @@ class FuncTable
     void Release(); // clear table
 
   private:
-    std::vector<FuncInfo> funcs_;
+    std::deque<FuncInfo> funcs_; // deque keeps references stable while new funcs are added
     storm::iStrHasher hasher_;
     std::unordered_map<std::string, size_t, storm::iStrHasher, storm::iStrComparator> hash_table_;
 };
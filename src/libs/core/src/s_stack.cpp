@@ -8,6 +8,7 @@ S_STACK::S_STACK()
     Buffer_size = 0;
     Data_num = 0;
     pVCompiler = nullptr;
+    pTop = pBlockBegin = pBlockEnd = nullptr;
 }
 
 S_STACK::~S_STACK()
@@ -17,43 +18,60 @@ S_STACK::~S_STACK()
 
 void S_STACK::Release()
 {
-    for (uint32_t n = 0; n < Buffer_size; n++)
-    {
-        delete pStackData[n];
-        // pStackData[n].~DATA();
-    }
-    pStackData.clear();
+    pStackBlocks.clear();
     Buffer_size = 0;
     Data_num = 0;
+    pTop = pBlockBegin = pBlockEnd = nullptr;
+}
+
+void S_STACK::Grow()
+{
+    // one allocation per block instead of one per slot
+    auto &block = pStackBlocks.emplace_back(std::make_unique<DATA[]>(STACK_BUFFER_BLOCK_SIZE));
+    for (uint32_t n = 0; n < STACK_BUFFER_BLOCK_SIZE; n++)
+    {
+        block[n].SetVCompiler(pVCompiler);
+    }
+    Buffer_size += STACK_BUFFER_BLOCK_SIZE;
+    // trace("stack: %d",Buffer_size);
+}
+
+void S_STACK::SetTop(uint32_t index)
+{
+    const auto block = index >> STACK_BUFFER_BLOCK_SHIFT;
+    if (block < pStackBlocks.size())
+    {
+        pBlockBegin = pStackBlocks[block].get();
+        pBlockEnd = pBlockBegin + STACK_BUFFER_BLOCK_SIZE;
+        pTop = pBlockBegin + (index & (STACK_BUFFER_BLOCK_SIZE - 1));
+    }
+    else
+    {
+        // the end of the last block, the next Push grows the stack
+        pTop = pBlockBegin = pBlockEnd = nullptr;
+    }
 }
 
 DATA *S_STACK::Push(DATA *pdataclass)
 {
-    if (Data_num > STACK_BUFFER_LIMIT)
-        throw std::runtime_error("stack overflaw");
-    if (Data_num >= Buffer_size)
+    if (pTop == pBlockEnd)
     {
-        const auto offset = Buffer_size;
-        Buffer_size += STACK_BUFFER_BLOCK_SIZE;
-        pStackData.resize(Buffer_size);
-        // trace("stack: %d",Buffer_size);
-        for (auto n = offset; n < Buffer_size; n++)
+        if (Data_num > STACK_BUFFER_LIMIT)
+            throw std::runtime_error("stack overflaw");
+        if (Data_num >= Buffer_size)
         {
-            // new(&pStackData[n]) DATA;
-            pStackData[n] = new DATA;
-            // pStackData[n].SetVCompiler(pVCompiler);
-            pStackData[n]->SetVCompiler(pVCompiler);
+            Grow();
         }
+        SetTop(Data_num);
     }
-    pStackData[Data_num]->ClearType();
-    pStackData[Data_num]->SetType(UNKNOWN);
+    DATA *pV = pTop++;
+    Data_num++;
+    pV->ResetType();
     if (pdataclass)
     {
-        pStackData[Data_num]->Copy(pdataclass);
+        pV->Copy(pdataclass);
     }
-    Data_num++;
-    // return &pStackData[Data_num - 1];
-    return pStackData[Data_num - 1];
+    return pV;
 }
 
 DATA *S_STACK::Pop()
@@ -62,15 +80,17 @@ DATA *S_STACK::Pop()
     if (Data_num == 0)
         throw std::runtime_error("stack 'pop' error");
     Data_num--;
-    // return &pStackData[Data_num];
-
-    /*if(pStackData[Data_num]->GetType() == VAR_OBJECT)
+    if (pTop == pBlockBegin)
+    {
+        SetTop(Data_num);
+    }
+    else
     {
-      entid_t id;
-      pStackData[Data_num]->Get(id);
-      core_internal.Entity_SetAttributePointer(&id,0);
-    }//*/
-    return pStackData[Data_num];
+        --pTop;
+    }
+
+    // popped slot keeps its value until it is pushed again
+    return pTop;
 }
 
 DATA *S_STACK::Read(uint32_t offset, uint32_t index)
@@ -79,22 +99,22 @@ DATA *S_STACK::Read(uint32_t offset, uint32_t index)
     {
         throw std::runtime_error("stack 'read' error");
     }
-    // return &pStackData[offset + index];
-    return pStackData[offset + index];
+    return Slot(offset + index);
 }
 
 DATA *S_STACK::Read()
 {
     if (Data_num <= 0)
         throw std::runtime_error("stack 'read' error");
-    // return &pStackData[Data_num - 1];
-    return pStackData[Data_num - 1];
+    return pTop != pBlockBegin ? pTop - 1 : Slot(Data_num - 1);
 }
 
 void S_STACK::InvalidateFrom(uint32_t index)
 {
-    while (Data_num > index)
+    // values of the dropped slots are released lazily on the next Push
+    if (Data_num > index)
     {
-        Pop();
+        Data_num = index;
+        SetTop(Data_num);
     }
 }
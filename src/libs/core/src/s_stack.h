@@ -3,16 +3,37 @@
 #include "data.h"
 #include "v_s_stack.h"
 
-#define STACK_BUFFER_BLOCK_SIZE 512
+#include <memory>
+
+#define STACK_BUFFER_BLOCK_SHIFT 9
+#define STACK_BUFFER_BLOCK_SIZE (1u << STACK_BUFFER_BLOCK_SHIFT)
 #define STACK_BUFFER_LIMIT 65535
 
+// the overflow is only checked when Push leaves a block
+static_assert((STACK_BUFFER_LIMIT + 1) % STACK_BUFFER_BLOCK_SIZE == 0);
+
 class S_STACK : public VS_STACK
 {
-    std::vector<DATA *> pStackData;
+    // slots live in contiguous blocks of STACK_BUFFER_BLOCK_SIZE elements, blocks are never moved
+    // or freed before Release(), so pointers returned by Push/Pop/Read stay valid
+    std::vector<std::unique_ptr<DATA[]>> pStackBlocks;
     uint32_t Buffer_size;
     uint32_t Data_num;
     VIRTUAL_COMPILER *pVCompiler;
 
+    // slot Data_num and the block it is in, Push and Pop only move pTop until they reach a block edge
+    DATA *pTop;
+    DATA *pBlockBegin;
+    DATA *pBlockEnd;
+
+    DATA *Slot(uint32_t index) const
+    {
+        return &pStackBlocks[index >> STACK_BUFFER_BLOCK_SHIFT][index & (STACK_BUFFER_BLOCK_SIZE - 1)];
+    }
+
+    void Grow();
+    void SetTop(uint32_t index);
+
   public:
     S_STACK();
     ~S_STACK();
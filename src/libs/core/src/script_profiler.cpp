@@ -0,0 +1,181 @@
+#include "script_profiler.h"
+
+#include <algorithm>
+#include <fstream>
+
+void ScriptProfiler::SetEnabled(const bool enabled)
+{
+    if (enabled_ == enabled)
+    {
+        return;
+    }
+
+    // toggling in the middle of a call would leave unbalanced frames
+    frames_.clear();
+    enabled_ = enabled;
+    if (enabled_ && nodes_.empty())
+    {
+        Reset();
+    }
+}
+
+void ScriptProfiler::Enter(const std::string_view &name)
+{
+    const uint32_t parent = frames_.empty() ? kRootNode : frames_.back().node;
+    const uint32_t name_index = GetNameIndex(name);
+    const uint64_t key = static_cast<uint64_t>(parent) << 32 | name_index;
+
+    auto [it, inserted] = children_.try_emplace(key, static_cast<uint32_t>(nodes_.size()));
+    if (inserted)
+    {
+        nodes_.push_back({parent, name_index, 0, {}, {}});
+    }
+
+    frames_.push_back({it->second, clock::now(), {}});
+}
+
+void ScriptProfiler::Leave()
+{
+    if (frames_.empty())
+    {
+        return;
+    }
+
+    const Frame frame = frames_.back();
+    frames_.pop_back();
+
+    const auto inclusive = clock::now() - frame.start;
+    auto &node = nodes_[frame.node];
+    ++node.calls;
+    node.inclusive += inclusive;
+    node.exclusive += inclusive - frame.children;
+
+    if (!frames_.empty())
+    {
+        frames_.back().children += inclusive;
+    }
+}
+
+void ScriptProfiler::Reset()
+{
+    names_.clear();
+    nameIndices_.clear();
+    children_.clear();
+    frames_.clear();
+    nodes_.clear();
+    nodes_.push_back({kRootNode, GetNameIndex("root"), 0, {}, {}});
+}
+
+bool ScriptProfiler::DumpFoldedStacks(const std::filesystem::path &path) const
+{
+    std::ofstream os(path, std::ios::trunc);
+    if (!os.is_open())
+    {
+        return false;
+    }
+
+    for (uint32_t n = 1; n < nodes_.size(); ++n)
+    {
+        const auto us = std::chrono::duration_cast<std::chrono::microseconds>(nodes_[n].exclusive).count();
+        if (us > 0)
+        {
+            os << GetStack(n) << ' ' << us << '\n';
+        }
+    }
+
+    return os.good();
+}
+
+bool ScriptProfiler::DumpFunctions(const std::filesystem::path &path) const
+{
+    std::ofstream os(path, std::ios::trunc);
+    if (!os.is_open())
+    {
+        return false;
+    }
+
+    struct Totals
+    {
+        uint64_t calls{};
+        clock::duration inclusive{};
+        clock::duration exclusive{};
+    };
+    std::vector<Totals> totals(names_.size());
+
+    for (uint32_t n = 1; n < nodes_.size(); ++n)
+    {
+        const auto &node = nodes_[n];
+        auto &total = totals[node.name];
+        total.calls += node.calls;
+        total.exclusive += node.exclusive;
+        if (!HasAncestorWithName(node.parent, node.name))
+        {
+            total.inclusive += node.inclusive;
+        }
+    }
+
+    std::vector<uint32_t> order;
+    for (uint32_t n = 0; n < totals.size(); ++n)
+    {
+        if (totals[n].calls != 0)
+        {
+            order.push_back(n);
+        }
+    }
+    std::ranges::sort(order, [&totals](uint32_t lhs, uint32_t rhs) { return totals[lhs].inclusive > totals[rhs].inclusive; });
+
+    using ms = std::chrono::duration<double, std::milli>;
+    os << "name,calls,inclusive_ms,exclusive_ms\n";
+    for (const uint32_t n : order)
+    {
+        os << names_[n] << ',' << totals[n].calls << ',' << ms(totals[n].inclusive).count() << ','
+           << ms(totals[n].exclusive).count() << '\n';
+    }
+
+    return os.good();
+}
+
+uint32_t ScriptProfiler::GetNameIndex(const std::string_view &name)
+{
+    if (const auto it = nameIndices_.find(name); it != nameIndices_.end())
+    {
+        return it->second;
+    }
+
+    const auto index = static_cast<uint32_t>(names_.size());
+    names_.emplace_back(name);
+    nameIndices_.emplace(name, index);
+    return index;
+}
+
+std::string ScriptProfiler::GetStack(uint32_t node) const
+{
+    std::vector<uint32_t> path;
+    for (; node != kRootNode; node = nodes_[node].parent)
+    {
+        path.push_back(node);
+    }
+
+    std::string result;
+    for (auto it = path.rbegin(); it != path.rend(); ++it)
+    {
+        if (!result.empty())
+        {
+            result += ';';
+        }
+        result += names_[nodes_[*it].name];
+    }
+    return result;
+}
+
+bool ScriptProfiler::HasAncestorWithName(uint32_t node, const uint32_t name) const
+{
+    for (; node != kRootNode; node = nodes_[node].parent)
+    {
+        if (nodes_[node].name == name)
+        {
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Call tree profiler for script functions and events.
+// Every node is a unique call stack, so the tree can be exported as folded stacks for flame graphs.
+class ScriptProfiler final
+{
+  public:
+    using clock = std::chrono::steady_clock;
+
+    class Scope
+    {
+      public:
+        Scope(ScriptProfiler &profiler, const std::string_view &name)
+            : profiler_(profiler.IsEnabled() ? &profiler : nullptr)
+        {
+            if (profiler_)
+            {
+                profiler_->Enter(name);
+            }
+        }
+
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+        ~Scope()
+        {
+            if (profiler_)
+            {
+                profiler_->Leave();
+            }
+        }
+
+      private:
+        ScriptProfiler *profiler_;
+    };
+
+    [[nodiscard]] bool IsEnabled() const noexcept
+    {
+        return enabled_;
+    }
+    void SetEnabled(bool enabled);
+
+    void Enter(const std::string_view &name);
+    void Leave();
+    void Reset();
+
+    // "event;function;function <exclusive microseconds>" lines, input for flamegraph.pl / speedscope
+    bool DumpFoldedStacks(const std::filesystem::path &path) const;
+    // inclusive/exclusive time per function, recursion is counted once per outermost call
+    bool DumpFunctions(const std::filesystem::path &path) const;
+
+  private:
+    struct Node
+    {
+        uint32_t parent;
+        uint32_t name;
+        uint64_t calls;
+        clock::duration inclusive;
+        clock::duration exclusive;
+    };
+
+    struct Frame
+    {
+        uint32_t node;
+        clock::time_point start;
+        clock::duration children;
+    };
+
+    struct NameHash
+    {
+        using is_transparent = void;
+        size_t operator()(const std::string_view &str) const noexcept
+        {
+            return std::hash<std::string_view>{}(str);
+        }
+    };
+
+    uint32_t GetNameIndex(const std::string_view &name);
+    [[nodiscard]] std::string GetStack(uint32_t node) const;
+    [[nodiscard]] bool HasAncestorWithName(uint32_t node, uint32_t name) const;
+
+    static constexpr uint32_t kRootNode = 0;
+
+    bool enabled_{false};
+    std::vector<std::string> names_;
+    std::unordered_map<std::string, uint32_t, NameHash, std::equal_to<>> nameIndices_;
+    // node 0 is an artificial root
+    std::vector<Node> nodes_;
+    // (parent node << 32 | name index) -> node
+    std::unordered_map<uint64_t, uint32_t> children_;
+    std::vector<Frame> frames_;
+};
@@ -0,0 +1,300 @@
+#include "storm/file_watcher.hpp"
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace storm
+{
+
+FileWatcher::FileWatcher(std::chrono::milliseconds pollInterval, bool useNative)
+    : pollInterval_(pollInterval), useNative_(useNative)
+{
+}
+
+FileWatcher::~FileWatcher()
+{
+    {
+        std::lock_guard lock(mutex_);
+        stop_ = true;
+    }
+    wakeup_.notify_all();
+#ifdef __linux__
+    if (wake_ >= 0)
+    {
+        const uint64_t one = 1;
+        [[maybe_unused]] const auto written = write(wake_, &one, sizeof(one));
+    }
+#endif
+    if (worker_.joinable())
+        worker_.join();
+#ifdef __linux__
+    if (inotify_ >= 0)
+        close(inotify_);
+    if (wake_ >= 0)
+        close(wake_);
+#endif
+}
+
+uint32_t FileWatcher::Watch(const std::filesystem::path &path, Callback callback)
+{
+    const auto absolute = std::filesystem::absolute(path).lexically_normal();
+    const auto key = absolute.string();
+
+    std::lock_guard lock(mutex_);
+    if (!worker_.joinable())
+        Start();
+
+    auto [it, inserted] = files_.try_emplace(key);
+    auto &file = it->second;
+    if (inserted)
+    {
+        file.path = absolute;
+        Stat(file);
+#ifdef __linux__
+        if (inotify_ >= 0)
+        {
+            const auto directory = absolute.parent_path().string();
+            const auto wd = inotify_add_watch(inotify_, directory.c_str(),
+                                              IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE | IN_ATTRIB);
+            if (wd >= 0)
+            {
+                auto &dir = directories_[wd];
+                dir.path = directory;
+                dir.files++;
+                file.directory = wd;
+            }
+        }
+#endif
+    }
+
+    const auto id = nextId_++;
+    file.watches.push_back(id);
+    watchers_[id] = {key, std::move(callback)};
+    return id;
+}
+
+void FileWatcher::Unwatch(uint32_t id)
+{
+    std::lock_guard lock(mutex_);
+    const auto watcher = watchers_.find(id);
+    if (watcher == watchers_.end())
+        return;
+
+    const auto it = files_.find(watcher->second.file);
+    watchers_.erase(watcher);
+    if (it == files_.end())
+        return;
+    auto &file = it->second;
+    std::erase(file.watches, id);
+    if (!file.watches.empty())
+        return;
+
+#ifdef __linux__
+    if (const auto dir = directories_.find(file.directory); dir != directories_.end() && --dir->second.files == 0)
+    {
+        inotify_rm_watch(inotify_, dir->first);
+        directories_.erase(dir);
+    }
+#endif
+    files_.erase(it);
+}
+
+size_t FileWatcher::Dispatch()
+{
+    if (!pending_.exchange(false))
+        return 0;
+
+    std::vector<uint32_t> ids;
+    {
+        std::lock_guard lock(mutex_);
+        for (auto &[key, file] : files_)
+        {
+            if (file.changed)
+            {
+                file.changed = false;
+                ids.insert(ids.end(), file.watches.begin(), file.watches.end());
+            }
+        }
+    }
+
+    // callbacks may watch and unwatch files
+    size_t calls = 0;
+    for (const auto id : ids)
+    {
+        Callback callback;
+        {
+            std::lock_guard lock(mutex_);
+            const auto it = watchers_.find(id);
+            if (it == watchers_.end())
+                continue;
+            callback = it->second.callback;
+        }
+        callback();
+        calls++;
+    }
+    return calls;
+}
+
+size_t FileWatcher::GetPolledCount() const
+{
+    std::lock_guard lock(mutex_);
+    size_t count = 0;
+    for (const auto &[key, file] : files_)
+        count += file.directory < 0;
+    return count;
+}
+
+void FileWatcher::Start()
+{
+#ifdef __linux__
+    if (useNative_)
+    {
+        inotify_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (inotify_ >= 0)
+            wake_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (wake_ < 0 && inotify_ >= 0)
+        {
+            close(inotify_);
+            inotify_ = -1;
+        }
+    }
+#endif
+    worker_ = std::thread(&FileWatcher::Work, this);
+}
+
+void FileWatcher::Work()
+{
+    auto lastPoll = std::chrono::steady_clock::now();
+    for (;;)
+    {
+#ifdef __linux__
+        if (inotify_ >= 0)
+        {
+            pollfd fds[2] = {{inotify_, POLLIN, 0}, {wake_, POLLIN, 0}};
+            poll(fds, 2, static_cast<int>(pollInterval_.count()));
+            if (fds[0].revents & POLLIN)
+                ReadEvents();
+            if (fds[1].revents & POLLIN)
+            {
+                uint64_t value;
+                [[maybe_unused]] const auto read_size = read(wake_, &value, sizeof(value));
+            }
+            std::lock_guard lock(mutex_);
+            if (stop_)
+                return;
+        }
+        else
+#endif
+        {
+            std::unique_lock lock(mutex_);
+            if (wakeup_.wait_for(lock, pollInterval_, [this] { return stop_; }))
+                return;
+        }
+
+        if (const auto now = std::chrono::steady_clock::now(); now - lastPoll >= pollInterval_)
+        {
+            lastPoll = now;
+            Poll();
+        }
+    }
+}
+
+void FileWatcher::ReadEvents()
+{
+#ifdef __linux__
+    alignas(inotify_event) char buffer[16 * 1024];
+    for (;;)
+    {
+        const auto size = read(inotify_, buffer, sizeof(buffer));
+        if (size <= 0)
+            return;
+
+        std::lock_guard lock(mutex_);
+        for (auto offset = 0; offset < size;)
+        {
+            const auto *event = reinterpret_cast<const inotify_event *>(buffer + offset);
+            offset += static_cast<int>(sizeof(inotify_event) + event->len);
+
+            const auto dir = directories_.find(event->wd);
+            if (dir == directories_.end())
+                continue;
+            if (event->mask & IN_IGNORED)
+            {
+                // the directory is removed, its files are polled from now on
+                for (auto &[key, file] : files_)
+                    if (file.directory == event->wd)
+                        file.directory = -1;
+                directories_.erase(dir);
+                continue;
+            }
+            if (event->len == 0)
+                continue;
+
+            const auto it = files_.find((std::filesystem::path(dir->second.path) / event->name).string());
+            if (it != files_.end())
+            {
+                Stat(it->second);
+                MarkChanged(it->second);
+            }
+        }
+    }
+#endif
+}
+
+void FileWatcher::Poll()
+{
+    std::vector<File> polled;
+    {
+        std::lock_guard lock(mutex_);
+        for (const auto &[key, file] : files_)
+            if (file.directory < 0)
+                polled.push_back(file);
+    }
+
+    // stat without the lock, Dispatch and Watch on the main thread shouldn't wait for the disk
+    for (auto &file : polled)
+    {
+        if (!Stat(file))
+            continue;
+        std::lock_guard lock(mutex_);
+        const auto it = files_.find(file.path.string());
+        if (it == files_.end() || it->second.directory >= 0)
+            continue;
+        it->second.exists = file.exists;
+        it->second.writeTime = file.writeTime;
+        it->second.size = file.size;
+        MarkChanged(it->second);
+    }
+}
+
+void FileWatcher::MarkChanged(File &file)
+{
+    file.changed = true;
+    pending_ = true;
+}
+
+bool FileWatcher::Stat(File &file)
+{
+    std::error_code ec;
+    const auto status = std::filesystem::status(file.path, ec);
+    const auto exists = std::filesystem::is_regular_file(status);
+    auto writeTime = std::filesystem::file_time_type{};
+    uintmax_t size = 0;
+    if (exists)
+    {
+        writeTime = std::filesystem::last_write_time(file.path, ec);
+        size = std::filesystem::file_size(file.path, ec);
+    }
+
+    const auto changed = exists != file.exists || writeTime != file.writeTime || size != file.size;
+    file.exists = exists;
+    file.writeTime = writeTime;
+    file.size = size;
+    return changed;
+}
+
+} // namespace storm
@@ -0,0 +1,420 @@
+#include "storm/save_state.hpp"
+
+#include "attributes.h"
+#include "utf8.h"
+
+#include <spdlog/spdlog.h>
+#include <zlib.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <future>
+#include <thread>
+
+namespace storm::save_state
+{
+namespace
+{
+
+using clock = std::chrono::steady_clock;
+
+double Milliseconds(clock::duration duration)
+{
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+struct PackedChunk
+{
+    std::vector<char> data;
+    double time;
+    bool ok;
+};
+
+PackedChunk PackChunk(const char *data, uint32_t size, int32_t level)
+{
+    const auto start = clock::now();
+    PackedChunk chunk;
+    uLongf packedSize = compressBound(size);
+    chunk.data.resize(packedSize);
+    chunk.ok = compress2(reinterpret_cast<Bytef *>(chunk.data.data()), &packedSize,
+                         reinterpret_cast<const Bytef *>(data), size, level) == Z_OK;
+    chunk.data.resize(packedSize);
+    chunk.time = Milliseconds(clock::now() - start);
+    return chunk;
+}
+
+} // namespace
+
+bool Write(const char *data, uint32_t size, const Options &options, const Sink &sink, Timings &timings)
+{
+    const auto start = clock::now();
+    const auto level = std::clamp(options.level, Z_NO_COMPRESSION, Z_BEST_COMPRESSION);
+    const auto chunkSize = std::max(options.chunk_size, 4096u);
+    const auto threads = std::max(options.threads ? options.threads : std::thread::hardware_concurrency(), 1u);
+
+    Header header;
+    header.magic = kMagic;
+    header.version = kVersion;
+    header.raw_size = size;
+    header.chunk_size = chunkSize;
+    header.chunk_count = (size + chunkSize - 1) / chunkSize;
+
+    timings.raw_size = size;
+    timings.packed_size = sizeof(header);
+    timings.chunks = header.chunk_count;
+
+    auto written = clock::duration::zero();
+    const auto write = [&](const void *ptr, size_t n) {
+        const auto writeStart = clock::now();
+        const auto ok = sink(ptr, n);
+        written += clock::now() - writeStart;
+        return ok;
+    };
+
+    bool ok = write(&header, sizeof(header));
+
+    // Keep a few chunks in flight and write them in order as they are done
+    std::deque<std::future<PackedChunk>> packing;
+    uint32_t next = 0;
+    while (next < header.chunk_count || !packing.empty())
+    {
+        while (ok && next < header.chunk_count && packing.size() < threads)
+        {
+            const auto offset = next * chunkSize;
+            packing.push_back(
+                std::async(std::launch::async, PackChunk, data + offset, std::min(chunkSize, size - offset), level));
+            next++;
+        }
+        if (packing.empty())
+            break;
+
+        const auto chunk = packing.front().get();
+        packing.pop_front();
+        timings.compress += chunk.time;
+        if (!ok || !chunk.ok)
+        {
+            ok = false;
+            continue;
+        }
+        const auto packedSize = static_cast<uint32_t>(chunk.data.size());
+        ok = write(&packedSize, sizeof(packedSize)) && write(chunk.data.data(), packedSize);
+        timings.packed_size += sizeof(packedSize) + packedSize;
+    }
+
+    timings.write = Milliseconds(written);
+    timings.total = Milliseconds(clock::now() - start);
+    return ok;
+}
+
+Reader::~Reader()
+{
+    Stop();
+}
+
+bool Reader::Open(const Source &source)
+{
+    header_.magic = kMagic;
+    if (!source(&header_.version, sizeof(header_) - sizeof(header_.magic)))
+        return false;
+    if (header_.version != kVersion || header_.raw_size == 0 || header_.raw_size > kMaxSize ||
+        header_.chunk_size == 0 ||
+        header_.chunk_count != (header_.raw_size + header_.chunk_size - 1) / header_.chunk_size)
+        return false;
+
+    source_ = source;
+    return true;
+}
+
+uint32_t Reader::GetSize() const
+{
+    return header_.raw_size;
+}
+
+void Reader::Start(char *data, uint32_t threads)
+{
+    data_ = data;
+    packed_.assign(header_.chunk_count, {});
+    chunkState_.assign(header_.chunk_count, ChunkState::Pending);
+    nextChunk_ = 0;
+    readyChunks_ = 0;
+    stopping_ = false;
+
+    // the file is read in order on its own thread, chunks are unpacked as soon as they are read
+    reading_ = std::thread(&Reader::ReadChunks, this);
+
+    // the loading thread unpacks too while it waits
+    if (threads == 0)
+        threads = std::max(std::thread::hardware_concurrency(), 1u) - 1;
+    threads = std::min(threads, header_.chunk_count);
+    for (uint32_t n = 0; n < threads; n++)
+        workers_.emplace_back(&Reader::Work, this);
+}
+
+bool Reader::WaitFor(uint32_t end)
+{
+    if (end > header_.raw_size)
+        return false;
+    if (end == 0)
+        return true;
+
+    const auto lastChunk = (end - 1) / header_.chunk_size;
+    const auto start = clock::now();
+    std::unique_lock lock(mutex_);
+    while (readyChunks_ <= lastChunk)
+    {
+        const auto state = chunkState_[readyChunks_];
+        if (state == ChunkState::Unpacked)
+        {
+            readyChunks_++;
+            continue;
+        }
+        if (state == ChunkState::Broken)
+            break;
+
+        // help the workers with a chunk that is already read
+        const auto next = nextChunk_.load();
+        if (next < header_.chunk_count && chunkState_[next] == ChunkState::Read)
+        {
+            lock.unlock();
+            UnpackNext();
+            lock.lock();
+            continue;
+        }
+        changed_.wait(lock);
+    }
+    waitTime_ += std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - start).count();
+    return readyChunks_ > lastChunk;
+}
+
+uint32_t Reader::GetReadySize() const
+{
+    return std::min(readyChunks_ * header_.chunk_size, header_.raw_size);
+}
+
+void Reader::Stop()
+{
+    {
+        const std::lock_guard lock(mutex_);
+        stopping_ = true;
+    }
+    // nothing left for the workers
+    nextChunk_ = header_.chunk_count;
+    changed_.notify_all();
+
+    if (reading_.joinable())
+        reading_.join();
+    for (auto &worker : workers_)
+        worker.join();
+    workers_.clear();
+}
+
+double Reader::GetReadTime() const
+{
+    return static_cast<double>(readTime_) / 1000.0;
+}
+
+double Reader::GetUnpackTime() const
+{
+    return static_cast<double>(unpackTime_) / 1000.0;
+}
+
+double Reader::GetWaitTime() const
+{
+    return static_cast<double>(waitTime_) / 1000.0;
+}
+
+void Reader::ReadChunks()
+{
+    const auto start = clock::now();
+    const auto maxPackedSize = compressBound(header_.chunk_size);
+    size_t packedTotal = 0;
+    for (uint32_t n = 0; n < header_.chunk_count; n++)
+    {
+        uint32_t packedSize;
+        std::vector<char> packed;
+        auto ok = source_(&packedSize, sizeof(packedSize)) && packedSize != 0 && packedSize <= maxPackedSize &&
+                  packedTotal + packedSize <= kMaxSize;
+        if (ok)
+        {
+            packed.resize(packedSize);
+            ok = source_(packed.data(), packedSize);
+            packedTotal += packedSize;
+        }
+
+        bool stopping;
+        {
+            const std::lock_guard lock(mutex_);
+            if (ok)
+            {
+                packed_[n] = std::move(packed);
+                chunkState_[n] = ChunkState::Read;
+            }
+            else
+            {
+                // the chunks after a broken one can't be found
+                std::fill(chunkState_.begin() + n, chunkState_.end(), ChunkState::Broken);
+            }
+            stopping = stopping_;
+        }
+        changed_.notify_all();
+        if (!ok || stopping)
+            break;
+    }
+    readTime_ = std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - start).count();
+}
+
+void Reader::Work()
+{
+    while (UnpackNext())
+        ;
+}
+
+bool Reader::UnpackNext()
+{
+    const auto n = nextChunk_++;
+    if (n >= header_.chunk_count)
+        return false;
+
+    std::vector<char> packed;
+    {
+        // the chunk may not be read from the file yet
+        std::unique_lock lock(mutex_);
+        changed_.wait(lock, [this, n] { return chunkState_[n] != ChunkState::Pending || stopping_; });
+        if (chunkState_[n] != ChunkState::Read)
+            return chunkState_[n] == ChunkState::Broken;
+        packed = std::move(packed_[n]);
+    }
+
+    const auto start = clock::now();
+    const auto offset = n * header_.chunk_size;
+    const auto rawSize = std::min(header_.chunk_size, header_.raw_size - offset);
+    uLongf unpackedSize = rawSize;
+    const auto ok = uncompress(reinterpret_cast<Bytef *>(data_ + offset), &unpackedSize,
+                               reinterpret_cast<const Bytef *>(packed.data()), static_cast<uLong>(packed.size())) ==
+                        Z_OK &&
+                    unpackedSize == rawSize;
+    unpackTime_ += std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - start).count();
+
+    {
+        const std::lock_guard lock(mutex_);
+        chunkState_[n] = ok ? ChunkState::Unpacked : ChunkState::Broken;
+    }
+    changed_.notify_all();
+    return true;
+}
+
+StateReader::StateReader(const char *data, uint32_t size, Reader *reader)
+    : data_(data), size_(size), reader_(reader), readySize_(reader ? 0 : size)
+{
+}
+
+bool StateReader::Read(void *data, uint32_t size)
+{
+    // skipping needs nothing unpacked
+    if (data == nullptr)
+    {
+        position_ += size;
+        return true;
+    }
+    if (!Reach(position_ + size))
+    {
+        memset(data, 0, size);
+        return false;
+    }
+    memcpy(data, data_ + position_, size);
+    position_ += size;
+    return true;
+}
+
+uint32_t StateReader::ReadVDword()
+{
+    uint8_t nbv;
+    Read(&nbv, sizeof(nbv));
+    if (nbv < 0xfe)
+        return nbv;
+    if (nbv == 0xfe)
+    {
+        uint16_t nwv;
+        Read(&nwv, sizeof(nwv));
+        return nwv;
+    }
+    uint32_t v;
+    Read(&v, sizeof(v));
+    return v;
+}
+
+const char *StateReader::ReadStringInPlace()
+{
+    const auto n = ReadVDword();
+    if (n == 0)
+        return nullptr;
+
+    if (!Reach(position_ + n) || data_[position_ + n - 1] != 0)
+    {
+        position_ += n;
+        return nullptr;
+    }
+    const auto *string = data_ + position_;
+    position_ += n;
+    if (!utf8::IsValidUtf8(string))
+        spdlog::warn("Deserializing invalid utf8 string: {}", string);
+    return string;
+}
+
+void StateReader::ReadAttributes(ATTRIBUTES *root)
+{
+    const auto count = ReadVDword();
+    root->SetNameCode(ReadVDword());
+    if (const auto *value = ReadStringInPlace())
+        root->SetValue(std::string_view(value));
+    else
+        root->ResetValue();
+    root->ReserveAttributes(count);
+    for (uint32_t n = 0; n < count; n++)
+        ReadAttributeClass(root);
+}
+
+ATTRIBUTES *StateReader::ReadAttributeClass(ATTRIBUTES *parent)
+{
+    const auto count = ReadVDword();
+    const auto code = ReadVDword();
+    const auto *value = ReadStringInPlace();
+    // the position SetAttribute found saves a second lookup
+    auto *attribute = parent->GetAttributeClass(
+        static_cast<uint32_t>(parent->SetAttribute(code, value ? std::string_view(value) : std::string_view())));
+    if (value == nullptr)
+        attribute->ResetValue();
+    attribute->ReserveAttributes(count);
+    for (uint32_t n = 0; n < count; n++)
+        ReadAttributeClass(attribute);
+    return attribute;
+}
+
+bool StateReader::IsBroken() const
+{
+    return broken_;
+}
+
+uint32_t StateReader::GetPosition() const
+{
+    return position_;
+}
+
+bool StateReader::Reach(uint32_t end)
+{
+    if (end > size_)
+        return false;
+    if (end <= readySize_)
+        return true;
+    if (!reader_->WaitFor(end))
+    {
+        broken_ = true;
+        return false;
+    }
+    readySize_ = reader_->GetReadySize();
+    return true;
+}
+
+} // namespace storm::save_state
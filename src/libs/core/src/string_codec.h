@@ -74,6 +74,26 @@ class STRING_CODEC : public VSTRING_CODEC
         return Convert(pString, bNew);
     }
 
+    std::optional<uint32_t> Find(const char *pString, int32_t iLen) override
+    {
+        if (pString == nullptr)
+            return std::nullopt;
+
+        char cTemp[1024];
+        strncpy_s(cTemp, pString, iLen);
+        cTemp[iLen] = 0;
+
+        const uint32_t nHash = MakeHashValue(cTemp);
+        const uint32_t nTableIndex = nHash & (HASH_TABLE_SIZE - 1);
+        const HTELEMENT &element = HTable[nTableIndex];
+        for (uint32_t n = 0; n < element.nStringsNum; n++)
+        {
+            if (element.pElements[n].dwHashCode == nHash && storm::iEquals(cTemp, element.pElements[n].pStr))
+                return (nTableIndex << 16) | (n & 0xffff);
+        }
+        return std::nullopt;
+    }
+
     inline uint32_t GetNum(uint32_t dwNum, uint32_t dwAlign = 8)
     {
         return (1 + dwNum / dwAlign) * dwAlign;
@@ -0,0 +1,252 @@
+#include "attributes.h"
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <string>
+#include <unordered_map>
+
+namespace
+{
+
+// Case insensitive like the engine STRING_CODEC
+class TestStringCodec : public VSTRING_CODEC
+{
+public:
+    uint32_t GetNum() override
+    {
+        return map_.size();
+    }
+
+    uint32_t Convert(const char *pString) override
+    {
+        return Convert(pString, static_cast<int32_t>(std::char_traits<char>::length(pString)));
+    }
+
+    uint32_t Convert(const char *pString, int32_t iLen) override
+    {
+        std::string str(pString, iLen);
+        std::transform(str.begin(), str.end(), str.begin(), [](unsigned char c) { return std::tolower(c); });
+        const uint32_t hash = std::hash<std::string>{}(str);
+        map_.emplace(hash, str);
+        return hash;
+    }
+
+    std::optional<uint32_t> Find(const char *pString, int32_t iLen) override
+    {
+        std::string str(pString, iLen);
+        std::transform(str.begin(), str.end(), str.begin(), [](unsigned char c) { return std::tolower(c); });
+        const uint32_t hash = std::hash<std::string>{}(str);
+        if (map_.contains(hash))
+            return hash;
+        return std::nullopt;
+    }
+
+    const char *Convert(uint32_t code) override
+    {
+        return map_[code].c_str();
+    }
+
+    void VariableChanged() override
+    {
+    }
+
+private:
+    std::unordered_map<uint32_t, std::string> map_;
+};
+
+} // namespace
+
+TEST_CASE("Child lookup on large attribute nodes", "[attributes]")
+{
+    TestStringCodec string_codec{};
+    ATTRIBUTES root(string_codec);
+
+    for (int i = 0; i < 100; ++i)
+    {
+        root.SetAttribute("child" + std::to_string(i), std::to_string(i));
+    }
+    REQUIRE(root.GetAttributesNum() == 100);
+
+    CHECK(to_string(root.GetAttribute("child0")) == "0");
+    CHECK(to_string(root.GetAttribute("CHILD42")) == "42");
+    CHECK(to_string(root.GetAttribute("child99")) == "99");
+    CHECK_FALSE(root.HasAttribute("child100"));
+
+    SECTION("Unknown names are not added to the string codec")
+    {
+        const uint32_t strings_num = string_codec.GetNum();
+        CHECK(root.GetAttributeClass("never_used_name") == nullptr);
+        CHECK(string_codec.GetNum() == strings_num);
+    }
+
+    SECTION("Lookup survives deletion")
+    {
+        CHECK(root.DeleteAttributeClassX(root.GetAttributeClass("child10")));
+        CHECK_FALSE(root.HasAttribute("child10"));
+        CHECK(to_string(root.GetAttribute("child11")) == "11");
+        CHECK(to_string(root.GetAttribute("child99")) == "99");
+    }
+
+    SECTION("Lookup survives rename")
+    {
+        root.GetAttributeClass("child5")->SetName("renamed");
+        CHECK_FALSE(root.HasAttribute("child5"));
+        CHECK(to_string(root.GetAttribute("renamed")) == "5");
+    }
+
+    SECTION("Duplicate names resolve to the first child")
+    {
+        root.CreateAttribute("child7", "duplicate");
+        CHECK(to_string(root.GetAttribute("child7")) == "7");
+    }
+}
+
+TEST_CASE("Compiled attribute path", "[attributes]")
+{
+    TestStringCodec string_codec{};
+    ATTRIBUTES root(string_codec);
+    const AttributePath path("ship.speed.z");
+
+    CHECK(path.Find(&root) == nullptr);
+
+    ATTRIBUTES *created = path.Create(&root);
+    REQUIRE(created != nullptr);
+    CHECK(created == root.FindAClass(&root, "ship.speed.z"));
+    CHECK(path.Find(&root) == created);
+
+    SECTION("Cache is dropped when the target is deleted")
+    {
+        ATTRIBUTES *speed = root.FindAClass(&root, "ship.speed");
+        speed->DeleteAttributeClassX(created);
+        CHECK(path.Find(&root) == nullptr);
+
+        ATTRIBUTES *recreated = speed->CreateAttribute("z", "1");
+        CHECK(path.Find(&root) == recreated);
+    }
+
+    SECTION("Cache survives unrelated trees being destroyed")
+    {
+        {
+            ATTRIBUTES other(string_codec);
+            other.CreateSubAClass(&other, "ship.speed.z");
+            root.CreateAttribute("cargo", "")->CreateAttribute("gold", "1");
+            root.DeleteAttributeClassX(root.GetAttributeClass("cargo"));
+        }
+        CHECK(path.Find(&root) == created);
+    }
+}
+
+TEST_CASE("Moved attribute tree", "[attributes]")
+{
+    TestStringCodec string_codec{};
+    ATTRIBUTES source(string_codec);
+    for (int i = 0; i < 20; ++i)
+    {
+        source.SetAttribute("item" + std::to_string(i), std::to_string(i));
+    }
+    const AttributePath path("item3");
+    ATTRIBUTES *item3 = path.Find(&source);
+    REQUIRE(item3 != nullptr);
+
+    const auto check_moved = [&](ATTRIBUTES &moved) {
+        CHECK(item3->GetParent() == &moved);
+        CHECK(path.Find(&source) == nullptr);
+        CHECK(path.Find(&moved) == item3);
+
+        moved.GetAttributeClass("item5")->SetName("renamed");
+        CHECK_FALSE(moved.HasAttribute("item5"));
+        CHECK(to_string(moved.GetAttribute("renamed")) == "5");
+        CHECK(to_string(moved.GetAttribute("item19")) == "19");
+    };
+
+    SECTION("Move constructor")
+    {
+        ATTRIBUTES moved(std::move(source));
+        check_moved(moved);
+    }
+
+    SECTION("Move assignment")
+    {
+        ATTRIBUTES moved(string_codec);
+        moved.SetAttribute("old", std::string_view("1"));
+        moved = std::move(source);
+        CHECK_FALSE(moved.HasAttribute("old"));
+        check_moved(moved);
+    }
+}
+
+TEST_CASE("Copy attribute tree", "[attributes]")
+{
+    TestStringCodec string_codec{};
+    ATTRIBUTES root(string_codec);
+    root.CreateSubAClass(&root, "ship.speed.z")->SetValue(std::string_view("5"));
+    for (int i = 0; i < 20; ++i)
+    {
+        root.SetAttribute("item" + std::to_string(i), std::to_string(i));
+    }
+
+    const ATTRIBUTES copy = root.Copy();
+    ATTRIBUTES *z = copy.GetAttributeClass("ship")->GetAttributeClass("speed")->GetAttributeClass("z");
+    REQUIRE(z != nullptr);
+    CHECK(z->GetValue() == "5");
+    CHECK(z->GetParent()->GetParent()->GetParent() == &copy);
+    CHECK(to_string(copy.GetAttribute("item19")) == "19");
+
+    const auto usage = copy.GetMemoryUsage();
+    CHECK(usage.nodes == root.GetMemoryUsage().nodes);
+    CHECK(usage.nodes == 24);
+    CHECK(usage.bytes >= usage.nodes * sizeof(ATTRIBUTES));
+}
+
+TEST_CASE("Numeric attribute values", "[attributes]")
+{
+    TestStringCodec string_codec{};
+    ATTRIBUTES root(string_codec);
+    root.SetAttributeUseDword("first", 1);
+    CHECK(root.SetAttributeUseDword("count", 4000000000u));
+    CHECK(root.SetAttributeUseFloat("speed", 0.25f));
+    root.CreateAttribute("fixed").SetValueUseFloat(1.5f, true);
+    root.CreateAttribute("negative").SetValueUseInteger(-7);
+
+    SECTION("Formatted as their text was before")
+    {
+        CHECK(root.GetAttributeClass("count")->GetValue() == "4000000000");
+        CHECK(to_string(root.GetAttribute("speed")) == "0.25");
+        CHECK(to_string(root.GetAttribute("fixed")) == "1.5000000");
+        CHECK(std::string(root.GetAttribute("negative")) == "-7");
+    }
+
+    SECTION("Read back as numbers")
+    {
+        CHECK(root.GetAttributeAsDword("count") == 4000000000u);
+        CHECK(root.GetAttributeAsFloat("negative") == -7.0f);
+        CHECK(root.GetAttributeAsFloat("speed") == 0.25f);
+        CHECK(root.GetAttributeAsDword("fixed") == 1);
+        CHECK(root.GetAttributeAsDword("missing", 3) == 3);
+        CHECK(root.GetAttributeClass("negative")->GetIntegerValue() == -7);
+        CHECK_FALSE(root.GetAttributeClass("speed")->GetIntegerValue());
+    }
+
+    SECTION("Replaced by a string")
+    {
+        root.SetAttribute("count", std::string_view("text"));
+        CHECK(to_string(root.GetAttribute("count")) == "text");
+        CHECK_FALSE(root.GetAttributeClass("count")->GetIntegerValue());
+    }
+
+    SECTION("Copied and moved")
+    {
+        // one value formatted before the copy, the others after it
+        CHECK(to_string(root.GetAttribute("speed")) == "0.25");
+        const ATTRIBUTES copy = root.Copy();
+        CHECK(to_string(copy.GetAttribute("speed")) == "0.25");
+        CHECK(to_string(copy.GetAttribute("fixed")) == "1.5000000");
+        CHECK(copy.GetAttributeAsDword("count") == 4000000000u);
+
+        ATTRIBUTES moved(string_codec);
+        moved = std::move(*root.GetAttributeClass("fixed"));
+        CHECK(moved.GetValue() == "1.5000000");
+    }
+}
@@ -0,0 +1,134 @@
+#include "storm/file_watcher.hpp"
+#include "stopwatch.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <fstream>
+
+using namespace std::chrono_literals;
+
+namespace
+{
+
+std::filesystem::path TestDirectory()
+{
+    auto path = std::filesystem::temp_directory_path() / "storm_file_watcher_test";
+    std::filesystem::create_directories(path);
+    return path;
+}
+
+void WriteTestFile(const std::filesystem::path &path, const std::string &text)
+{
+    std::ofstream(path, std::ios::binary) << text;
+}
+
+// Dispatch until calls are made or the time is out
+size_t DispatchFor(storm::FileWatcher &watcher, std::chrono::milliseconds timeout = 3s)
+{
+    const auto end = std::chrono::steady_clock::now() + timeout;
+    size_t calls = 0;
+    while (calls == 0 && std::chrono::steady_clock::now() < end)
+    {
+        calls = watcher.Dispatch();
+        std::this_thread::sleep_for(5ms);
+    }
+    return calls;
+}
+
+} // namespace
+
+TEST_CASE("File watcher reports changes", "[file_watcher]")
+{
+    const auto useNative = GENERATE(true, false);
+    storm::FileWatcher watcher(20ms, useNative);
+
+    const auto path = TestDirectory() / (useNative ? "native.ini" : "polled.ini");
+    std::filesystem::remove(path);
+    WriteTestFile(path, "[Sail]\n");
+
+    int32_t changes = 0, otherChanges = 0;
+    const auto id = watcher.Watch(path, [&] { changes++; });
+    const auto other = watcher.Watch(path, [&] { otherChanges++; });
+    REQUIRE(id != 0);
+    REQUIRE(other != id);
+    CHECK(watcher.GetPolledCount() == (useNative ? 0 : 1));
+    CHECK(watcher.Dispatch() == 0);
+
+    WriteTestFile(path, "[Sail]\nwind = 2\n");
+    CHECK(DispatchFor(watcher) == 2);
+    CHECK(changes == 1);
+    CHECK(otherChanges == 1);
+
+    watcher.Unwatch(other);
+    std::filesystem::remove(path);
+    CHECK(DispatchFor(watcher) == 1);
+    CHECK(changes == 2);
+    CHECK(otherChanges == 1);
+
+    WriteTestFile(path, "[Flag]\n");
+    CHECK(DispatchFor(watcher) == 1);
+    CHECK(changes == 3);
+
+    watcher.Unwatch(id);
+    WriteTestFile(path, "[Vant]\n");
+    CHECK(DispatchFor(watcher, 200ms) == 0);
+    CHECK(changes == 3);
+}
+
+TEST_CASE("File watcher callbacks can unwatch", "[file_watcher]")
+{
+    storm::FileWatcher watcher(20ms);
+    const auto path = TestDirectory() / "unwatch.ini";
+    WriteTestFile(path, "1");
+
+    int32_t calls = 0;
+    uint32_t first = 0, second = 0;
+    first = watcher.Watch(path, [&] {
+        calls++;
+        watcher.Unwatch(second);
+    });
+    second = watcher.Watch(path, [&] {
+        calls++;
+        watcher.Unwatch(first);
+    });
+
+    WriteTestFile(path, "22");
+    CHECK(DispatchFor(watcher) == 1);
+    CHECK(calls == 1);
+}
+
+TEST_CASE("File watcher against polling every frame", "[file_watcher][.benchmark]")
+{
+    // a fleet of ships, every sail, flag, vant and mast entity checked rigging.ini every frame
+    constexpr size_t entities = 200;
+    constexpr size_t frames = 300;
+    const auto path = TestDirectory() / "rigging.ini";
+    WriteTestFile(path, "[SAILS]\n");
+
+    storm::Stopwatch pollTime, watchTime;
+    size_t changed = 0;
+    const auto lastTime = std::filesystem::last_write_time(path);
+    pollTime.measure([&] {
+        for (size_t frame = 0; frame < frames; frame++)
+            for (size_t entity = 0; entity < entities; entity++)
+                if (std::filesystem::exists(path))
+                    changed += std::filesystem::last_write_time(path) != lastTime;
+    });
+
+    storm::FileWatcher watcher;
+    std::vector<bool> reload(entities);
+    for (size_t entity = 0; entity < entities; entity++)
+        watcher.Watch(path, [&reload, entity] { reload[entity] = true; });
+    watchTime.measure([&] {
+        for (size_t frame = 0; frame < frames; frame++)
+        {
+            changed += watcher.Dispatch();
+            for (size_t entity = 0; entity < entities; entity++)
+                changed += reload[entity];
+        }
+    });
+
+    WARN(entities << " entities, us/frame stat polling: " << pollTime.microseconds(frames)
+                  << ", watcher: " << watchTime.microseconds(frames));
+    CHECK(changed == 0);
+}
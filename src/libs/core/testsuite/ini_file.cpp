@@ -0,0 +1,292 @@
+#include "file_service.h"
+#include "stopwatch.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <sstream>
+
+namespace
+{
+
+const char *TEST_INI = "; header\r\n"
+                       "global = 1\r\n"
+                       "[Ship]\r\n"
+                       "Name = Frigate\r\n"
+                       "speed=  12.5  \r\n"
+                       "Cannon = left\r\n"
+                       "; between\r\n"
+                       "cannon = right\r\n"
+                       "CANNON = back\r\n"
+                       "flag\r\n"
+                       "[ship]\r\n"
+                       "name = duplicate\r\n"
+                       "[Sails]\r\n"
+                       "count = 3\r\n";
+
+std::filesystem::path TestDirectory()
+{
+    auto path = std::filesystem::temp_directory_path() / "storm_ini_test";
+    std::filesystem::create_directories(path);
+    return path;
+}
+
+std::string WriteTestFile(const std::string &name, const std::string &text)
+{
+    const auto path = TestDirectory() / name;
+    std::ofstream(path, std::ios::binary) << text;
+    return path.string();
+}
+
+std::string ReadTestFile(const std::string &path)
+{
+    std::ifstream file(path, std::ios::binary);
+    return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+}
+
+} // namespace
+
+TEST_CASE("Ini file lookup", "[ini]")
+{
+    const auto path = WriteTestFile("lookup.ini", TEST_INI);
+    const auto ini = fio->OpenIniFile(path.c_str());
+    REQUIRE(ini != nullptr);
+
+    char buffer[256];
+    REQUIRE(ini->GetInt(nullptr, "GLOBAL", 0) == 1);
+    REQUIRE(ini->ReadString("ship", "name", buffer, sizeof(buffer), ""));
+    CHECK(std::string(buffer) == "Frigate");
+    CHECK(ini->GetFloat("Ship", "Speed", 0.0f) == 12.5f);
+    CHECK_FALSE(ini->ReadString("Ship", "missing", buffer, sizeof(buffer), "def"));
+    CHECK(std::string(buffer) == "def");
+    CHECK_FALSE(ini->ReadString("Masts", "count", buffer, sizeof(buffer), "def"));
+
+    SECTION("Keys with the same name")
+    {
+        std::vector<std::string> cannons;
+        REQUIRE(ini->ReadString("Ship", "cannon", buffer, sizeof(buffer), ""));
+        do
+            cannons.emplace_back(buffer);
+        while (ini->ReadStringNext("Ship", "Cannon", buffer, sizeof(buffer)));
+        CHECK(cannons == std::vector<std::string>{"left", "right", "back"});
+    }
+
+    SECTION("Keys and sections")
+    {
+        CHECK(ini->TestKey("Ship", "flag", nullptr));
+        CHECK(ini->TestKey("Ship", "cannon", "RIGHT"));
+        CHECK_FALSE(ini->TestKey("Ship", "cannon", "front"));
+        CHECK_FALSE(ini->TestKey("Ship", "; between", nullptr));
+        CHECK(ini->TestSection("sails"));
+
+        std::vector<std::string> sections;
+        for (auto found = ini->GetSectionName(buffer, sizeof(buffer)); found;
+             found = ini->GetSectionNameNext(buffer, sizeof(buffer)))
+            sections.emplace_back(buffer);
+        CHECK(sections == std::vector<std::string>{"Ship", "ship", "Sails"});
+    }
+}
+
+TEST_CASE("Ini file writes", "[ini]")
+{
+    const auto path = WriteTestFile("writes.ini", TEST_INI);
+    {
+        const auto ini = fio->OpenIniFile(path.c_str());
+        REQUIRE(ini != nullptr);
+        ini->WriteString("Ship", "name", "Brig");
+        ini->WriteLong("Masts", "count", 2);
+        ini->AddString("Ship", "cannon", "front");
+        ini->DeleteKey("Ship", "cannon", "right");
+        ini->DeleteSection("Sails");
+
+        char buffer[256];
+        std::vector<std::string> cannons;
+        REQUIRE(ini->ReadString("Ship", "cannon", buffer, sizeof(buffer), ""));
+        do
+            cannons.emplace_back(buffer);
+        while (ini->ReadStringNext("Ship", "cannon", buffer, sizeof(buffer)));
+        CHECK(cannons == std::vector<std::string>{"left", "back", "front"});
+
+        // strings replaced many times are repacked
+        for (int32_t n = 0; n < 20000; n++)
+            ini->WriteLong("Masts", "height", n);
+        CHECK(ini->GetInt("Masts", "height", 0) == 19999);
+        CHECK(ini->GetInt("Masts", "count", 0) == 2);
+        ini->ReadString("Ship", "name", buffer, sizeof(buffer), "");
+        CHECK(std::string(buffer) == "Brig");
+    }
+
+    const auto text = ReadTestFile(path);
+    CHECK(text.find("Name = Brig\r\n") != std::string::npos);
+    CHECK(text.find("[Masts]\r\ncount = 2\r\nheight = 19999\r\n") != std::string::npos);
+    CHECK(text.find("; between\r\nCANNON = back\r\nflag\r\ncannon = front\r\n") != std::string::npos);
+    CHECK(text.find("[Sails]") == std::string::npos);
+}
+
+TEST_CASE("Ini file cache follows the file on disk", "[ini]")
+{
+    const auto path = WriteTestFile("cache.ini", "[Ship]\r\nname = Frigate\r\n");
+    char buffer[256];
+    {
+        const auto ini = fio->OpenIniFile(path.c_str());
+        REQUIRE(ini != nullptr);
+        ini->ReadString("Ship", "name", buffer, sizeof(buffer), "");
+        CHECK(std::string(buffer) == "Frigate");
+
+        // files open at the same time share the data
+        const auto other = fio->OpenIniFile(path.c_str());
+        other->WriteString("Ship", "name", "Brig");
+        ini->ReadString("Ship", "name", buffer, sizeof(buffer), "");
+        CHECK(std::string(buffer) == "Brig");
+    }
+
+    // closed unchanged files come back as they were left
+    {
+        const auto ini = fio->OpenIniFile(path.c_str());
+        ini->ReadString("Ship", "name", buffer, sizeof(buffer), "");
+        CHECK(std::string(buffer) == "Brig");
+    }
+
+    WriteTestFile("cache.ini", "[Ship]\r\nname = Galleon\r\n");
+    std::filesystem::last_write_time(path, std::filesystem::last_write_time(path) + std::chrono::seconds(2));
+    {
+        const auto ini = fio->OpenIniFile(path.c_str());
+        ini->ReadString("Ship", "name", buffer, sizeof(buffer), "");
+        CHECK(std::string(buffer) == "Galleon");
+    }
+
+    std::filesystem::remove(path);
+    CHECK(fio->OpenIniFile(path.c_str()) == nullptr);
+}
+
+// STORM_INI_CORPUS may point to a directory with the game ini files, otherwise large files are made up
+TEST_CASE("Ini file corpus", "[ini][.benchmark]")
+{
+    std::vector<std::string> texts;
+    if (const auto *corpus = std::getenv("STORM_INI_CORPUS"))
+    {
+        for (const auto &entry : std::filesystem::recursive_directory_iterator(corpus))
+        {
+            if (entry.is_regular_file() && storm::iEquals(entry.path().extension().string(), std::string(".ini")))
+                texts.push_back(ReadTestFile(entry.path().string()));
+        }
+    }
+    else
+    {
+        std::mt19937 gen(4);
+        std::uniform_int_distribution<int32_t> value(0, 100000);
+        for (int32_t file = 0; file < 40; file++)
+        {
+            std::string text = "; made up\r\n";
+            for (int32_t section = 0; section < 150; section++)
+            {
+                text += "[Section" + std::to_string(section) + "]\r\n";
+                for (int32_t key = 0; key < 40; key++)
+                    text += "Key" + std::to_string(key) + " = " + std::to_string(value(gen)) + ", 0.5, text\r\n";
+            }
+            texts.push_back(std::move(text));
+        }
+    }
+    REQUIRE(!texts.empty());
+
+    // section and key names of every file, to read them back
+    struct Entry
+    {
+        std::string section, key;
+    };
+    struct Section
+    {
+        std::string name;
+        std::vector<std::string> keys;
+    };
+    std::vector<std::string> paths;
+    std::vector<std::vector<Entry>> entries;
+    std::vector<std::vector<Section>> sections;
+    size_t corpusSize = 0;
+    for (size_t n = 0; n < texts.size(); n++)
+    {
+        paths.push_back(WriteTestFile("corpus_" + std::to_string(n) + ".ini", texts[n]));
+        corpusSize += texts[n].size();
+
+        auto &fileEntries = entries.emplace_back();
+        auto &fileSections = sections.emplace_back(1);
+        std::string section;
+        std::istringstream lines(texts[n]);
+        for (std::string line; std::getline(lines, line);)
+        {
+            line.erase(line.find_last_not_of(" \t\r") + 1);
+            line.erase(0, line.find_first_not_of(" \t"));
+            if (line.empty() || line[0] == ';')
+                continue;
+            if (line[0] == '[')
+            {
+                if (line.find(']') != std::string::npos)
+                {
+                    section = line.substr(1, line.find(']') - 1);
+                    fileSections.push_back({section, {}});
+                }
+            }
+            else if (line.find('=') != std::string::npos && line.find('=') > 0)
+            {
+                auto key = line.substr(0, line.find('='));
+                key.erase(key.find_last_not_of(" \t") + 1);
+                fileEntries.push_back({section, key});
+                fileSections.back().keys.push_back(key);
+            }
+        }
+    }
+
+    storm::Stopwatch firstTime, againTime, scanTime;
+    char buffer[1024];
+
+    size_t found = 0;
+    firstTime.measure([&] {
+        for (size_t n = 0; n < paths.size(); n++)
+        {
+            const auto ini = fio->OpenIniFile(paths[n].c_str());
+            REQUIRE(ini != nullptr);
+            for (const auto &entry : entries[n])
+                found +=
+                    ini->TestKey(entry.section.empty() ? nullptr : entry.section.c_str(), entry.key.c_str(), nullptr);
+        }
+    });
+
+    // the location loader opens the same files again
+    size_t reads = 0;
+    againTime.measure([&] {
+        for (size_t n = 0; n < paths.size(); n++)
+        {
+            const auto ini = fio->OpenIniFile(paths[n].c_str());
+            for (const auto &entry : entries[n])
+            {
+                ini->ReadString(entry.section.empty() ? nullptr : entry.section.c_str(), entry.key.c_str(), buffer,
+                                sizeof(buffer), "");
+                reads++;
+            }
+        }
+    });
+
+    // the same lookups walking the sections and then the keys, as the linked lists did
+    size_t scanned = 0;
+    scanTime.measure([&] {
+        for (size_t n = 0; n < paths.size(); n++)
+        {
+            for (const auto &entry : entries[n])
+            {
+                const auto section = std::ranges::find_if(sections[n], [&](const Section &candidate) {
+                    return storm::iEquals(candidate.name, entry.section);
+                });
+                scanned += std::ranges::any_of(section->keys,
+                                               [&](const auto &key) { return storm::iEquals(key, entry.key); });
+            }
+        }
+    });
+
+    WARN(paths.size() << " files, " << corpusSize / 1024 << " KB, " << reads << " keys");
+    WARN("ms open and look up: " << firstTime.milliseconds() << ", open again and read: " << againTime.milliseconds()
+                                 << ", linear scan of the keys alone: " << scanTime.milliseconds());
+    CHECK(found == scanned);
+}
@@ -0,0 +1,37 @@
+#include "message.h"
+
+#include <catch2/catch.hpp>
+
+TEST_CASE("Message params are read back as the format type", "[message]")
+{
+    MESSAGE message;
+
+    SECTION("Numbers are stored as the type of their format char")
+    {
+        message.Reset("blufdi", 7, 70000, 3u, 1.5, 2.5f, entid_t{42});
+        CHECK(message.Byte() == 7);
+        CHECK(message.Long() == 70000);
+        CHECK(message.Dword() == 3);
+        CHECK(message.Float() == 1.5f);
+        CHECK(message.Double() == 2.5);
+        CHECK(message.EntityID() == 42);
+    }
+
+    SECTION("Unsigned values keep their bits")
+    {
+        message.Reset("lu", 0xffffffffu, 0xffffffffu);
+        CHECK(message.Long() == -1);
+        CHECK(message.Dword() == -1);
+    }
+
+    SECTION("Booleans and enums are numbers")
+    {
+        enum class Flag : uint8_t
+        {
+            on = 2
+        };
+        message.Reset("lw", true, Flag::on);
+        CHECK(message.Long() == 1);
+        CHECK(message.Word() == 2);
+    }
+}
@@ -0,0 +1,112 @@
+#include "s_stack.h"
+
+#include <catch2/catch.hpp>
+
+#include <random>
+#include <vector>
+
+namespace
+{
+
+int32_t Value(DATA *data)
+{
+    int32_t value = -1;
+    data->Get(value);
+    return value;
+}
+
+DATA *Push(S_STACK &stack, int32_t value)
+{
+    auto *data = stack.Push();
+    data->Set(value);
+    return data;
+}
+
+} // namespace
+
+TEST_CASE("Script stack slots in blocks", "[core]")
+{
+    constexpr uint32_t kCount = 3 * STACK_BUFFER_BLOCK_SIZE + 7;
+    S_STACK stack;
+
+    SECTION("Slots keep their place when the stack grows")
+    {
+        std::vector<DATA *> slots;
+        for (uint32_t i = 0; i < kCount; i++)
+            slots.push_back(Push(stack, static_cast<int32_t>(i)));
+
+        REQUIRE(stack.GetDataNum() == kCount);
+        for (uint32_t i = 0; i < kCount; i++)
+        {
+            REQUIRE(stack.Read(0, i) == slots[i]);
+            REQUIRE(Value(slots[i]) == static_cast<int32_t>(i));
+        }
+        REQUIRE(stack.Read() == slots.back());
+        REQUIRE_THROWS(stack.Read(1, kCount - 1));
+    }
+
+    SECTION("Pop goes back across the block edges")
+    {
+        for (uint32_t i = 0; i < kCount; i++)
+            Push(stack, static_cast<int32_t>(i));
+
+        for (uint32_t i = kCount; i-- > 0;)
+        {
+            // the popped slot keeps its value until it is pushed again
+            REQUIRE(Value(stack.Pop()) == static_cast<int32_t>(i));
+            if (i > 0)
+                REQUIRE(Value(stack.Read()) == static_cast<int32_t>(i - 1));
+        }
+        REQUIRE(stack.GetDataNum() == 0);
+    }
+
+    SECTION("Push after Pop and InvalidateFrom reuses the same slots")
+    {
+        std::vector<DATA *> slots;
+        for (uint32_t i = 0; i < kCount; i++)
+            slots.push_back(Push(stack, static_cast<int32_t>(i)));
+
+        // down to the first slot of a block and one below it, then up again
+        for (const uint32_t top : {2 * STACK_BUFFER_BLOCK_SIZE, 2 * STACK_BUFFER_BLOCK_SIZE - 1, 5u, 0u})
+        {
+            while (stack.GetDataNum() > top)
+                stack.Pop();
+            for (uint32_t i = top; i < kCount; i++)
+                REQUIRE(Push(stack, -static_cast<int32_t>(i)) == slots[i]);
+        }
+
+        stack.InvalidateFrom(STACK_BUFFER_BLOCK_SIZE);
+        REQUIRE(stack.GetDataNum() == STACK_BUFFER_BLOCK_SIZE);
+        REQUIRE(stack.Read() == slots[STACK_BUFFER_BLOCK_SIZE - 1]);
+        REQUIRE(stack.Push() == slots[STACK_BUFFER_BLOCK_SIZE]);
+    }
+
+    SECTION("Random push and pop match a vector")
+    {
+        std::mt19937 gen(3);
+        std::uniform_int_distribution<int32_t> step(0, 2);
+        std::vector<int32_t> expected;
+        for (int32_t i = 0; i < 200000; i++)
+        {
+            // pushes and pops win in turns, so the stack fills all blocks and empties again
+            const bool filling = i / 10000 % 2 == 0;
+            if (filling == (step(gen) != 0) || expected.empty())
+            {
+                if (expected.size() == kCount)
+                    continue;
+                Push(stack, i);
+                expected.push_back(i);
+            }
+            else
+            {
+                REQUIRE(Value(stack.Pop()) == expected.back());
+                expected.pop_back();
+            }
+            REQUIRE(stack.GetDataNum() == expected.size());
+            if (!expected.empty())
+                REQUIRE(Value(stack.Read()) == expected.back());
+        }
+        for (uint32_t i = 0; i < expected.size(); i++)
+            REQUIRE(Value(stack.Read(0, i)) == expected[i]);
+    }
+}
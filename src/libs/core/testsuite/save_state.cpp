@@ -0,0 +1,585 @@
+#include "storm/save_state.hpp"
+
+#include "attributes.h"
+#include "stopwatch.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <zlib.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <unordered_map>
+
+namespace
+{
+
+// Something like serialized attribute trees: repeated names with small numbers in between
+std::vector<char> MakeState(size_t size, uint32_t seed)
+{
+    static const char *names[] = {"characters", "ship", "cargo", "quest", "location", "reputation", "skill"};
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<int32_t> name(0, 6), value(0, 1000);
+    std::vector<char> state;
+    while (state.size() < size)
+    {
+        const auto *s = names[name(gen)];
+        state.insert(state.end(), s, s + strlen(s) + 1);
+        const auto v = value(gen);
+        const auto *p = reinterpret_cast<const char *>(&v);
+        state.insert(state.end(), p, p + sizeof(v));
+    }
+    state.resize(size);
+    return state;
+}
+
+std::vector<char> Pack(const std::vector<char> &state, const storm::save_state::Options &options,
+                       storm::save_state::Timings &timings)
+{
+    std::vector<char> file;
+    REQUIRE(storm::save_state::Write(
+        state.data(), static_cast<uint32_t>(state.size()), options,
+        [&file](const void *data, size_t size) {
+            file.insert(file.end(), static_cast<const char *>(data), static_cast<const char *>(data) + size);
+            return true;
+        },
+        timings));
+    return file;
+}
+
+// The reader keeps reading from the source after Open, so the source keeps its own offset
+storm::save_state::Source MakeSource(const std::vector<char> &file, size_t offset)
+{
+    return [&file, offset](void *data, size_t size) mutable {
+        if (offset + size > file.size())
+            return false;
+        memcpy(data, file.data() + offset, size);
+        offset += size;
+        return true;
+    };
+}
+
+bool Open(storm::save_state::Reader &reader, const std::vector<char> &file)
+{
+    uint32_t magic;
+    if (file.size() < sizeof(magic))
+        return false;
+    memcpy(&magic, file.data(), sizeof(magic));
+    if (magic != storm::save_state::kMagic)
+        return false;
+    return reader.Open(MakeSource(file, sizeof(magic)));
+}
+
+bool Unpack(const std::vector<char> &file, std::vector<char> &state, uint32_t threads = 0)
+{
+    storm::save_state::Reader reader;
+    if (!Open(reader, file))
+        return false;
+    state.resize(reader.GetSize());
+    reader.Start(state.data(), threads);
+    const auto ok = reader.WaitFor(reader.GetSize());
+    reader.Stop();
+    return ok;
+}
+
+class TestStringCodec : public VSTRING_CODEC
+{
+  public:
+    uint32_t GetNum() override
+    {
+        return static_cast<uint32_t>(names_.size());
+    }
+
+    uint32_t Convert(const char *pString) override
+    {
+        const auto [it, added] = codes_.emplace(pString, static_cast<uint32_t>(names_.size()));
+        if (added)
+            names_.push_back(it->first);
+        return it->second;
+    }
+
+    uint32_t Convert(const char *pString, int32_t iLen) override
+    {
+        return Convert(std::string(pString, iLen).c_str());
+    }
+
+    const char *Convert(uint32_t code) override
+    {
+        return names_[code].c_str();
+    }
+
+    void VariableChanged() override
+    {
+    }
+
+  private:
+    std::unordered_map<std::string, uint32_t> codes_;
+    std::vector<std::string> names_;
+};
+
+// The save layout of COMPILER: the name table once, then attribute trees with name codes
+class StateWriter
+{
+  public:
+    void WriteVDword(uint32_t v)
+    {
+        if (v < 0xfe)
+        {
+            data.push_back(static_cast<char>(v));
+        }
+        else if (v < 0xffff)
+        {
+            data.push_back(static_cast<char>(0xfe));
+            const auto w = static_cast<uint16_t>(v);
+            Write(&w, sizeof(w));
+        }
+        else
+        {
+            data.push_back(static_cast<char>(0xff));
+            Write(&v, sizeof(v));
+        }
+    }
+
+    void WriteString(const char *s)
+    {
+        if (s == nullptr)
+        {
+            WriteVDword(0);
+            return;
+        }
+        const auto n = static_cast<uint32_t>(strlen(s) + 1);
+        WriteVDword(n);
+        Write(s, n);
+    }
+
+    void WriteAttributes(const ATTRIBUTES &a)
+    {
+        WriteVDword(static_cast<uint32_t>(a.GetAttributesNum()));
+        WriteVDword(a.GetThisNameCode());
+        WriteString(a.HasValue() ? a.GetValue().c_str() : nullptr);
+        for (uint32_t n = 0; n < a.GetAttributesNum(); n++)
+            WriteAttributes(*a.GetAttributeClass(n));
+    }
+
+    std::vector<char> data;
+
+  private:
+    void Write(const void *p, size_t size)
+    {
+        data.insert(data.end(), static_cast<const char *>(p), static_cast<const char *>(p) + size);
+    }
+};
+
+// The loader before the container: every string is copied out of the buffer
+char *ReadStringCopy(storm::save_state::StateReader &reader)
+{
+    const auto n = reader.ReadVDword();
+    if (n == 0)
+        return nullptr;
+    auto *s = new char[n];
+    reader.Read(s, n);
+    return s;
+}
+
+// Same as COMPILER::ReadAttributesData used to do, two lookups per node and no reserve
+void ReadAttributesLegacy(storm::save_state::StateReader &reader, ATTRIBUTES *parent)
+{
+    const auto count = reader.ReadVDword();
+    const auto code = reader.ReadVDword();
+    auto *value = ReadStringCopy(reader);
+    parent->SetAttribute(code, std::string_view(value ? value : ""));
+    auto *a = parent->GetAttributeClassByCode(code);
+    delete[] value;
+    for (uint32_t n = 0; n < count; n++)
+        ReadAttributesLegacy(reader, a);
+}
+
+// Characters, ships and quests of a late game campaign, grows until the save has the given size
+std::vector<char> MakeCampaign(size_t size, TestStringCodec &codec, uint32_t &roots)
+{
+    std::mt19937 gen(11);
+    std::uniform_int_distribution<int32_t> name(0, 299), value(0, 100000), children(0, 12);
+    std::vector<std::string> names;
+    for (int32_t i = 0; i < 300; i++)
+        names.push_back("attr" + std::to_string(i));
+
+    ATTRIBUTES root(codec);
+    StateWriter body;
+    roots = 0;
+    while (body.data.size() < size)
+    {
+        root.DeleteAttributeClassX(&root);
+        for (int32_t c = 0; c < 50; c++)
+        {
+            auto &character = root.CreateAttribute("character" + std::to_string(c));
+            for (int32_t i = children(gen); i >= 0; i--)
+            {
+                auto *a = character.CreateSubAClass(&character, names[name(gen)].c_str());
+                a->SetValue(std::to_string(value(gen)));
+                for (int32_t j = children(gen); j >= 0; j--)
+                    a->SetAttribute(names[name(gen)], std::to_string(value(gen)));
+            }
+        }
+        body.WriteAttributes(root);
+        roots++;
+    }
+
+    StateWriter state;
+    state.WriteVDword(codec.GetNum());
+    for (uint32_t n = 0; n < codec.GetNum(); n++)
+        state.WriteString(codec.Convert(n));
+    state.data.insert(state.data.end(), body.data.begin(), body.data.end());
+    return state.data;
+}
+
+size_t CountNodes(const ATTRIBUTES &a)
+{
+    size_t count = 1;
+    for (uint32_t n = 0; n < a.GetAttributesNum(); n++)
+        count += CountNodes(*a.GetAttributeClass(n));
+    return count;
+}
+
+} // namespace
+
+TEST_CASE("Save state round trip", "[core]")
+{
+    storm::save_state::Options options;
+    options.chunk_size = 64 * 1024;
+
+    for (const size_t size : {size_t(1), size_t(4096), size_t(64 * 1024), size_t(64 * 1024 + 1), size_t(1000000)})
+    {
+        for (const uint32_t threads : {1u, 3u})
+        {
+            options.threads = threads;
+            const auto state = MakeState(size, static_cast<uint32_t>(size));
+            storm::save_state::Timings timings;
+            const auto file = Pack(state, options, timings);
+            CHECK(timings.raw_size == size);
+            CHECK(timings.packed_size == file.size());
+            CHECK(timings.chunks == (size + options.chunk_size - 1) / options.chunk_size);
+
+            std::vector<char> unpacked;
+            REQUIRE(Unpack(file, unpacked, threads));
+            REQUIRE(unpacked == state);
+        }
+    }
+}
+
+TEST_CASE("Save state is read while it is unpacked", "[core]")
+{
+    const auto state = MakeState(1000000, 5);
+    storm::save_state::Options options;
+    options.chunk_size = 10000;
+    storm::save_state::Timings timings;
+    const auto file = Pack(state, options, timings);
+
+    for (const uint32_t threads : {0u, 1u, 4u})
+    {
+        storm::save_state::Reader reader;
+        REQUIRE(Open(reader, file));
+        std::vector<char> unpacked(reader.GetSize());
+        reader.Start(unpacked.data(), threads);
+
+        // read it the way the compiler does, a few bytes at a time
+        std::mt19937 gen(threads);
+        std::uniform_int_distribution<uint32_t> step(1, 3000);
+        for (uint32_t end = 0; end < state.size();)
+        {
+            end = std::min<uint32_t>(end + step(gen), static_cast<uint32_t>(state.size()));
+            if (end > reader.GetReadySize())
+                REQUIRE(reader.WaitFor(end));
+            REQUIRE(reader.GetReadySize() >= end);
+            REQUIRE(memcmp(unpacked.data() + end - 1, state.data() + end - 1, 1) == 0);
+        }
+        reader.Stop();
+        REQUIRE(unpacked == state);
+    }
+
+    SECTION("Stopped before the end")
+    {
+        storm::save_state::Reader reader;
+        REQUIRE(Open(reader, file));
+        std::vector<char> unpacked(reader.GetSize());
+        reader.Start(unpacked.data(), 2);
+        REQUIRE(reader.WaitFor(1));
+        reader.Stop();
+    }
+}
+
+TEST_CASE("Save state compression levels", "[core]")
+{
+    const auto state = MakeState(300000, 2);
+    storm::save_state::Options options;
+    options.chunk_size = 100000;
+
+    std::vector<size_t> sizes;
+    for (const int32_t level : {0, 1, 9})
+    {
+        options.level = level;
+        storm::save_state::Timings timings;
+        const auto file = Pack(state, options, timings);
+        std::vector<char> unpacked;
+        REQUIRE(Unpack(file, unpacked));
+        REQUIRE(unpacked == state);
+        sizes.push_back(file.size());
+    }
+    CHECK(sizes[0] > state.size());
+    CHECK(sizes[1] < sizes[0]);
+    CHECK(sizes[2] <= sizes[1]);
+}
+
+TEST_CASE("Save state rejects broken files", "[core]")
+{
+    const auto state = MakeState(200000, 3);
+    storm::save_state::Options options;
+    options.chunk_size = 50000;
+    storm::save_state::Timings timings;
+    const auto file = Pack(state, options, timings);
+    std::vector<char> unpacked;
+
+    SECTION("Truncated")
+    {
+        REQUIRE_FALSE(Unpack(std::vector<char>(file.begin(), file.end() - 10), unpacked));
+    }
+
+    SECTION("Damaged chunk")
+    {
+        auto damaged = file;
+        damaged[damaged.size() / 2] ^= 0x5a;
+        REQUIRE_FALSE(Unpack(damaged, unpacked));
+
+        // chunks before the damaged one are fine
+        storm::save_state::Reader reader;
+        REQUIRE(Open(reader, damaged));
+        unpacked.resize(reader.GetSize());
+        reader.Start(unpacked.data(), 1);
+        REQUIRE(reader.WaitFor(options.chunk_size));
+        REQUIRE_FALSE(reader.WaitFor(reader.GetSize()));
+    }
+
+    SECTION("Wrong header")
+    {
+        auto damaged = file;
+        storm::save_state::Header header;
+        memcpy(&header, damaged.data(), sizeof(header));
+        header.chunk_count++;
+        memcpy(damaged.data(), &header, sizeof(header));
+        REQUIRE_FALSE(Unpack(damaged, unpacked));
+    }
+
+    SECTION("Legacy size is not a magic")
+    {
+        REQUIRE(storm::save_state::kMagic > storm::save_state::kLegacyMaxSize);
+    }
+}
+
+TEST_CASE("Save state packing against a single stream", "[core][.benchmark]")
+{
+    const auto state = MakeState(50 * 1024 * 1024, 4);
+
+    uLongf packedSize = compressBound(static_cast<uLong>(state.size()));
+    std::vector<char> packed(packedSize);
+    storm::Stopwatch singleTime;
+    singleTime.measure([&] {
+        REQUIRE(compress2(reinterpret_cast<Bytef *>(packed.data()), &packedSize,
+                          reinterpret_cast<const Bytef *>(state.data()), static_cast<uLong>(state.size()),
+                          Z_BEST_COMPRESSION) == Z_OK);
+    });
+
+    WARN("single stream: " << packedSize << " bytes, " << singleTime.milliseconds() << " ms");
+    for (const int32_t level : {1, 6, 9})
+    {
+        storm::save_state::Options options;
+        options.level = level;
+        storm::save_state::Timings timings;
+        const auto file = Pack(state, options, timings);
+        WARN("chunks level " << level << ": " << file.size() << " bytes, " << timings.total << " ms, compress "
+                             << timings.compress << " ms in " << timings.chunks << " chunks");
+    }
+}
+
+TEST_CASE("Save state attribute trees load through the container", "[core]")
+{
+    TestStringCodec saveCodec;
+    uint32_t roots;
+    const auto state = MakeCampaign(300000, saveCodec, roots);
+    storm::save_state::Options options;
+    options.chunk_size = 8192;
+    storm::save_state::Timings timings;
+    const auto file = Pack(state, options, timings);
+
+    // the same state from an unpacked buffer and while the container is read and unpacked
+    const auto load = [&](storm::save_state::Reader *reader, std::vector<char> &data, VSTRING_CODEC &codec,
+                          ATTRIBUTES &root) {
+        storm::save_state::StateReader stateReader(data.data(), static_cast<uint32_t>(data.size()), reader);
+        const auto names = stateReader.ReadVDword();
+        for (uint32_t n = 0; n < names; n++)
+            codec.Convert(stateReader.ReadStringInPlace());
+        for (uint32_t n = 0; n < roots; n++)
+        {
+            root.DeleteAttributeClassX(&root);
+            stateReader.ReadAttributes(&root);
+        }
+        REQUIRE_FALSE(stateReader.IsBroken());
+        REQUIRE(stateReader.GetPosition() == data.size());
+    };
+
+    TestStringCodec plainCodec;
+    ATTRIBUTES plain(plainCodec);
+    auto plainData = state;
+    load(nullptr, plainData, plainCodec, plain);
+
+    TestStringCodec codec;
+    ATTRIBUTES root(codec);
+    storm::save_state::Reader reader;
+    REQUIRE(Open(reader, file));
+    std::vector<char> data(reader.GetSize());
+    reader.Start(data.data(), 2);
+    load(&reader, data, codec, root);
+    reader.Stop();
+
+    REQUIRE(root.GetAttributesNum() == 50);
+    REQUIRE(CountNodes(root) == CountNodes(plain));
+    for (uint32_t c = 0; c < 50; c++)
+    {
+        const auto *a = root.GetAttributeClass(c);
+        const auto *b = plain.GetAttributeClass(c);
+        REQUIRE(std::string(a->GetThisName()) == b->GetThisName());
+        for (uint32_t n = 0; n < a->GetAttributesNum(); n++)
+        {
+            REQUIRE(std::string(a->GetAttributeClass(n)->GetThisName()) == b->GetAttributeClass(n)->GetThisName());
+            REQUIRE(a->GetAttributeClass(n)->GetValue() == b->GetAttributeClass(n)->GetValue());
+        }
+    }
+
+    SECTION("Broken chunk")
+    {
+        auto damaged = file;
+        damaged[damaged.size() / 2] ^= 0x5a;
+        storm::save_state::Reader damagedReader;
+        REQUIRE(Open(damagedReader, damaged));
+        std::vector<char> damagedData(damagedReader.GetSize());
+        damagedReader.Start(damagedData.data(), 1);
+        storm::save_state::StateReader stateReader(damagedData.data(), static_cast<uint32_t>(damagedData.size()),
+                                                   &damagedReader);
+        std::vector<char> out(damagedData.size());
+        REQUIRE_FALSE(stateReader.Read(out.data(), static_cast<uint32_t>(out.size())));
+        REQUIRE(stateReader.IsBroken());
+        damagedReader.Stop();
+    }
+}
+
+TEST_CASE("Save state keeps attributes without a value apart from empty ones", "[core]")
+{
+    TestStringCodec codec;
+    ATTRIBUTES source(codec);
+    source.SetAttribute("empty", std::string_view());
+    source.CreateAttribute("none");
+    source.SetValue(std::string_view("root"));
+    StateWriter writer;
+    writer.WriteAttributes(source);
+
+    ATTRIBUTES root(codec);
+    root.SetValue(std::string_view("old"));
+    root.SetAttribute("none", std::string_view("old"));
+    storm::save_state::StateReader reader(writer.data.data(), static_cast<uint32_t>(writer.data.size()), nullptr);
+    reader.ReadAttributes(&root);
+
+    REQUIRE_FALSE(reader.IsBroken());
+    REQUIRE(root.GetValue() == "root");
+    REQUIRE(root.GetAttributeClass("empty")->HasValue());
+    REQUIRE(root.GetAttributeClass("empty")->GetValue().empty());
+    REQUIRE_FALSE(root.GetAttributeClass("none")->HasValue());
+}
+
+// STORM_SAVE_BENCHMARK_MB sets the size of the uncompressed save, 50 MB by default
+TEST_CASE("Save state load against a single stream", "[core][.benchmark]")
+{
+    const auto *env = std::getenv("STORM_SAVE_BENCHMARK_MB");
+    const size_t size = (env ? std::strtoul(env, nullptr, 10) : 50) * 1024 * 1024;
+
+    TestStringCodec saveCodec;
+    uint32_t roots;
+    const auto state = MakeCampaign(size, saveCodec, roots);
+
+    // the old layout: one zlib stream
+    uLongf legacySize = compressBound(static_cast<uLong>(state.size()));
+    std::vector<char> legacy(legacySize);
+    REQUIRE(compress2(reinterpret_cast<Bytef *>(legacy.data()), &legacySize,
+                      reinterpret_cast<const Bytef *>(state.data()), static_cast<uLong>(state.size()),
+                      Z_BEST_COMPRESSION) == Z_OK);
+    legacy.resize(legacySize);
+
+    storm::save_state::Timings timings;
+    const auto file = Pack(state, storm::save_state::Options{}, timings);
+
+    const auto load = [&](bool container) {
+        TestStringCodec codec;
+        ATTRIBUTES root(codec);
+        storm::Stopwatch time;
+        time.measure([&] {
+            std::vector<char> data(state.size());
+            storm::save_state::Reader reader;
+            if (container)
+            {
+                REQUIRE(Open(reader, file));
+                reader.Start(data.data());
+            }
+            else
+            {
+                uLongf dataSize = static_cast<uLong>(data.size());
+                REQUIRE(uncompress(reinterpret_cast<Bytef *>(data.data()), &dataSize,
+                                   reinterpret_cast<const Bytef *>(legacy.data()), legacySize) == Z_OK);
+            }
+
+            storm::save_state::StateReader stateReader(data.data(), static_cast<uint32_t>(data.size()),
+                                                       container ? &reader : nullptr);
+            const auto names = stateReader.ReadVDword();
+            for (uint32_t n = 0; n < names; n++)
+            {
+                if (container)
+                {
+                    codec.Convert(stateReader.ReadStringInPlace());
+                }
+                else
+                {
+                    auto *name = ReadStringCopy(stateReader);
+                    codec.Convert(name);
+                    delete[] name;
+                }
+            }
+            for (uint32_t n = 0; n < roots; n++)
+            {
+                root.DeleteAttributeClassX(&root);
+                if (container)
+                {
+                    stateReader.ReadAttributes(&root);
+                }
+                else
+                {
+                    stateReader.ReadVDword();
+                    stateReader.ReadVDword();
+                    delete[] ReadStringCopy(stateReader);
+                    for (uint32_t c = 0; c < 50; c++)
+                        ReadAttributesLegacy(stateReader, &root);
+                }
+            }
+            REQUIRE_FALSE(stateReader.IsBroken());
+            reader.Stop();
+        });
+
+        REQUIRE(root.GetAttributesNum() == 50);
+        REQUIRE(CountNodes(root) > 50);
+        return time.milliseconds();
+    };
+
+    const auto legacyTime = load(false);
+    const auto containerTime = load(true);
+    WARN("save: " << state.size() << " bytes, single stream " << legacy.size() << " bytes, container " << file.size()
+                  << " bytes in " << timings.chunks << " chunks");
+    WARN("load ms single stream: " << legacyTime << ", container: " << containerTime << " ("
+                                   << std::thread::hardware_concurrency() << " threads)");
+}
@@ -7,6 +7,8 @@
 #define SENTRY_BUILD_STATIC 1
 #include <sentry.h>
 
+#include "stage_profiler.hpp"
+
 namespace storm::diag
 {
 
@@ -49,8 +51,11 @@ class LifecycleDiagnosticsService final
 
     [[maybe_unused, nodiscard("This guard shall exist until stack unwind")]] Guard initialize(bool enableCrashReports);
     void terminate() const;
+    // closes the frame of the stage profiler too
     void notifyAfterRun() const;
     void setCrashInfoCollector(crash_info_collector f);
+    // timings of entity stages and script events, its csv goes into the crash report logs when enabled
+    [[nodiscard]] StageProfiler &stageProfiler() const;
 
   private:
     bool initialized_{false};
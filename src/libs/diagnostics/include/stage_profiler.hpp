@@ -0,0 +1,145 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace storm::diag
+{
+
+// Per-frame timing of entity stages and script events.
+// Disabled by default, when disabled every probe costs a single atomic load.
+class StageProfiler final
+{
+  public:
+    using clock = std::chrono::steady_clock;
+
+    enum class Category : uint8_t
+    {
+        execute,
+        realize,
+        script_event
+    };
+
+    // number of frames kept for the rolling per-frame histograms
+    static constexpr size_t kWindowFrames = 256;
+    // number of last samples kept for the trace dump
+    static constexpr size_t kTraceCapacity = 1 << 16;
+
+    // name() returns the string shown in dumps, called only the first time the key is recorded
+    template <typename NameFn = std::nullptr_t> class Scope
+    {
+      public:
+        Scope(StageProfiler &profiler, Category category, uint64_t key, NameFn name = {})
+            : profiler_(profiler.isEnabled() ? &profiler : nullptr), category_(category), key_(key), name_(name)
+        {
+            if (profiler_)
+            {
+                start_ = clock::now();
+            }
+        }
+
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+        ~Scope()
+        {
+            if (profiler_)
+            {
+                if constexpr (std::is_null_pointer_v<NameFn>)
+                {
+                    profiler_->record(category_, key_, start_, clock::now());
+                }
+                else
+                {
+                    profiler_->record(category_, key_, start_, clock::now(), name_);
+                }
+            }
+        }
+
+      private:
+        StageProfiler *profiler_;
+        Category category_;
+        uint64_t key_;
+        NameFn name_;
+        clock::time_point start_;
+    };
+
+    StageProfiler();
+
+    void setEnabled(bool enabled);
+    [[nodiscard]] bool isEnabled() const noexcept
+    {
+        return enabled_.load(std::memory_order_relaxed);
+    }
+
+    // closes current frame and moves per-frame totals into the rolling window
+    void nextFrame();
+    void record(Category category, uint64_t key, clock::time_point start, clock::time_point end);
+    // same, and names the key for dumps if it has no name yet, under the same lock
+    template <typename NameFn>
+    void record(Category category, uint64_t key, clock::time_point start, clock::time_point end, NameFn &name)
+    {
+        std::lock_guard lock(mutex_);
+        auto &stats = recordLocked(category, key, start, end);
+        if (stats.name.empty())
+        {
+            stats.name = name();
+        }
+    }
+    void reset();
+    // drops the execute and realize stats of a deleted entity, its samples in the trace keep only the id
+    void eraseEntity(uint64_t id);
+    // same for all entities, script event stats stay
+    void eraseEntities();
+
+    // chrome://tracing / Perfetto compatible JSON with the last recorded samples
+    bool dumpChromeTrace(const std::filesystem::path &path) const;
+    // one line per entity/event: totals and percentiles of per-frame time over the rolling window,
+    // with tryLock gives up instead of waiting for a probe, as the crash handler may run inside one
+    bool dumpCsv(const std::filesystem::path &path, bool tryLock = false) const;
+
+  private:
+    struct Stats
+    {
+        std::string name;
+        uint64_t calls{};
+        uint64_t totalNs{};
+        uint64_t maxNs{};
+        uint64_t frameNs{};
+        std::array<uint32_t, kWindowFrames> frameUs{};
+    };
+
+    struct Sample
+    {
+        uint64_t key;
+        int64_t startNs;
+        uint32_t durationNs;
+        uint32_t thread;
+        Category category;
+    };
+
+    Stats &recordLocked(Category category, uint64_t key, clock::time_point start, clock::time_point end);
+
+    static uint64_t makeKey(Category category, uint64_t key);
+    static uint32_t getThreadIndex();
+
+    std::atomic<bool> enabled_{false};
+    mutable std::mutex mutex_;
+    std::unordered_map<uint64_t, Stats> stats_;
+    std::vector<Sample> samples_;
+    size_t nextSample_{};
+    size_t frame_{};
+    clock::time_point origin_;
+};
+
+StageProfiler &getStageProfiler();
+
+} // namespace storm::diag
@@ -238,6 +238,8 @@ void LifecycleDiagnosticsService::notifyAfterRun() const
         loggingService_->flushAsync();
         latestFlushTimePoint = now;
     }
+
+    stageProfiler().nextFrame();
 }
 
 void LifecycleDiagnosticsService::setCrashInfoCollector(crash_info_collector f)
@@ -245,6 +247,11 @@ void LifecycleDiagnosticsService::setCrashInfoCollector(crash_info_collector f)
     collectCrashInfo_ = std::move(f);
 }
 
+StageProfiler &LifecycleDiagnosticsService::stageProfiler() const
+{
+    return getStageProfiler();
+}
+
 sentry_value_t LifecycleDiagnosticsService::beforeCrash(const sentry_ucontext_t *uctx, sentry_value_t event,
                                                         void *closure)
 {
@@ -269,6 +276,13 @@ sentry_value_t LifecycleDiagnosticsService::beforeCrash(const sentry_ucontext_t
     }
 #endif
     
+    // the frames before the crash, skipped if the crashed thread holds the profiler
+    if (self->stageProfiler().isEnabled())
+    {
+        self->stageProfiler().dumpCsv(
+            storm::GetEngineSettings().GetEnginePath(storm::EngineSettingsPathType::Logs) / "stage_profile.csv", true);
+    }
+
     // terminate logging
     self->loggingService_->terminate();
 
@@ -0,0 +1,247 @@
+#include "stage_profiler.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <thread>
+
+namespace
+{
+
+const char *getCategoryName(const storm::diag::StageProfiler::Category category)
+{
+    using Category = storm::diag::StageProfiler::Category;
+    switch (category)
+    {
+    case Category::execute:
+        return "execute";
+    case Category::realize:
+        return "realize";
+    case Category::script_event:
+        return "script_event";
+    }
+    return "unknown";
+}
+
+void writeJsonString(std::ostream &os, const std::string_view &str)
+{
+    os << '"';
+    for (const char c : str)
+    {
+        if (c == '"' || c == '\\')
+        {
+            os << '\\' << c;
+        }
+        else if (static_cast<unsigned char>(c) >= 0x20)
+        {
+            os << c;
+        }
+    }
+    os << '"';
+}
+
+} // namespace
+
+namespace storm::diag
+{
+
+StageProfiler::StageProfiler() : origin_(clock::now())
+{
+}
+
+void StageProfiler::setEnabled(const bool enabled)
+{
+    std::lock_guard lock(mutex_);
+    if (enabled && samples_.empty())
+    {
+        samples_.resize(kTraceCapacity);
+    }
+    enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+void StageProfiler::nextFrame()
+{
+    if (!isEnabled())
+    {
+        return;
+    }
+
+    std::lock_guard lock(mutex_);
+    const size_t slot = frame_ % kWindowFrames;
+    for (auto &[key, stats] : stats_)
+    {
+        stats.frameUs[slot] = static_cast<uint32_t>(std::min<uint64_t>(stats.frameNs / 1000, UINT32_MAX));
+        stats.frameNs = 0;
+    }
+    ++frame_;
+}
+
+void StageProfiler::record(const Category category, const uint64_t key, const clock::time_point start,
+                           const clock::time_point end)
+{
+    std::lock_guard lock(mutex_);
+    recordLocked(category, key, start, end);
+}
+
+StageProfiler::Stats &StageProfiler::recordLocked(const Category category, const uint64_t key,
+                                                  const clock::time_point start, const clock::time_point end)
+{
+    const auto duration = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+    const uint32_t thread = getThreadIndex();
+
+    auto &stats = stats_[makeKey(category, key)];
+    ++stats.calls;
+    stats.totalNs += duration;
+    stats.frameNs += duration;
+    stats.maxNs = std::max(stats.maxNs, duration);
+
+    if (!samples_.empty())
+    {
+        samples_[nextSample_ % samples_.size()] = {
+            key, std::chrono::duration_cast<std::chrono::nanoseconds>(start - origin_).count(),
+            static_cast<uint32_t>(std::min<uint64_t>(duration, UINT32_MAX)), thread, category};
+        ++nextSample_;
+    }
+    return stats;
+}
+
+void StageProfiler::reset()
+{
+    std::lock_guard lock(mutex_);
+    stats_.clear();
+    nextSample_ = 0;
+    frame_ = 0;
+}
+
+void StageProfiler::eraseEntity(const uint64_t id)
+{
+    std::lock_guard lock(mutex_);
+    stats_.erase(makeKey(Category::execute, id));
+    stats_.erase(makeKey(Category::realize, id));
+}
+
+void StageProfiler::eraseEntities()
+{
+    std::lock_guard lock(mutex_);
+    std::erase_if(stats_, [](const auto &entry) {
+        return static_cast<Category>(entry.first >> 62) != Category::script_event;
+    });
+}
+
+bool StageProfiler::dumpChromeTrace(const std::filesystem::path &path) const
+{
+    std::ofstream os(path, std::ios::trunc);
+    if (!os.is_open())
+    {
+        return false;
+    }
+
+    std::lock_guard lock(mutex_);
+    os << "{\"traceEvents\":[";
+    const size_t count = std::min(nextSample_, samples_.size());
+    for (size_t i = nextSample_ - count; i < nextSample_; ++i)
+    {
+        const auto &sample = samples_[i % samples_.size()];
+        const auto it = stats_.find(makeKey(sample.category, sample.key));
+
+        os << (i + count == nextSample_ ? "" : ",") << "\n{\"name\":";
+        writeJsonString(os, it != stats_.end() && !it->second.name.empty() ? it->second.name
+                                                                          : std::to_string(sample.key));
+        os << ",\"cat\":\"" << getCategoryName(sample.category) << "\",\"ph\":\"X\",\"pid\":0,\"tid\":"
+           << sample.thread << ",\"ts\":" << sample.startNs / 1000.0 << ",\"dur\":" << sample.durationNs / 1000.0
+           << '}';
+    }
+    os << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+    return os.good();
+}
+
+bool StageProfiler::dumpCsv(const std::filesystem::path &path, const bool tryLock) const
+{
+    std::unique_lock lock(mutex_, std::defer_lock);
+    if (tryLock)
+    {
+        if (!lock.try_lock())
+        {
+            return false;
+        }
+    }
+    else
+    {
+        lock.lock();
+    }
+
+    std::ofstream os(path, std::ios::trunc);
+    if (!os.is_open())
+    {
+        return false;
+    }
+
+    const size_t frames = std::min(frame_, kWindowFrames);
+
+    struct Row
+    {
+        const Stats *stats;
+        Category category;
+        uint32_t p50, p95, p99, max;
+    };
+    std::vector<Row> rows;
+    rows.reserve(stats_.size());
+
+    std::vector<uint32_t> window;
+    for (const auto &[key, stats] : stats_)
+    {
+        if (stats.calls == 0)
+        {
+            continue;
+        }
+
+        Row row{};
+        row.stats = &stats;
+        row.category = static_cast<Category>(key >> 62);
+        window.assign(stats.frameUs.begin(), stats.frameUs.begin() + frames);
+        std::ranges::sort(window);
+        if (!window.empty())
+        {
+            row.p50 = window[window.size() * 50 / 100];
+            row.p95 = window[window.size() * 95 / 100];
+            row.p99 = window[window.size() * 99 / 100];
+            row.max = window.back();
+        }
+        rows.push_back(row);
+    }
+
+    // most expensive first
+    std::ranges::sort(rows, [](const Row &lhs, const Row &rhs) { return lhs.p95 > rhs.p95; });
+
+    os << "name,category,calls,total_ms,avg_us,max_call_us,frame_p50_us,frame_p95_us,frame_p99_us,frame_max_us\n";
+    for (const auto &row : rows)
+    {
+        const auto &stats = *row.stats;
+        os << '"' << stats.name << "\"," << getCategoryName(row.category) << ',' << stats.calls << ','
+           << stats.totalNs / 1e6 << ',' << stats.totalNs / 1e3 / stats.calls << ',' << stats.maxNs / 1e3 << ','
+           << row.p50 << ',' << row.p95 << ',' << row.p99 << ',' << row.max << '\n';
+    }
+
+    return os.good();
+}
+
+uint64_t StageProfiler::makeKey(const Category category, const uint64_t key)
+{
+    // entity ids keep their index in the low bits, category goes to the top ones
+    return (static_cast<uint64_t>(category) << 62) | (key & ((uint64_t{1} << 62) - 1));
+}
+
+uint32_t StageProfiler::getThreadIndex()
+{
+    static std::atomic<uint32_t> counter{};
+    thread_local const uint32_t index = counter.fetch_add(1, std::memory_order_relaxed);
+    return index;
+}
+
+StageProfiler &getStageProfiler()
+{
+    static StageProfiler profiler;
+    return profiler;
+}
+
+} // namespace storm::diag
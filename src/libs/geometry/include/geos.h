@@ -243,8 +243,21 @@ class GEOS
         VERTEX vrt[3];
     };
 
+    // ray of a batched trace, dist and trg are filled by Trace
+    struct TRACE_RAY
+    {
+        VERTEX src, dst;
+        float dist; // 0..1 on hit, 2.0 if nothing was hit
+        int32_t trg; // hit triangle for GetCollisionDetails, -1 if nothing was hit
+    };
+
     // Trace a ray in local coord-system
     virtual float Trace(VERTEX &src, VERTEX &dst) = 0;
+    // Trace a ray in local coord-system without changing the object state,
+    // safe to call from several threads at once
+    virtual float Trace(const VERTEX &src, const VERTEX &dst, int32_t &trg) const = 0;
+    // Trace a batch of rays in local coord-system, re-entrant as well
+    virtual void Trace(TRACE_RAY *rays, int32_t nrays) const = 0;
 
     // clip in local coord-system
     using ADD_POLYGON_FUNC = bool (*)(const VERTEX *v, int32_t nv);
@@ -253,6 +266,8 @@ class GEOS
 
     // Get detail info on last ray hit or clip
     virtual bool GetCollisionDetails(TRACE_INFO &ti) const = 0;
+    // Get detail info on a hit returned by re-entrant Trace
+    virtual bool GetCollisionDetails(const VERTEX &src, const VERTEX &dst, int32_t trg, TRACE_INFO &ti) const = 0;
 
     //-----------------------------------------
     // all other
@@ -13,8 +13,6 @@ trace and clip functions
 //---------------------------------------------------------------------------
 // Trace main procedure
 //---------------------------------------------------------------------------
-SAVAGE GEOM::_stack[256];
-
 float GEOM::Trace(VERTEX &start, VERTEX &finish)
 {
     if (!(rhead.flags & FLAGS_BSP_PRESENT))
@@ -22,19 +20,58 @@ float GEOM::Trace(VERTEX &start, VERTEX &finish)
     src = DVECTOR(start.x, start.y, start.z);
     dst = DVECTOR(finish.x, finish.y, finish.z);
 
+    SAVAGE stack[TRACE_STACK_SIZE];
+    res_dist = TraceRay(src, dst, stack, traceid);
+    return res_dist;
+}
+
+float GEOM::Trace(const VERTEX &start, const VERTEX &finish, int32_t &trg) const
+{
+    trg = -1;
+    if (!(rhead.flags & FLAGS_BSP_PRESENT))
+        return 2.0f;
+
+    SAVAGE stack[TRACE_STACK_SIZE];
+    return TraceRay(DVECTOR(start.x, start.y, start.z), DVECTOR(finish.x, finish.y, finish.z), stack, trg);
+}
+
+void GEOM::Trace(TRACE_RAY *rays, int32_t nrays) const
+{
+    if (!(rhead.flags & FLAGS_BSP_PRESENT))
+    {
+        for (int32_t r = 0; r < nrays; r++)
+        {
+            rays[r].dist = 2.0f;
+            rays[r].trg = -1;
+        }
+        return;
+    }
+
+    // one stack for the whole batch, the tree stays hot in cache between rays
+    SAVAGE stack[TRACE_STACK_SIZE];
+    for (int32_t r = 0; r < nrays; r++)
+    {
+        auto &ray = rays[r];
+        ray.dist = TraceRay(DVECTOR(ray.src.x, ray.src.y, ray.src.z), DVECTOR(ray.dst.x, ray.dst.y, ray.dst.z), stack,
+                            ray.trg);
+    }
+}
+
+float GEOM::TraceRay(const DVECTOR &src, const DVECTOR &dst, SAVAGE *stack_base, int32_t &trg) const
+{
     double diss, dise, ssrc, sdst, dist;
-    DVECTOR dirvec, tp, V, AV;
-    BSP_NODE *second;
-    BSP_NODE *node;
+    DVECTOR dirvec;
+    const BSP_NODE *second;
+    const BSP_NODE *node;
     SAVAGE *stack;
-    unsigned char *pface;
+    const unsigned char *pface;
     unsigned char t;
 
     diss = 0.0;
     dise = 1.0;
     dirvec = dst - src;
     node = sroot.data();
-    stack = _stack - 1;
+    stack = stack_base - 1;
 
 rec_loop:;
 
@@ -123,7 +160,7 @@ rec_return:;
     if (node->nfaces > 0)
     {
         t = node->nfaces;
-        pface = (unsigned char *)&node->face;
+        pface = reinterpret_cast<const unsigned char *>(&node->face);
 
     loop0:
         const auto face = (static_cast<int32_t>(*(pface + 2)) << 16) | (static_cast<int32_t>(*(pface + 1)) << 8) |
@@ -148,16 +185,14 @@ rec_return:;
         {
             if (U < 0.0f && U > det && V < 0.0f && U + V > det)
             {
-                res_dist = static_cast<float>(dist);
-                traceid = face;
-                return res_dist;
+                trg = face;
+                return static_cast<float>(dist);
             }
         }
         else if (U >= 0.0f && U <= det && V >= 0.0f && U + V <= det)
         {
-            res_dist = static_cast<float>(dist);
-            traceid = face;
-            return res_dist;
+            trg = face;
+            return static_cast<float>(dist);
         }
 
         if (--t > 0)
@@ -171,9 +206,9 @@ rec_return:;
     if (second == nullptr)
     {
     rec_avoid:;
-        if (stack < _stack)
+        if (stack < stack_base)
         {
-            traceid = -1;
+            trg = -1;
             return 2.0f;
         }
 
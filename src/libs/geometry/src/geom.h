@@ -19,12 +19,14 @@ Import library class
 struct SAVAGE
 {
     double dist, dise;
-    BSP_NODE *node, *second;
+    const BSP_NODE *node, *second;
 };
 
 class GEOM : public GEOS
 {
-    static SAVAGE _stack[256];
+    // traversal stack of a single trace, lives on the caller's stack
+    static constexpr int32_t TRACE_STACK_SIZE = 256;
+
     std::vector<CVECTOR> vrt{};
     std::vector<RDF_BSPTRIANGLE> btrg{};
     std::vector<BSP_NODE> sroot{};
@@ -60,6 +62,9 @@ class GEOM : public GEOS
     int32_t traceid;
     DVECTOR src, dst;
 
+    float TraceRay(const DVECTOR &src, const DVECTOR &dst, SAVAGE *stack_base, int32_t &trg) const;
+    bool GetTriangleDetails(const DVECTOR &src, const DVECTOR &dst, int32_t trg, TRACE_INFO &ti) const;
+
   public:
     GEOM(const char *fname, const char *lightname, GEOM_SERVICE &srv, int32_t flags);
     virtual ~GEOM();
@@ -90,8 +95,11 @@ class GEOM : public GEOS
     virtual void Draw(const PLANE *pl, int32_t np, MATERIAL_FUNC mtf) const;
 
     virtual float Trace(VERTEX &src, VERTEX &dst);
+    virtual float Trace(const VERTEX &src, const VERTEX &dst, int32_t &trg) const;
+    virtual void Trace(TRACE_RAY *rays, int32_t nrays) const;
     virtual bool Clip(const PLANE *planes, int32_t nplanes, const VERTEX &center, float radius, ADD_POLYGON_FUNC addpoly);
     virtual bool GetCollisionDetails(TRACE_INFO &ti) const;
+    virtual bool GetCollisionDetails(const VERTEX &src, const VERTEX &dst, int32_t trg, TRACE_INFO &ti) const;
 
     virtual int32_t FindTexture(int32_t start_index, int32_t name_id);
     virtual int32_t GetTexture(int32_t tx) const;
@@ -299,7 +299,17 @@ void GEOM::Draw(const PLANE *pl, int32_t np, MATERIAL_FUNC mtf) const
 
 bool GEOM::GetCollisionDetails(TRACE_INFO &ti) const
 {
-    if (!(rhead.flags & FLAGS_BSP_PRESENT) || traceid == -1)
+    return GetTriangleDetails(src, dst, traceid, ti);
+}
+
+bool GEOM::GetCollisionDetails(const VERTEX &src, const VERTEX &dst, int32_t trg, TRACE_INFO &ti) const
+{
+    return GetTriangleDetails(DVECTOR(src.x, src.y, src.z), DVECTOR(dst.x, dst.y, dst.z), trg, ti);
+}
+
+bool GEOM::GetTriangleDetails(const DVECTOR &src, const DVECTOR &dst, int32_t trg, TRACE_INFO &ti) const
+{
+    if (!(rhead.flags & FLAGS_BSP_PRESENT) || trg == -1)
     {
         ti.a = ti.b = -1.0;
         ti.obj = ti.trg = -1;
@@ -310,11 +320,11 @@ bool GEOM::GetCollisionDetails(TRACE_INFO &ti) const
     // triangle-based coord
     int32_t vindex[3];
     vindex[0] =
-        (btrg[traceid].vindex[0][0] << 0) | (btrg[traceid].vindex[0][1] << 8) | (btrg[traceid].vindex[0][2] << 16);
+        (btrg[trg].vindex[0][0] << 0) | (btrg[trg].vindex[0][1] << 8) | (btrg[trg].vindex[0][2] << 16);
     vindex[1] =
-        (btrg[traceid].vindex[1][0] << 0) | (btrg[traceid].vindex[1][1] << 8) | (btrg[traceid].vindex[1][2] << 16);
+        (btrg[trg].vindex[1][0] << 0) | (btrg[trg].vindex[1][1] << 8) | (btrg[trg].vindex[1][2] << 16);
     vindex[2] =
-        (btrg[traceid].vindex[2][0] << 0) | (btrg[traceid].vindex[2][1] << 8) | (btrg[traceid].vindex[2][2] << 16);
+        (btrg[trg].vindex[2][0] << 0) | (btrg[trg].vindex[2][1] << 8) | (btrg[trg].vindex[2][2] << 16);
 
     const auto ve = dst - src;
     const DVECTOR a = vrt[vindex[1]] - vrt[vindex[0]];
@@ -337,10 +347,10 @@ bool GEOM::GetCollisionDetails(TRACE_INFO &ti) const
 
     // object and triangle
     for (int32_t o = 0; o < rhead.nobjects; o++)
-        if (atriangles[o] > traceid)
+        if (atriangles[o] > trg)
         {
             ti.obj = o;
-            ti.trg = traceid;
+            ti.trg = trg;
             if (o > 0)
                 ti.trg -= atriangles[o - 1];
             break;
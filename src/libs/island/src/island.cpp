@@ -644,32 +644,27 @@ bool ISLAND::GetMovePoint(CVECTOR &vSrc, CVECTOR &vDst, CVECTOR &vRes)
 
     CVECTOR vDir = !(vDst - vSrc);
 
-    std::vector<AIFlowGraph::npoint_t> *PointsSrc, *PointsDst;
+    AIPath.GetNearestPoints(vSrc, 8, aPathPointsSrc);
+    AIPath.GetNearestPoints(vDst, 8, aPathPointsDst);
 
-    PointsSrc = AIPath.GetNearestPoints(vSrc);
-    PointsDst = AIPath.GetNearestPoints(vDst);
-
-    const uint32_t dwSizeSrc = ((*PointsSrc).size() > 8) ? 8 : (*PointsSrc).size();
-    const uint32_t dwSizeDst = ((*PointsDst).size() > 8) ? 8 : (*PointsDst).size();
-
-    for (i = 0; i < dwSizeDst; i++)
-        (*PointsDst)[i].fTemp = Trace(vDst, AIPath.GetPointPos((*PointsDst)[i].dwPnt));
+    for (auto &point : aPathPointsDst)
+        point.fTemp = Trace(vDst, AIPath.GetPointPos(point.dwPnt));
 
     float fMaxDistance = 1e9f;
     uint32_t dwI = INVALID_ARRAY_INDEX, dwJ;
-    for (i = 0; i < dwSizeSrc; i++)
+    for (i = 0; i < aPathPointsSrc.size(); i++)
     {
-        if (Trace(vSrc, AIPath.GetPointPos((*PointsSrc)[i].dwPnt)) < 1.0f)
+        if (Trace(vSrc, AIPath.GetPointPos(aPathPointsSrc[i].dwPnt)) < 1.0f)
             continue;
-        const float fDist1 = sqrtf(~(vSrc - AIPath.GetPointPos((*PointsSrc)[i].dwPnt)));
+        const float fDist1 = sqrtf(~(vSrc - AIPath.GetPointPos(aPathPointsSrc[i].dwPnt)));
         if (fDist1 < 80.0f)
             continue;
-        for (j = 0; j < dwSizeDst; j++)
-            if ((*PointsDst)[j].fTemp > 1.0f)
+        for (j = 0; j < aPathPointsDst.size(); j++)
+            if (aPathPointsDst[j].fTemp > 1.0f)
             {
-                // if (Trace(vDst,AIPath.GetPointPos((*PointsDst)[j].dwPnt)) < 1.0f) continue;
-                const float fDist2 = sqrtf(~(vDst - AIPath.GetPointPos((*PointsDst)[j].dwPnt)));
-                const float fDistance = AIPath.GetPathDistance((*PointsSrc)[i].dwPnt, (*PointsDst)[j].dwPnt);
+                // if (Trace(vDst,AIPath.GetPointPos(aPathPointsDst[j].dwPnt)) < 1.0f) continue;
+                const float fDist2 = sqrtf(~(vDst - AIPath.GetPointPos(aPathPointsDst[j].dwPnt)));
+                const float fDistance = AIPath.GetPathDistance(aPathPointsSrc[i].dwPnt, aPathPointsDst[j].dwPnt);
                 const float fTotalDist = fDistance + fDist1 + fDist2;
                 if (fTotalDist < fMaxDistance && fTotalDist > 0.0f)
                 {
@@ -681,10 +676,7 @@ bool ISLAND::GetMovePoint(CVECTOR &vSrc, CVECTOR &vDst, CVECTOR &vRes)
     }
 
     if (INVALID_ARRAY_INDEX != dwI)
-        vRes = AIPath.GetPointPos((*PointsSrc)[dwI].dwPnt);
-
-    STORM_DELETE(PointsSrc);
-    STORM_DELETE(PointsDst);
+        vRes = AIPath.GetPointPos(aPathPointsSrc[dwI].dwPnt);
 
     return true;
 }
@@ -105,6 +105,7 @@ class ISLAND : public ISLAND_BASE
     std::string sIslandName;
     std::vector<entid_t> aForts;
     AIFlowGraph AIPath;
+    std::vector<AIFlowGraph::npoint_t> aPathPointsSrc, aPathPointsDst; // GetMovePoint buffers
     entid_t AIFortEID{};
 
     FRECT rIsland{};
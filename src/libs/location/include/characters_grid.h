@@ -0,0 +1,143 @@
+//============================================================================================
+//    CharactersGrid
+//--------------------------------------------------------------------------------------------
+// Uniform XZ grid over character positions, rebuilt when characters move.
+// Queries test the positions the grid was built with, characters that moved since
+// are found by widening the radius, and the caller checks the real distances.
+//============================================================================================
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+class CharactersGrid
+{
+  public:
+    void Clear()
+    {
+        items.clear();
+        cellStart.clear();
+        cellItems.clear();
+        cellPos.clear();
+        width = height = 0;
+    }
+
+    // Items are identified by the order they were added in
+    void Add(float x, float z)
+    {
+        items.push_back({x, z});
+    }
+
+    // Cells are sized from the radius most queries use, so a query touches at most 3x3 cells
+    void Build(float queryRadius)
+    {
+        cellStart.clear();
+        cellItems.clear();
+        cellPos.clear();
+        width = height = 0;
+        if (items.empty())
+            return;
+
+        minX = maxX = items[0].x;
+        minZ = maxZ = items[0].z;
+        for (const auto &item : items)
+        {
+            minX = std::min(minX, item.x);
+            maxX = std::max(maxX, item.x);
+            minZ = std::min(minZ, item.z);
+            maxZ = std::max(maxZ, item.z);
+        }
+
+        // Characters standing far apart should not make a huge grid
+        cellSize = std::max(queryRadius, minCellSize);
+        const auto maxCells = 4.0f * static_cast<float>(items.size()) + 16.0f;
+        while (((maxX - minX) / cellSize + 1.0f) * ((maxZ - minZ) / cellSize + 1.0f) > maxCells &&
+               cellSize < maxCellSize)
+            cellSize *= 2.0f;
+        width = static_cast<int32_t>((maxX - minX) / cellSize) + 1;
+        height = static_cast<int32_t>((maxZ - minZ) / cellSize) + 1;
+
+        // Counting sort, items of a cell keep the order they were added in
+        cellStart.assign(static_cast<size_t>(width) * height + 1, 0);
+        for (const auto &item : items)
+            cellStart[GetCell(item.x, item.z) + 1]++;
+        for (size_t i = 1; i < cellStart.size(); i++)
+            cellStart[i] += cellStart[i - 1];
+        auto fill = cellStart;
+        cellItems.resize(items.size());
+        cellPos.resize(items.size());
+        for (uint32_t i = 0; i < items.size(); i++)
+        {
+            const auto k = fill[GetCell(items[i].x, items[i].z)]++;
+            cellItems[k] = i;
+            cellPos[k] = items[i];
+        }
+    }
+
+    // Fill result with items within radius in xz, sorted by index
+    void Query(float x, float z, float radius, std::vector<uint32_t> &result) const
+    {
+        result.clear();
+        if (width == 0 || x + radius < minX || x - radius > maxX || z + radius < minZ || z - radius > maxZ)
+            return;
+        const auto x1 = GetCellX(x - radius);
+        const auto x2 = GetCellX(x + radius);
+        const auto z1 = GetCellZ(z - radius);
+        const auto z2 = GetCellZ(z + radius);
+        const auto radius2 = radius * radius;
+        for (auto cz = z1; cz <= z2; cz++)
+        {
+            const auto *const row = &cellStart[cz * width];
+            for (auto k = row[x1]; k < row[x2 + 1]; k++)
+            {
+                const auto dx = cellPos[k].x - x;
+                const auto dz = cellPos[k].z - z;
+                if (dx * dx + dz * dz <= radius2)
+                    result.push_back(cellItems[k]);
+            }
+        }
+        // Items of a cell are in index order already, survivors of several cells need sorting
+        if (z1 != z2 || x1 != x2)
+            std::sort(result.begin(), result.end());
+    }
+
+    size_t GetCount() const
+    {
+        return items.size();
+    }
+
+  private:
+    struct Item
+    {
+        float x, z;
+    };
+
+    static constexpr float minCellSize = 4.0f;
+    static constexpr float maxCellSize = 65536.0f;
+
+    std::vector<Item> items;
+    std::vector<uint32_t> cellStart; // Items of cell c are cellItems[cellStart[c]..cellStart[c + 1])
+    std::vector<uint32_t> cellItems;
+    std::vector<Item> cellPos; // Positions of cellItems, filtered without jumping around items
+    float minX = 0.0f, minZ = 0.0f, maxX = 0.0f, maxZ = 0.0f;
+    float cellSize = minCellSize;
+    int32_t width = 0, height = 0;
+
+    int32_t GetCellX(float x) const
+    {
+        return std::clamp(static_cast<int32_t>(std::floor((x - minX) / cellSize)), 0, width - 1);
+    }
+
+    int32_t GetCellZ(float z) const
+    {
+        return std::clamp(static_cast<int32_t>(std::floor((z - minZ) / cellSize)), 0, height - 1);
+    }
+
+    int32_t GetCell(float x, float z) const
+    {
+        return GetCellX(x) + GetCellZ(z) * width;
+    }
+};
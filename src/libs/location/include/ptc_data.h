@@ -12,8 +12,11 @@
 
 #include "c_vector.h"
 #include "ptc.h"
+#include "ptc_path_finder.h"
 
 #define PTCDATA_MAXSTEPS 32
+// Bigger direction tables are dropped after loading and paths are searched on demand
+#define PTCDATA_MAXTABLESIZE (4 * 1024 * 1024)
 
 class VDX9RENDER;
 
@@ -33,6 +36,13 @@ class PtcData
         uint32_t c;
     };
 
+    enum class PathMode
+    {
+        Auto,  // Table if it is not bigger than PTCDATA_MAXTABLESIZE, search otherwise
+        Table, // Precomputed direction table from the file
+        Search // A* over triangles
+    };
+
     // --------------------------------------------------------------------------------------------
     // Construction, destruction
     // --------------------------------------------------------------------------------------------
@@ -40,16 +50,23 @@ class PtcData
     PtcData();
     virtual ~PtcData();
 
+    // Set the way paths are found, must be called before loading
+    void SetPathMode(PathMode mode);
     // load the patch
     bool Load(const char *path);
+    // Is the direction table used for paths
+    bool IsPathTable() const;
+    // Memory taken by pathfinding data
+    size_t GetPathMemoryUsage() const;
     // Determine the current position
     int32_t FindNode(const CVECTOR &pos, float &y);
     // Moves "pos" to "to", returns a new node
     int32_t Move(int32_t curNode, const CVECTOR &to, CVECTOR &pos, int32_t depth = 0);
     // Get normal to a node
     void GetNodeNormal(int32_t curNode, CVECTOR &n) const;
-    // Find the direction of the path
-    bool FindPathDir(int32_t curNode, const CVECTOR &cur, int32_t toNode, const CVECTOR &to, int32_t &node, CVECTOR &toPos);
+    // Find the direction of the path, corridor is kept by the caller between calls for searched paths
+    bool FindPathDir(int32_t curNode, const CVECTOR &cur, int32_t toNode, const CVECTOR &to, int32_t &node, CVECTOR &toPos,
+                     PtcPathFinder::Corridor &corridor);
     // Find patch intersection
     float Trace(const CVECTOR &s, const CVECTOR &d) const;
     // Find the force pushing away from the edges
@@ -79,7 +96,7 @@ class PtcData
     // --------------------------------------------------------------------------------------------
   private:
     // Protection function
-    void SFLB_PotectionLoad();
+    void SFLB_PotectionLoad(bool useTable);
 
     // Calculate the height of a point on the plane of a triangle
     float FindHeight(int32_t trgID, float x, float z);
@@ -121,8 +138,12 @@ class PtcData
     int32_t numIndeces;   // Number of indexes
 
     // Pathfinding data
-    uint8_t *table; // Direction table
+    uint8_t *table; // Direction table, nullptr if paths are searched
     int32_t lineSize;  // Line size
+    PathMode pathMode;
+    PtcPathFinder pathFinder;
+    const uint8_t *pathEdges; // Corridor edges of the current search
+    int32_t numPathEdges;
 
     // Triangles after collision
     Triangle *ctriangle;
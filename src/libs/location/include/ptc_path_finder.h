@@ -0,0 +1,79 @@
+//============================================================================================
+//    PtcPathFinder
+//--------------------------------------------------------------------------------------------
+// On demand path search over the patch triangles, replaces the precomputed direction table
+// of the patch. Memory grows linearly with the number of triangles instead of quadratically.
+//============================================================================================
+
+#pragma once
+
+#include "c_vector.h"
+#include "ptc.h"
+
+#include <cstdint>
+#include <vector>
+
+class PtcPathFinder
+{
+  public:
+    // Triangles to go through, edges[i] is the edge of nodes[i] leading to nodes[i + 1]
+    struct Corridor
+    {
+        std::vector<int32_t> nodes;
+        std::vector<uint8_t> edges;
+        float length = 0.0f; // Length of the searched path, a reused corridor keeps it
+        uint32_t patch = 0;  // Init call of any finder the corridor was searched after
+    };
+
+    void Init(const PtcTriangle *triangles, int32_t numTriangles, const PtcVertex *vertices);
+    void Release();
+
+    // Find the corridor from curNode to toNode, false if toNode can't be reached
+    // The corridor is kept by the caller, while curNode stays inside it only the walked part is dropped
+    bool FindCorridor(int32_t curNode, const CVECTOR &cur, int32_t toNode, const CVECTOR &to, Corridor &corridor);
+    // Search without heuristic, for checks
+    // The result stays valid until the next search
+    const Corridor *FindCorridorDijkstra(int32_t curNode, const CVECTOR &cur, int32_t toNode, const CVECTOR &to);
+
+    // Memory taken by the search data
+    size_t GetMemoryUsage() const;
+
+  private:
+    struct Node
+    {
+        float g;       // Path length to the entry point
+        CVECTOR entry; // Point where the path enters the triangle
+        int32_t parent;
+        uint8_t edge; // Edge of the parent the path came through
+        uint32_t visited;
+        uint32_t closed;
+    };
+
+    struct QueueItem
+    {
+        float f;
+        int32_t node;
+
+        bool operator<(const QueueItem &item) const
+        {
+            return f > item.f;
+        }
+    };
+
+    bool Search(int32_t curNode, const CVECTOR &cur, int32_t toNode, const CVECTOR &to, bool useHeuristic,
+                Corridor &corridor);
+    bool Reuse(int32_t curNode, int32_t toNode, Corridor &corridor) const;
+    CVECTOR EdgeMiddle(int32_t node, int32_t edge) const;
+
+    const PtcTriangle *triangle = nullptr;
+    const PtcVertex *vertex = nullptr;
+    int32_t numTriangles = 0;
+
+    std::vector<Node> nodes;
+    std::vector<QueueItem> queue;
+    uint32_t searchId = 0;
+    // Numbers Init calls of all finders, corridors found on another patch are never reused
+    uint32_t patch = 0;
+
+    Corridor result;
+};
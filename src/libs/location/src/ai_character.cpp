@@ -477,7 +477,7 @@ bool AICharacter::FindDirectional()
         return false;
     auto *const location = GetLocation();
     if (!location->GetPtcData().FindPathDir(command.tnode, CVECTOR(command.tpnt), command.node, command.pnt,
-                                            command.tnode, command.tpnt))
+                                            command.tnode, command.tpnt, pathCorridor))
         return false;
     if (location->IsDebugView())
     {
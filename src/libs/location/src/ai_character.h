@@ -11,6 +11,7 @@
 #pragma once
 
 #include "character.h"
+#include "ptc_path_finder.h"
 
 class AICharacter : public Character
 {
@@ -132,6 +133,8 @@ class AICharacter : public Character
     // Current command
     Command command;
     PathNode path[2];
+    // Path to the command node, kept while walking along it
+    PtcPathFinder::Corridor pathCorridor;
     // Preferred speed factor
     float likeKSpd;
     float collisionValue;
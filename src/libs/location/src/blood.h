@@ -51,6 +51,12 @@ class Blood : public Entity
     //
     uint64_t ProcessMessage(MESSAGE &message) override;
 
+    // execute only ages own blood spots and fades their vertex colors
+    [[nodiscard]] ExecutePolicy GetExecutePolicy() const override
+    {
+        return ExecutePolicy::parallel;
+    }
+
     void ProcessStage(Stage stage, uint32_t delta) override
     {
         switch (stage)
@@ -1150,6 +1150,7 @@ bool Character::Teleport(float x, float y, float z)
     // New coordinates
     man->mtx.SetPosition(x, y, z);
     curPos = oldPos = grsPos = CVECTOR(x, y, z);
+    location->supervisor.InvalidateGrid();
     vy = 0.0f;
     float bearingY;
     currentNode = location->GetPtcData().FindNode(curPos, bearingY);
@@ -1171,6 +1172,7 @@ bool Character::Teleport(float x, float y, float z, float ay)
     // New coordinates
     man->mtx.BuildMatrix(0.0f, ay, 0.0f, x, y, z);
     curPos = oldPos = grsPos = CVECTOR(x, y, z);
+    location->supervisor.InvalidateGrid();
     vy = 0.0f;
     Turn(ay);
     this->ay = nay;
@@ -2480,7 +2482,7 @@ void Character::Update(float dltTime)
             {
                 tuner.alpha = 1.0f;
                 liveValue = 0.0f;
-                core.Event("Location_CharacterEntryToLocation", "e", GetId());
+                core.Event("Location_CharacterEntryToLocation", "i", GetId());
             }
         }
         else
@@ -2490,11 +2492,11 @@ void Character::Update(float dltTime)
                 tuner.alpha = 0.0f;
                 if (deadName)
                 {
-                    core.Event("Location_CharacterDead", "e", GetId());
+                    core.Event("Location_CharacterDead", "i", GetId());
                 }
                 else
                 {
-                    core.Event("Location_CharacterExitFromLocation", "e", GetId());
+                    core.Event("Location_CharacterExitFromLocation", "i", GetId());
                 }
                 core.EraseEntity(GetId());
             }
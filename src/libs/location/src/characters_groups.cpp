@@ -133,6 +133,7 @@ bool CharactersGroups::Init()
     if (!location)
         return false;
     RegistryGroup("");
+    updateAlarmEvent_ = core.GetEventHandle("CharacterGroup_UpdateAlarm");
     // core.LayerCreate("execute", true, false);
     core.SetLayerType(EXECUTE, layer_type_t::execute);
     core.AddToLayer(EXECUTE, GetId(), 10);
@@ -199,7 +200,7 @@ void CharactersGroups::Execute(uint32_t delta_time)
     if (isDeactivate)
         RemoveAllInvalidTargets();
     // inform about the player's current state of affairs
-    core.Event("CharacterGroup_UpdateAlarm", "fl", playerAlarm, playerActive);
+    core.Event(updateAlarmEvent_, "fl", playerAlarm, playerActive);
     // Executing the characters
     waveTime += dltTime;
     if (curExecuteChr >= 0)
@@ -236,13 +237,13 @@ void CharactersGroups::CharacterVisibleCheck(Character *chr)
         return;
     auto *const grp = groups[gi];
     // Visible area
-    fnd = location->supervisor.FindCharacters(chr, grp->look, CGS_VIEWANGLE, 0.05f);
+    location->supervisor.FindCharacters(fnd, chr, grp->look, CGS_VIEWANGLE, 0.05f);
     if (!fnd.empty())
     {
         FindEnemyFromFindList(chr, grp, true);
     }
     // Audible area
-    fnd = location->supervisor.FindCharacters(chr, grp->hear);
+    location->supervisor.FindCharacters(fnd, chr, grp->hear);
     if (!fnd.empty())
     {
         FindEnemyFromFindList(chr, grp, false);
@@ -273,7 +274,10 @@ void CharactersGroups::FindEnemyFromFindList(Character *chr, Group *grp, bool vi
         }
     }
     // Inform others about the detected targets
-    if (!targets.empty() && !(fnd = location->supervisor.FindCharacters(chr, grp->say)).empty())
+    if (targets.empty())
+        return;
+    location->supervisor.FindCharacters(fnd, chr, grp->say);
+    if (!fnd.empty())
     {
         for (size_t i = 0; i < fnd.size(); i++)
         {
@@ -699,7 +703,7 @@ void CharactersGroups::MsgAddTarget(MESSAGE &message)
     // Adding the enemy
     AddEnemyTarget(chr, enemy, message.Float());
     // Informing others about the new goal
-    fnd = location->supervisor.FindCharacters(chr, groups[g1]->say);
+    location->supervisor.FindCharacters(fnd, chr, groups[g1]->say);
     if (!fnd.empty())
     {
         for (size_t i = 0; i < fnd.size(); i++)
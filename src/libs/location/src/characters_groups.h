@@ -10,6 +10,7 @@
 
 #pragma once
 
+#include "core.h"
 #include "matrix.h"
 #include "vma.hpp"
 
@@ -211,6 +212,7 @@ class CharactersGroups : public Entity
     Location *location;          // Current location
     int32_t curExecuteChr;          // The index of the currently executing character
     float waveTime;              // Time since last wave launch
+    event_handle_t updateAlarmEvent_{event_handle_t::invalid};
 
     // Character search array
     std::vector<Supervisor::FindCharacter> fnd;
@@ -129,7 +129,7 @@ void LocLife::Update(float dltTime)
         }
         // Looking for a direction
         auto dir = pos;
-        if (!ptc.FindPathDir(cnode, pos, node, npos, cnode, dir))
+        if (!ptc.FindPathDir(cnode, pos, node, npos, cnode, dir, pathCorridor))
         {
             StopMove();
             return;
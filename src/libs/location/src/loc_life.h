@@ -12,6 +12,7 @@
 
 #include "animation.h"
 #include "entity.h"
+#include "ptc_path_finder.h"
 
 class Location;
 class Animation;
@@ -60,4 +61,6 @@ class LocLife : public AnimationEventListener
     float ay;
     CVECTOR pos;
     CVECTOR npos;
+    // Path to npos, kept while walking along it
+    PtcPathFinder::Corridor pathCorridor;
 };
@@ -10,6 +10,7 @@
 
 #include "location.h"
 
+#include <algorithm>
 #include <chrono>
 
 #include "core.h"
@@ -557,6 +558,9 @@ bool Location::LoadCharacterPatch(const char *ptcName)
     strcat_s(path, model.modelspath.c_str());
     strcat_s(path, ptcName);
     strcat_s(path, ".ptc");
+    // 0 - choose by the table size, 1 - direction table, 2 - path search
+    const auto pathMode = std::min(AttributesPointer->GetAttributeAsDword("patchPathMode", 0), 2u);
+    ptc.SetPathMode(static_cast<PtcData::PathMode>(pathMode));
     // load the patch
     const auto result = ptc.Load(path);
     if (!result)
@@ -44,6 +44,9 @@ PtcData::PtcData()
     numIndeces = 0;
     table = nullptr;
     lineSize = 0;
+    pathMode = PathMode::Auto;
+    pathEdges = nullptr;
+    numPathEdges = 0;
     ctriangle = nullptr;
     numClTriangles = 0;
     maxClTriangles = 0;
@@ -62,6 +65,13 @@ PtcData::~PtcData()
     delete dbgEdges;
 }
 
+// Set the way paths are found, must be called before loading
+void PtcData::SetPathMode(PathMode mode)
+{
+    Assert(data == nullptr);
+    pathMode = mode;
+}
+
 bool PtcData::Load(const char *path)
 {
     Assert(data == nullptr);
@@ -116,14 +126,42 @@ bool PtcData::Load(const char *path)
         delete buf;
         return false;
     }
+    // Large tables are replaced by the path search
+    const uint32_t tableSize = hdr.lineSize * hdr.numTriangles;
+    const bool useTable =
+        pathMode == PathMode::Table || (pathMode == PathMode::Auto && tableSize <= PTCDATA_MAXTABLESIZE);
+    if (!useTable)
+    {
+        // Cut the table out of the data, materials go to its place
+        const uint32_t tableOffset = size - tableSize - (hdr.ver == PTC_VERSION ? sizeof(PtcMaterials) : 0);
+        auto *const compact = new char[size - tableSize];
+        memcpy(compact, buf, tableOffset);
+        memcpy(compact + tableOffset, buf + tableOffset + tableSize, size - tableOffset - tableSize);
+        delete[] buf;
+        buf = compact;
+    }
     // form data structures
     data = buf;
-    SFLB_PotectionLoad();
+    SFLB_PotectionLoad(useTable);
     return true;
 }
 
+// Is the direction table used for paths
+bool PtcData::IsPathTable() const
+{
+    return table != nullptr;
+}
+
+// Memory taken by pathfinding data
+size_t PtcData::GetPathMemoryUsage() const
+{
+    if (table)
+        return static_cast<size_t>(lineSize) * numTriangles;
+    return pathFinder.GetMemoryUsage();
+}
+
 // Protection function
-void PtcData::SFLB_PotectionLoad()
+void PtcData::SFLB_PotectionLoad(bool useTable)
 {
     // Data
     auto *const buf = static_cast<char *>(data);
@@ -157,11 +195,20 @@ void PtcData::SFLB_PotectionLoad()
     indeces = (uint16_t *)(buf + tsize);
     // Pathfinding data
     tsize += hdr.numIndeces * sizeof(uint16_t);
-    table = (uint8_t *)(buf + tsize);
     lineSize = hdr.lineSize;
+    if (useTable)
+    {
+        table = (uint8_t *)(buf + tsize);
+        tsize += lineSize * numTriangles;
+    }
+    else
+    {
+        table = nullptr;
+        pathFinder.Init(triangle, numTriangles, vertex);
+    }
     // Materials
     if (hdr.ver == PTC_VERSION)
-        materials = (PtcMaterials *)(table + lineSize * numTriangles);
+        materials = (PtcMaterials *)(buf + tsize);
     // Looking for the midpoint
     middle = 0.0f;
     for (int32_t i = 0; i < numVerteces; i++)
@@ -503,11 +550,25 @@ void PtcData::GetNodeNormal(int32_t curNode, CVECTOR &n) const
 }
 
 // Find the direction of the path
-bool PtcData::FindPathDir(int32_t curNode, const CVECTOR &cur, int32_t toNode, const CVECTOR &to, int32_t &node, CVECTOR &toPos)
+bool PtcData::FindPathDir(int32_t curNode, const CVECTOR &cur, int32_t toNode, const CVECTOR &to, int32_t &node, CVECTOR &toPos,
+                          PtcPathFinder::Corridor &corridor)
 {
     numSteps = 0;
     if (curNode < 0 || toNode < 0)
         return false;
+    pathEdges = nullptr;
+    numPathEdges = 0;
+    if (!table)
+    {
+        // Without the table the edges to cross are taken from the corridor
+        if (!pathFinder.FindCorridor(curNode, cur, toNode, to, corridor))
+        {
+            toPos = to;
+            return false;
+        }
+        pathEdges = corridor.edges.data();
+        numPathEdges = static_cast<int32_t>(corridor.edges.size());
+    }
     if (FindPathDir(0, curNode, cur, toNode, to, node, toPos))
         return true;
     toPos = to;
@@ -532,8 +593,16 @@ bool PtcData::FindPathDir(int32_t step, int32_t curNode, const CVECTOR &cur, int
     // Determine in which direction to move (edge)
     Assert(curNode < numTriangles);
     Assert(toNode < numTriangles);
-    uint8_t *line = table + curNode * lineSize;
-    const uint8_t v = (line[toNode >> 2] >> ((toNode & 3) * 2)) & 3;
+    uint8_t v;
+    if (table)
+    {
+        uint8_t *line = table + curNode * lineSize;
+        v = (line[toNode >> 2] >> ((toNode & 3) * 2)) & 3;
+    }
+    else
+    {
+        v = step < numPathEdges ? pathEdges[step] : 3;
+    }
     if (v == 3)
         return false;
     // Edge
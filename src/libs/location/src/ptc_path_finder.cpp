@@ -0,0 +1,165 @@
+//============================================================================================
+//    PtcPathFinder
+//============================================================================================
+
+#include "ptc_path_finder.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+void PtcPathFinder::Init(const PtcTriangle *triangles, int32_t numTriangles, const PtcVertex *vertices)
+{
+    Release();
+    triangle = triangles;
+    vertex = vertices;
+    this->numTriangles = numTriangles;
+    nodes.resize(numTriangles);
+    // Unique across all finders, a character keeps its corridor when it moves to another location
+    static std::atomic<uint32_t> patches{0};
+    patch = patches.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+void PtcPathFinder::Release()
+{
+    triangle = nullptr;
+    vertex = nullptr;
+    numTriangles = 0;
+    nodes.clear();
+    nodes.shrink_to_fit();
+    queue.clear();
+    searchId = 0;
+}
+
+bool PtcPathFinder::FindCorridor(int32_t curNode, const CVECTOR &cur, int32_t toNode, const CVECTOR &to,
+                                 Corridor &corridor)
+{
+    if (curNode < 0 || curNode >= numTriangles || toNode < 0 || toNode >= numTriangles)
+        return false;
+    if (Reuse(curNode, toNode, corridor))
+        return true;
+    corridor.patch = patch;
+    return Search(curNode, cur, toNode, to, true, corridor);
+}
+
+const PtcPathFinder::Corridor *PtcPathFinder::FindCorridorDijkstra(int32_t curNode, const CVECTOR &cur, int32_t toNode,
+                                                                   const CVECTOR &to)
+{
+    if (curNode < 0 || curNode >= numTriangles || toNode < 0 || toNode >= numTriangles)
+        return nullptr;
+    return Search(curNode, cur, toNode, to, false, result) ? &result : nullptr;
+}
+
+size_t PtcPathFinder::GetMemoryUsage() const
+{
+    size_t size = nodes.capacity() * sizeof(Node) + queue.capacity() * sizeof(QueueItem);
+    size += result.nodes.capacity() * sizeof(int32_t) + result.edges.capacity();
+    return size;
+}
+
+// A* over triangles, the path goes through the middles of the crossed edges
+bool PtcPathFinder::Search(int32_t curNode, const CVECTOR &cur, int32_t toNode, const CVECTOR &to, bool useHeuristic,
+                           Corridor &corridor)
+{
+    corridor.nodes.clear();
+    corridor.edges.clear();
+    corridor.length = 0.0f;
+
+    if (++searchId == 0)
+    {
+        // Stamps wrapped around, forget all of them
+        for (auto &node : nodes)
+            node.visited = node.closed = 0;
+        searchId = 1;
+    }
+
+    const auto distance = [](const CVECTOR &a, const CVECTOR &b) {
+        return sqrtf((a.x - b.x) * (a.x - b.x) + (a.z - b.z) * (a.z - b.z));
+    };
+    const auto heuristic = [&](const CVECTOR &p) { return useHeuristic ? distance(p, to) : 0.0f; };
+
+    queue.clear();
+    auto &start = nodes[curNode];
+    start.g = 0.0f;
+    start.entry = cur;
+    start.parent = -1;
+    start.edge = 3;
+    start.visited = searchId;
+    queue.push_back({heuristic(cur), curNode});
+
+    float length = -1.0f;
+    while (!queue.empty())
+    {
+        std::pop_heap(queue.begin(), queue.end());
+        const auto item = queue.back();
+        queue.pop_back();
+
+        auto &node = nodes[item.node];
+        if (node.closed == searchId)
+            continue;
+        node.closed = searchId;
+
+        if (item.node == toNode)
+        {
+            length = node.g + distance(node.entry, to);
+            break;
+        }
+
+        for (int32_t j = 0; j < 3; j++)
+        {
+            const int32_t nb = triangle[item.node].nb[j];
+            if (nb < 0 || nb >= numTriangles)
+                continue;
+            auto &next = nodes[nb];
+            if (next.closed == searchId)
+                continue;
+            const auto entry = EdgeMiddle(item.node, j);
+            const float g = node.g + distance(node.entry, entry);
+            if (next.visited == searchId && next.g <= g)
+                continue;
+            next.g = g;
+            next.entry = entry;
+            next.parent = item.node;
+            next.edge = static_cast<uint8_t>(j);
+            next.visited = searchId;
+            // The last leg goes to the destination point itself
+            queue.push_back({g + (nb == toNode ? distance(entry, to) : heuristic(entry)), nb});
+            std::push_heap(queue.begin(), queue.end());
+        }
+    }
+    if (length < 0.0f)
+        return false;
+
+    // Unwind from the destination
+    for (int32_t n = toNode; n >= 0; n = nodes[n].parent)
+    {
+        corridor.nodes.push_back(n);
+        if (nodes[n].parent >= 0)
+            corridor.edges.push_back(nodes[n].edge);
+    }
+    std::reverse(corridor.nodes.begin(), corridor.nodes.end());
+    std::reverse(corridor.edges.begin(), corridor.edges.end());
+    corridor.length = length;
+    return true;
+}
+
+// A character walking along its corridor keeps it, only the triangles behind are dropped
+bool PtcPathFinder::Reuse(int32_t curNode, int32_t toNode, Corridor &corridor) const
+{
+    if (corridor.patch != patch || corridor.nodes.empty() || corridor.nodes.back() != toNode)
+        return false;
+    const auto it = std::find(corridor.nodes.begin(), corridor.nodes.end(), curNode);
+    if (it == corridor.nodes.end())
+        return false;
+    const auto first = it - corridor.nodes.begin();
+    corridor.nodes.erase(corridor.nodes.begin(), it);
+    corridor.edges.erase(corridor.edges.begin(), corridor.edges.begin() + first);
+    return true;
+}
+
+CVECTOR PtcPathFinder::EdgeMiddle(int32_t node, int32_t edge) const
+{
+    const auto &vs = vertex[triangle[node].i[edge]];
+    const auto &ve = vertex[triangle[node].i[edge < 2 ? edge + 1 : 0]];
+    return CVECTOR((vs.x + ve.x) * 0.5f, (vs.y + ve.y) * 0.5f, (vs.z + ve.z) * 0.5f);
+}
@@ -15,6 +15,9 @@
 #include "core.h"
 #include "math_inlines.h"
 
+// How far characters can walk between grid rebuilds
+constexpr float gridMoveMargin = 1.0f;
+
 // ============================================================================================
 // Construction, destruction
 // ============================================================================================
@@ -25,6 +28,8 @@ Supervisor::Supervisor()
     time = 0.0f;
     waveTime = 0.0f;
     curUpdate = 0;
+    isGridDirty = true;
+    maxRadius = 0.0f;
     player = nullptr;
 }
 
@@ -44,6 +49,7 @@ void Supervisor::AddCharacter(Character *ch)
     Assert(ch);
     character.emplace_back(CharacterEx{ch, time});
     colchr.resize(character.size() * character.size());
+    InvalidateGrid();
 }
 
 // Remove character from location
@@ -55,10 +61,33 @@ void Supervisor::DelCharacter(Character *ch)
             character[i] = character.back();
             character.pop_back();
             colchr.resize(character.size() * character.size());
+            InvalidateGrid();
             return;
         }
 }
 
+// Positions of characters changed, rebuild the grid before the next search
+void Supervisor::InvalidateGrid()
+{
+    isGridDirty = true;
+}
+
+// Put all characters to the grid
+void Supervisor::BuildGrid()
+{
+    grid.Clear();
+    maxRadius = 0.0f;
+    for (size_t i = 0; i < character.size(); i++)
+    {
+        grid.Add(character[i].c->curPos.x, character[i].c->curPos.z);
+        if (character[i].c->radius > maxRadius)
+            maxRadius = character[i].c->radius;
+    }
+    // Update queries up to (radius + maxRadius) * 4 around each character
+    grid.Build(maxRadius * 8.0f);
+    isGridDirty = false;
+}
+
 void Supervisor::Update(float dltTime)
 {
     // If there are no characters, do nothing
@@ -71,6 +100,10 @@ void Supervisor::Update(float dltTime)
         character[i].c->colMove = 0.0f;
         character[i].c->isCollision = false;
     }
+    // Only characters from the near cells can interact
+    BuildGrid();
+    pushShift.assign(character.size(), 0.0f);
+    auto maxShift = 0.0f;
     // calculate the distances, and determine the interacting characters
     constexpr float push_ang_step = PI / 64.0f;
     float push_ang = 0.0f;
@@ -84,8 +117,12 @@ void Supervisor::Update(float dltTime)
         character[i].c->startColCharacter = chr;
         auto curPos(character[i].c->curPos);
         const auto radius = character[i].c->radius;
-        for (auto j = i + 1; j < character.size(); j++)
+        // Characters pushed earlier could be out of their cells by maxShift
+        grid.Query(curPos.x, curPos.z, (radius + maxRadius) * 4.0f + maxShift, gridFound);
+        for (const size_t j : gridFound)
         {
+            if (j <= i)
+                continue;
             // skip the dead
             auto *ci = character[i].c;
             auto *cj = character[j].c;
@@ -128,6 +165,10 @@ void Supervisor::Update(float dltTime)
             d = (r - d) / d;
             dx *= d;
             dz *= d;
+            const auto push = sqrtf(dx * dx + dz * dz);
+            pushShift[i] += push;
+            pushShift[j] += push;
+            maxShift = std::max(maxShift, std::max(pushShift[i], pushShift[j]));
             ci->isCollision = true;
             cj->isCollision = true;
             auto moveI = ci->IsMove();
@@ -195,12 +236,14 @@ void Supervisor::Update(float dltTime)
         character[i].c->numColCharacter = chr - character[i].c->startColCharacter;
     }
     character[i].c->numColCharacter = 0;
+    InvalidateGrid();
     // Calculations
     for (i = 0; i < character.size(); i++)
         character[i].c->Calculate(dltTime);
     // Collision of characters and setting new coordinates
     for (i = 0; i < character.size(); i++)
         character[i].c->Update(dltTime);
+    InvalidateGrid();
 }
 
 void Supervisor::PreUpdate(float dltTime) const
@@ -293,12 +336,25 @@ bool Supervisor::CheckPosition(float x, float y, float z, Character *c) const
 // Find characters by radius
 std::vector<Supervisor::FindCharacter> Supervisor::FindCharacters(Character *chr,
                                 float radius, float angTest, float nearPlane, float ax, bool isSort,
-                                bool lookCenter) const
+                                bool lookCenter)
 {
+    std::vector<FindCharacter> found_characters;
+    FindCharacters(found_characters, chr, radius, angTest, nearPlane, ax, isSort, lookCenter);
+    return found_characters;
+}
+
+// Find characters by radius into the given buffer
+void Supervisor::FindCharacters(std::vector<FindCharacter> &found_characters, Character *chr, float radius,
+                                float angTest, float nearPlane, float ax, bool isSort, bool lookCenter)
+{
+    found_characters.clear();
     if (!chr || radius < 0.0f)
-        return {};
+        return;
 
-    auto found_characters = std::vector<FindCharacter>();
+    if (isGridDirty)
+        BuildGrid();
+    // Characters could walk a little since the grid was built
+    grid.Query(chr->curPos.x, chr->curPos.z, radius + gridMoveMargin, gridFound);
     // Test radius
     radius *= radius;
     // Character position
@@ -333,7 +389,7 @@ std::vector<Supervisor::FindCharacter> Supervisor::FindCharacters(Character *chr
     ax *= ax;
     auto testY = y + chr->height * 0.5f;
     // Viewing the characters
-    for (size_t i = 0; i < character.size(); i++)
+    for (const size_t i : gridFound)
     {
         // Exclude ourselves
         if (character[i].c == chr)
@@ -384,7 +440,6 @@ std::vector<Supervisor::FindCharacter> Supervisor::FindCharacters(Character *chr
 
         std::ranges::sort(found_characters, comparator);
     }
-    return found_characters;
 }
 
 // Find the best locator to continue walking the character
@@ -12,6 +12,8 @@
 #include <cstdint>
 #include <vector>
 
+#include "characters_grid.h"
+
 class Character;
 class LocatorArray;
 struct CVECTOR;
@@ -54,7 +56,10 @@ class Supervisor
     std::vector<FindCharacter> FindCharacters(Character *chr,
                                               float radius, float angTest = 0.0f, float nearPlane = 0.4f,
                                               float ax = 0.0f,
-                                              bool isSort = false, bool lookCenter = false) const;
+                                              bool isSort = false, bool lookCenter = false);
+    // Find characters by radius into the given buffer
+    void FindCharacters(std::vector<FindCharacter> &found, Character *chr, float radius, float angTest = 0.0f,
+                        float nearPlane = 0.4f, float ax = 0.0f, bool isSort = false, bool lookCenter = false);
 
     void Update(float dltTime);
     void PreUpdate(float dltTime) const;
@@ -76,10 +81,21 @@ class Supervisor
     void AddCharacter(Character *ch);
     // Remove character from location
     void DelCharacter(Character *ch);
+    // Positions of characters changed, rebuild the grid before the next search
+    void InvalidateGrid();
+    // Put all characters to the grid
+    void BuildGrid();
 
     float time, waveTime;
     int32_t curUpdate;
 
+    // Characters by position, the index is the index in character
+    CharactersGrid grid;
+    bool isGridDirty;
+    float maxRadius;                // The largest radius of characters in the grid
+    std::vector<uint32_t> gridFound; // Grid search result
+    std::vector<float> pushShift;   // How far characters were pushed since the grid was built
+
   public:
     std::vector<CharacterEx> character;
     std::vector<CharacterInfo> colchr;
@@ -0,0 +1,243 @@
+#include "characters_grid.h"
+#include "stopwatch.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <cmath>
+#include <random>
+
+namespace
+{
+
+struct crowd_t
+{
+    std::vector<float> x, z;
+};
+
+// town square with a few clusters of fighting characters
+crowd_t MakeCrowd(uint32_t count, std::mt19937 &gen)
+{
+    std::uniform_real_distribution<float> square(-60.0f, 60.0f);
+    std::normal_distribution<float> cluster(0.0f, 3.0f);
+    crowd_t crowd;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        auto x = square(gen), z = square(gen);
+        if (i % 3 != 0)
+        {
+            x = static_cast<float>(i % 4) * 25.0f - 40.0f + cluster(gen);
+            z = static_cast<float>(i % 5) * 20.0f - 40.0f + cluster(gen);
+        }
+        crowd.x.push_back(x);
+        crowd.z.push_back(z);
+    }
+    return crowd;
+}
+
+std::vector<uint32_t> BruteForce(const crowd_t &crowd, float x, float z, float radius)
+{
+    std::vector<uint32_t> result;
+    for (uint32_t i = 0; i < crowd.x.size(); i++)
+    {
+        const auto dx = crowd.x[i] - x;
+        const auto dz = crowd.z[i] - z;
+        if (dx * dx + dz * dz <= radius * radius)
+            result.push_back(i);
+    }
+    return result;
+}
+
+// Characters walking to the clusters, with what Supervisor::Update reads and writes of them
+struct walker_t
+{
+    float x, z, tx, tz;
+    float radius;
+    bool isMove;
+};
+
+std::vector<walker_t> MakeWalkers(uint32_t count, std::mt19937 &gen)
+{
+    std::uniform_real_distribution<float> radius(0.3f, 0.6f);
+    std::bernoulli_distribution standing(0.3);
+    const auto crowd = MakeCrowd(count * 2, gen);
+    std::vector<walker_t> walkers;
+    for (uint32_t i = 0; i < count; i++)
+        walkers.push_back({crowd.x[i], crowd.z[i], crowd.x[count + i], crowd.z[count + i], radius(gen),
+                           !standing(gen)});
+    return walkers;
+}
+
+// Supervisor::Update without the engine: move, then find the interacting pairs and push them apart.
+// Without a grid every pair is tested, as before the grid was added.
+size_t UpdateWalkers(std::vector<walker_t> &walkers, float dltTime, CharactersGrid *grid,
+                     std::vector<uint32_t> &found, std::vector<float> &pushShift, float &maxShiftPeak)
+{
+    for (auto &w : walkers)
+    {
+        if (!w.isMove)
+            continue;
+        const auto dx = w.tx - w.x, dz = w.tz - w.z;
+        const auto d = std::sqrt(dx * dx + dz * dz);
+        const auto step = std::min(d, 1.5f * dltTime);
+        if (d > 0.0f)
+        {
+            w.x += dx / d * step;
+            w.z += dz / d * step;
+        }
+    }
+
+    auto maxRadius = 0.0f;
+    if (grid)
+    {
+        grid->Clear();
+        for (const auto &w : walkers)
+        {
+            grid->Add(w.x, w.z);
+            maxRadius = std::max(maxRadius, w.radius);
+        }
+        grid->Build(maxRadius * 8.0f);
+    }
+    pushShift.assign(walkers.size(), 0.0f);
+    auto maxShift = 0.0f;
+    size_t pairs = 0;
+    for (uint32_t i = 0; i + 1 < walkers.size(); i++)
+    {
+        auto &ci = walkers[i];
+        const auto x = ci.x, z = ci.z;
+        if (grid)
+        {
+            grid->Query(x, z, (ci.radius + maxRadius) * 4.0f + maxShift, found);
+        }
+        else
+        {
+            found.resize(walkers.size() - i - 1);
+            for (uint32_t j = i + 1; j < walkers.size(); j++)
+                found[j - i - 1] = j;
+        }
+        for (const auto j : found)
+        {
+            if (j <= i)
+                continue;
+            auto &cj = walkers[j];
+            auto dx = x - cj.x;
+            auto dz = z - cj.z;
+            auto d = dx * dx + dz * dz;
+            auto r = ci.radius + cj.radius;
+            const auto rr = r * 4.0f;
+            if (d > rr * rr)
+                continue;
+            pairs++;
+            r *= 0.5f;
+            // characters standing in one point are not spread around here
+            if (d >= r * r || d <= 0.25f)
+                continue;
+            d = std::sqrt(d);
+            d = (r - d) / d;
+            dx *= d;
+            dz *= d;
+            const auto push = std::sqrt(dx * dx + dz * dz);
+            pushShift[i] += push;
+            pushShift[j] += push;
+            maxShift = std::max(maxShift, std::max(pushShift[i], pushShift[j]));
+            const auto kI = ci.isMove == cj.isMove ? 0.5f : ci.isMove ? 0.9f : 0.1f;
+            ci.x += dx * kI;
+            ci.z += dz * kI;
+            cj.x -= dx * (1.0f - kI);
+            cj.z -= dz * (1.0f - kI);
+        }
+    }
+    maxShiftPeak = std::max(maxShiftPeak, maxShift);
+    return pairs;
+}
+
+} // namespace
+
+TEST_CASE("Characters grid finds everyone in radius", "[location]")
+{
+    std::mt19937 gen(21);
+    const auto crowd = MakeCrowd(300, gen);
+    CharactersGrid grid;
+    for (size_t i = 0; i < crowd.x.size(); i++)
+        grid.Add(crowd.x[i], crowd.z[i]);
+    grid.Build(10.0f);
+
+    std::uniform_real_distribution<float> pos(-80.0f, 80.0f);
+    std::uniform_real_distribution<float> rad(0.0f, 40.0f);
+    std::vector<uint32_t> candidates;
+    for (int32_t n = 0; n < 2000; n++)
+    {
+        const auto x = pos(gen), z = pos(gen), radius = rad(gen);
+        grid.Query(x, z, radius, candidates);
+        REQUIRE(std::is_sorted(candidates.begin(), candidates.end()));
+        REQUIRE(candidates == BruteForce(crowd, x, z, radius));
+    }
+
+    SECTION("Far away characters")
+    {
+        grid.Clear();
+        grid.Add(0.0f, 0.0f);
+        grid.Add(100000.0f, -100000.0f);
+        grid.Build(4.0f);
+        grid.Query(100000.0f, -100000.0f, 1.0f, candidates);
+        REQUIRE(candidates == std::vector<uint32_t>{1});
+        grid.Query(500.0f, 500.0f, 1.0f, candidates);
+        REQUIRE(candidates.empty());
+    }
+}
+
+TEST_CASE("Characters grid pushes the same pairs as the full search", "[location]")
+{
+    std::mt19937 gen(5);
+    auto brute = MakeWalkers(200, gen);
+    auto gridded = brute;
+    CharactersGrid grid;
+    std::vector<uint32_t> found;
+    std::vector<float> pushShift;
+    auto maxShiftPeak = 0.0f;
+    for (int32_t frame = 0; frame < 300; frame++)
+    {
+        const auto brutePairs = UpdateWalkers(brute, 0.03f, nullptr, found, pushShift, maxShiftPeak);
+        const auto gridPairs = UpdateWalkers(gridded, 0.03f, &grid, found, pushShift, maxShiftPeak);
+        REQUIRE(gridPairs == brutePairs);
+        for (size_t i = 0; i < brute.size(); i++)
+        {
+            REQUIRE(gridded[i].x == brute[i].x);
+            REQUIRE(gridded[i].z == brute[i].z);
+        }
+    }
+    // the clusters are dense enough for the pushes to add up
+    REQUIRE(maxShiftPeak > 0.0f);
+}
+
+TEST_CASE("Characters grid crowd", "[location][.benchmark]")
+{
+    constexpr int32_t frames = 200;
+    for (const uint32_t count : {60u, 120u, 250u, 500u})
+    {
+        std::mt19937 gen(8);
+        auto brute = MakeWalkers(count, gen);
+        auto gridded = brute;
+        std::vector<uint32_t> found;
+        std::vector<float> pushShift;
+        auto bruteShift = 0.0f, gridShift = 0.0f;
+        size_t brutePairs = 0, gridPairs = 0;
+
+        storm::Stopwatch bruteTime, gridTime;
+        bruteTime.measure([&] {
+            for (int32_t frame = 0; frame < frames; frame++)
+                brutePairs += UpdateWalkers(brute, 0.03f, nullptr, found, pushShift, bruteShift);
+        });
+
+        CharactersGrid grid;
+        gridTime.measure([&] {
+            for (int32_t frame = 0; frame < frames; frame++)
+                gridPairs += UpdateWalkers(gridded, 0.03f, &grid, found, pushShift, gridShift);
+        });
+
+        WARN(count << " characters, us/frame full search: " << bruteTime.microseconds(frames)
+                   << ", grid: " << gridTime.microseconds(frames) << ", max shift: " << gridShift
+                   << ", pairs/frame: " << gridPairs / frames);
+        REQUIRE(gridPairs == brutePairs);
+    }
+}
+
@@ -0,0 +1,310 @@
+#include "ptc_path_finder.h"
+#include "stopwatch.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <queue>
+#include <random>
+
+namespace
+{
+
+// Town like patch: a grid of square cells split into two triangles, some cells are houses
+struct TestPatch
+{
+    std::vector<PtcTriangle> triangles;
+    std::vector<PtcVertex> vertices;
+    int32_t width = 0, height = 0;
+
+    TestPatch(int32_t width, int32_t height, float houses, uint32_t seed) : width(width), height(height)
+    {
+        std::mt19937 gen(seed);
+        std::bernoulli_distribution isHouse(houses);
+        std::vector<int32_t> cells(width * height, -1);
+        for (int32_t i = 0; i < width * height; i++)
+            if (!isHouse(gen))
+            {
+                cells[i] = static_cast<int32_t>(triangles.size());
+                triangles.emplace_back();
+                triangles.emplace_back();
+            }
+
+        for (int32_t z = 0; z <= height; z++)
+            for (int32_t x = 0; x <= width; x++)
+                vertices.push_back({static_cast<float>(x) * 2.0f, 0.0f, static_cast<float>(z) * 2.0f});
+
+        const auto cell = [&](int32_t x, int32_t z) {
+            return (x < 0 || x >= width || z < 0 || z >= height) ? -1 : cells[z * width + x];
+        };
+        const auto vtx = [&](int32_t x, int32_t z) { return static_cast<unsigned short>(z * (width + 1) + x); };
+        for (int32_t z = 0; z < height; z++)
+            for (int32_t x = 0; x < width; x++)
+            {
+                const auto c = cell(x, z);
+                if (c < 0)
+                    continue;
+                // a: 00, 10, 11 - bottom, right, diagonal; b: 00, 11, 01 - diagonal, top, left
+                auto &a = triangles[c];
+                auto &b = triangles[c + 1];
+                a = {{vtx(x, z), vtx(x + 1, z), vtx(x + 1, z + 1)}, 0, {-1, -1, -1}, 0, 0};
+                b = {{vtx(x, z), vtx(x + 1, z + 1), vtx(x, z + 1)}, 0, {-1, -1, -1}, 0, 0};
+                if (cell(x, z - 1) >= 0)
+                    a.nb[0] = static_cast<short>(cell(x, z - 1) + 1);
+                if (cell(x + 1, z) >= 0)
+                    a.nb[1] = static_cast<short>(cell(x + 1, z) + 1);
+                a.nb[2] = static_cast<short>(c + 1);
+                b.nb[0] = static_cast<short>(c);
+                if (cell(x, z + 1) >= 0)
+                    b.nb[1] = static_cast<short>(cell(x, z + 1));
+                if (cell(x - 1, z) >= 0)
+                    b.nb[2] = static_cast<short>(cell(x - 1, z));
+            }
+    }
+
+    int32_t Count() const
+    {
+        return static_cast<int32_t>(triangles.size());
+    }
+
+    CVECTOR Center(int32_t node) const
+    {
+        CVECTOR c(0.0f, 0.0f, 0.0f);
+        for (const auto i : triangles[node].i)
+            c += CVECTOR(vertices[i].x, vertices[i].y, vertices[i].z);
+        return c / 3.0f;
+    }
+
+    // hops from every node to the target, -1 if it can't be reached
+    std::vector<int32_t> Hops(int32_t toNode) const
+    {
+        std::vector<int32_t> hops(triangles.size(), -1);
+        std::queue<int32_t> queue;
+        hops[toNode] = 0;
+        queue.push(toNode);
+        while (!queue.empty())
+        {
+            const auto n = queue.front();
+            queue.pop();
+            for (const auto nb : triangles[n].nb)
+                if (nb >= 0 && hops[nb] < 0)
+                {
+                    hops[nb] = hops[n] + 1;
+                    queue.push(nb);
+                }
+        }
+        return hops;
+    }
+
+    // direction table as stored in the ptc file, 2 bits per pair, 3 - no way
+    std::vector<uint8_t> BuildTable(int32_t &lineSize) const
+    {
+        lineSize = (Count() + 3) / 4;
+        std::vector<uint8_t> table(static_cast<size_t>(lineSize) * Count(), 0xff);
+        for (int32_t to = 0; to < Count(); to++)
+        {
+            const auto hops = Hops(to);
+            for (int32_t n = 0; n < Count(); n++)
+            {
+                if (hops[n] <= 0)
+                    continue;
+                for (uint8_t j = 0; j < 3; j++)
+                {
+                    const auto nb = triangles[n].nb[j];
+                    if (nb >= 0 && hops[nb] == hops[n] - 1)
+                    {
+                        auto &cell = table[n * lineSize + (to >> 2)];
+                        cell = static_cast<uint8_t>((cell & ~(3 << ((to & 3) * 2))) | (j << ((to & 3) * 2)));
+                        break;
+                    }
+                }
+            }
+        }
+        return table;
+    }
+};
+
+void CheckCorridor(const TestPatch &patch, const PtcPathFinder::Corridor &corridor, int32_t from, int32_t to)
+{
+    REQUIRE(corridor.nodes.front() == from);
+    REQUIRE(corridor.nodes.back() == to);
+    REQUIRE(corridor.edges.size() + 1 == corridor.nodes.size());
+    for (size_t i = 0; i < corridor.edges.size(); i++)
+    {
+        REQUIRE(corridor.edges[i] < 3);
+        REQUIRE(patch.triangles[corridor.nodes[i]].nb[corridor.edges[i]] == corridor.nodes[i + 1]);
+    }
+}
+
+} // namespace
+
+TEST_CASE("Patch path search finds corridors", "[location]")
+{
+    const TestPatch patch(40, 30, 0.25f, 17);
+    PtcPathFinder finder;
+    finder.Init(patch.triangles.data(), patch.Count(), patch.vertices.data());
+
+    std::mt19937 gen(5);
+    std::uniform_int_distribution<int32_t> node(0, patch.Count() - 1);
+    for (int32_t n = 0; n < 500; n++)
+    {
+        const auto from = node(gen);
+        const auto to = node(gen);
+        const auto reachable = patch.Hops(to)[from] >= 0;
+
+        PtcPathFinder::Corridor corridor;
+        const auto found = finder.FindCorridor(from, patch.Center(from), to, patch.Center(to), corridor);
+        REQUIRE(found == reachable);
+        if (!found)
+            continue;
+        CheckCorridor(patch, corridor, from, to);
+        const auto length = corridor.length;
+
+        const auto *reference = finder.FindCorridorDijkstra(from, patch.Center(from), to, patch.Center(to));
+        REQUIRE(reference != nullptr);
+        CheckCorridor(patch, *reference, from, to);
+        REQUIRE(length <= reference->length * 1.02f + 0.001f);
+    }
+}
+
+TEST_CASE("Patch path search reuses corridors", "[location]")
+{
+    const TestPatch patch(20, 20, 0.0f, 1);
+    PtcPathFinder finder;
+    finder.Init(patch.triangles.data(), patch.Count(), patch.vertices.data());
+
+    const int32_t from = 0;
+    const int32_t to = patch.Count() - 1;
+    PtcPathFinder::Corridor corridor;
+    REQUIRE(finder.FindCorridor(from, patch.Center(from), to, patch.Center(to), corridor));
+    const auto nodes = corridor.nodes;
+    REQUIRE(nodes.size() > 4);
+
+    // searches of other characters don't touch this corridor
+    PtcPathFinder::Corridor other;
+    REQUIRE(finder.FindCorridor(to, patch.Center(to), from, patch.Center(from), other));
+    CheckCorridor(patch, other, to, from);
+
+    // a character that has walked a few triangles keeps the rest of the same corridor
+    REQUIRE(finder.FindCorridor(nodes[3], patch.Center(nodes[3]), to, patch.Center(to), corridor));
+    REQUIRE(std::vector<int32_t>(nodes.begin() + 3, nodes.end()) == corridor.nodes);
+    CheckCorridor(patch, corridor, nodes[3], to);
+
+    SECTION("New target is searched again")
+    {
+        REQUIRE(finder.FindCorridor(nodes[3], patch.Center(nodes[3]), from, patch.Center(from), corridor));
+        CheckCorridor(patch, corridor, nodes[3], from);
+    }
+
+    SECTION("Corridors of the previous patch are not reused")
+    {
+        finder.Init(patch.triangles.data(), patch.Count(), patch.vertices.data());
+        corridor.nodes.insert(corridor.nodes.begin() + 1, 0);
+        corridor.edges.insert(corridor.edges.begin(), 0);
+        REQUIRE(finder.FindCorridor(nodes[3], patch.Center(nodes[3]), to, patch.Center(to), corridor));
+        CheckCorridor(patch, corridor, nodes[3], to);
+    }
+
+    SECTION("Corridors of another location are not reused")
+    {
+        // the first patch loaded by another location's finder
+        PtcPathFinder location;
+        location.Init(patch.triangles.data(), patch.Count(), patch.vertices.data());
+        corridor.nodes.insert(corridor.nodes.begin() + 1, 0);
+        corridor.edges.insert(corridor.edges.begin(), 0);
+        REQUIRE(location.FindCorridor(nodes[3], patch.Center(nodes[3]), to, patch.Center(to), corridor));
+        CheckCorridor(patch, corridor, nodes[3], to);
+    }
+}
+
+TEST_CASE("Patch direction table against path search", "[location][.benchmark]")
+{
+    constexpr size_t charactersNum = 8;
+    const TestPatch patch(64, 64, 0.2f, 99);
+    int32_t lineSize;
+    const auto table = patch.BuildTable(lineSize);
+
+    PtcPathFinder finder;
+    finder.Init(patch.triangles.data(), patch.Count(), patch.vertices.data());
+
+    std::mt19937 gen(3);
+    std::uniform_int_distribution<int32_t> node(0, patch.Count() - 1);
+    std::vector<std::pair<int32_t, int32_t>> queries;
+    while (queries.size() < 2000)
+    {
+        const auto from = node(gen);
+        const auto to = node(gen);
+        if (patch.Hops(to)[from] > 0)
+            queries.emplace_back(from, to);
+    }
+
+    storm::Stopwatch tableTime, dijkstraTime, searchTime, walkTime;
+    size_t tableSteps = 0;
+    tableTime.measure([&] {
+        for (const auto &[from, to] : queries)
+        {
+            // the same walk PtcData::FindPathDir does, up to 32 edges
+            for (int32_t n = from, step = 0; n != to && step < 32; step++, tableSteps++)
+            {
+                const auto v = (table[n * lineSize + (to >> 2)] >> ((to & 3) * 2)) & 3;
+                REQUIRE(v != 3);
+                n = patch.triangles[n].nb[v];
+            }
+        }
+    });
+
+    dijkstraTime.measure([&] {
+        for (const auto &[from, to] : queries)
+            REQUIRE(finder.FindCorridorDijkstra(from, patch.Center(from), to, patch.Center(to)) != nullptr);
+    });
+
+    searchTime.measure([&] {
+        PtcPathFinder::Corridor corridor;
+        for (const auto &[from, to] : queries)
+        {
+            corridor.nodes.clear();
+            REQUIRE(finder.FindCorridor(from, patch.Center(from), to, patch.Center(to), corridor));
+        }
+    });
+
+    // characters walk along their corridors and ask again from every triangle they enter, one step each in turn
+    size_t walkQueries = 0;
+    walkTime.measure([&] {
+        for (size_t i = 0; i < queries.size(); i += charactersNum)
+        {
+            std::vector<PtcPathFinder::Corridor> corridors(std::min(charactersNum, queries.size() - i));
+            std::vector<std::vector<int32_t>> walks;
+            for (size_t j = 0; j < corridors.size(); j++)
+            {
+                const auto [from, to] = queries[i + j];
+                REQUIRE(finder.FindCorridor(from, patch.Center(from), to, patch.Center(to), corridors[j]));
+                walks.push_back(corridors[j].nodes);
+            }
+            for (size_t step = 0;; step++)
+            {
+                bool walking = false;
+                for (size_t j = 0; j < corridors.size(); j++)
+                {
+                    const auto &walk = walks[j];
+                    if (step >= walk.size())
+                        continue;
+                    const auto n = walk[step];
+                    REQUIRE(finder.FindCorridor(n, patch.Center(n), walk.back(), patch.Center(walk.back()),
+                                                corridors[j]));
+                    walkQueries++;
+                    walking = true;
+                }
+                if (!walking)
+                    break;
+            }
+        }
+    });
+
+    WARN("triangles: " << patch.Count() << ", table walk steps: " << tableSteps);
+    WARN("memory bytes table: " << table.size() << ", search: " << finder.GetMemoryUsage());
+    WARN("us/query table: " << tableTime.microseconds(queries.size())
+                            << ", dijkstra: " << dijkstraTime.microseconds(queries.size())
+                            << ", a*: " << searchTime.microseconds(queries.size()));
+    WARN("us/query walking along corridors: " << walkTime.microseconds(walkQueries));
+
+    CHECK(finder.GetMemoryUsage() * 10 < table.size());
+}
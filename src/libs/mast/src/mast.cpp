@@ -51,6 +51,7 @@ MAST::MAST()
 
 MAST::~MAST()
 {
+    fio->UnwatchFile(iniWatch);
     AllRelease();
 }
 
@@ -59,6 +60,7 @@ bool MAST::Init()
     // GUARD(MAST::Init())
 
     SetDevice();
+    iniWatch = fio->WatchFile(MAST_INI_FILE, [this] { bIniChanged = true; });
 
     // UNGUARD
     return true;
@@ -107,13 +109,11 @@ void MAST::Execute(uint32_t Delta_Time)
     {
         // ====================================================
         // If the ini-file has been changed, read the info from it
-        if (fio->_FileOrDirectoryExists(MAST_INI_FILE))
+        if (bIniChanged)
         {
-            auto ft_new = fio->_GetLastWriteTime(MAST_INI_FILE);
-            if (ft_old != ft_new)
-            {
+            bIniChanged = false;
+            if (fio->_FileOrDirectoryExists(MAST_INI_FILE))
                 LoadIni();
-            }
         }
         doMove(Delta_Time);
         auto *mdl = static_cast<MODEL *>(core.GetEntityPointer(model_id));
@@ -427,10 +427,6 @@ void MAST::LoadIni()
     // GUARD(MAST::LoadIni());
     char section[256];
 
-    if (fio->_FileOrDirectoryExists(MAST_INI_FILE))
-    {
-        ft_old = fio->_GetLastWriteTime(MAST_INI_FILE);
-    }
     auto ini = fio->OpenIniFile(MAST_INI_FILE);
     if (!ini)
     {
@@ -27,7 +27,8 @@ class MAST : public Entity
     bool bModel;
     entid_t model_id, oldmodel_id;
     entid_t ship_id;
-    std::filesystem::file_time_type ft_old;
+    uint32_t iniWatch = 0;
+    bool bIniChanged = false;
     NODE *m_pMastNode;
 
   public:
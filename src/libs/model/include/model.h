@@ -51,6 +51,8 @@ class NODE
                       const CMatrix &globm, NODER *par, const char *lmPath) = 0;
 
     virtual float Trace(const CVECTOR &src, const CVECTOR &dst) = 0;
+    // world space sphere around the node with its children, Trace never hits outside of it
+    virtual void GetBoundingSphere(CVECTOR &center, float &radius) = 0;
 
     virtual void SubstituteGeometry(const std::string& new_model) = 0;
 };
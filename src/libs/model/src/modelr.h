@@ -41,6 +41,7 @@ class NODER final : public NODE
     ~NODER() override;
     void Draw();
     float Trace(const CVECTOR &src, const CVECTOR &dst) override;
+    void GetBoundingSphere(CVECTOR &center, float &radius) override;
     NODER *GetNode(int32_t n);
     NODER *FindNode(const char *cNodeName);
     float Update(CMatrix &mtx, CVECTOR &cnt);
@@ -483,6 +483,15 @@ NODER *NODER::GetNode(int32_t n)
     return nullptr;
 }
 
+//-------------------------------------------------------------------
+//
+//-------------------------------------------------------------------
+void NODER::GetBoundingSphere(CVECTOR &cnt, float &rad)
+{
+    cnt = glob_mtx * center;
+    rad = radius;
+}
+
 //-------------------------------------------------------------------
 //
 //-------------------------------------------------------------------
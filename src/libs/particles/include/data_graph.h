@@ -1,29 +1,47 @@
 #pragma once
 
-#include "../../i_common/mem_file.h"
+#include "graph_vertex.h"
 
-#include "../../i_common/graph_vertex.h"
 #include <string>
 #include <vector>
 
+class MemFile;
+
 class DataGraph
 {
-    std::string Name;
+    // The time of the graph split into equal steps, every step keeps the first key segment that ends in it,
+    // so a value is read without searching the keys from the start.
+    // Reading doesn't change the graph, so particles of any age can be processed in any order and on any thread
+    struct BakedGraph
+    {
+        float StartTime = 0.0f;
+        float EndTime = -1.0f;
+        float InvStep = 0.0f;
+        std::vector<uint32_t> Segments;
+    };
+
+    // Number of time steps in the baked graph
+    static constexpr uint32_t BAKED_GRAPH_SIZE = 256;
 
-    // when was the last time the value was read
-    float MaxCachedTime;
-    float MinCachedTime;
-    // What was the index of this time
-    uint32_t MaxCachedIndex;
-    uint32_t MinCachedIndex;
+    std::string Name;
 
     std::vector<GraphVertex> MinGraph;
     std::vector<GraphVertex> MaxGraph;
 
-    void ResetCachedTime();
+    BakedGraph BakedMin;
+    BakedGraph BakedMax;
+
+    // Rebuild the baked graphs, must be called after the keys are changed
+    void Bake();
+
+    static void BakeGraph(const std::vector<GraphVertex> &Graph, BakedGraph &Baked);
+    static uint32_t GetBakedStep(const BakedGraph &Baked, float Time);
+    static float GetSegmentValue(const std::vector<GraphVertex> &Graph, uint32_t Index, float Time);
+    static float GetKeysValue(const std::vector<GraphVertex> &Graph, float Time);
+    static float GetBakedValue(const BakedGraph &Baked, const std::vector<GraphVertex> &Graph, float Time);
 
-    float GetMinAtTime(float Time, float LifeTime);
-    float GetMaxAtTime(float Time, float LifeTime);
+    float GetMinAtTime(float Time, float LifeTime) const;
+    float GetMaxAtTime(float Time, float LifeTime) const;
 
     bool bRelative;
     bool bNegative;
@@ -42,8 +60,8 @@ class DataGraph
     bool GetRelative() const;
 
     // Get value (Current time, Random factor [0..1])
-    float GetValue(float Time, float LifeTime, float K_rand);
-    float GetRandomValue(float Time, float LifeTime);
+    float GetValue(float Time, float LifeTime, float K_rand) const;
+    float GetRandomValue(float Time, float LifeTime) const;
 
     // Set values
     void SetValues(const GraphVertex *MinValues, uint32_t MinValuesSize, const GraphVertex *MaxValues,
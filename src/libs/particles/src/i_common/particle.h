@@ -2,19 +2,61 @@
 
 #include "math3d.h"
 
+#include <algorithm>
+#include <execution>
+#include <numeric>
+#include <utility>
+#include <vector>
+
 class DataGraph;
 class DataColor;
 class DataUV;
 class IEmitter;
 class GEOS;
 
-struct BB_ParticleData
+// Processors keep the alive particles in parallel arrays, element n of every array belongs to the same
+// particle. The state is split by what reads it, so the physics step streams through small structs
+// and doesn't load the graphs and the render state of every particle.
+
+// Remove element n from the arrays by moving the last particle in its place
+template <typename... Arrays> void RemoveParticle(uint32_t n, Arrays &...arrays)
 {
-    bool SpeedOriented; // Turn along the velocity vector ...
+    ((arrays[n] = std::move(arrays.back()), arrays.pop_back()), ...);
+}
 
-    // Pointer to the number of particles of this type, when removing a particle, you need to decrease it !!!
-    uint32_t *ActiveCount;
+// Number of particles simulated by a worker thread at once
+constexpr uint32_t PARTICLE_CHUNK_SIZE = 256;
+
+// Call func(From, To) for the chunks of the first Count particles, the chunks run in parallel when there
+// are many of them, so func may change only the particles of its chunk and read the shared data
+template <typename Func> void ForEachParticleChunk(uint32_t Count, Func &&func)
+{
+    if (Count <= PARTICLE_CHUNK_SIZE)
+    {
+        if (Count > 0)
+            func(0u, Count);
+        return;
+    }
+
+    std::vector<uint32_t> Chunks((Count + PARTICLE_CHUNK_SIZE - 1) / PARTICLE_CHUNK_SIZE);
+    std::iota(Chunks.begin(), Chunks.end(), 0u);
+    std::for_each(std::execution::par, Chunks.begin(), Chunks.end(), [Count, &func](uint32_t Chunk) {
+        const auto From = Chunk * PARTICLE_CHUNK_SIZE;
+        func(From, std::min(From + PARTICLE_CHUNK_SIZE, Count));
+    });
+}
+
+struct ParticleTime
+{
+    // Lifetime
+    float LifeTime;
 
+    // How long did it live
+    float ElapsedTime;
+};
+
+struct BB_ParticlePhysics
+{
     // Physical position
     Vector PhysPos;
 
@@ -27,35 +69,29 @@ struct BB_ParticleData
     // Direction and "strength" of speed (NOT Normalized)
     Vector Velocity;
 
-    // External force (for applying it to a particle)
-    Vector ExternalForce;
-
-    // Lifetime
-    float LifeTime;
-
-    // How long did it live
-    float ElapsedTime;
-
-    // Transformation matrix, at emission of a particle (for a track)
-    Matrix matWorld;
-
     // Weight
     float Mass;
 
     // fabsf(Mass)
     float UMass;
+};
 
-    // ===========================================================================
+struct BB_ParticleRender
+{
     // Final position / angle for rendering
     Vector RenderPos;
     float RenderAngle;
     Vector OldRenderPos;
     float OldRenderAngle;
 
-    // ===========================================================================
     // Distance to camera
     float CamDistance;
-    bool Visible;
+};
+
+struct BB_ParticleParams
+{
+    // Transformation matrix, at emission of a particle (for a track)
+    Matrix matWorld;
 
     // ===========================================================================
     // Graphs
@@ -89,20 +125,23 @@ struct BB_ParticleData
     float KTrackZ;
     float KPhysBlend;
 
-    // ===========================================================================
+    bool SpeedOriented; // Turn along the velocity vector ...
+};
+
+struct ParticleOwner
+{
+    // Pointer to the number of particles of this type, when removing a particle, you need to decrease it !!!
+    uint32_t *ActiveCount;
+
     // Pointer to the emitter that is attached to the particle
     IEmitter *AttachedEmitter;
 
-    // ===============================================
     // ID of the emitter to which the particle belongs
     uint32_t EmitterGUID;
 };
 
-struct MDL_ParticleData
+struct MDL_ParticlePhysics
 {
-    // Pointer to the number of particles of this type, when removing a particle, you need to decrease it !!!
-    uint32_t *ActiveCount;
-
     // Physical position
     Vector PhysPos;
 
@@ -115,31 +154,30 @@ struct MDL_ParticleData
     // Direction and "strength" of speed (NOT Normalized)
     Vector Velocity;
 
-    // External force (for applying it to a particle)
-    Vector ExternalForce;
-
-    // Lifetime
-    float LifeTime;
-
-    // How long did it live
-    float ElapsedTime;
-
-    // Transformation matrix, at emission of a particle (for a track)
-    Matrix matWorld;
-
     // Weight
     float Mass;
 
     // fabsf(Mass)
     float UMass;
+};
 
-    // ===========================================================================
+struct MDL_ParticleRender
+{
     // Final position / angle for rendering
     Vector RenderPos;
     Vector RenderAngle;
     Vector OldRenderPos;
     Vector OldRenderAngle;
 
+    // Pointer to the model to render
+    GEOS *pScene;
+};
+
+struct MDL_ParticleParams
+{
+    // Transformation matrix, at emission of a particle (for a track)
+    Matrix matWorld;
+
     // ===========================================================================
     // Graphs
 
@@ -164,16 +202,4 @@ struct MDL_ParticleData
     float KTrackY;
     float KTrackZ;
     float KPhysBlend;
-
-    // ===========================================================================
-    // Pointer to the model to render
-    GEOS *pScene;
-
-    // ===========================================================================
-    // Pointer to the emitter that is attached to the particle
-    IEmitter *AttachedEmitter;
-
-    // ===============================================
-    // ID of the emitter to which the particle belongs
-    uint32_t EmitterGUID;
 };
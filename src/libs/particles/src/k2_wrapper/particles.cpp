@@ -25,7 +25,6 @@ PARTICLES::~PARTICLES()
 bool PARTICLES::Init()
 {
     core.AddToLayer(REALIZE, GetId(), 0xfffff);
-    core.AddToLayer(EXECUTE, GetId(), 0);
 
     pService = static_cast<IParticleService *>(core.GetService("ParticleService"));
     Assert(pService);
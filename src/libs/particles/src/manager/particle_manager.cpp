@@ -15,8 +15,6 @@
 #include <filesystem>
 #include <thread>
 
-uint32_t GraphRead = 0;
-
 ParticleManager::ParticleManager(ParticleService *service) : IParticleManager(service)
 {
     pService = service;
@@ -209,7 +207,6 @@ void ParticleManager::RemoveResource(IParticleSystem *pResource)
 // Execute Particles
 void ParticleManager::Execute(float DeltaTime)
 {
-    GraphRead = 0;
     ActiveSystems = 0;
     ActiveEmitters = 0;
     ActiveBillboardParticles = 0;
@@ -252,12 +249,6 @@ void ParticleManager::Execute(float DeltaTime)
 
     if (ShowStat)
     {
-        /*
-        IFont* pSysFont = pRS->GetSystemFont ();
-        float Width = pSysFont->GetLength("Graph read count - %d", GraphRead);
-        pSysFont->Release();
-        */
-
         D3DVIEWPORT9 ViewPort;
         pRS->GetViewport(&ViewPort);
         RS_SPRITE spr[4];
@@ -278,14 +269,7 @@ void ParticleManager::Execute(float DeltaTime)
             pRS->Print(0, 64, 0xFFFFFFFF, "Models - %d", ActiveModelParticles);
             pRS->Print(0, 80, 0xFFFFFFFF, "Total time - %d", nowTickTime);
             pRS->Print(0, 96, 0xFFFFFFFF, "Update time - %d", nowUpdateTime);
-            pRS->Print(0, 112, 0xFFFFFFFF, "Graph read count - %d", GraphRead);
         */
-
-        if (GraphRead != 0)
-        {
-            float AverageReadTime = static_cast<float>(nowUpdateTime) / static_cast<float>(GraphRead);
-            //            pRS->Print(0, 128, 0xFFFFFFFF, "Average read time - %3.2f", AverageReadTime);
-        }
     }
 
     if (core.Controls->GetDebugAsyncKeyState(VK_F3) < 0 && core.Controls->GetDebugAsyncKeyState(VK_CONTROL) < 0)
@@ -1,11 +1,13 @@
 #include "data_graph.h"
 #include "../../i_common/graph_time.h"
+#include "../../i_common/mem_file.h"
 #include "../../i_common/types.h"
 #include "vma.hpp"
 
-#pragma warning(disable : 4800)
+#include <algorithm>
+#include <cmath>
 
-extern uint32_t GraphRead;
+#pragma warning(disable : 4800)
 
 // Linear interpolation
 float Lerp(float val1, float val2, float lerp_k)
@@ -33,8 +35,6 @@ DataGraph::DataGraph()
 {
     bRelative = false;
     bNegative = false;
-
-    ResetCachedTime();
 }
 
 DataGraph::~DataGraph()
@@ -59,7 +59,7 @@ void DataGraph::SetValues(const GraphVertex *MinValues, uint32_t MinValuesSize,
         MaxGraph.push_back(MaxValues[n]);
     }
 
-    ResetCachedTime();
+    Bake();
 }
 
 // Set the "default"
@@ -83,7 +83,7 @@ void DataGraph::SetDefaultValue(float MaxValue, float MinValue)
     Max.Time = MAX_GRAPH_TIME;
     MaxGraph.push_back(Max);
 
-    ResetCachedTime();
+    Bake();
 }
 
 // Get the count in the minimum graph
@@ -110,10 +110,98 @@ const GraphVertex &DataGraph::GetMaxVertex(uint32_t Index)
     return MaxGraph[Index];
 }
 
-void DataGraph::ResetCachedTime()
+void DataGraph::Bake()
 {
-    MaxCachedTime = NOT_INITED_CACHE_VALUE;
-    MinCachedTime = NOT_INITED_CACHE_VALUE;
+    BakeGraph(MinGraph, BakedMin);
+    BakeGraph(MaxGraph, BakedMax);
+}
+
+void DataGraph::BakeGraph(const std::vector<GraphVertex> &Graph, BakedGraph &Baked)
+{
+    Baked.Segments.clear();
+    Baked.EndTime = -1.0f;
+
+    const uint32_t Count = Graph.size();
+    if (Count < 2)
+        return;
+
+    // The last key is usually placed at MAX_GRAPH_TIME to hold the value, it is left out of the table
+    auto EndIndex = Count - 1;
+    if (Count > 2 && Graph[EndIndex].Time >= MAX_GRAPH_TIME)
+        EndIndex--;
+
+    const auto StartTime = Graph[0].Time;
+    const auto EndTime = Graph[EndIndex].Time;
+    for (uint32_t n = 1; n <= EndIndex; n++)
+    {
+        if (!(Graph[n].Time >= Graph[n - 1].Time))
+            return;
+    }
+    if (!(EndTime - StartTime > 0.001f) || !std::isfinite(EndTime - StartTime))
+        return;
+
+    Baked.StartTime = StartTime;
+    Baked.EndTime = EndTime;
+    Baked.InvStep = static_cast<float>(BAKED_GRAPH_SIZE) / (EndTime - StartTime);
+    Baked.Segments.resize(BAKED_GRAPH_SIZE);
+
+    // the key is placed to a step the same way as the time is read, so a segment ending in the earlier
+    // step always ends before the time
+    uint32_t Index = 0;
+    for (uint32_t Step = 0; Step < BAKED_GRAPH_SIZE; Step++)
+    {
+        while (Index + 1 < EndIndex && GetBakedStep(Baked, Graph[Index + 1].Time) < Step)
+            Index++;
+        Baked.Segments[Step] = Index;
+    }
+}
+
+uint32_t DataGraph::GetBakedStep(const BakedGraph &Baked, float Time)
+{
+    return std::min(static_cast<uint32_t>((Time - Baked.StartTime) * Baked.InvStep), BAKED_GRAPH_SIZE - 1);
+}
+
+float DataGraph::GetSegmentValue(const std::vector<GraphVertex> &Graph, uint32_t Index, float Time)
+{
+    const auto FromTime = Graph[Index].Time;
+    const auto ToTime = Graph[Index + 1].Time;
+
+    const auto SegmentDeltaTime = ToTime - FromTime;
+    const auto ValueDeltaTime = Time - FromTime;
+    float blend_k;
+    if (SegmentDeltaTime > 0.001f)
+        blend_k = ValueDeltaTime / SegmentDeltaTime;
+    else
+        blend_k = 0.0f;
+
+    return Lerp(Graph[Index].Val, Graph[Index + 1].Val, blend_k);
+}
+
+float DataGraph::GetKeysValue(const std::vector<GraphVertex> &Graph, float Time)
+{
+    const uint32_t Count = Graph.size();
+    for (uint32_t Index = 0; Index + 1 < Count; Index++)
+    {
+        // If the time is in the correct range
+        if (Time <= Graph[Index + 1].Time)
+            return GetSegmentValue(Graph, Index, Time);
+    }
+
+    return 0.0f;
+}
+
+float DataGraph::GetBakedValue(const BakedGraph &Baked, const std::vector<GraphVertex> &Graph, float Time)
+{
+    // the time outside of the table (and NaN for particles without lifetime) goes to the keys
+    if (!(Time >= Baked.StartTime && Time <= Baked.EndTime))
+        return GetKeysValue(Graph, Time);
+
+    // only the segments ending in the same step are left to skip
+    auto Index = Baked.Segments[GetBakedStep(Baked, Time)];
+    while (Time > Graph[Index + 1].Time)
+        Index++;
+
+    return GetSegmentValue(Graph, Index, Time);
 }
 
 void DataGraph::Load(MemFile *File)
@@ -174,6 +262,8 @@ void DataGraph::Load(MemFile *File)
         // core.Trace("Min value %d = %3.2f, %3.2f", i, fTime, fValue);
     }
 
+    Bake();
+
     static char AttribueName[128];
     uint32_t NameLength = 0;
     File->ReadType(NameLength);
@@ -244,105 +334,35 @@ void DataGraph::MultiplyBy(float Val)
 
     for (n = 0; n < MinGraph.size(); n++)
         MinGraph[n].Val *= Val;
+
+    Bake();
 }
 
-float DataGraph::GetMinAtTime(float Time, float LifeTime)
+float DataGraph::GetMinAtTime(float Time, float LifeTime) const
 {
     if (bRelative)
         Time = Time / LifeTime * 100.0f;
 
-    const uint32_t Count = MinGraph.size();
-    uint32_t Index;
-    if (MinCachedTime < Time)
-        Index = MinCachedIndex;
-    else
-        Index = 0;
-
-    for (; Index < (Count - 1); Index++)
-    {
-        const auto ToTime = MinGraph[Index + 1].Time;
-
-        // If the time is in the correct range
-        // if ((Time >= FromTime) && (Time <= ToTime))
-        if (Time <= ToTime)
-        {
-            const auto FromTime = MinGraph[Index].Time;
-
-            const auto SegmentDeltaTime = ToTime - FromTime;
-            const auto ValueDeltaTime = Time - FromTime;
-            float blend_k;
-            if (SegmentDeltaTime > 0.001f)
-                blend_k = ValueDeltaTime / SegmentDeltaTime;
-            else
-                blend_k = 0.0f;
-
-            const auto ValueFirst = MinGraph[Index].Val;
-            const auto ValueSecond = MinGraph[Index + 1].Val;
-
-            MinCachedTime = Time;
-            MinCachedIndex = Index;
-            return Lerp(ValueFirst, ValueSecond, blend_k);
-        }
-    }
-
-    return 0.0f;
+    return GetBakedValue(BakedMin, MinGraph, Time);
 }
 
-float DataGraph::GetMaxAtTime(float Time, float LifeTime)
+float DataGraph::GetMaxAtTime(float Time, float LifeTime) const
 {
     if (bRelative)
         Time = Time / LifeTime * 100.0f;
 
-    const uint32_t Count = MaxGraph.size();
-
-    uint32_t Index;
-
-    if (MaxCachedTime < Time)
-        Index = MaxCachedIndex;
-    else
-        Index = 0;
-
-    for (; Index < (Count - 1); Index++)
-    {
-        const auto ToTime = MaxGraph[Index + 1].Time;
-
-        // If the time is in the correct range
-        // if ((Time >= FromTime) && (Time <= ToTime))
-        if (Time <= ToTime)
-        {
-            const auto FromTime = MaxGraph[Index].Time;
-
-            const auto SegmentDeltaTime = ToTime - FromTime;
-            const auto ValueDeltaTime = Time - FromTime;
-            float blend_k;
-            if (SegmentDeltaTime > 0.001f)
-                blend_k = ValueDeltaTime / SegmentDeltaTime;
-            else
-                blend_k = 0.0f;
-
-            const auto ValueFirst = MaxGraph[Index].Val;
-            const auto ValueSecond = MaxGraph[Index + 1].Val;
-
-            MaxCachedTime = Time;
-            MaxCachedIndex = Index;
-            return Lerp(ValueFirst, ValueSecond, blend_k);
-        }
-    }
-
-    return 0.0f;
+    return GetBakedValue(BakedMax, MaxGraph, Time);
 }
 
-float DataGraph::GetValue(float Time, float LifeTime, float K_rand)
+float DataGraph::GetValue(float Time, float LifeTime, float K_rand) const
 {
-    GraphRead++;
     const auto pMax = GetMaxAtTime(Time, LifeTime);
     const auto pMin = GetMinAtTime(Time, LifeTime);
     return Lerp(pMin, pMax, K_rand);
 }
 
-float DataGraph::GetRandomValue(float Time, float LifeTime)
+float DataGraph::GetRandomValue(float Time, float LifeTime) const
 {
-    GraphRead++;
     const auto pMax = GetMaxAtTime(Time, LifeTime);
     const auto pMin = GetMinAtTime(Time, LifeTime);
     return RandomRange(pMin, pMax);
@@ -366,6 +386,8 @@ void DataGraph::Clamp(float MinValue, float MaxValue)
         if (MinGraph[n].Val < MinValue)
             MinGraph[n].Val = MinValue;
     }
+
+    Bake();
 }
 
 void DataGraph::Reverse()
@@ -376,6 +398,8 @@ void DataGraph::Reverse()
 
     for (n = 0; n < MinGraph.size(); n++)
         MinGraph[n].Val = 1.0f - MinGraph[n].Val;
+
+    Bake();
 }
 
 void DataGraph::NormalToPercent()
@@ -1,6 +1,6 @@
 #include "base.h"
 #include "../../i_common/names.h"
-#include "../data_source/data_graph.h"
+#include "data_graph.h"
 #include "../data_source/data_string.h"
 #include "math3d/quaternion.h"
 
@@ -0,0 +1,240 @@
+#include "bb_particles.h"
+
+#include "../../i_common/i_emitter.h"
+#include "../../i_common/names.h"
+#include "data_graph.h"
+#include "../particle_system/particle_system.h"
+#include "physic.h"
+#include "string_compare.hpp"
+
+BillBoardParticles::BillBoardParticles()
+{
+    Times.reserve(MAX_BILLBOARDS);
+    Physics.reserve(MAX_BILLBOARDS);
+    Render.reserve(MAX_BILLBOARDS);
+    Params.reserve(MAX_BILLBOARDS);
+    Owners.reserve(MAX_BILLBOARDS);
+}
+
+// "Kill" the particle
+void BillBoardParticles::FreeParticle(uint32_t n)
+{
+    *(Owners[n].ActiveCount) = (*(Owners[n].ActiveCount) - 1);
+    RemoveParticle(n, Times, Physics, Render, Params, Owners);
+}
+
+void BillBoardParticles::AddParticle(ParticleSystem *pSystem, const Vector &velocity_dir, const Vector &pos,
+                                     const Matrix &matWorld, float EmitterTime, float EmitterLifeTime,
+                                     FieldList *pFields, uint32_t *pActiveCount, uint32_t dwGUID)
+{
+    // It will work if there are particles > MAX_BILLBOARDS, there should not be so many of them
+    if (Times.size() >= MAX_BILLBOARDS)
+    {
+        *(pActiveCount) = (*(pActiveCount)-1);
+        return;
+    }
+
+    ParticleTime time{};
+    BB_ParticlePhysics physics{};
+    BB_ParticleRender render{};
+    BB_ParticleParams params{};
+    ParticleOwner owner{};
+
+    params.Graph_TrackX = pFields->FindGraph(PARTICLE_TRACK_X);
+    params.Graph_TrackY = pFields->FindGraph(PARTICLE_TRACK_Y);
+    params.Graph_TrackZ = pFields->FindGraph(PARTICLE_TRACK_Z);
+
+    Vector PositionOffset;
+    PositionOffset.x = params.Graph_TrackX->GetRandomValue(0.0f, 100.0f);
+    PositionOffset.y = params.Graph_TrackY->GetRandomValue(0.0f, 100.0f);
+    PositionOffset.z = params.Graph_TrackZ->GetRandomValue(0.0f, 100.0f);
+
+    params.SpeedOriented = pFields->GetBool(PARTICLE_DIR_ORIENT, false);
+    owner.EmitterGUID = dwGUID;
+    owner.ActiveCount = pActiveCount;
+    render.RenderPos = (pos + PositionOffset) * matWorld;
+    physics.Velocity = matWorld.MulNormal(velocity_dir);
+    time.ElapsedTime = 0.0f;
+    params.matWorld = matWorld;
+
+    physics.Angle = 0.0f;
+    render.RenderAngle = 0.0f;
+    physics.PhysPos = render.RenderPos;
+
+    render.OldRenderPos = render.RenderPos;
+    render.OldRenderAngle = render.RenderAngle;
+
+    time.LifeTime = pFields->GetRandomGraphVal(PARTICLE_LIFE_TIME, EmitterTime, EmitterLifeTime);
+    physics.Mass = pFields->GetRandomGraphVal(PARTICLE_MASS, EmitterTime, EmitterLifeTime);
+    physics.Spin = pFields->GetRandomGraphVal(PARTICLE_SPIN, EmitterTime, EmitterLifeTime);
+    physics.Spin = physics.Spin * MUL_DEGTORAD;
+
+    const auto VelocityPower = pFields->GetRandomGraphVal(PARTICLE_VELOCITY_POWER, EmitterTime, EmitterLifeTime);
+    physics.Velocity = physics.Velocity * VelocityPower;
+    physics.UMass = fabsf(physics.Mass);
+
+    params.Graph_SpinDrag = pFields->FindGraph(PARTICLE_SPIN_DRAG);
+    params.Graph_Size = pFields->FindGraph(PARTICLE_SIZE);
+    params.Graph_Frames = pFields->FindGraph(PARTICLE_ANIMFRAME);
+    params.Graph_Color = pFields->FindColor(PARTICLE_COLOR);
+    params.Graph_UV = pFields->FindUV(PARTICLE_FRAMES);
+    params.Graph_Transparency = pFields->FindGraph(PARTICLE_TRANSPARENCY);
+    params.Graph_Drag = pFields->FindGraph(PARTICLE_DRAG);
+    params.Graph_PhysBlend = pFields->FindGraph(PARTICLE_PHYSIC_BLEND);
+    params.graph_GravK = pFields->FindGraph(PARTICLE_GRAVITATION_K);
+    params.graph_AddPower = pFields->FindGraph(PARTICLE_ADDPOWER);
+
+    params.DragK = FRAND(1.0f);
+    params.SpinDragK = FRAND(1.0f);
+    params.SizeK = FRAND(1.0f);
+    params.ColorK = FRAND(1.0f);
+    params.AlphaK = FRAND(1.0f);
+    params.FrameK = FRAND(1.0f);
+    params.GravKK = FRAND(1.0f);
+    params.AddPowerK = FRAND(1.0f);
+
+    params.KPhysBlend = FRAND(1.0f);
+    params.KTrackX = FRAND(1.0f);
+    params.KTrackY = FRAND(1.0f);
+    params.KTrackZ = FRAND(1.0f);
+
+    const auto *const pEmitterName = pFields->GetString(ATTACHEDEMITTER_NAME);
+    if (storm::iEquals(pEmitterName, "none"))
+    {
+        owner.AttachedEmitter = nullptr;
+    }
+    else if (pSystem != nullptr)
+    {
+        owner.AttachedEmitter = pSystem->FindEmitter(pEmitterName);
+        if (owner.AttachedEmitter)
+            owner.AttachedEmitter->SetAttachedFlag(true);
+    }
+
+    Times.push_back(time);
+    Physics.push_back(physics);
+    Render.push_back(render);
+    Params.push_back(params);
+    Owners.push_back(owner);
+}
+
+// Calculate physics, tracks, etc.
+void BillBoardParticles::Process(float DeltaTime)
+{
+    // DWORD t;
+    // RDTSC_B (t);
+
+    // immediately kill the dead, the rest don't depend on each other and are simulated in parallel
+    for (uint32_t n = 0; n < Times.size(); n++)
+    {
+        Times[n].ElapsedTime += DeltaTime;
+        if (Times[n].ElapsedTime > Times[n].LifeTime)
+        {
+            FreeParticle(n);
+            n--;
+        }
+    }
+
+    ForEachParticleChunk(Times.size(),
+                         [this, DeltaTime](uint32_t From, uint32_t To) { SimulateParticles(From, To, DeltaTime); });
+
+    // emit particles that are attached to our particle, they may be added to the arrays
+    for (uint32_t n = 0; n < Times.size(); n++)
+    {
+        if (auto *pEmitter = Owners[n].AttachedEmitter)
+        {
+            pEmitter->Teleport(Matrix(Render[n].OldRenderAngle, Render[n].OldRenderPos));
+            pEmitter->SetTransform(Matrix(Render[n].RenderAngle, Render[n].RenderPos));
+            pEmitter->BornParticles(DeltaTime);
+        }
+    }
+
+    // RDTSC_E (t);
+    // core.Trace("Time - %d", t);
+}
+
+// Calculate physics and tracks of the alive particles
+void BillBoardParticles::SimulateParticles(uint32_t From, uint32_t To, float DeltaTime)
+{
+    for (auto n = From; n < To; n++)
+    {
+        const auto Time = Times[n].ElapsedTime;
+        const auto LifeTime = Times[n].LifeTime;
+
+        auto &physics = Physics[n];
+        auto &render = Render[n];
+        const auto &params = Params[n];
+
+        auto Drag = params.Graph_Drag->GetValue(Time, LifeTime, params.DragK);
+        Drag = 1.0f - (Drag * 0.01f);
+        if (Drag < 0.0f)
+            Drag = 0.0f;
+        if (Drag > 1.0f)
+            Drag = 1.0f;
+
+        const auto GravK = params.graph_GravK->GetValue(Time, LifeTime, params.GravKK);
+
+        auto ExternalForce = Vector(0.0f);
+        AddGravityForce(ExternalForce, physics.Mass, GravK);
+        SolvePhysic(physics.PhysPos, physics.Velocity, ExternalForce, physics.UMass, Drag, DeltaTime);
+
+        // FIX ME !!!
+        auto SpinDrag = params.Graph_SpinDrag->GetValue(Time, LifeTime, params.SpinDragK);
+        SpinDrag = 1.0f - (SpinDrag * 0.01f);
+        if (SpinDrag < 0.0f)
+            SpinDrag = 0.0f;
+        if (SpinDrag > 1.0f)
+            SpinDrag = 1.0f;
+        physics.Angle += (physics.Spin * SpinDrag) * DeltaTime;
+
+        Vector TrackPos;
+        TrackPos.x = params.Graph_TrackX->GetValue(Time, LifeTime, params.KTrackX);
+        TrackPos.y = params.Graph_TrackY->GetValue(Time, LifeTime, params.KTrackY);
+        TrackPos.z = params.Graph_TrackZ->GetValue(Time, LifeTime, params.KTrackZ);
+        TrackPos = TrackPos * params.matWorld;
+
+        // FIX ME !!!
+        auto BlendPhys = params.Graph_PhysBlend->GetValue(Time, LifeTime, params.KPhysBlend);
+        BlendPhys = 1.0f - (BlendPhys * DeltaTime);
+        if (BlendPhys < 0.0f)
+            BlendPhys = 0.0f;
+        if (BlendPhys > 1.0f)
+            BlendPhys = 1.0f;
+
+        // Save old positions
+        render.OldRenderPos = render.RenderPos;
+        // render.OldRenderAngle = render.RenderAngle;
+
+        render.RenderPos.Lerp(TrackPos, physics.PhysPos, BlendPhys);
+        physics.PhysPos = render.RenderPos;
+
+        render.RenderAngle = physics.Angle;
+    }
+}
+
+uint32_t BillBoardParticles::GetCount() const
+{
+    return Times.size();
+}
+
+void BillBoardParticles::DeleteWithGUID(uint32_t dwGUID, uint32_t GUIDRange)
+{
+    for (uint32_t j = 0; j < Owners.size(); j++)
+    {
+        if (Owners[j].EmitterGUID >= dwGUID && Owners[j].EmitterGUID < dwGUID + GUIDRange)
+        {
+            FreeParticle(j);
+            j--;
+        }
+    }
+}
+
+void BillBoardParticles::Clear()
+{
+    for (const auto &owner : Owners)
+        *(owner.ActiveCount) = (*(owner.ActiveCount) - 1);
+    Times.clear();
+    Physics.clear();
+    Render.clear();
+    Params.clear();
+    Owners.clear();
+}
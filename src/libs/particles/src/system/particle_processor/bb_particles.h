@@ -0,0 +1,45 @@
+#pragma once
+
+#include "math3d/matrix.h"
+
+#include "../../i_common/particle.h"
+#include "../data_source/field_list.h"
+
+// How many billboards can there be
+#define MAX_BILLBOARDS 4096
+
+class ParticleSystem;
+
+// Alive billboard particles and their simulation, BillBoardProcessor draws them
+class BillBoardParticles
+{
+  protected:
+    // Alive particles, see particle.h
+    std::vector<ParticleTime> Times;
+    std::vector<BB_ParticlePhysics> Physics;
+    std::vector<BB_ParticleRender> Render;
+    std::vector<BB_ParticleParams> Params;
+    std::vector<ParticleOwner> Owners;
+
+    // "Kill" the particle, the last one takes its place
+    void FreeParticle(uint32_t n);
+
+    // Move the particles [From, To) by their graphs and physics, touches nothing but these particles
+    void SimulateParticles(uint32_t From, uint32_t To, float DeltaTime);
+
+  public:
+    BillBoardParticles();
+
+    // pSystem finds the emitter attached to the particle, without a system nothing is attached
+    void AddParticle(ParticleSystem *pSystem, const Vector &velocity_dir, const Vector &pos, const Matrix &matWorld,
+                     float EmitterTime, float EmitterLifeTime, FieldList *pFields, uint32_t *pActiveCount,
+                     uint32_t dwGUID);
+
+    void Process(float DeltaTime);
+
+    uint32_t GetCount() const;
+
+    void DeleteWithGUID(uint32_t dwGUID, uint32_t GUIDRange = GUIDSTEP);
+
+    void Clear();
+};
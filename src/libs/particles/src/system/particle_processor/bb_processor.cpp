@@ -3,17 +3,12 @@
 #include "core.h"
 #include "math_inlines.h"
 
-#include "../../i_common/i_emitter.h"
-#include "../../i_common/names.h"
 #include "../data_source/data_color.h"
-#include "../data_source/data_graph.h"
+#include "data_graph.h"
 #include "../data_source/data_uv.h"
-#include "../particle_system/particle_system.h"
-#include "physic.h"
-#include "string_compare.hpp"
 
-// How many billboards can there be
-#define MAX_BILLBOARDS 4096
+#include <algorithm>
+#include <execution>
 
 #define UV_TX1 0
 #define UV_TX2 2
@@ -33,13 +28,7 @@ IDirect3DVertexDeclaration9 *BillBoardProcessor::vertexDecl_ = nullptr;
 
 BillBoardProcessor::BillBoardProcessor()
 {
-    Particles.reserve(MAX_BILLBOARDS);
-    pMemArray = new MemArrayItem[MAX_BILLBOARDS];
-
-    for (uint32_t n = 0; n < MAX_BILLBOARDS; n++)
-    {
-        pMemArray[n].Free = true;
-    }
+    DrawOrder.reserve(MAX_BILLBOARDS);
 
     pRS = static_cast<VDX9RENDER *>(core.GetService("DX9Render"));
     Assert(pRS);
@@ -70,8 +59,6 @@ BillBoardProcessor::BillBoardProcessor()
 
 BillBoardProcessor::~BillBoardProcessor()
 {
-    delete pMemArray;
-
     pRS = static_cast<VDX9RENDER *>(core.GetService("DX9Render"));
     if (pRS != nullptr)
     {
@@ -83,247 +70,22 @@ BillBoardProcessor::~BillBoardProcessor()
     pIBuffer = -1;
 }
 
-// Allocate memory for particle storage
-BB_ParticleData *BillBoardProcessor::AllocParticle() const
-{
-    for (uint32_t n = 0; n < MAX_BILLBOARDS; n++)
-    {
-        if (pMemArray[n].Free)
-        {
-            pMemArray[n].Free = false;
-            return &pMemArray[n].pData;
-        }
-    }
-
-    return nullptr;
-}
-
-// "Kill" the particle
-void BillBoardProcessor::FreeParticle(BB_ParticleData *pItem) const
-{
-    for (uint32_t n = 0; n < MAX_BILLBOARDS; n++)
-    {
-        if (&pMemArray[n].pData == pItem)
-        {
-            pMemArray[n].Free = true;
-            return;
-        }
-    }
-}
-
-void BillBoardProcessor::AddParticle(ParticleSystem *pSystem, const Vector &velocity_dir, const Vector &pos,
-                                     const Matrix &matWorld, float EmitterTime, float EmitterLifeTime,
-                                     FieldList *pFields, uint32_t *pActiveCount, uint32_t dwGUID)
-{
-    auto *pData = AllocParticle();
-
-    // It will work if there are particles > MAX_BILLBOARDS, there should not be so many of them
-    if (!pData)
-    {
-        *(pActiveCount) = (*(pActiveCount)-1);
-        return;
-    }
-
-    pData->Graph_TrackX = pFields->FindGraph(PARTICLE_TRACK_X);
-    pData->Graph_TrackY = pFields->FindGraph(PARTICLE_TRACK_Y);
-    pData->Graph_TrackZ = pFields->FindGraph(PARTICLE_TRACK_Z);
-
-    Vector PositionOffset;
-    PositionOffset.x = pData->Graph_TrackX->GetRandomValue(0.0f, 100.0f);
-    PositionOffset.y = pData->Graph_TrackY->GetRandomValue(0.0f, 100.0f);
-    PositionOffset.z = pData->Graph_TrackZ->GetRandomValue(0.0f, 100.0f);
-
-    pData->SpeedOriented = pFields->GetBool(PARTICLE_DIR_ORIENT, false);
-    pData->EmitterGUID = dwGUID;
-    pData->ActiveCount = pActiveCount;
-    pData->RenderPos = (pos + PositionOffset) * matWorld;
-    pData->Velocity = matWorld.MulNormal(velocity_dir);
-    pData->ElapsedTime = 0.0f;
-    pData->matWorld = matWorld;
-
-    pData->Angle = 0.0f;
-    pData->RenderAngle = 0.0f;
-    pData->ExternalForce = Vector(0.0f, 0.0f, 0.0f);
-    pData->PhysPos = pData->RenderPos;
-
-    pData->OldRenderPos = pData->RenderPos;
-    pData->OldRenderAngle = pData->RenderAngle;
-
-    pData->LifeTime = pFields->GetRandomGraphVal(PARTICLE_LIFE_TIME, EmitterTime, EmitterLifeTime);
-    pData->Mass = pFields->GetRandomGraphVal(PARTICLE_MASS, EmitterTime, EmitterLifeTime);
-    pData->Spin = pFields->GetRandomGraphVal(PARTICLE_SPIN, EmitterTime, EmitterLifeTime);
-    pData->Spin = pData->Spin * MUL_DEGTORAD;
-
-    const auto VelocityPower = pFields->GetRandomGraphVal(PARTICLE_VELOCITY_POWER, EmitterTime, EmitterLifeTime);
-    pData->Velocity = pData->Velocity * VelocityPower;
-    pData->UMass = fabsf(pData->Mass);
-
-    pData->Graph_SpinDrag = pFields->FindGraph(PARTICLE_SPIN_DRAG);
-    pData->Graph_Size = pFields->FindGraph(PARTICLE_SIZE);
-    pData->Graph_Frames = pFields->FindGraph(PARTICLE_ANIMFRAME);
-    pData->Graph_Color = pFields->FindColor(PARTICLE_COLOR);
-    pData->Graph_UV = pFields->FindUV(PARTICLE_FRAMES);
-    pData->Graph_Transparency = pFields->FindGraph(PARTICLE_TRANSPARENCY);
-    pData->Graph_Drag = pFields->FindGraph(PARTICLE_DRAG);
-    pData->Graph_PhysBlend = pFields->FindGraph(PARTICLE_PHYSIC_BLEND);
-    pData->graph_GravK = pFields->FindGraph(PARTICLE_GRAVITATION_K);
-    pData->graph_AddPower = pFields->FindGraph(PARTICLE_ADDPOWER);
-
-    pData->DragK = FRAND(1.0f);
-    pData->SpinDragK = FRAND(1.0f);
-    pData->SizeK = FRAND(1.0f);
-    pData->ColorK = FRAND(1.0f);
-    pData->AlphaK = FRAND(1.0f);
-    pData->FrameK = FRAND(1.0f);
-    pData->GravKK = FRAND(1.0f);
-    pData->AddPowerK = FRAND(1.0f);
-
-    pData->KPhysBlend = FRAND(1.0f);
-    pData->KTrackX = FRAND(1.0f);
-    pData->KTrackY = FRAND(1.0f);
-    pData->KTrackZ = FRAND(1.0f);
-
-    const auto *const pEmitterName = pFields->GetString(ATTACHEDEMITTER_NAME);
-    if (storm::iEquals(pEmitterName, "none"))
-    {
-        pData->AttachedEmitter = nullptr;
-    }
-    else
-    {
-        pData->AttachedEmitter = pSystem->FindEmitter(pEmitterName);
-        if (pData->AttachedEmitter)
-            pData->AttachedEmitter->SetAttachedFlag(true);
-    }
-
-    Particles.push_back(pData);
-}
-
-// Calculate physics, tracks, etc.
-void BillBoardProcessor::Process(float DeltaTime)
-{
-    // DWORD t;
-    // RDTSC_B (t);
-
-    for (uint32_t n = 0; n < Particles.size(); n++)
-    {
-        Particles[n]->ElapsedTime += DeltaTime;
-
-        const auto Time = Particles[n]->ElapsedTime;
-        const auto LifeTime = Particles[n]->LifeTime;
-
-        //        _mm_prefetch ((const char *)Particles[n+1], _MM_HINT_T0);
-
-        // immediately kill the dead
-        if (Time > LifeTime)
-        {
-            *(Particles[n]->ActiveCount) = (*(Particles[n]->ActiveCount) - 1);
-            FreeParticle(Particles[n]);
-            // Particles.ExtractNoShift(n);
-            Particles[n] = Particles.back();
-            Particles.pop_back();
-            n--;
-            continue;
-        }
-
-        auto Drag = Particles[n]->Graph_Drag->GetValue(Time, LifeTime, Particles[n]->DragK);
-        Drag = 1.0f - (Drag * 0.01f);
-        if (Drag < 0.0f)
-            Drag = 0.0f;
-        if (Drag > 1.0f)
-            Drag = 1.0f;
-
-        const auto GravK = Particles[n]->graph_GravK->GetValue(Time, LifeTime, Particles[n]->GravKK);
-
-        AddGravityForce(Particles[n]->ExternalForce, Particles[n]->Mass, GravK);
-        SolvePhysic(Particles[n]->PhysPos, Particles[n]->Velocity, Particles[n]->ExternalForce, Particles[n]->UMass,
-                    Drag, DeltaTime);
-        Particles[n]->ExternalForce = Vector(0.0f);
-
-        // FIX ME !!!
-        auto SpinDrag = Particles[n]->Graph_SpinDrag->GetValue(Time, LifeTime, Particles[n]->SpinDragK);
-        SpinDrag = 1.0f - (SpinDrag * 0.01f);
-        if (SpinDrag < 0.0f)
-            SpinDrag = 0.0f;
-        if (SpinDrag > 1.0f)
-            SpinDrag = 1.0f;
-        Particles[n]->Angle += (Particles[n]->Spin * SpinDrag) * DeltaTime;
-
-        Vector TrackPos;
-        TrackPos.x = Particles[n]->Graph_TrackX->GetValue(Time, LifeTime, Particles[n]->KTrackX);
-        TrackPos.y = Particles[n]->Graph_TrackY->GetValue(Time, LifeTime, Particles[n]->KTrackY);
-        TrackPos.z = Particles[n]->Graph_TrackZ->GetValue(Time, LifeTime, Particles[n]->KTrackZ);
-        TrackPos = TrackPos * Particles[n]->matWorld;
-
-        // FIX ME !!!
-        auto BlendPhys = Particles[n]->Graph_PhysBlend->GetValue(Time, LifeTime, Particles[n]->KPhysBlend);
-        BlendPhys = 1.0f - (BlendPhys * DeltaTime);
-        if (BlendPhys < 0.0f)
-            BlendPhys = 0.0f;
-        if (BlendPhys > 1.0f)
-            BlendPhys = 1.0f;
-
-        // Save old positions
-        Particles[n]->OldRenderPos = Particles[n]->RenderPos;
-        // Particles[n]->OldRenderAngle = Particles[n]->RenderAngle;
-
-        Particles[n]->RenderPos.Lerp(TrackPos, Particles[n]->PhysPos, BlendPhys);
-        Particles[n]->PhysPos = Particles[n]->RenderPos;
-
-        // Particles[n]->RenderPos    = Particles[n]->PhysPos;
-        Particles[n]->RenderAngle = Particles[n]->Angle;
-    }
-
-    // emit particles that are attached to our particle
-
-    for (uint32_t n = 0; n < Particles.size(); n++)
-    {
-        if (Particles[n]->AttachedEmitter)
-        {
-            //            core.Trace("%d, %3.2f, %3.2f, %3.2f", n, Particles[n]->RenderPos.x, Particles[n]->RenderPos.y,
-            // Particles[n]->RenderPos.z);             Particles[n]->AttachedEmitter->SaveTime();
-            Particles[n]->AttachedEmitter->Teleport(Matrix(Particles[n]->OldRenderAngle, Particles[n]->OldRenderPos));
-            Particles[n]->AttachedEmitter->SetTransform(Matrix(Particles[n]->RenderAngle, Particles[n]->RenderPos));
-            Particles[n]->AttachedEmitter->BornParticles(DeltaTime);
-
-            // if (n < Particles.size()-1)    Particles[n]->AttachedEmitter->RestoreTime();
-        }
-    }
-
-    // RDTSC_E (t);
-    // core.Trace("Time - %d", t);
-}
-
 // Calculate distance to billboards
 uint32_t BillBoardProcessor::CalcDistanceToCamera()
 {
-    uint32_t VisParticles = 0;
+    DrawOrder.clear();
     const Matrix mView;
     pRS->GetTransform(D3DTS_VIEW, mView);
-    for (uint32_t j = 0; j < Particles.size(); j++)
+    ForEachParticleChunk(Render.size(), [this, &mView](uint32_t From, uint32_t To) {
+        for (auto j = From; j < To; j++)
+            Render[j].CamDistance = Vector(Render[j].RenderPos * mView).z;
+    });
+    for (uint32_t j = 0; j < Render.size(); j++)
     {
-        Particles[j]->CamDistance = Vector(Particles[j]->RenderPos * mView).z;
-
-        //        _mm_prefetch ((const char *)Particles[j+1], _MM_HINT_T0);
-
-        if (Particles[j]->CamDistance > 0)
-        {
-            Particles[j]->Visible = true;
-            VisParticles++;
-        }
-        else
-        {
-            Particles[j]->Visible = false;
-        }
+        if (Render[j].CamDistance > 0)
+            DrawOrder.push_back(j);
     }
-    return VisParticles;
-}
-
-// Compare function when sorting
-BOOL BillBoardProcessor::CompareFunction(BB_ParticleData *e1, BB_ParticleData *e2)
-{
-    if (e1->CamDistance > e2->CamDistance)
-        return true;
-    return false;
+    return DrawOrder.size();
 }
 
 // Draws all the billboards
@@ -331,7 +93,12 @@ void BillBoardProcessor::Draw()
 {
     if (CalcDistanceToCamera() == 0)
         return;
-    ParticleSorter.QSort(CompareFunction, &Particles[0], Particles.size());
+    // equal distances are ordered by index, so the parallel sort gives the same order every time
+    std::sort(std::execution::par, DrawOrder.begin(), DrawOrder.end(), [this](uint32_t a, uint32_t b) {
+        if (Render[a].CamDistance != Render[b].CamDistance)
+            return Render[a].CamDistance > Render[b].CamDistance;
+        return a < b;
+    });
 
     auto *pVerts = static_cast<RECT_VERTEX *>(pRS->LockVertexBuffer(pVBuffer, D3DLOCK_DISCARD));
     // RECT_VERTEX * pVerts = (RECT_VERTEX*)pVBuffer->Lock(0, 0, D3DLOCK_DISCARD);
@@ -339,25 +106,23 @@ void BillBoardProcessor::Draw()
 
     int32_t Index = 0;
     uint32_t ParticlesCount = 0;
-    for (uint32_t j = 0; j < Particles.size(); j++)
+    for (const auto j : DrawOrder)
     {
-        auto pR = Particles[j];
+        const auto &time = Times[j];
+        const auto &physics = Physics[j];
+        auto &render = Render[j];
+        const auto &params = Params[j];
 
-        if (!pR->Visible)
-            continue;
-
-        auto SpeedOriented = pR->SpeedOriented;
-        auto fSize = pR->Graph_Size->GetValue(pR->ElapsedTime, pR->LifeTime, pR->SizeK);
+        auto SpeedOriented = params.SpeedOriented;
+        auto fSize = params.Graph_Size->GetValue(time.ElapsedTime, time.LifeTime, params.SizeK);
         if (fSize <= 0.000001f)
             continue;
 
-        //        _mm_prefetch ((const char *)Particles[j+1], _MM_HINT_T0);
-
-        auto fAngle = pR->RenderAngle;
-        auto vPos = pR->RenderPos;
-        uint32_t dwColor = pR->Graph_Color->GetValue(pR->ElapsedTime, pR->LifeTime, pR->ColorK);
+        auto fAngle = render.RenderAngle;
+        auto vPos = render.RenderPos;
+        uint32_t dwColor = params.Graph_Color->GetValue(time.ElapsedTime, time.LifeTime, params.ColorK);
 
-        auto Alpha = pR->Graph_Transparency->GetValue(pR->ElapsedTime, pR->LifeTime, pR->AlphaK);
+        auto Alpha = params.Graph_Transparency->GetValue(time.ElapsedTime, time.LifeTime, params.AlphaK);
         Alpha = Alpha * 0.01f;
         Alpha = 1.0f - Alpha;
         if (Alpha < 0.0f)
@@ -366,7 +131,7 @@ void BillBoardProcessor::Draw()
             Alpha = 1.0f;
         Alpha = Alpha * 255.0f;
 
-        auto AddPower = pR->graph_AddPower->GetValue(pR->ElapsedTime, pR->LifeTime, pR->AddPowerK);
+        auto AddPower = params.graph_AddPower->GetValue(time.ElapsedTime, time.LifeTime, params.AddPowerK);
         AddPower = AddPower * 0.01f;
         AddPower = 1.0f - AddPower;
         if (AddPower < 0.0f)
@@ -376,17 +141,17 @@ void BillBoardProcessor::Draw()
 
         // AddPower = 0.0f;
 
-        auto FrameIndex = pR->Graph_Frames->GetValue(pR->ElapsedTime, pR->LifeTime, pR->FrameK);
+        auto FrameIndex = params.Graph_Frames->GetValue(time.ElapsedTime, time.LifeTime, params.FrameK);
         auto FrameIndexLong = fftol(FrameIndex);
         auto FrameBlendK = 1.0f - (FrameIndex - FrameIndexLong);
-        const auto &UV_WH1 = pR->Graph_UV->GetValue(FrameIndexLong);
-        const auto &UV_WH2 = pR->Graph_UV->GetValue(FrameIndexLong + 1);
+        const auto &UV_WH1 = params.Graph_UV->GetValue(FrameIndexLong);
+        const auto &UV_WH2 = params.Graph_UV->GetValue(FrameIndexLong + 1);
 
         // Maximum particle size limiter
         // =============================================================
-        auto SizeK = pR->CamDistance / fSize;
+        auto SizeK = render.CamDistance / fSize;
         if (SizeK < PLOD)
-            fSize = pR->CamDistance / PLOD;
+            fSize = render.CamDistance / PLOD;
         //=============================================================
 
         auto *pV = &pVerts[Index * 4];
@@ -399,8 +164,8 @@ void BillBoardProcessor::Draw()
         {
             Matrix matView;
             pRS->GetTransform(D3DTS_VIEW, matView);
-            auto SpeedVector = pR->Velocity;
-            // pR->RenderPos - pR->OldRenderPos;
+            auto SpeedVector = physics.Velocity;
+            // render.RenderPos - render.OldRenderPos;
             SpeedVector = matView.MulNormal(SpeedVector);
             SpeedVector.Normalize();
             ScaleF = 1.0f - fabsf(SpeedVector.z);
@@ -410,9 +175,9 @@ void BillBoardProcessor::Draw()
             Alpha *= ScaleF;
 
             SpeedVector.z = SpeedVector.y;
-            DirAngle = SpeedVector.GetAY(pR->OldRenderAngle);
+            DirAngle = SpeedVector.GetAY(render.OldRenderAngle);
 
-            pR->OldRenderAngle = DirAngle;
+            render.OldRenderAngle = DirAngle;
         }
 
         uint32_t dwAlpha = static_cast<uint8_t>(Alpha) << 24;
@@ -533,37 +298,6 @@ void BillBoardProcessor::Draw()
     // pRS->Print(20, 20, "PSYS 2.0 : Draw %d billboard particles", ParticlesCount);
 }
 
-uint32_t BillBoardProcessor::GetCount() const
-{
-    return Particles.size();
-}
-
-void BillBoardProcessor::DeleteWithGUID(uint32_t dwGUID, uint32_t GUIDRange)
-{
-    for (uint32_t j = 0; j < Particles.size(); j++)
-    {
-        if (Particles[j]->EmitterGUID >= dwGUID && Particles[j]->EmitterGUID < dwGUID + GUIDRange)
-        {
-            *(Particles[j]->ActiveCount) = (*(Particles[j]->ActiveCount) - 1);
-            FreeParticle(Particles[j]);
-            // Particles.ExtractNoShift(j);
-            Particles[j] = Particles.back();
-            Particles.pop_back();
-            j--;
-        }
-    }
-}
-
-void BillBoardProcessor::Clear()
-{
-    for (uint32_t j = 0; j < Particles.size(); j++)
-    {
-        *(Particles[j]->ActiveCount) = (*(Particles[j]->ActiveCount) - 1);
-        FreeParticle(Particles[j]);
-    }
-    Particles.clear();
-}
-
 void BillBoardProcessor::CreateVertexDeclaration() const
 {
     if (vertexDecl_ != nullptr)
@@ -9,14 +9,10 @@
 
 #include "dx9render.h"
 #include "math3d/matrix.h"
-#include "../../gmx_qsort.h"
 
-#include "../../i_common/particle.h"
-#include "../data_source/field_list.h"
+#include "bb_particles.h"
 
-class ParticleSystem;
-
-class BillBoardProcessor
+class BillBoardProcessor : public BillBoardParticles
 {
     static IDirect3DVertexDeclaration9 *vertexDecl_;
     void CreateVertexDeclaration() const;
@@ -38,47 +34,15 @@ class BillBoardProcessor
     int32_t pVBuffer;
     int32_t pIBuffer;
 
-    struct MemArrayItem
-    {
-        BB_ParticleData pData;
-        bool Free;
-
-        MemArrayItem()
-            : pData()
-        {
-            Free = true;
-        }
-    };
-
-    MemArrayItem *pMemArray;
-
-    std::vector<BB_ParticleData *> Particles;
-
-    GMXQSort<BB_ParticleData *> ParticleSorter;
+    // Visible particles, back to front after sorting
+    std::vector<uint32_t> DrawOrder;
 
     // Counts distance to billboards
     uint32_t CalcDistanceToCamera();
 
-    // Compare function when sorting
-    static BOOL CompareFunction(BB_ParticleData *e1, BB_ParticleData *e2);
-
-    BB_ParticleData *AllocParticle() const;
-    void FreeParticle(BB_ParticleData *pItem) const;
-
   public:
     BillBoardProcessor();
     ~BillBoardProcessor();
 
-    void AddParticle(ParticleSystem *pSystem, const Vector &velocity_dir, const Vector &pos, const Matrix &matWorld,
-                     float EmitterTime, float EmitterLifeTime, FieldList *pFields, uint32_t *pActiveCount,
-                     uint32_t dwGUID);
-
-    void Process(float DeltaTime);
     void Draw();
-
-    uint32_t GetCount() const;
-
-    void DeleteWithGUID(uint32_t dwGUID, uint32_t GUIDRange = GUIDSTEP);
-
-    void Clear();
 };
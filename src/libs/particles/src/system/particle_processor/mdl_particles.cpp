@@ -0,0 +1,253 @@
+#include "mdl_particles.h"
+
+#include "../../i_common/i_emitter.h"
+#include "../../i_common/names.h"
+#include "data_graph.h"
+#include "../particle_system/particle_system.h"
+#include "physic.h"
+#include "string_compare.hpp"
+
+ModelParticles::ModelParticles()
+{
+    Times.reserve(MAX_MODELS);
+    Physics.reserve(MAX_MODELS);
+    Render.reserve(MAX_MODELS);
+    Params.reserve(MAX_MODELS);
+    Owners.reserve(MAX_MODELS);
+}
+
+void ModelParticles::FreeParticle(uint32_t n)
+{
+    *(Owners[n].ActiveCount) = (*(Owners[n].ActiveCount) - 1);
+    RemoveParticle(n, Times, Physics, Render, Params, Owners);
+}
+
+void ModelParticles::AddParticle(ParticleSystem *pSystem, const Vector &velocity_dir, const Vector &pos,
+                                 const Matrix &matWorld, float EmitterTime, float EmitterLifeTime, FieldList *pFields,
+                                 uint32_t *pActiveCount, uint32_t dwGUID, GEOS *pScene)
+{
+    // works if the number of particles > MAX_BILLBOARDS, there shouldn't be that many :))))
+    if (Times.size() >= MAX_MODELS)
+    {
+        *(pActiveCount) = (*(pActiveCount)-1);
+        return;
+    }
+
+    ParticleTime time{};
+    MDL_ParticlePhysics physics{};
+    MDL_ParticleRender render{};
+    MDL_ParticleParams params{};
+    ParticleOwner owner{};
+
+    render.pScene = pScene;
+
+    params.Graph_TrackX = pFields->FindGraph(PARTICLE_TRACK_X);
+    params.Graph_TrackY = pFields->FindGraph(PARTICLE_TRACK_Y);
+    params.Graph_TrackZ = pFields->FindGraph(PARTICLE_TRACK_Z);
+
+    Vector PositionOffset;
+    PositionOffset.x = params.Graph_TrackX->GetRandomValue(0.0f, 100.0f);
+    PositionOffset.y = params.Graph_TrackY->GetRandomValue(0.0f, 100.0f);
+    PositionOffset.z = params.Graph_TrackZ->GetRandomValue(0.0f, 100.0f);
+
+    owner.EmitterGUID = dwGUID;
+    owner.ActiveCount = pActiveCount;
+    render.RenderPos = (pos + PositionOffset) * matWorld;
+    physics.Velocity = matWorld.MulNormal(velocity_dir);
+    time.ElapsedTime = 0.0f;
+    params.matWorld = matWorld;
+
+    physics.Angle = Vector(0.0f);
+    render.RenderAngle = Vector(0.0f);
+    physics.PhysPos = render.RenderPos;
+
+    render.OldRenderPos = render.RenderPos;
+    render.OldRenderAngle = render.RenderAngle;
+
+    time.LifeTime = pFields->GetRandomGraphVal(PARTICLE_LIFE_TIME, EmitterTime, EmitterLifeTime);
+    physics.Mass = pFields->GetRandomGraphVal(PARTICLE_MASS, EmitterTime, EmitterLifeTime);
+    physics.Spin.x = pFields->GetRandomGraphVal(PARTICLE_SPIN_X, EmitterTime, EmitterLifeTime);
+    physics.Spin.y = pFields->GetRandomGraphVal(PARTICLE_SPIN_Y, EmitterTime, EmitterLifeTime);
+    physics.Spin.z = pFields->GetRandomGraphVal(PARTICLE_SPIN_Z, EmitterTime, EmitterLifeTime);
+    physics.Spin = physics.Spin * MUL_DEGTORAD;
+    // core.Trace("spin %3.2f, %3.2f, %3.2f [%3.2f, %3.2f]", physics.Spin.x, physics.Spin.y, physics.Spin.z, EmitterTime,
+    // EmitterLifeTime);
+
+    const auto VelocityPower = pFields->GetRandomGraphVal(PARTICLE_VELOCITY_POWER, EmitterTime, EmitterLifeTime);
+    physics.Velocity = physics.Velocity * VelocityPower;
+    physics.UMass = fabsf(physics.Mass);
+
+    params.Graph_SpinDragX = pFields->FindGraph(PARTICLE_SPIN_DRAGX);
+    params.Graph_SpinDragY = pFields->FindGraph(PARTICLE_SPIN_DRAGY);
+    params.Graph_SpinDragZ = pFields->FindGraph(PARTICLE_SPIN_DRAGZ);
+    params.Graph_Drag = pFields->FindGraph(PARTICLE_DRAG);
+    params.Graph_PhysBlend = pFields->FindGraph(PARTICLE_PHYSIC_BLEND);
+    params.graph_GravK = pFields->FindGraph(PARTICLE_GRAVITATION_K);
+
+    params.DragK = FRAND(1.0f);
+    params.SpinDragK_X = FRAND(1.0f);
+    params.SpinDragK_Y = FRAND(1.0f);
+    params.SpinDragK_Z = FRAND(1.0f);
+    params.GravKK = FRAND(1.0f);
+
+    params.KPhysBlend = FRAND(1.0f);
+    params.KTrackX = FRAND(1.0f);
+    params.KTrackY = FRAND(1.0f);
+    params.KTrackZ = FRAND(1.0f);
+
+    const auto *const pEmitterName = pFields->GetString(ATTACHEDEMITTER_NAME);
+    if (storm::iEquals(pEmitterName, "none"))
+    {
+        owner.AttachedEmitter = nullptr;
+    }
+    else if (pSystem != nullptr)
+    {
+        owner.AttachedEmitter = pSystem->FindEmitter(pEmitterName);
+        if (owner.AttachedEmitter)
+            owner.AttachedEmitter->SetAttachedFlag(true);
+    }
+
+    Times.push_back(time);
+    Physics.push_back(physics);
+    Render.push_back(render);
+    Params.push_back(params);
+    Owners.push_back(owner);
+}
+
+// Calculates physics, tracks, etc.
+void ModelParticles::Process(float DeltaTime)
+{
+    // DWORD t;
+    // RDTSC_B (t);
+
+    // kill the dead ones, the alive ones are simulated in parallel chunks
+    for (uint32_t n = 0; n < Times.size(); n++)
+    {
+        Times[n].ElapsedTime += DeltaTime;
+        if (Times[n].ElapsedTime > Times[n].LifeTime)
+        {
+            FreeParticle(n);
+            n--;
+        }
+    }
+
+    ForEachParticleChunk(Times.size(),
+                         [this, DeltaTime](uint32_t From, uint32_t To) { SimulateParticles(From, To, DeltaTime); });
+
+    // waiting for the particles that are attached to our particle, they may be added to the arrays
+    for (uint32_t n = 0; n < Times.size(); n++)
+    {
+        if (auto *pEmitter = Owners[n].AttachedEmitter)
+        {
+            pEmitter->Teleport(Matrix(Render[n].OldRenderAngle, Render[n].OldRenderPos));
+            pEmitter->SetTransform(Matrix(Render[n].RenderAngle, Render[n].RenderPos));
+            pEmitter->BornParticles(DeltaTime);
+        }
+    }
+
+    // RDTSC_E (t);
+    // core.Trace("Time - %d", t);
+}
+
+// Calculate physics and tracks of the alive particles
+void ModelParticles::SimulateParticles(uint32_t From, uint32_t To, float DeltaTime)
+{
+    for (auto n = From; n < To; n++)
+    {
+        const auto Time = Times[n].ElapsedTime;
+        const auto LifeTime = Times[n].LifeTime;
+
+        auto &physics = Physics[n];
+        auto &render = Render[n];
+        const auto &params = Params[n];
+
+        auto Drag = params.Graph_Drag->GetValue(Time, LifeTime, params.DragK);
+        Drag = 1.0f - (Drag * 0.01f);
+        if (Drag < 0.0f)
+            Drag = 0.0f;
+        if (Drag > 1.0f)
+            Drag = 1.0f;
+
+        const auto GravK = params.graph_GravK->GetValue(Time, LifeTime, params.GravKK);
+
+        auto ExternalForce = Vector(0.0f);
+        AddGravityForce(ExternalForce, physics.Mass, GravK);
+        SolvePhysic(physics.PhysPos, physics.Velocity, ExternalForce, physics.UMass, Drag, DeltaTime);
+
+        // FIX ME !!!
+        Vector SpinDrag;
+        SpinDrag.x = params.Graph_SpinDragX->GetValue(Time, LifeTime, params.SpinDragK_X);
+        SpinDrag.x = 1.0f - (SpinDrag.x * 0.01f);
+        if (SpinDrag.x < 0.0f)
+            SpinDrag.x = 0.0f;
+        if (SpinDrag.x > 1.0f)
+            SpinDrag.x = 1.0f;
+
+        SpinDrag.y = params.Graph_SpinDragX->GetValue(Time, LifeTime, params.SpinDragK_Y);
+        SpinDrag.y = 1.0f - (SpinDrag.y * 0.01f);
+        if (SpinDrag.y < 0.0f)
+            SpinDrag.y = 0.0f;
+        if (SpinDrag.y > 1.0f)
+            SpinDrag.y = 1.0f;
+
+        SpinDrag.z = params.Graph_SpinDragX->GetValue(Time, LifeTime, params.SpinDragK_Z);
+        SpinDrag.z = 1.0f - (SpinDrag.z * 0.01f);
+        if (SpinDrag.z < 0.0f)
+            SpinDrag.z = 0.0f;
+        if (SpinDrag.z > 1.0f)
+            SpinDrag.z = 1.0f;
+
+        physics.Angle += (physics.Spin * SpinDrag) * DeltaTime;
+
+        Vector TrackPos;
+        TrackPos.x = params.Graph_TrackX->GetValue(Time, LifeTime, params.KTrackX);
+        TrackPos.y = params.Graph_TrackY->GetValue(Time, LifeTime, params.KTrackY);
+        TrackPos.z = params.Graph_TrackZ->GetValue(Time, LifeTime, params.KTrackZ);
+        TrackPos = TrackPos * params.matWorld;
+
+        // FIX ME !!!
+        auto BlendPhys = params.Graph_PhysBlend->GetValue(Time, LifeTime, params.KPhysBlend);
+        BlendPhys = 1.0f - (BlendPhys * DeltaTime);
+        if (BlendPhys < 0.0f)
+            BlendPhys = 0.0f;
+        if (BlendPhys > 1.0f)
+            BlendPhys = 1.0f;
+
+        // Save old positions
+        render.OldRenderPos = render.RenderPos;
+        render.OldRenderAngle = render.RenderAngle;
+
+        render.RenderPos.Lerp(TrackPos, physics.PhysPos, BlendPhys);
+        physics.PhysPos = render.RenderPos;
+
+        render.RenderAngle = physics.Angle;
+    }
+}
+
+uint32_t ModelParticles::GetCount() const
+{
+    return Times.size();
+}
+
+void ModelParticles::DeleteWithGUID(uint32_t dwGUID, uint32_t GUIDRange)
+{
+    for (uint32_t j = 0; j < Owners.size(); j++)
+    {
+        if (Owners[j].EmitterGUID >= dwGUID && Owners[j].EmitterGUID < dwGUID + GUIDSTEP)
+        {
+            FreeParticle(j);
+            j--;
+        }
+    }
+}
+
+void ModelParticles::Clear()
+{
+    for (const auto &owner : Owners)
+        *(owner.ActiveCount) = (*(owner.ActiveCount) - 1);
+    Times.clear();
+    Physics.clear();
+    Render.clear();
+    Params.clear();
+    Owners.clear();
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "math3d/matrix.h"
+
+#include "../../i_common/particle.h"
+#include "../data_source/field_list.h"
+
+// how many models there can be
+#define MAX_MODELS 8192
+
+class ParticleSystem;
+class GEOS;
+
+// Alive model particles and their simulation, ModelProcessor picks their models and draws them
+class ModelParticles
+{
+  protected:
+    // Alive particles, see particle.h
+    std::vector<ParticleTime> Times;
+    std::vector<MDL_ParticlePhysics> Physics;
+    std::vector<MDL_ParticleRender> Render;
+    std::vector<MDL_ParticleParams> Params;
+    std::vector<ParticleOwner> Owners;
+
+    // "Kill" the particle, the last one takes its place
+    void FreeParticle(uint32_t n);
+
+    // Simulate the particles [From, To), may run on a worker thread
+    void SimulateParticles(uint32_t From, uint32_t To, float DeltaTime);
+
+  public:
+    ModelParticles();
+
+    // pSystem finds the emitter attached to the particle, without a system nothing is attached
+    void AddParticle(ParticleSystem *pSystem, const Vector &velocity_dir, const Vector &pos, const Matrix &matWorld,
+                     float EmitterTime, float EmitterLifeTime, FieldList *pFields, uint32_t *pActiveCount,
+                     uint32_t dwGUID, GEOS *pScene);
+
+    void Process(float DeltaTime);
+
+    uint32_t GetCount() const;
+
+    void DeleteWithGUID(uint32_t dwGUID, uint32_t GUIDRange = GUIDSTEP);
+
+    void Clear();
+};
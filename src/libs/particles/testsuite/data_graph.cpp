@@ -0,0 +1,128 @@
+#include "data_graph.h"
+
+#include <catch2/catch.hpp>
+
+#include <random>
+#include <vector>
+
+namespace
+{
+
+// MAX_GRAPH_TIME, the time of the key holding the value to the end
+constexpr float kMaxGraphTime = 99999.0f;
+
+// The key search used before the graphs were baked
+float SearchKeys(const std::vector<GraphVertex> &graph, float time)
+{
+    for (size_t i = 0; i + 1 < graph.size(); i++)
+    {
+        if (time <= graph[i + 1].Time)
+        {
+            const auto delta = graph[i + 1].Time - graph[i].Time;
+            const auto k = delta > 0.001f ? (time - graph[i].Time) / delta : 0.0f;
+            return graph[i].Val + (graph[i + 1].Val - graph[i].Val) * k;
+        }
+    }
+    return 0.0f;
+}
+
+float SearchValue(const DataGraph &graph, const std::vector<GraphVertex> &min, const std::vector<GraphVertex> &max,
+                  float time, float lifeTime, float k)
+{
+    if (graph.GetRelative())
+        time = time / lifeTime * 100.0f;
+    const auto minValue = SearchKeys(min, time);
+    const auto maxValue = SearchKeys(max, time);
+    return minValue + (maxValue - minValue) * k;
+}
+
+// Random keys, some of them at the same time as the previous one (jumps), the last one can be at MAX_GRAPH_TIME
+std::vector<GraphVertex> RandomKeys(std::mt19937 &gen, int32_t count, bool holdToEnd)
+{
+    std::uniform_real_distribution<float> value(-10.0f, 10.0f);
+    std::uniform_real_distribution<float> step(0.0f, 5.0f);
+    std::bernoulli_distribution jump(0.25);
+    std::vector<GraphVertex> keys(count);
+    auto time = 0.0f;
+    for (auto &key : keys)
+    {
+        key.Time = time;
+        key.Val = value(gen);
+        if (!jump(gen))
+            time += step(gen);
+    }
+    if (holdToEnd)
+        keys.back().Time = kMaxGraphTime;
+    return keys;
+}
+
+} // namespace
+
+TEST_CASE("Baked graph reads the same values as the key search", "[particles]")
+{
+    std::mt19937 gen(17);
+    std::uniform_int_distribution<int32_t> keyCount(2, 12);
+    std::bernoulli_distribution coin(0.5);
+    std::uniform_real_distribution<float> k01(0.0f, 1.0f);
+
+    SECTION("Random graphs with jumps and MAX_GRAPH_TIME tails")
+    {
+        for (int32_t i = 0; i < 500; i++)
+        {
+            const auto holdToEnd = coin(gen);
+            const auto min = RandomKeys(gen, keyCount(gen), holdToEnd);
+            const auto max = RandomKeys(gen, keyCount(gen), holdToEnd);
+
+            DataGraph graph;
+            graph.SetRelative(coin(gen));
+            graph.SetValues(min.data(), min.size(), max.data(), max.size());
+
+            const auto lifeTime = graph.GetRelative() ? 100.0f : 1.0f;
+            const auto endTime = std::max(min[min.size() - 2].Time, max[max.size() - 2].Time);
+            // from before the first key to after the last one
+            std::uniform_real_distribution<float> anyTime(-2.0f, endTime * 1.5f + 2.0f);
+            for (int32_t n = 0; n < 200; n++)
+            {
+                const auto time = anyTime(gen);
+                const auto k = k01(gen);
+                REQUIRE(graph.GetValue(time, lifeTime, k) == SearchValue(graph, min, max, time, lifeTime, k));
+            }
+
+            // exactly at the keys, a jump reads the value before it
+            for (const auto &keys : {min, max})
+                for (const auto &key : keys)
+                {
+                    const auto k = k01(gen);
+                    REQUIRE(graph.GetValue(key.Time, lifeTime, k) ==
+                            SearchValue(graph, min, max, key.Time, lifeTime, k));
+                }
+        }
+    }
+
+    SECTION("Times far outside of the keys")
+    {
+        const auto min = RandomKeys(gen, 6, true);
+        const auto max = RandomKeys(gen, 6, false);
+        DataGraph graph;
+        graph.SetValues(min.data(), min.size(), max.data(), max.size());
+        for (const auto time : {-1000.0f, -0.5f, 1000.0f, kMaxGraphTime, kMaxGraphTime * 2.0f})
+        {
+            const auto k = k01(gen);
+            REQUIRE(graph.GetValue(time, 1.0f, k) == SearchValue(graph, min, max, time, 1.0f, k));
+        }
+    }
+
+    SECTION("Relative graph of a particle without lifetime")
+    {
+        const auto min = RandomKeys(gen, 5, true);
+        const auto max = RandomKeys(gen, 5, true);
+        DataGraph graph;
+        graph.SetRelative(true);
+        graph.SetValues(min.data(), min.size(), max.data(), max.size());
+
+        // 0 / 0 is NaN, no key is found for it and the value is 0
+        const auto value = graph.GetValue(0.0f, 0.0f, 0.5f);
+        REQUIRE(value == SearchValue(graph, min, max, 0.0f, 0.0f, 0.5f));
+        REQUIRE(value == 0.0f);
+    }
+}
@@ -0,0 +1,7 @@
+#define CATCH_CONFIG_MAIN
+
+#ifdef _WIN32
+#define CATCH_CONFIG_WINDOWS_CRTDBG
+#endif
+
+#include <catch2/catch.hpp>
@@ -0,0 +1,181 @@
+#include "../src/i_common/mem_file.h"
+#include "../src/i_common/names.h"
+#include "../src/system/data_source/data_source.h"
+#include "../src/system/particle_processor/bb_particles.h"
+#include "../src/system/particle_processor/mdl_particles.h"
+#include "data_graph.h"
+#include "stopwatch.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+// The particle types of one emitter of a system, emitted the way BaseEmitter::BornParticles does
+struct BenchEmitter
+{
+    struct TypeDesc
+    {
+        ParticleType Type;
+        FieldList *pFields;
+        DataGraph *EmissionRate;
+        uint32_t MaxCount;
+        uint32_t ActiveCount;
+        float Remain;
+    };
+
+    std::vector<TypeDesc> Types;
+    Matrix matWorld;
+    DataGraph *DirX;
+    DataGraph *DirY;
+    DataGraph *DirZ;
+    float LifeTime;
+    float ElapsedTime;
+    uint32_t GUID;
+};
+
+// Load a system with DataSource, the same loader DataCache uses
+DataSource *LoadSystem(const std::filesystem::path &path)
+{
+    std::ifstream file(path, std::ios::binary);
+    std::vector<char> buffer(std::istreambuf_iterator<char>(file), {});
+
+    auto *pSource = new DataSource(nullptr);
+    MemFile memFile;
+    memFile.OpenRead(buffer.data(), buffer.size());
+    pSource->Load(&memFile);
+    memFile.Close();
+    return pSource;
+}
+
+void Emit(BenchEmitter &emitter, BillBoardParticles &billboards, ModelParticles &models, float DeltaTime)
+{
+    for (auto &type : emitter.Types)
+    {
+        type.Remain += type.EmissionRate->GetRandomValue(emitter.ElapsedTime, emitter.LifeTime) * DeltaTime;
+        while (type.Remain >= 1.0f)
+        {
+            type.Remain -= 1.0f;
+            if (type.ActiveCount >= type.MaxCount)
+                continue;
+
+            Vector DirAngles;
+            DirAngles.x = emitter.DirX->GetRandomValue(emitter.ElapsedTime, emitter.LifeTime);
+            DirAngles.y = emitter.DirY->GetRandomValue(emitter.ElapsedTime, emitter.LifeTime);
+            DirAngles.z = emitter.DirZ->GetRandomValue(emitter.ElapsedTime, emitter.LifeTime);
+            const auto VelDir = Matrix(DirAngles * MUL_DEGTORAD, Vector(0.0f)).v.vy;
+
+            type.ActiveCount++;
+            if (type.Type == BILLBOARD_PARTICLE)
+                billboards.AddParticle(nullptr, VelDir, Vector(0.0f), emitter.matWorld, emitter.ElapsedTime,
+                                       emitter.LifeTime, type.pFields, &type.ActiveCount, emitter.GUID);
+            else
+                models.AddParticle(nullptr, VelDir, Vector(0.0f), emitter.matWorld, emitter.ElapsedTime,
+                                   emitter.LifeTime, type.pFields, &type.ActiveCount, emitter.GUID, nullptr);
+        }
+    }
+
+    // systems that ran out are started again, as the game keeps creating new shots and splashes
+    emitter.ElapsedTime += DeltaTime;
+    if (emitter.ElapsedTime > emitter.LifeTime)
+        emitter.ElapsedTime -= emitter.LifeTime;
+}
+
+} // namespace
+
+// STORM_PARTICLES_DIR may point to the game resource/particles, otherwise the editor's shipped systems are used.
+// STORM_PARTICLES_SECONDS sets the simulated time, 20 seconds by default.
+TEST_CASE("Shipped particle systems at a fixed timestep", "[particles][.benchmark]")
+{
+    auto dir = std::filesystem::path(__FILE__).parent_path() / "../../../../tools/particles-editor/resource/particles";
+    if (const auto *env = std::getenv("STORM_PARTICLES_DIR"))
+        dir = env;
+    auto seconds = 20.0f;
+    if (const auto *env = std::getenv("STORM_PARTICLES_SECONDS"))
+        seconds = std::strtof(env, nullptr);
+    constexpr auto kDeltaTime = 1.0f / 60.0f;
+    const auto frames = static_cast<int32_t>(seconds / kDeltaTime);
+    // at least one step, the rates below are averaged per frame
+    REQUIRE(frames > 0);
+
+    std::vector<DataSource *> sources;
+    for (const auto &entry : std::filesystem::directory_iterator(dir))
+    {
+        if (entry.path().extension() == ".xps")
+            sources.push_back(LoadSystem(entry.path()));
+    }
+    REQUIRE(!sources.empty());
+
+    // a few instances of every system spread over the scene
+    constexpr int32_t kInstances = 4;
+    std::vector<BenchEmitter> emitters;
+    for (int32_t instance = 0; instance < kInstances; instance++)
+    {
+        for (auto *pSource : sources)
+        {
+            for (int32_t n = 0; n < pSource->GetEmitterCount(); n++)
+            {
+                auto *pDesc = pSource->GetEmitterDesc(n);
+                auto &emitter = emitters.emplace_back();
+                emitter.matWorld = Matrix(Vector(0.0f), Vector(emitters.size() * 3.0f, 0.0f, instance * 3.0f));
+                emitter.DirX = pDesc->Fields.FindGraph(EMISSION_DIR_X);
+                emitter.DirY = pDesc->Fields.FindGraph(EMISSION_DIR_Y);
+                emitter.DirZ = pDesc->Fields.FindGraph(EMISSION_DIR_Z);
+                emitter.LifeTime = pDesc->Fields.GetFloat(EMITTER_LIFETIME);
+                // instances start at different times of their emitters
+                emitter.ElapsedTime = emitter.LifeTime * instance / kInstances;
+                emitter.GUID = emitters.size() * GUIDSTEP;
+                for (auto &particle : pDesc->Particles)
+                {
+                    emitter.Types.push_back({particle.Type, &particle.Fields,
+                                             particle.Fields.FindGraph(PARTICLE_EMISSION_RATE),
+                                             static_cast<uint32_t>(particle.Fields.GetFloatAsInt(PARTICLE_MAX_COUNT)),
+                                             0, 0.0f});
+                }
+            }
+        }
+    }
+
+    BillBoardParticles billboards;
+    ModelParticles models;
+
+    uint64_t simulated = 0;
+    storm::Stopwatch emitTime, processTime;
+    for (int32_t frame = 0; frame < frames; frame++)
+    {
+        emitTime.measure([&] {
+            for (auto &emitter : emitters)
+                Emit(emitter, billboards, models, kDeltaTime);
+        });
+
+        processTime.measure([&] {
+            billboards.Process(kDeltaTime);
+            models.Process(kDeltaTime);
+        });
+        simulated += billboards.GetCount() + models.GetCount();
+    }
+
+    // every particle has a slot in the count of its type
+    uint64_t active = 0;
+    for (const auto &emitter : emitters)
+        for (const auto &type : emitter.Types)
+            active += type.ActiveCount;
+    REQUIRE(active == billboards.GetCount() + models.GetCount());
+
+    WARN(sources.size() << " systems x " << kInstances << ", " << frames << " frames, particles/frame: "
+                        << simulated / frames << ", particles/ms simulated: " << simulated / processTime.milliseconds()
+                        << ", emission ms/frame: " << emitTime.milliseconds(frames)
+                        << ", simulation ms/frame: " << processTime.milliseconds(frames));
+
+    billboards.Clear();
+    models.Clear();
+    for (auto *pSource : sources)
+        pSource->Release();
+}
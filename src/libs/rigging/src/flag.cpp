@@ -28,6 +28,7 @@ FLAG::FLAG()
 
 FLAG::~FLAG()
 {
+    fio->UnwatchFile(iniWatch);
     TEXTURE_RELEASE(RenderService, texl);
     STORM_DELETE(gdata);
     VERTEX_BUFFER_RELEASE(RenderService, vBuf);
@@ -45,6 +46,7 @@ bool FLAG::Init()
 {
     // GUARD(FLAG::FLAG())
     SetDevice();
+    iniWatch = fio->WatchFile(RIGGING_INI_FILE, [this] { bIniChanged = true; });
     // UNGUARD
     return true;
 }
@@ -92,13 +94,11 @@ void FLAG::Execute(uint32_t Delta_Time)
     {
         // ====================================================
         // If the ini-file has been changed, read the info from it
-        if (fio->_FileOrDirectoryExists(RIGGING_INI_FILE))
+        if (bIniChanged)
         {
-            auto ft_new = fio->_GetLastWriteTime(RIGGING_INI_FILE);
-            if (ft_old != ft_new)
-            {
+            bIniChanged = false;
+            if (fio->_FileOrDirectoryExists(RIGGING_INI_FILE))
                 LoadIni();
-            }
         }
 
         // get the wind value
@@ -573,10 +573,6 @@ void FLAG::LoadIni()
     char section[256];
     char param[256];
 
-    if (fio->_FileOrDirectoryExists(RIGGING_INI_FILE))
-    {
-        ft_old = fio->_GetLastWriteTime(RIGGING_INI_FILE);
-    }
     auto ini = fio->OpenIniFile("resource\\ini\\rigging.ini");
     if (!ini)
     {
@@ -60,7 +60,8 @@ class FLAG : public Entity
     };
 
     WIND globalWind;
-    std::filesystem::file_time_type ft_old;
+    uint32_t iniWatch = 0;
+    bool bIniChanged = false;
 
   public:
     FLAG();
@@ -95,6 +95,7 @@ SAIL::SAIL()
 
 SAIL::~SAIL()
 {
+    fio->UnwatchFile(iniWatch);
     if (slist != nullptr)
     {
         for (auto i = 0; i < sailQuantity; i++)
@@ -124,6 +125,7 @@ bool SAIL::Init()
     // GUARD(SAIL::SAIL())
 
     SetDevice();
+    iniWatch = fio->WatchFile(RIGGING_INI_FILE, [this] { bIniChanged = true; });
 
     // UNGUARD
     return true;
@@ -233,10 +235,10 @@ void SAIL::Execute(uint32_t Delta_Time)
         int i;
         // ====================================================
         // If the ini-file has been changed, read the info from it
-        if (fio->_FileOrDirectoryExists(RIGGING_INI_FILE))
+        if (bIniChanged)
         {
-            auto ft_new = fio->_GetLastWriteTime(RIGGING_INI_FILE);
-            if (ft_old != ft_new)
+            bIniChanged = false;
+            if (fio->_FileOrDirectoryExists(RIGGING_INI_FILE))
             {
                 const int wind_vector_quantity = sailConfig_.WINDVECTOR_QUANTITY;
                 int oldWindQnt = wind_vector_quantity;
@@ -1246,11 +1248,6 @@ void SAIL::SetAllSails()
 
 void SAIL::LoadSailIni()
 {
-    if (fio->_FileOrDirectoryExists(RIGGING_INI_FILE))
-    {
-        ft_old = fio->_GetLastWriteTime(RIGGING_INI_FILE);
-    }
-
     const auto opt_config = storm::LoadConfig(RIGGING_INI_FILE);
 
     if (!opt_config) {
@@ -35,7 +35,8 @@ class SAIL : public SAIL_BASE
     bool bUse;
     VDX9RENDER *RenderService;
     D3DMATERIAL9 mat;
-    std::filesystem::file_time_type ft_old;
+    uint32_t iniWatch = 0; // set bIniChanged when rigging.ini is edited
+    bool bIniChanged = false;
     int32_t texl;
     int32_t m_nEmptyGerbTex;
 
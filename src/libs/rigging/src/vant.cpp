@@ -28,6 +28,7 @@ VANT_BASE::VANT_BASE()
 
 VANT_BASE::~VANT_BASE()
 {
+    fio->UnwatchFile(iniWatch);
     TEXTURE_RELEASE(RenderService, texl);
     STORM_DELETE(TextureName);
     while (groupQuantity > 0)
@@ -51,6 +52,7 @@ bool VANT_BASE::Init()
 {
     // GUARD(VANT::VANT())
     SetDevice();
+    iniWatch = fio->WatchFile(RIGGING_INI_FILE, [this] { bIniChanged = true; });
     // UNGUARD
     return true;
 }
@@ -91,13 +93,11 @@ void VANT_BASE::Execute(uint32_t Delta_Time)
     {
         // ====================================================
         // If the ini-file has been changed, read the info from it
-        if (fio->_FileOrDirectoryExists(RIGGING_INI_FILE))
+        if (bIniChanged)
         {
-            auto ft_new = fio->_GetLastWriteTime(RIGGING_INI_FILE);
-            if (ft_old != ft_new)
-            {
+            bIniChanged = false;
+            if (fio->_FileOrDirectoryExists(RIGGING_INI_FILE))
                 LoadIni();
-            }
         }
 
         doMove();
@@ -625,10 +625,6 @@ void VANT::LoadIni()
     char section[256];
     char param[256];
 
-    if (fio->_FileOrDirectoryExists(RIGGING_INI_FILE))
-    {
-        ft_old = fio->_GetLastWriteTime(RIGGING_INI_FILE);
-    }
     auto ini = fio->OpenIniFile("resource\\ini\\rigging.ini");
     if (!ini)
     {
@@ -706,10 +702,6 @@ void VANTL::LoadIni()
     char section[256];
     char param[256];
 
-    if (fio->_FileOrDirectoryExists(RIGGING_INI_FILE))
-    {
-        ft_old = fio->_GetLastWriteTime(RIGGING_INI_FILE);
-    }
     auto ini = fio->OpenIniFile("resource\\ini\\rigging.ini");
     if (!ini)
     {
@@ -787,10 +779,6 @@ void VANTZ::LoadIni()
     char section[256];
     char param[256];
 
-    if (fio->_FileOrDirectoryExists(RIGGING_INI_FILE))
-    {
-        ft_old = fio->_GetLastWriteTime(RIGGING_INI_FILE);
-    }
     auto ini = fio->OpenIniFile("resource\\ini\\rigging.ini");
     if (!ini)
     {
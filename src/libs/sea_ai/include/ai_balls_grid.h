@@ -0,0 +1,129 @@
+#pragma once
+
+#include "c_vector.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Uniform XZ grid over bounding spheres of cannon trace targets, rebuilt every frame.
+// A ball moves a few meters per frame, so its segment touches one or two cells and only
+// the targets registered there are traced instead of every ship on the layer.
+class AIBallsGrid
+{
+  public:
+    // targets are identified by the order they were added in
+    void Reset()
+    {
+        aTargets.clear();
+        aUnbounded.clear();
+        aCells.clear();
+        fMaxRadius = 0.0f;
+    }
+
+    void AddTarget(const CVECTOR &vCenter, float fRadius)
+    {
+        const auto dwIndex = static_cast<uint32_t>(aTargets.size());
+        aTargets.push_back({vCenter, fRadius});
+        if (fRadius < 0.0f)
+            aUnbounded.push_back(dwIndex);
+        else
+            fMaxRadius = std::max(fMaxRadius, fRadius);
+    }
+
+    // target without known bounds, it is returned by every query
+    void AddUnbounded()
+    {
+        AddTarget(CVECTOR(0.0f, 0.0f, 0.0f), -1.0f);
+    }
+
+    void Build()
+    {
+        // cell fits the biggest target, so every sphere covers at most 2x2 cells
+        fCellSize = std::max(fMinCellSize, 2.0f * fMaxRadius);
+
+        aCells.clear();
+        for (uint32_t i = 0; i < aTargets.size(); i++)
+        {
+            const auto &target = aTargets[i];
+            if (target.fRadius < 0.0f)
+                continue;
+
+            const int32_t x1 = GetCell(target.vCenter.x - target.fRadius);
+            const int32_t x2 = GetCell(target.vCenter.x + target.fRadius);
+            const int32_t z1 = GetCell(target.vCenter.z - target.fRadius);
+            const int32_t z2 = GetCell(target.vCenter.z + target.fRadius);
+            for (auto z = z1; z <= z2; z++)
+                for (auto x = x1; x <= x2; x++)
+                    aCells.emplace_back(GetCellKey(x, z), i);
+        }
+        std::sort(aCells.begin(), aCells.end());
+    }
+
+    // fills indices of targets the segment src-dst may hit, in the order targets were added
+    void Query(const CVECTOR &vSrc, const CVECTOR &vDst, std::vector<uint32_t> &aResult) const
+    {
+        aResult.assign(aUnbounded.begin(), aUnbounded.end());
+
+        const int32_t x1 = GetCell(std::min(vSrc.x, vDst.x));
+        const int32_t x2 = GetCell(std::max(vSrc.x, vDst.x));
+        const int32_t z1 = GetCell(std::min(vSrc.z, vDst.z));
+        const int32_t z2 = GetCell(std::max(vSrc.z, vDst.z));
+        for (auto z = z1; z <= z2; z++)
+            for (auto x = x1; x <= x2; x++)
+            {
+                const auto key = GetCellKey(x, z);
+                auto it = std::lower_bound(aCells.begin(), aCells.end(), std::make_pair(key, uint32_t{0}));
+                for (; it != aCells.end() && it->first == key; ++it)
+                    if (SegmentTouchesTarget(vSrc, vDst, aTargets[it->second]))
+                        aResult.push_back(it->second);
+            }
+
+        // a target covering several cells is found once per cell
+        std::sort(aResult.begin(), aResult.end());
+        aResult.erase(std::unique(aResult.begin(), aResult.end()), aResult.end());
+    }
+
+    [[nodiscard]] uint32_t GetTargetsCount() const
+    {
+        return static_cast<uint32_t>(aTargets.size());
+    }
+
+  private:
+    struct target_t
+    {
+        CVECTOR vCenter;
+        float fRadius; // negative for targets without bounds
+    };
+
+    // segments of fast balls may cross many cells if the grid gets too fine
+    static constexpr float fMinCellSize = 32.0f;
+
+    std::vector<target_t> aTargets;
+    std::vector<uint32_t> aUnbounded;
+    std::vector<std::pair<uint64_t, uint32_t>> aCells; // (cell key, target index) sorted by key
+    float fMaxRadius{};
+    float fCellSize{fMinCellSize};
+
+    [[nodiscard]] int32_t GetCell(float fCoord) const
+    {
+        return static_cast<int32_t>(std::floor(fCoord / fCellSize));
+    }
+
+    static uint64_t GetCellKey(int32_t x, int32_t z)
+    {
+        return static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32 | static_cast<uint32_t>(z);
+    }
+
+    static bool SegmentTouchesTarget(const CVECTOR &vSrc, const CVECTOR &vDst, const target_t &target)
+    {
+        const auto vDir = vDst - vSrc;
+        const auto fLen2 = vDir | vDir;
+        auto fT = fLen2 > 0.0f ? ((target.vCenter - vSrc) | vDir) / fLen2 : 0.0f;
+        fT = std::clamp(fT, 0.0f, 1.0f);
+        const auto vDelta = vSrc + vDir * fT - target.vCenter;
+        return (vDelta | vDelta) <= target.fRadius * target.fRadius;
+    }
+};
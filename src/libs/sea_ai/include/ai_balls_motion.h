@@ -0,0 +1,120 @@
+#pragma once
+
+#include "c_vector.h"
+#include "math_inlines.h"
+
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class CSaveLoad;
+class VPARTICLE_SYSTEM;
+
+struct BALL_PARAMS
+{
+    void Save(CSaveLoad *pSL);
+    void Load(CSaveLoad *pSL);
+
+    CVECTOR vFirstPos, vPos; // first and current ball position
+    VPARTICLE_SYSTEM *pParticle;
+    std::string sBallEvent;
+    int32_t iBallOwner;    // ball owner(character index)
+    float fTime;        // ball time: in seconds
+    float fSpeedV0;     // initial speed: in m/s
+    float fDirX, fDirZ; // X/Z identity moving(cos(dir),sin(dir))
+
+    float fSinAngle; // initial angle: sin(a)
+    float fCosAngle; // initial angle: cos(a)
+
+    float fHeightMultiply;    // Height position multiply
+    float fSizeMultiply;      // Size of ball multiply
+    float fTimeSpeedMultiply; // Time speed multiply
+    float fMaxFireDistance;
+    float fRawAng;
+    uint32_t dwCannonType; // Additional parameter
+};
+
+// ============================================================================
+// Trajectories of all balls of one type as structure of arrays, index matches BALL_TYPE::Balls
+// Ball position is first_pos + velocity * t + acceleration * t^2, so the whole
+// type is integrated in one loop the compiler vectorizes
+// ============================================================================
+struct BALLS_MOTION
+{
+    std::vector<float> fTime, fTimeSpeed;
+    std::vector<float> fX0, fY0, fZ0; // first position
+    std::vector<float> fVX, fVY, fVZ; // t coefficient
+    std::vector<float> fAX, fAY, fAZ; // t^2 coefficient
+    std::vector<float> fX, fY, fZ;    // current position
+
+    void Add(const BALL_PARAMS &ball, float fGravity)
+    {
+        // local trajectory (fsX, fsY) goes through the raw angle height scaling and the direction turn,
+        // both linear, so t and t^2 parts of the position are transformed separately once
+        const auto fCosRaw = cosf(ball.fRawAng);
+        const auto fSinRaw = sinf(ball.fRawAng);
+        auto Transform = [&](float fsX, float fsY) {
+            const auto fProjX = fsX * fCosRaw + fsY * fSinRaw;
+            const auto fProjY = (-fsX * fSinRaw + fsY * fCosRaw) * ball.fHeightMultiply;
+            const auto fX = fProjX * fCosRaw - fProjY * fSinRaw;
+            const auto fY = fProjX * fSinRaw + fProjY * fCosRaw;
+            auto v = CVECTOR(0.0f, fY, fX);
+            RotateAroundY(v.x, v.z, ball.fDirX, ball.fDirZ);
+            return v;
+        };
+        const auto vVelocity = Transform(ball.fSpeedV0 * ball.fCosAngle, ball.fSpeedV0 * ball.fSinAngle);
+        const auto vAcceleration = Transform(0.0f, -fGravity / 2.0f);
+
+        fTime.push_back(ball.fTime);
+        fTimeSpeed.push_back(ball.fTimeSpeedMultiply);
+        fX0.push_back(ball.vFirstPos.x);
+        fY0.push_back(ball.vFirstPos.y);
+        fZ0.push_back(ball.vFirstPos.z);
+        fVX.push_back(vVelocity.x);
+        fVY.push_back(vVelocity.y);
+        fVZ.push_back(vVelocity.z);
+        fAX.push_back(vAcceleration.x);
+        fAY.push_back(vAcceleration.y);
+        fAZ.push_back(vAcceleration.z);
+        fX.push_back(ball.vPos.x);
+        fY.push_back(ball.vPos.y);
+        fZ.push_back(ball.vPos.z);
+    }
+
+    // same swap with the last ball as for BALL_TYPE::Balls
+    void Remove(size_t idx)
+    {
+        for (auto *pArray :
+             {&fTime, &fTimeSpeed, &fX0, &fY0, &fZ0, &fVX, &fVY, &fVZ, &fAX, &fAY, &fAZ, &fX, &fY, &fZ})
+        {
+            (*pArray)[idx] = pArray->back();
+            pArray->pop_back();
+        }
+    }
+
+    void Clear()
+    {
+        for (auto *pArray :
+             {&fTime, &fTimeSpeed, &fX0, &fY0, &fZ0, &fVX, &fVY, &fVZ, &fAX, &fAY, &fAZ, &fX, &fY, &fZ})
+            pArray->clear();
+    }
+
+    void Integrate(float fDeltaTime)
+    {
+        const auto n = fTime.size();
+        auto *__restrict pTime = fTime.data();
+        const auto *__restrict pTimeSpeed = fTimeSpeed.data();
+        for (size_t i = 0; i < n; i++)
+            pTime[i] += fDeltaTime * pTimeSpeed[i];
+
+        auto Axis = [n, pTime](float *__restrict pRes, const float *__restrict p0, const float *__restrict pV,
+                               const float *__restrict pA) {
+            for (size_t i = 0; i < n; i++)
+                pRes[i] = p0[i] + (pV[i] + pA[i] * pTime[i]) * pTime[i];
+        };
+        Axis(fX.data(), fX0.data(), fVX.data(), fAX.data());
+        Axis(fY.data(), fY0.data(), fVY.data(), fAY.data());
+        Axis(fZ.data(), fZ0.data(), fVZ.data(), fAZ.data());
+    }
+};
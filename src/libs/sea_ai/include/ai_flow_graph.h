@@ -7,7 +7,10 @@
 #include "math_inlines.h"
 
 #include <algorithm>
+#include <functional>
+#include <queue>
 #include <string>
+#include <utility>
 #include <vector>
 
 #define INVALID_ARRAY_INDEX 0xFFFFFFFF
@@ -77,26 +80,34 @@ class AIFlowGraph
     std::vector<point_t> aPoints;
     std::string sSectionName;
 
-    struct table_t
+    // outgoing links of every point in one array, links of point i are [aLinkStart[i], aLinkStart[i + 1])
+    struct link_t
     {
-        uint32_t p;
-        float d;
+        uint32_t dwPnt;
+        float fLen;
     };
 
-    table_t *pTable;
+    std::vector<uint32_t> aLinkStart;
+    std::vector<link_t> aLinks;
+
+    // shortest path lengths from a source point, a row is built by Dijkstra on the first query from its source
+    std::vector<std::vector<float>> aPathRows;
+
+    // uniform XZ grid over points for nearest queries, points of cell c are [aCellStart[c], aCellStart[c + 1])
+    std::vector<uint32_t> aCellStart;
+    std::vector<uint32_t> aCellPoints;
+    float fGridX, fGridZ, fCellSize;
+    int32_t iGridWidth, iGridHeight;
+
+    static constexpr float fNoPath = 1e8f;
 
   public:
     AIFlowGraph()
+        : fGridX(0.0f), fGridZ(0.0f), fCellSize(1.0f), iGridWidth(0), iGridHeight(0)
     {
-        pTable = nullptr;
         sSectionName = "GraphPoints";
     }
 
-    ~AIFlowGraph()
-    {
-        STORM_DELETE(pTable);
-    }
-
     // save/load/release section
     void ReleaseAll();
     bool Load(INIFILE &pIni);
@@ -106,7 +117,12 @@ class AIFlowGraph
         return aEdges.size();
     }
 
-    CVECTOR GetPointPos(size_t dwPnt)
+    size_t GetNumPoints() const
+    {
+        return aPoints.size();
+    }
+
+    CVECTOR GetPointPos(size_t dwPnt) const
     {
         Assert(dwPnt < aPoints.size());
         return aPoints[dwPnt].vPos;
@@ -114,21 +130,41 @@ class AIFlowGraph
 
     edge_t *GetEdge(size_t dwEdgeIdx);
     float GetPathDistance(size_t dwP1, size_t dwP2);
-    float GetDistance(size_t dwP1, size_t dwP2);
-    size_t GetOtherEdgePoint(size_t dwEdgeIdx, size_t dwPnt);
-    std::vector<npoint_t> *GetNearestPoints(CVECTOR &vP);
+    float GetDistance(size_t dwP1, size_t dwP2) const;
+    size_t GetOtherEdgePoint(size_t dwEdgeIdx, size_t dwPnt) const;
+    // fills aResult with up to dwCount points nearest to vP, sorted by distance
+    void GetNearestPoints(const CVECTOR &vP, size_t dwCount, std::vector<npoint_t> &aResult) const;
 
     decltype(aEdges)::difference_type AddEdge(size_t dwEdgePnt1, size_t dwEdgePnt2);
 
+    // prepares links and nearest points grid, must be called after the graph is changed
     void BuildTable();
 
   private:
+    const std::vector<float> &GetPathRow(size_t dwSrc);
+    void BuildGrid();
+
+    int32_t GetCellX(float fX) const
+    {
+        return std::clamp(static_cast<int32_t>(std::floor((fX - fGridX) / fCellSize)), 0, iGridWidth - 1);
+    }
+
+    int32_t GetCellZ(float fZ) const
+    {
+        return std::clamp(static_cast<int32_t>(std::floor((fZ - fGridZ) / fCellSize)), 0, iGridHeight - 1);
+    }
 };
 
 inline void AIFlowGraph::ReleaseAll()
 {
     aEdges.clear();
     aPoints.clear();
+    aLinkStart.clear();
+    aLinks.clear();
+    aPathRows.clear();
+    aCellStart.clear();
+    aCellPoints.clear();
+    iGridWidth = iGridHeight = 0;
 }
 
 inline bool AIFlowGraph::Load(INIFILE &pIni)
@@ -199,7 +235,7 @@ inline AIFlowGraph::edge_t *AIFlowGraph::GetEdge(size_t dwEdgeIdx)
     return &aEdges[dwEdgeIdx];
 }
 
-inline size_t AIFlowGraph::GetOtherEdgePoint(size_t dwEdgeIdx, size_t dwPnt)
+inline size_t AIFlowGraph::GetOtherEdgePoint(size_t dwEdgeIdx, size_t dwPnt) const
 {
     Assert(dwEdgeIdx < aEdges.size());
     if (aEdges[dwEdgeIdx].dw1 == dwPnt)
@@ -209,58 +245,100 @@ inline size_t AIFlowGraph::GetOtherEdgePoint(size_t dwEdgeIdx, size_t dwPnt)
 
 inline void AIFlowGraph::BuildTable()
 {
-    uint32_t i, j, k, x, y;
     const auto dwNumPoints = aPoints.size();
 
-    STORM_DELETE(pTable);
-    pTable = new table_t[SQR(dwNumPoints)];
-    for (i = 0; i < SQR(dwNumPoints); i++)
+    aLinkStart.assign(dwNumPoints + 1, 0);
+    aLinks.clear();
+    for (size_t i = 0; i < dwNumPoints; i++)
     {
-        pTable[i].p = INVALID_ARRAY_INDEX;
-        pTable[i].d = 1e8f;
+        aLinkStart[i] = static_cast<uint32_t>(aLinks.size());
+        for (const auto dwEdge : aPoints[i].aEdges)
+            aLinks.push_back({static_cast<uint32_t>(GetOtherEdgePoint(dwEdge, i)), aEdges[dwEdge].fLen});
     }
-    for (i = 0; i < dwNumPoints; i++)
+    aLinkStart[dwNumPoints] = static_cast<uint32_t>(aLinks.size());
+
+    aPathRows.clear();
+    aPathRows.resize(dwNumPoints);
+
+    BuildGrid();
+}
+
+inline const std::vector<float> &AIFlowGraph::GetPathRow(size_t dwSrc)
+{
+    Assert(aPathRows.size() == aPoints.size());
+
+    auto &aRow = aPathRows[dwSrc];
+    if (!aRow.empty())
+        return aRow;
+
+    using queued_t = std::pair<float, uint32_t>;
+    std::priority_queue<queued_t, std::vector<queued_t>, std::greater<>> aQueue;
+
+    aRow.assign(aPoints.size(), fNoPath);
+    aRow[dwSrc] = 0.0f;
+    aQueue.emplace(0.0f, static_cast<uint32_t>(dwSrc));
+    while (!aQueue.empty())
     {
-        point_t *pP = &aPoints[i];
-        table_t *pTableRow = &pTable[i * dwNumPoints];
-        for (j = 0; j < pP->aEdges.size(); j++)
+        const auto [fDist, dwPnt] = aQueue.top();
+        aQueue.pop();
+        if (fDist > aRow[dwPnt])
+            continue;
+
+        for (auto i = aLinkStart[dwPnt]; i < aLinkStart[dwPnt + 1]; i++)
         {
-            const uint32_t dwPnt = GetOtherEdgePoint(pP->aEdges[j], i);
-            pTableRow[dwPnt].p = dwPnt;
-            pTableRow[dwPnt].d = aEdges[pP->aEdges[j]].fLen;
+            const auto &link = aLinks[i];
+            const float fNewDist = fDist + link.fLen;
+            if (fNewDist < aRow[link.dwPnt])
+            {
+                aRow[link.dwPnt] = fNewDist;
+                aQueue.emplace(fNewDist, link.dwPnt);
+            }
         }
     }
-    for (k = 0; k < dwNumPoints; k++)
+
+    return aRow;
+}
+
+inline void AIFlowGraph::BuildGrid()
+{
+    aCellStart.clear();
+    aCellPoints.clear();
+    iGridWidth = iGridHeight = 0;
+    if (aPoints.empty())
+        return;
+
+    float fMinX = aPoints[0].vPos.x, fMaxX = fMinX;
+    float fMinZ = aPoints[0].vPos.z, fMaxZ = fMinZ;
+    for (const auto &point : aPoints)
     {
-        bool bF = true;
-        for (y = 0; y < dwNumPoints; y++)
-        {
-            for (x = 0; x < dwNumPoints; x++)
-                if (x != y)
-                {
-                    point_t *pP = &aPoints[y];
-                    float d = pTable[x + y * dwNumPoints].d;
-                    for (j = 0; j < pP->aEdges.size(); j++)
-                    {
-                        const uint32_t dwPnt = GetOtherEdgePoint(pP->aEdges[j], y);
-                        const float d1 = pTable[dwPnt + y * dwNumPoints].d;
-                        const float d2 = pTable[x + dwPnt * dwNumPoints].d;
-                        if (d1 + d2 < d && fabsf((d1 + d2) - d) > 0.01f)
-                        {
-                            d = d1 + d2;
-                            pTable[x + y * dwNumPoints].d = d;
-                            pTable[x + y * dwNumPoints].p = dwPnt;
-                            bF = false;
-                        }
-                    }
-                }
-        }
-        if (bF)
-            break;
+        fMinX = std::min(fMinX, point.vPos.x);
+        fMaxX = std::max(fMaxX, point.vPos.x);
+        fMinZ = std::min(fMinZ, point.vPos.z);
+        fMaxZ = std::max(fMaxZ, point.vPos.z);
     }
+
+    // about two points per cell for evenly spread points
+    const float fArea = std::max(fMaxX - fMinX, 1.0f) * std::max(fMaxZ - fMinZ, 1.0f);
+    fCellSize = std::max(sqrtf(2.0f * fArea / static_cast<float>(aPoints.size())), 1.0f);
+    fGridX = fMinX;
+    fGridZ = fMinZ;
+    iGridWidth = static_cast<int32_t>((fMaxX - fMinX) / fCellSize) + 1;
+    iGridHeight = static_cast<int32_t>((fMaxZ - fMinZ) / fCellSize) + 1;
+
+    // counting sort of points by cell
+    aCellStart.assign(static_cast<size_t>(iGridWidth) * iGridHeight + 1, 0);
+    for (const auto &point : aPoints)
+        aCellStart[GetCellX(point.vPos.x) + GetCellZ(point.vPos.z) * iGridWidth + 1]++;
+    for (size_t i = 1; i < aCellStart.size(); i++)
+        aCellStart[i] += aCellStart[i - 1];
+
+    auto aFill = aCellStart;
+    aCellPoints.resize(aPoints.size());
+    for (uint32_t i = 0; i < aPoints.size(); i++)
+        aCellPoints[aFill[GetCellX(aPoints[i].vPos.x) + GetCellZ(aPoints[i].vPos.z) * iGridWidth]++] = i;
 }
 
-inline float AIFlowGraph::GetDistance(size_t dwP1, size_t dwP2)
+inline float AIFlowGraph::GetDistance(size_t dwP1, size_t dwP2) const
 {
     return sqrtf(~(GetPointPos(dwP2) - GetPointPos(dwP1)));
 }
@@ -270,33 +348,61 @@ inline float AIFlowGraph::GetPathDistance(size_t dwP1, size_t dwP2)
     Assert(dwP1 < aPoints.size() && dwP2 < aPoints.size());
     if (dwP1 == dwP2)
         return 0.0f;
-    const auto dwNumPoints = aPoints.size();
-
-    float fDistance = 0.0f;
-    uint32_t dwPnt = pTable[dwP2 + dwP1 * dwNumPoints].p;
-    while (dwPnt != INVALID_ARRAY_INDEX)
-    {
-        fDistance += GetDistance(dwP1, dwPnt);
-        dwP1 = dwPnt;
-        dwPnt = pTable[dwP2 + dwPnt * dwNumPoints].p;
-    }
 
-    return fDistance;
+    const float fDistance = GetPathRow(dwP1)[dwP2];
+    // unreachable points always had zero path distance
+    return (fDistance < fNoPath) ? fDistance : 0.0f;
 }
 
-inline std::vector<AIFlowGraph::npoint_t> *AIFlowGraph::GetNearestPoints(CVECTOR &vP)
+inline void AIFlowGraph::GetNearestPoints(const CVECTOR &vP, size_t dwCount, std::vector<npoint_t> &aResult) const
 {
-    auto aNearestPoints = new std::vector<npoint_t>(aPoints.size());
-    for (uint32_t i = 0; i < aPoints.size(); i++)
+    aResult.clear();
+    dwCount = std::min(dwCount, aPoints.size());
+    if (dwCount == 0)
+        return;
+
+    const auto AddCell = [&](int32_t x, int32_t z) {
+        if (x < 0 || x >= iGridWidth || z < 0 || z >= iGridHeight)
+            return;
+        const auto dwCell = x + z * iGridWidth;
+        for (auto i = aCellStart[dwCell]; i < aCellStart[dwCell + 1]; i++)
+        {
+            const auto dwPnt = aCellPoints[i];
+            aResult.push_back({dwPnt, sqrtf(~(vP - aPoints[dwPnt].vPos)), 0.0f});
+        }
+    };
+
+    // walk square rings of cells around vP; cells of ring r + 1 and further are at least r cells away,
+    // so the search stops once the dwCount-th nearest point is closer than that
+    const int32_t cx = GetCellX(vP.x);
+    const int32_t cz = GetCellZ(vP.z);
+    const int32_t iMaxRing = std::max({cx, iGridWidth - 1 - cx, cz, iGridHeight - 1 - cz});
+    for (int32_t r = 0; r <= iMaxRing; r++)
     {
-        // npoint_t * pN = &(*aNearestPoints)[(*aNearestPoints).Add()];
-        // pN->fDistance = sqrtf(~(vP - aPoints[i].vPos));
-        // pN->dwPnt = i;
-        (*aNearestPoints)[i].fDistance = sqrtf(~(vP - aPoints[i].vPos));
-        (*aNearestPoints)[i].dwPnt = i;
+        if (r == 0)
+            AddCell(cx, cz);
+        else
+        {
+            for (int32_t x = cx - r; x <= cx + r; x++)
+            {
+                AddCell(x, cz - r);
+                AddCell(x, cz + r);
+            }
+            for (int32_t z = cz - r + 1; z < cz + r; z++)
+            {
+                AddCell(cx - r, z);
+                AddCell(cx + r, z);
+            }
+        }
+
+        if (aResult.size() >= dwCount)
+        {
+            std::nth_element(aResult.begin(), aResult.begin() + (dwCount - 1), aResult.end());
+            if (aResult[dwCount - 1].fDistance <= static_cast<float>(r) * fCellSize)
+                break;
+        }
     }
-    //(*aNearestPoints).Sort();
-    std::sort(aNearestPoints->begin(), aNearestPoints->end());
 
-    return aNearestPoints;
+    std::partial_sort(aResult.begin(), aResult.begin() + dwCount, aResult.end());
+    aResult.resize(dwCount);
 }
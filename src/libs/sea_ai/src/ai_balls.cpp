@@ -35,6 +35,7 @@ AIBalls::~AIBalls()
             pBall->sBallEvent.clear();
         }
         aBallTypes[i].Balls.clear();
+        aBallTypes[i].Motion.Clear();
     }
     aBallTypes.clear();
 }
@@ -144,6 +145,7 @@ void AIBalls::AddBall(ATTRIBUTES *pABall)
     pBall->fDirZ = sinf(fDir);
     pBall->fRawAng = pABall->GetAttributeAsFloat("RawAng");
     pBall->pParticle = nullptr;
+    aBallTypes[i].Motion.Add(*pBall, AIHelper::fGravity);
 
     pBall->sBallEvent = to_string(pABall->GetAttribute("Event"));
 
@@ -159,6 +161,30 @@ void AIBalls::AddBall(ATTRIBUTES *pABall)
     }
 }
 
+void AIBalls::BuildTraceShipsGrid()
+{
+    aTraceShips.clear();
+    TraceShipsGrid.Reset();
+
+    auto &&entities = core.GetEntityIds(SHIP_CANNON_TRACE);
+    for (auto ent_id : entities)
+    {
+        auto *pShip = static_cast<CANNON_TRACE_BASE *>(core.GetEntityPointer(ent_id));
+        if (!pShip)
+            continue;
+
+        CVECTOR vCenter;
+        float fRadius;
+        aTraceShips.push_back(ent_id);
+        if (pShip->GetCannonTraceBounds(vCenter, fRadius))
+            TraceShipsGrid.AddTarget(vCenter, fRadius);
+        else
+            TraceShipsGrid.AddUnbounded();
+    }
+
+    TraceShipsGrid.Build();
+}
+
 void AIBalls::Execute(uint32_t Delta_Time)
 {
     uint32_t i, j;
@@ -180,11 +206,14 @@ void AIBalls::Execute(uint32_t Delta_Time)
 
     auto fDeltaTime = 0.001f * static_cast<float>(Delta_Time);
 
+    BuildTraceShipsGrid();
+
     for (i = 0; i < aBallTypes.size(); i++)
     {
         auto *pBallsType = &aBallTypes[i];
+        auto &motion = pBallsType->Motion;
 
-        AttributesPointer->SetAttributeUseDword("CurrentBallType", pBallsType->dwGoodIndex);
+        motion.Integrate(fDeltaTime * fDeltaTimeMultiplier);
 
         for (j = 0; j < pBallsType->Balls.size(); j++)
         {
@@ -192,37 +221,28 @@ void AIBalls::Execute(uint32_t Delta_Time)
 
             vSrc = pBall->vPos;
 
-            AttributesPointer->SetAttributeUseDword("CurrentBallCannonType", pBall->dwCannonType);
-            AttributesPointer->SetAttributeUseFloat("CurrentBallDistance", sqrtf(~(pBall->vPos - pBall->vFirstPos)));
-            AttributesPointer->SetAttributeUseFloat("CurrentMaxBallDistance", pBall->fMaxFireDistance);
-
-            // update ball time
-            pBall->fTime += fDeltaTime * fDeltaTimeMultiplier * pBall->fTimeSpeedMultiply;
-            // update positions
-            float fsX = pBall->fSpeedV0 * pBall->fTime * pBall->fCosAngle;
-            float fsY =
-                (pBall->fSpeedV0 * pBall->fTime * pBall->fSinAngle - AIHelper::fGravity * SQR(pBall->fTime) / 2.0f);
-
-            // HeightMultiply
-            float fCosRaw = cosf(pBall->fRawAng);
-            float fSinRaw = sinf(pBall->fRawAng);
-            float fProjX = fsX * fCosRaw + fsY * fSinRaw;
-            float fProjY = -fsX * fSinRaw + fsY * fCosRaw;
-            fProjY *= pBall->fHeightMultiply;
-            float fX = fProjX * fCosRaw - fProjY * fSinRaw;
-            float fY = fProjX * fSinRaw + fProjY * fCosRaw;
-
-            pBall->vPos = CVECTOR(0.0f, fY, fX);
-            RotateAroundY(pBall->vPos.x, pBall->vPos.z, pBall->fDirX, pBall->fDirZ);
-
-            pBall->vPos += pBall->vFirstPos;
+            pBall->fTime = motion.fTime[j];
+            pBall->vPos = CVECTOR(motion.fX[j], motion.fY[j], motion.fZ[j]);
 
             vDst = pBall->vPos;
 
+            // ball attributes are written only before something that may run script code
+            auto bContextPublished = false;
+            auto PublishContext = [&] {
+                // distance at the start of the step, as scripts always got it
+                if (!bContextPublished)
+                    PublishBallContext(pBallsType->dwGoodIndex, pBall->dwCannonType,
+                                       sqrtf(~(vSrc - pBall->vFirstPos)), pBall->fMaxFireDistance);
+                bContextPublished = true;
+            };
+
             if (!pBall->sBallEvent.empty())
-                core.Event(pBall->sBallEvent.c_str(), "lllffffffs", pBall->iBallOwner, static_cast<uint32_t>(1),
+            {
+                PublishContext();
+                core.Event(pBall->sBallEvent.c_str(), "lllffffff", pBall->iBallOwner, static_cast<uint32_t>(1),
                            pBallsType->dwGoodIndex, pBall->vPos.x, pBall->vPos.y, pBall->vPos.z, vSrc.x, vSrc.y,
                            vSrc.z);
+            }
 
             if (pBall->pParticle)
             {
@@ -246,18 +266,26 @@ void AIBalls::Execute(uint32_t Delta_Time)
                     CVECTOR vRes, v = fBallFlySoundStereoMultiplier * CVECTOR(x, y, 0.0f);
                     mView.MulToInv(v, vRes);
 
+                    PublishContext();
                     core.Event(BALL_FLY_NEAR_CAMERA, "fff", vRes.x, vRes.y, vRes.z);
                 }
             }
 
-            // sail trace
-            if (pSail)
+            // sail trace, balls fly through sails, the plain trace only tells if the hit event will fire
+            if (pSail && pSail->Trace(vSrc, vDst) <= 1.0f)
+            {
+                PublishContext();
                 pSail->Cannon_Trace(pBall->iBallOwner, vSrc, vDst);
+            }
 
-            auto &&entities = core.GetEntityIds(SHIP_CANNON_TRACE);
-            for (auto ent_id : entities)
+            // only ships whose bounds the ball passes through this frame
+            TraceShipsGrid.Query(vSrc, vDst, aTraceCandidates);
+            if (!aTraceCandidates.empty())
+                PublishContext();
+            for (const auto dwShip : aTraceCandidates)
             {
-                if (auto *pShip = static_cast<CANNON_TRACE_BASE *>(core.GetEntityPointer(ent_id)))
+                // ball events may delete ships, so pointers are resolved on use
+                if (auto *pShip = static_cast<CANNON_TRACE_BASE *>(core.GetEntityPointer(aTraceShips[dwShip])))
                 {
                     fRes = pShip->Cannon_Trace(pBall->iBallOwner, vSrc, vDst);
                     if (fRes <= 1.0f)
@@ -268,16 +296,23 @@ void AIBalls::Execute(uint32_t Delta_Time)
             // fort trace
             if (fRes > 1.0f && AIFort::pAIFort)
             {
+                PublishContext();
                 fRes = AIFort::pAIFort->Cannon_Trace(pBall->iBallOwner, vSrc, vDst);
             }
 
-            // island trace
-            if (fRes > 1.0f && pIsland)
+            // island and sea cannon traces only add a hit event to the plain trace,
+            // so the plain one decides if the context is needed
+            if (fRes > 1.0f && pIsland && (fRes = pIsland->Trace(vSrc, vDst)) <= 1.0f)
+            {
+                PublishContext();
                 fRes = pIsland->Cannon_Trace(pBall->iBallOwner, vSrc, vDst);
+            }
 
-            // sea trace
-            if (fRes > 1.0f && pSea)
+            if (fRes > 1.0f && pSea && (fRes = pSea->Trace(vSrc, vDst)) <= 1.0f)
+            {
+                PublishContext();
                 fRes = pSea->Cannon_Trace(pBall->iBallOwner, vSrc, vDst);
+            }
 
             // delete ball
             if (fRes <= 1.0f)
@@ -298,6 +333,7 @@ void AIBalls::Execute(uint32_t Delta_Time)
                 // pBallsType->Balls.ExtractNoShift(j);
                 pBallsType->Balls[j] = pBallsType->Balls.back();
                 pBallsType->Balls.pop_back();
+                motion.Remove(j);
                 j--;
 
                 continue;
@@ -318,6 +354,15 @@ void AIBalls::Execute(uint32_t Delta_Time)
     }
 }
 
+void AIBalls::PublishBallContext(uint32_t dwType, uint32_t dwCannonType, float fDistance, float fMaxDistance)
+{
+    // always written, scripts may have changed or recreated the attributes since the last ball
+    pathCurrentBallType_.Create(AttributesPointer)->SetAttributeUseDword(nullptr, dwType);
+    pathCurrentBallCannonType_.Create(AttributesPointer)->SetAttributeUseDword(nullptr, dwCannonType);
+    pathCurrentBallDistance_.Create(AttributesPointer)->SetAttributeUseFloat(nullptr, fDistance);
+    pathCurrentMaxBallDistance_.Create(AttributesPointer)->SetAttributeUseFloat(nullptr, fMaxDistance);
+}
+
 void AIBalls::Realize(uint32_t Delta_Time)
 {
     if (aBallRects.size())
@@ -362,6 +407,7 @@ uint32_t AIBalls::AttributeChanged(ATTRIBUTES *pAttributeChanged)
             }
 
             pBallsType->Balls.clear();
+            pBallsType->Motion.Clear();
         }
 
         return 0;
@@ -505,6 +551,7 @@ void AIBalls::Load(CSaveLoad *pSL)
             // BALL_PARAMS * pB = &aBallTypes[i].Balls[aBallTypes[i].Balls.Add()];
             BALL_PARAMS &pB = aBallType.Balls[balls_size + j];
             pB.Load(pSL);
+            aBallType.Motion.Add(pB, AIHelper::fGravity);
             if (pB.pParticle)
             {
                 pB.pParticle = nullptr;
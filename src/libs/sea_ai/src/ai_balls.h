@@ -1,33 +1,11 @@
 #pragma once
 
+#include "ai_balls_grid.h"
+#include "ai_balls_motion.h"
 #include "ai_helper.h"
 #include "cannon_trace.h"
 #include <v_particle_system.h>
 
-struct BALL_PARAMS
-{
-    void Save(CSaveLoad *pSL);
-    void Load(CSaveLoad *pSL);
-
-    CVECTOR vFirstPos, vPos; // first and current ball position
-    VPARTICLE_SYSTEM *pParticle;
-    std::string sBallEvent;
-    int32_t iBallOwner;    // ball owner(character index)
-    float fTime;        // ball time: in seconds
-    float fSpeedV0;     // initial speed: in m/s
-    float fDirX, fDirZ; // X/Z identity moving(cos(dir),sin(dir))
-
-    float fSinAngle; // initial angle: sin(a)
-    float fCosAngle; // initial angle: cos(a)
-
-    float fHeightMultiply;    // Height position multiply
-    float fSizeMultiply;      // Size of ball multiply
-    float fTimeSpeedMultiply; // Time speed multiply
-    float fMaxFireDistance;
-    float fRawAng;
-    uint32_t dwCannonType; // Additional parameter
-};
-
 // ============================================================================
 // One ball type, contain common parameters
 // ============================================================================
@@ -40,6 +18,7 @@ struct BALL_TYPE
     float fSize;                    // ball size(sprite size in meters)
     float fWeight;                  // ball weight
     std::vector<BALL_PARAMS> Balls; // container with current balls
+    BALLS_MOTION Motion;            // trajectories of Balls
 
     // constructor for initialization
     // BALL_TYPE() : Balls(_FL_, 64) {};
@@ -66,6 +45,22 @@ class AIBalls : public Entity
     std::vector<BALL_TYPE> aBallTypes; // Balls types container
     std::vector<RS_RECT> aBallRects;   // Balls container for render
 
+    // ships of SHIP_CANNON_TRACE layer in layer order, indexed by grid targets
+    std::vector<entid_t> aTraceShips;
+    AIBallsGrid TraceShipsGrid;
+    std::vector<uint32_t> aTraceCandidates;
+
+    void BuildTraceShipsGrid();
+
+    // ball being processed, scripts read it from attributes in ball events and hit events
+    AttributePath pathCurrentBallType_{"CurrentBallType"};
+    AttributePath pathCurrentBallCannonType_{"CurrentBallCannonType"};
+    AttributePath pathCurrentBallDistance_{"CurrentBallDistance"};
+    AttributePath pathCurrentMaxBallDistance_{"CurrentMaxBallDistance"};
+
+    // writes the context attributes
+    void PublishBallContext(uint32_t dwType, uint32_t dwCannonType, float fDistance, float fMaxDistance);
+
     VDX9RENDER *rs{};
 
     void AddBall(ATTRIBUTES *pABall);
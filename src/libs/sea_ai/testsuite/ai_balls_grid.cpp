@@ -0,0 +1,154 @@
+#include "ai_balls_grid.h"
+#include "stopwatch.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <random>
+
+namespace
+{
+
+struct ship_t
+{
+    CVECTOR vPos;
+    float fRadius;
+};
+
+struct ball_t
+{
+    CVECTOR vPos, vSpeed;
+    float fTime;
+};
+
+bool SegmentTouchesShip(const CVECTOR &vSrc, const CVECTOR &vDst, const ship_t &ship)
+{
+    const auto vDir = vDst - vSrc;
+    const auto fLen2 = vDir | vDir;
+    const auto fT = fLen2 > 0.0f ? std::clamp(((ship.vPos - vSrc) | vDir) / fLen2, 0.0f, 1.0f) : 0.0f;
+    const auto vDelta = vSrc + vDir * fT - ship.vPos;
+    return (vDelta | vDelta) <= ship.fRadius * ship.fRadius;
+}
+
+// brute force reference: every ship whose sphere the segment touches
+std::vector<uint32_t> TouchedShips(const std::vector<ship_t> &aShips, const CVECTOR &vSrc, const CVECTOR &vDst)
+{
+    std::vector<uint32_t> aResult;
+    for (uint32_t i = 0; i < aShips.size(); i++)
+        if (SegmentTouchesShip(vSrc, vDst, aShips[i]))
+            aResult.push_back(i);
+    return aResult;
+}
+
+// two lines of ships exchanging broadsides
+std::vector<ship_t> MakeFleets(uint32_t dwShipsPerSide)
+{
+    std::vector<ship_t> aShips;
+    for (uint32_t i = 0; i < dwShipsPerSide; i++)
+    {
+        const auto fZ = static_cast<float>(i) * 90.0f;
+        aShips.push_back({CVECTOR(-150.0f, 10.0f, fZ), 35.0f});
+        aShips.push_back({CVECTOR(150.0f, 10.0f, fZ + 45.0f), 35.0f});
+    }
+    return aShips;
+}
+
+} // namespace
+
+TEST_CASE("Balls grid matches brute force", "[sea_ai]")
+{
+    std::mt19937 gen(12345);
+    std::uniform_real_distribution<float> pos(-1000.0f, 1000.0f);
+    std::uniform_real_distribution<float> step(-40.0f, 40.0f);
+    std::uniform_real_distribution<float> radius(5.0f, 60.0f);
+
+    std::vector<ship_t> aShips;
+    AIBallsGrid grid;
+    for (int32_t i = 0; i < 64; i++)
+    {
+        aShips.push_back({CVECTOR(pos(gen), 0.0f, pos(gen)), radius(gen)});
+        grid.AddTarget(aShips.back().vPos, aShips.back().fRadius);
+    }
+    grid.Build();
+
+    std::vector<uint32_t> aCandidates;
+    for (int32_t i = 0; i < 10000; i++)
+    {
+        const CVECTOR vSrc(pos(gen), step(gen), pos(gen));
+        const CVECTOR vDst = vSrc + CVECTOR(step(gen), step(gen), step(gen));
+        grid.Query(vSrc, vDst, aCandidates);
+        REQUIRE(aCandidates == TouchedShips(aShips, vSrc, vDst));
+    }
+
+    SECTION("Unbounded targets are always candidates")
+    {
+        grid.AddUnbounded();
+        grid.Build();
+        grid.Query(CVECTOR(5000.0f, 0.0f, 5000.0f), CVECTOR(5001.0f, 0.0f, 5000.0f), aCandidates);
+        REQUIRE(aCandidates == std::vector<uint32_t>{64});
+    }
+}
+
+TEST_CASE("Balls grid broadside replay", "[sea_ai][.benchmark]")
+{
+    constexpr uint32_t dwShipsPerSide = 12;
+    constexpr uint32_t dwFrames = 60 * 30;
+    constexpr float fDeltaTime = 1.0f / 60.0f;
+    constexpr float fGravity = 9.81f;
+
+    const auto aShips = MakeFleets(dwShipsPerSide);
+    std::vector<ball_t> aBalls;
+    AIBallsGrid grid;
+    std::vector<uint32_t> aCandidates;
+
+    uint64_t dwBruteTraces = 0, dwGridTraces = 0;
+    storm::Stopwatch gridTime;
+
+    for (uint32_t dwFrame = 0; dwFrame < dwFrames; dwFrame++)
+    {
+        // every ship fires a 16 guns broadside every 3 seconds
+        if (dwFrame % 180 == 0)
+            for (const auto &ship : aShips)
+                for (int32_t g = 0; g < 16; g++)
+                {
+                    const auto fSide = ship.vPos.x < 0.0f ? 1.0f : -1.0f;
+                    const auto vStart = ship.vPos + CVECTOR(fSide * 40.0f, 2.0f, static_cast<float>(g - 8) * 3.0f);
+                    aBalls.push_back({vStart, CVECTOR(fSide * 160.0f, 12.0f, static_cast<float>(g % 5) - 2.0f), 0.0f});
+                }
+
+        gridTime.measure([&] {
+            grid.Reset();
+            for (const auto &ship : aShips)
+                grid.AddTarget(ship.vPos, ship.fRadius);
+            grid.Build();
+        });
+
+        for (size_t i = 0; i < aBalls.size(); i++)
+        {
+            auto &ball = aBalls[i];
+            const auto vSrc = ball.vPos;
+            ball.vSpeed.y -= fGravity * fDeltaTime;
+            ball.vPos += ball.vSpeed * fDeltaTime;
+            ball.fTime += fDeltaTime;
+
+            gridTime.measure([&] { grid.Query(vSrc, ball.vPos, aCandidates); });
+
+            dwBruteTraces += aShips.size();
+            dwGridTraces += aCandidates.size();
+
+            // a ball leaves the battle when it enters a ship sphere, falls into the sea or flies too long
+            if (!aCandidates.empty() || ball.vPos.y < 0.0f || ball.fTime > 4.0f)
+            {
+                aBalls[i] = aBalls.back();
+                aBalls.pop_back();
+                i--;
+            }
+        }
+    }
+
+    WARN("ships: " << aShips.size() << ", frames: " << dwFrames);
+    WARN("traces/frame brute force: " << static_cast<double>(dwBruteTraces) / dwFrames
+                                      << ", grid: " << static_cast<double>(dwGridTraces) / dwFrames);
+    WARN("grid ms/frame: " << gridTime.milliseconds(dwFrames));
+
+    CHECK(dwGridTraces * 4 < dwBruteTraces);
+}
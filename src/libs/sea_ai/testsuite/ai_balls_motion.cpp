@@ -0,0 +1,146 @@
+#include "ai_balls_motion.h"
+
+#include <catch2/catch.hpp>
+
+#include <random>
+
+namespace
+{
+
+constexpr float kGravity = 9.81f;
+
+BALL_PARAMS RandomLaunch(std::mt19937 &gen)
+{
+    std::uniform_real_distribution<float> pos(-2000.0f, 2000.0f);
+    std::uniform_real_distribution<float> speed(40.0f, 300.0f);
+    std::uniform_real_distribution<float> angle(-0.3f, 0.8f);
+    std::uniform_real_distribution<float> dir(-3.1415f, 3.1415f);
+    std::uniform_real_distribution<float> rawAng(-0.5f, 0.5f);
+    std::uniform_real_distribution<float> multiply(0.5f, 2.0f);
+
+    BALL_PARAMS ball{};
+    ball.vFirstPos = CVECTOR(pos(gen), pos(gen) * 0.01f, pos(gen));
+    ball.vPos = ball.vFirstPos;
+    ball.fTime = 0.0f;
+    ball.fSpeedV0 = speed(gen);
+    const auto fAngle = angle(gen);
+    ball.fCosAngle = cosf(fAngle);
+    ball.fSinAngle = sinf(fAngle);
+    const auto fDir = dir(gen);
+    ball.fDirX = cosf(fDir);
+    ball.fDirZ = sinf(fDir);
+    ball.fRawAng = rawAng(gen);
+    ball.fHeightMultiply = multiply(gen);
+    ball.fTimeSpeedMultiply = multiply(gen);
+    return ball;
+}
+
+// The per-step integrator AIBalls::Execute used before the trajectories were precomputed
+void StepBall(BALL_PARAMS &ball, float fDeltaTime)
+{
+    ball.fTime += fDeltaTime * ball.fTimeSpeedMultiply;
+    const auto fsX = ball.fSpeedV0 * ball.fTime * ball.fCosAngle;
+    const auto fsY = ball.fSpeedV0 * ball.fTime * ball.fSinAngle - kGravity * ball.fTime * ball.fTime / 2.0f;
+
+    const auto fCosRaw = cosf(ball.fRawAng);
+    const auto fSinRaw = sinf(ball.fRawAng);
+    const auto fProjX = fsX * fCosRaw + fsY * fSinRaw;
+    auto fProjY = -fsX * fSinRaw + fsY * fCosRaw;
+    fProjY *= ball.fHeightMultiply;
+    const auto fX = fProjX * fCosRaw - fProjY * fSinRaw;
+    const auto fY = fProjX * fSinRaw + fProjY * fCosRaw;
+
+    ball.vPos = CVECTOR(0.0f, fY, fX);
+    RotateAroundY(ball.vPos.x, ball.vPos.z, ball.fDirX, ball.fDirZ);
+    ball.vPos += ball.vFirstPos;
+}
+
+void CheckPositions(const BALLS_MOTION &motion, const std::vector<BALL_PARAMS> &balls)
+{
+    REQUIRE(motion.fTime.size() == balls.size());
+    for (size_t i = 0; i < balls.size(); i++)
+    {
+        REQUIRE(motion.fTime[i] == Approx(balls[i].fTime));
+        // both forms round differently, a few millimeters over kilometers of flight
+        REQUIRE(motion.fX[i] == Approx(balls[i].vPos.x).margin(0.02f));
+        REQUIRE(motion.fY[i] == Approx(balls[i].vPos.y).margin(0.02f));
+        REQUIRE(motion.fZ[i] == Approx(balls[i].vPos.z).margin(0.02f));
+    }
+}
+
+} // namespace
+
+TEST_CASE("Closed form ball trajectory matches the per-step integrator", "[sea_ai]")
+{
+    std::mt19937 gen(12);
+    std::uniform_real_distribution<float> frameTime(0.005f, 0.05f);
+
+    SECTION("Random launches over a whole flight")
+    {
+        BALLS_MOTION motion;
+        std::vector<BALL_PARAMS> balls;
+        for (int32_t i = 0; i < 200; i++)
+        {
+            balls.push_back(RandomLaunch(gen));
+            motion.Add(balls.back(), kGravity);
+        }
+
+        // 20 seconds at most, long enough for the farthest shots to fall into the sea
+        for (auto fFlight = 0.0f; fFlight < 20.0f;)
+        {
+            const auto fDeltaTime = frameTime(gen);
+            fFlight += fDeltaTime;
+            motion.Integrate(fDeltaTime);
+            for (auto &ball : balls)
+                StepBall(ball, fDeltaTime);
+            CheckPositions(motion, balls);
+        }
+    }
+
+    SECTION("Balls removed and added during the flight keep their trajectories")
+    {
+        std::uniform_int_distribution<int32_t> coin(0, 3);
+        BALLS_MOTION motion;
+        std::vector<BALL_PARAMS> balls;
+        for (int32_t step = 0; step < 500; step++)
+        {
+            // a new volley every few frames, AIBalls swaps a removed ball with the last one
+            if (coin(gen) == 0)
+                for (int32_t i = 0; i < 5; i++)
+                {
+                    balls.push_back(RandomLaunch(gen));
+                    motion.Add(balls.back(), kGravity);
+                }
+            for (size_t i = 0; i < balls.size(); i++)
+                if (coin(gen) == 0)
+                {
+                    balls[i] = balls.back();
+                    balls.pop_back();
+                    motion.Remove(i);
+                }
+
+            const auto fDeltaTime = frameTime(gen);
+            motion.Integrate(fDeltaTime);
+            for (auto &ball : balls)
+                StepBall(ball, fDeltaTime);
+            CheckPositions(motion, balls);
+        }
+    }
+
+    SECTION("Loaded ball continues from its saved time")
+    {
+        auto ball = RandomLaunch(gen);
+        for (int32_t i = 0; i < 100; i++)
+            StepBall(ball, 0.02f);
+
+        BALLS_MOTION motion;
+        motion.Add(ball, kGravity);
+        std::vector<BALL_PARAMS> balls{ball};
+        for (int32_t i = 0; i < 100; i++)
+        {
+            motion.Integrate(0.02f);
+            StepBall(balls.front(), 0.02f);
+            CheckPositions(motion, balls);
+        }
+    }
+}
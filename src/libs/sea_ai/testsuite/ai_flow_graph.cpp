@@ -0,0 +1,119 @@
+#include "ai_flow_graph.h"
+
+#include <catch2/catch.hpp>
+
+#include <random>
+
+namespace
+{
+
+class TestFlowGraph : public AIFlowGraph
+{
+  public:
+    void AddPoint(const CVECTOR &vPos)
+    {
+        aPoints.emplace_back(vPos);
+    }
+
+    void Link(size_t dwP1, size_t dwP2)
+    {
+        const auto dwEdge = AddEdge(dwP1, dwP2);
+        aPoints[dwP1].aEdges.push_back(dwEdge);
+        aPoints[dwP2].aEdges.push_back(dwEdge);
+    }
+};
+
+// random sea points linked to a few close neighbours, a handful of points stay isolated
+void MakeGraph(TestFlowGraph &graph, std::mt19937 &gen, uint32_t dwNumPoints)
+{
+    std::uniform_real_distribution<float> pos(-2000.0f, 2000.0f);
+    for (uint32_t i = 0; i < dwNumPoints; i++)
+        graph.AddPoint(CVECTOR(pos(gen), 0.0f, pos(gen)));
+
+    std::uniform_int_distribution<uint32_t> pnt(0, dwNumPoints - 1);
+    for (uint32_t i = 0; i < dwNumPoints - 5; i++)
+        for (uint32_t j = 0; j < 3; j++)
+        {
+            uint32_t dwBest = pnt(gen);
+            for (uint32_t k = 0; k < 8; k++)
+            {
+                const auto dwOther = pnt(gen);
+                if (graph.GetDistance(i, dwOther) < graph.GetDistance(i, dwBest))
+                    dwBest = dwOther;
+            }
+            if (dwBest != i && dwBest < dwNumPoints - 5)
+                graph.Link(i, dwBest);
+        }
+    graph.BuildTable();
+}
+
+} // namespace
+
+TEST_CASE("Flow graph path distances match Floyd-Warshall", "[sea_ai]")
+{
+    std::mt19937 gen(777);
+    TestFlowGraph graph;
+    constexpr uint32_t dwNumPoints = 120;
+    MakeGraph(graph, gen, dwNumPoints);
+
+    std::vector<float> aDist(dwNumPoints * dwNumPoints, 1e8f);
+    for (uint32_t i = 0; i < dwNumPoints; i++)
+        aDist[i * dwNumPoints + i] = 0.0f;
+    for (size_t i = 0; i < graph.GetNumEdges(); i++)
+    {
+        const auto *pE = graph.GetEdge(i);
+        aDist[pE->dw1 * dwNumPoints + pE->dw2] = aDist[pE->dw2 * dwNumPoints + pE->dw1] = pE->fLen;
+    }
+    for (uint32_t k = 0; k < dwNumPoints; k++)
+        for (uint32_t i = 0; i < dwNumPoints; i++)
+            for (uint32_t j = 0; j < dwNumPoints; j++)
+                aDist[i * dwNumPoints + j] =
+                    std::min(aDist[i * dwNumPoints + j], aDist[i * dwNumPoints + k] + aDist[k * dwNumPoints + j]);
+
+    for (uint32_t i = 0; i < dwNumPoints; i++)
+        for (uint32_t j = 0; j < dwNumPoints; j++)
+        {
+            const float fExpected = (aDist[i * dwNumPoints + j] < 1e8f) ? aDist[i * dwNumPoints + j] : 0.0f;
+            REQUIRE(graph.GetPathDistance(i, j) == Approx(fExpected).margin(0.01f));
+        }
+}
+
+TEST_CASE("Flow graph nearest points match brute force", "[sea_ai]")
+{
+    std::mt19937 gen(4242);
+    TestFlowGraph graph;
+    constexpr uint32_t dwNumPoints = 300;
+    MakeGraph(graph, gen, dwNumPoints);
+
+    std::uniform_real_distribution<float> pos(-3000.0f, 3000.0f);
+    std::vector<AIFlowGraph::npoint_t> aNearest;
+    for (uint32_t n = 0; n < 2000; n++)
+    {
+        const CVECTOR vP(pos(gen), 0.1f, pos(gen));
+        const size_t dwCount = 1 + n % 12;
+        graph.GetNearestPoints(vP, dwCount, aNearest);
+
+        std::vector<float> aExpected;
+        for (uint32_t i = 0; i < dwNumPoints; i++)
+            aExpected.push_back(sqrtf(~(vP - graph.GetPointPos(i))));
+        std::sort(aExpected.begin(), aExpected.end());
+
+        REQUIRE(aNearest.size() == dwCount);
+        for (size_t i = 0; i < dwCount; i++)
+        {
+            REQUIRE(aNearest[i].fDistance == aExpected[i]);
+            REQUIRE(aNearest[i].fDistance == sqrtf(~(vP - graph.GetPointPos(aNearest[i].dwPnt))));
+        }
+    }
+
+    SECTION("Empty graph and oversized requests")
+    {
+        graph.GetNearestPoints(CVECTOR(0.0f, 0.0f, 0.0f), dwNumPoints + 10, aNearest);
+        REQUIRE(aNearest.size() == dwNumPoints);
+
+        TestFlowGraph empty;
+        empty.BuildTable();
+        empty.GetNearestPoints(CVECTOR(0.0f, 0.0f, 0.0f), 8, aNearest);
+        REQUIRE(aNearest.empty());
+    }
+}
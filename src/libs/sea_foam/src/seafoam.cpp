@@ -131,23 +131,28 @@ void SEAFOAM::CreateTracePoints(tShipFoamInfo *_shipFoamInfo)
     const auto yStep = 0.9f * _shipFoamInfo->hullInfo.boxsize.y / (TRACE_STEPS_Y - 1);
     const auto zStep = .15f * _shipFoamInfo->hullInfo.boxsize.z / TRACE_STEPS_Z;
     float curY, curZ;
-    GEOS::VERTEX startSrcV, startDestV{};
     float startZ[TRACE_STEPS_Y];
+    GEOS::TRACE_RAY rays[TRACE_STEPS_Y * 2];
+    const GEOS *hullGeo = _shipFoamInfo->shipModel->GetNode(0)->geo;
 
     // <find_startZ>
     curY = _shipFoamInfo->hullInfo.boxcenter.y + (_shipFoamInfo->hullInfo.boxsize.y / 2.0f);
 
-    startSrcV.x = _shipFoamInfo->hullInfo.boxcenter.x;
-    startSrcV.z = _shipFoamInfo->hullInfo.boxcenter.z + _shipFoamInfo->hullInfo.boxsize.z / 2.0f;
-
-    startDestV.x = _shipFoamInfo->hullInfo.boxcenter.x;
-    startDestV.z = _shipFoamInfo->hullInfo.boxcenter.z - _shipFoamInfo->hullInfo.boxsize.z / 2.0f;
     int y;
     for (y = 0; y < TRACE_STEPS_Y; y++, curY -= yStep)
     {
-        startSrcV.y = curY;
-        startDestV.y = curY;
-        const auto d = _shipFoamInfo->shipModel->GetNode(0)->geo->Trace(startSrcV, startDestV);
+        rays[y].src.x = _shipFoamInfo->hullInfo.boxcenter.x;
+        rays[y].src.y = curY;
+        rays[y].src.z = _shipFoamInfo->hullInfo.boxcenter.z + _shipFoamInfo->hullInfo.boxsize.z / 2.0f;
+        rays[y].dst.x = _shipFoamInfo->hullInfo.boxcenter.x;
+        rays[y].dst.y = curY;
+        rays[y].dst.z = _shipFoamInfo->hullInfo.boxcenter.z - _shipFoamInfo->hullInfo.boxsize.z / 2.0f;
+    }
+    hullGeo->Trace(rays, TRACE_STEPS_Y);
+
+    for (y = 0; y < TRACE_STEPS_Y; y++)
+    {
+        const auto d = rays[y].dist;
         if (d <= 1.0f)
         {
             startZ[y] = d * _shipFoamInfo->hullInfo.boxsize.z
@@ -172,45 +177,46 @@ void SEAFOAM::CreateTracePoints(tShipFoamInfo *_shipFoamInfo)
         float deltaZ;
         auto kSum = 0.0f;
 
+        // rays from the left side go first, then rays from the right side
         for (y = 0; y < TRACE_STEPS_Y; y++, curY -= yStep)
         {
             deltaZ = startZ[y];
-            const CVECTOR srcLeft(_shipFoamInfo->hullInfo.boxcenter.x - _shipFoamInfo->hullInfo.boxsize.x / 2.0f, curY,
-                                  curZ - deltaZ);
-            const CVECTOR srcRight(_shipFoamInfo->hullInfo.boxcenter.x + _shipFoamInfo->hullInfo.boxsize.x / 2.0f, curY,
-                                   curZ - deltaZ);
-            const CVECTOR dst(_shipFoamInfo->hullInfo.boxcenter.x, curY, curZ - deltaZ);
-            GEOS::VERTEX srcLeftV, srcRightV, dstV;
-            srcLeftV.x = srcLeft.x;
-            srcLeftV.y = srcLeft.y;
-            srcLeftV.z = srcLeft.z;
-            srcRightV.x = srcRight.x;
-            srcRightV.y = srcRight.y;
-            srcRightV.z = srcRight.z;
-            dstV.x = dst.x;
-            dstV.y = dst.y;
-            dstV.z = dst.z;
+            auto &left = rays[y];
+            auto &right = rays[TRACE_STEPS_Y + y];
+            left.src.x = _shipFoamInfo->hullInfo.boxcenter.x - _shipFoamInfo->hullInfo.boxsize.x / 2.0f;
+            right.src.x = _shipFoamInfo->hullInfo.boxcenter.x + _shipFoamInfo->hullInfo.boxsize.x / 2.0f;
+            left.dst.x = right.dst.x = _shipFoamInfo->hullInfo.boxcenter.x;
+            left.src.y = right.src.y = left.dst.y = right.dst.y = curY;
+            left.src.z = right.src.z = left.dst.z = right.dst.z = curZ - deltaZ;
 
             _shipFoamInfo->hull[0][z].center[y].y = curY;
             _shipFoamInfo->hull[0][z].center[y].z = curZ - deltaZ;
             _shipFoamInfo->hull[1][z].center[y].y = curY;
             _shipFoamInfo->hull[1][z].center[y].z = curZ - deltaZ;
+        }
+        hullGeo->Trace(rays, TRACE_STEPS_Y * 2);
+
+        for (y = 0; y < TRACE_STEPS_Y; y++)
+        {
+            const float srcLeftX = rays[y].src.x;
+            const float srcRightX = rays[TRACE_STEPS_Y + y].src.x;
+
             // <from_left>
-            auto d = _shipFoamInfo->shipModel->GetNode(0)->geo->Trace(srcLeftV, dstV);
+            auto d = rays[y].dist;
             if (d > 1.0f)
                 _shipFoamInfo->hull[0][z].center[y].x = _shipFoamInfo->hullInfo.boxcenter.x;
             else
                 _shipFoamInfo->hull[0][z].center[y].x = -0.0f +
-                                                        (1.0f - d) * (srcLeft.x - _shipFoamInfo->hullInfo.boxcenter.x) +
+                                                        (1.0f - d) * (srcLeftX - _shipFoamInfo->hullInfo.boxcenter.x) +
                                                         _shipFoamInfo->hullInfo.boxcenter.x;
 
             // <from_right>
-            d = _shipFoamInfo->shipModel->GetNode(0)->geo->Trace(srcRightV, dstV);
+            d = rays[TRACE_STEPS_Y + y].dist;
             if (d > 1.0f)
                 _shipFoamInfo->hull[1][z].center[y].x = _shipFoamInfo->hullInfo.boxcenter.x;
             else
                 _shipFoamInfo->hull[1][z].center[y].x =
-                    0.0f + (1.0f - d) * (srcRight.x - _shipFoamInfo->hullInfo.boxcenter.x) +
+                    0.0f + (1.0f - d) * (srcRightX - _shipFoamInfo->hullInfo.boxcenter.x) +
                     _shipFoamInfo->hullInfo.boxcenter.x;
         }
     }
@@ -48,6 +48,12 @@ class SEAFOAM : public Entity
     virtual void Realize(uint32_t dTime);
     virtual void Execute(uint32_t dTime);
 
+    // execute only copies ships' current speed into own carcasses
+    [[nodiscard]] ExecutePolicy GetExecutePolicy() const override
+    {
+        return ExecutePolicy::parallel;
+    }
+
     void ProcessStage(Stage stage, uint32_t delta) override
     {
         switch (stage)
@@ -74,14 +74,14 @@ void SHIP::InitSailState()
     // some legacy stuff
     // should've been done from scripts
     float fNewSailState = 0.0f;
-    ATTRIBUTES *pAShipStopped = GetACharacter()->FindAClass(GetACharacter(), "ship.stopped");
+    ATTRIBUTES *pAShipStopped = pathShipStopped_.Find(GetACharacter());
     if (pAShipStopped && pAShipStopped->GetAttributeAsDword())
     {
         fNewSailState = 0.0f;
     }
     else
     {
-        auto *pASpeedZ = GetACharacter()->FindAClass(GetACharacter(), "Ship.Speed.z");
+        auto *pASpeedZ = pathShipSpeedZ_.Find(GetACharacter());
         if (pASpeedZ && pASpeedZ->GetAttributeAsFloat() > 0.0f)
         {
             fNewSailState = 1.0f;
@@ -481,7 +481,7 @@ float SHIP::GetBrakingDistance(float *pfTime)
 // calculate ship immersion
 void SHIP::CalculateImmersion()
 {
-    auto *pAShipImmersion = GetACharacter()->FindAClass(GetACharacter(), "Ship.Immersion");
+    auto *pAShipImmersion = pathShipImmersion_.Find(GetACharacter());
     State.fShipImmersion = (pAShipImmersion) ? pAShipImmersion->GetAttributeAsFloat() : 0.0f;
     // return State.fShipImmersion;
 }
@@ -521,7 +521,7 @@ void SHIP::SetDead()
         vOldAng = State.vAng;
         vOldPos = State.vPos;
 
-        auto *pASinkSpeed = GetACharacter()->FindAClass(GetACharacter(), "ship.sink.speed");
+        auto *pASinkSpeed = pathShipSinkSpeed_.Find(GetACharacter());
 
         // aref aSink; makearef(aSink, rDead.Ship.Sink);
         if (!pASinkSpeed)
@@ -552,7 +552,7 @@ void SHIP::SetDead()
 
 void SHIP::Execute(uint32_t DeltaTime)
 {
-    auto *pAPerks = GetACharacter()->FindAClass(GetACharacter(), "TmpPerks");
+    auto *pAPerks = pathTmpPerks_.Find(GetACharacter());
 
     auto *pARocking = GetAShip()->GetAttributeClass("Rocking");
 
@@ -595,7 +595,7 @@ void SHIP::Execute(uint32_t DeltaTime)
     if (!bMounted)
         return;
 
-    auto *pAShipStopped = GetACharacter()->FindAClass(GetACharacter(), "ship.stopped");
+    auto *pAShipStopped = pathShipStopped_.Find(GetACharacter());
     auto bMainCharacter = GetACharacter()->GetAttributeAsDword("MainCharacter", 0) != 0;
 
     if (dtUpdateParameters.Update(fDeltaTime))
@@ -606,7 +606,7 @@ void SHIP::Execute(uint32_t DeltaTime)
         }
     }
     // check impulse
-    auto *pAImpulse = GetACharacter()->FindAClass(GetACharacter(), "Ship.Impulse");
+    auto *pAImpulse = pathShipImpulse_.Find(GetACharacter());
     if (pAImpulse && !isDead())
     {
         CVECTOR vRotate = 0.0f, vXSpeed = 0.0f;
@@ -657,7 +657,7 @@ void SHIP::Execute(uint32_t DeltaTime)
         vAng.z += fRotate;
     }
 
-    auto *pASpeed = GetACharacter()->FindAClass(GetACharacter(), "ship.speed");
+    auto *pASpeed = pathShipSpeed_.Find(GetACharacter());
     if (!pASpeed)
     {
         pASpeed = GetACharacter()->CreateSubAClass(GetACharacter(), "ship.speed");
@@ -758,8 +758,8 @@ void SHIP::Execute(uint32_t DeltaTime)
     }
 
     // set attributes for script
-    auto *pAPos = GetACharacter()->FindAClass(GetACharacter(), "ship.pos");
-    auto *pAAng = GetACharacter()->FindAClass(GetACharacter(), "ship.ang");
+    auto *pAPos = pathShipPos_.Find(GetACharacter());
+    auto *pAAng = pathShipAng_.Find(GetACharacter());
     if (!pAPos)
     {
         pAPos = GetACharacter()->CreateSubAClass(GetACharacter(), "ship.pos");
@@ -1414,8 +1414,8 @@ void SHIP::FakeFire(const char *sBort, float fRandTime)
 
 void SHIP::LoadPositionFromAttributes()
 {
-    auto *pAPos = GetACharacter()->FindAClass(GetACharacter(), "ship.pos");
-    auto *pAAng = GetACharacter()->FindAClass(GetACharacter(), "ship.ang");
+    auto *pAPos = pathShipPos_.Find(GetACharacter());
+    auto *pAAng = pathShipAng_.Find(GetACharacter());
     Assert(pAPos && pAAng);
     State.vPos.x = pAPos->GetAttributeAsFloat("x");
     State.vPos.z = pAPos->GetAttributeAsFloat("z");
@@ -1853,6 +1853,18 @@ float SHIP::Cannon_Trace(int32_t iBallOwner, const CVECTOR &vSrc, const CVECTOR
     return fRes;
 }
 
+bool SHIP::GetCannonTraceBounds(CVECTOR &center, float &radius)
+{
+    // masts and hulls are nodes of the ship model, so the root sphere covers them too
+    MODEL *pModel = GetModel();
+    NODE *pRoot = pModel ? pModel->GetNode(0) : nullptr;
+    if (!pRoot)
+        return false;
+
+    pRoot->GetBoundingSphere(center, radius);
+    return true;
+}
+
 uint32_t SHIP::AttributeChanged(ATTRIBUTES *pAttribute)
 {
     return 0;
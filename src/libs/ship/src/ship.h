@@ -133,6 +133,17 @@ class SHIP : public SHIP_BASE
 
     DTimer dtMastTrace, dtUpdateParameters;
 
+    // character attributes read every frame
+    AttributePath pathShipStopped_{"ship.stopped"};
+    AttributePath pathShipSpeedZ_{"ship.speed.z"};
+    AttributePath pathShipImmersion_{"ship.immersion"};
+    AttributePath pathShipSinkSpeed_{"ship.sink.speed"};
+    AttributePath pathTmpPerks_{"TmpPerks"};
+    AttributePath pathShipImpulse_{"ship.impulse"};
+    AttributePath pathShipSpeed_{"ship.speed"};
+    AttributePath pathShipPos_{"ship.pos"};
+    AttributePath pathShipAng_{"ship.ang"};
+
     // executed functions
     CVECTOR ShipRocking(float fDeltaTime);
     BOOL ApplyStrength(float dtime, BOOL bCollision);
@@ -230,6 +241,7 @@ class SHIP : public SHIP_BASE
 
     // inherit functions CANNON_TRACE_BASE
     float Cannon_Trace(int32_t iBallOwner, const CVECTOR &src, const CVECTOR &dst) override;
+    bool GetCannonTraceBounds(CVECTOR &center, float &radius) override;
 
     // inherit functions VAI_OBJBASE
     void SetACharacter(ATTRIBUTES *pAP) override;
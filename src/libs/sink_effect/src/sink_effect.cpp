@@ -118,6 +118,13 @@ void SINKEFFECT::Execute(uint32_t _dTime)
     // UNGUARD
 }
 
+//--------------------------------------------------------------------
+void SINKEFFECT::FinishParallelExecute(uint32_t _dTime)
+{
+    for (auto i = 0; i < sink_effect::MAX_SINKS; ++i)
+        sinks[i].ProcessSplashes(_dTime);
+}
+
 //--------------------------------------------------------------------
 void SINKEFFECT::InitializeSinks()
 {
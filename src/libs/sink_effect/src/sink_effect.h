@@ -22,6 +22,13 @@ class SINKEFFECT : public Entity
     virtual void Realize(uint32_t dTime);
     virtual void Execute(uint32_t dTime);
 
+    // execute only moves the flotsam of own sinks, the splashes are written to the buffers afterwards
+    [[nodiscard]] ExecutePolicy GetExecutePolicy() const override
+    {
+        return ExecutePolicy::parallel;
+    }
+    void FinishParallelExecute(uint32_t dTime) override;
+
     void ProcessStage(Stage stage, uint32_t delta) override
     {
         switch (stage)
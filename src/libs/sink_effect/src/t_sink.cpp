@@ -81,6 +81,29 @@ void TSink::Process(uint32_t _dTime)
         return;
 
     time += _dTime;
+    if (time > (sink_effect::SINK_TIME + sink_effect::MAX_SPLASH_TIME))
+        return;
+
+    for (auto i = 0; i < sink_effect::MAX_FLOTSAMS; i++)
+    {
+        if (flotsamTimes[i] > 0)
+            flotsamTimes[i] -= _dTime;
+        else
+        {
+            if (!flotsams[i].Enabled())
+                flotsams[i].Start(center.x, center.z, radius);
+            else
+                flotsams[i].Process(_dTime);
+        }
+    }
+}
+
+//--------------------------------------------------------------------
+void TSink::ProcessSplashes(uint32_t _dTime)
+{
+    if (!enabled)
+        return;
+
     uint16_t *indexes;
     SINK_VERTEX *vertices;
 
@@ -139,19 +162,6 @@ void TSink::Process(uint32_t _dTime)
         }
     }
     ivManager->UnlockBuffers();
-
-    for (auto i = 0; i < sink_effect::MAX_FLOTSAMS; i++)
-    {
-        if (flotsamTimes[i] > 0)
-            flotsamTimes[i] -= _dTime;
-        else
-        {
-            if (!flotsams[i].Enabled())
-                flotsams[i].Start(center.x, center.z, radius);
-            else
-                flotsams[i].Process(_dTime);
-        }
-    }
 }
 
 //--------------------------------------------------------------------
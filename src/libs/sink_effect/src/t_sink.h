@@ -19,7 +19,10 @@ class TSink
     void Initialize(INIFILE *_ini, IDirect3DDevice9 *_device, SEA_BASE *sea, VDX9RENDER *_renderer);
     void Release();
     void Start(const CVECTOR &_pos, float _radius);
+    // Moves the flotsam, touches nothing but this sink
     void Process(uint32_t dTime);
+    // Splash grids live in the render buffers, so they are updated on the main thread after Process
+    void ProcessSplashes(uint32_t dTime);
     void Realize(uint32_t dTime);
     bool Enabled();
 
@@ -54,7 +54,7 @@ void Debris::Init()
     soundService = static_cast<VSoundService *>(core.GetService("SoundService"));
 }
 
-void Debris::Update(float dltTime)
+void Debris::Spawn(float dltTime)
 {
     if (numModels == 0)
         return;
@@ -78,6 +78,8 @@ void Debris::Update(float dltTime)
                 fly[flyCounter].ang = 0.0f;
                 fly[flyCounter].scale = 1.0f + (rand() & 3) / 4.0f;
                 flyCounter++;
+                // the others have already moved in this frame
+                Update(dltTime, flyCounter - 1);
                 if (soundService)
                 {
                     if (lastPlayTime <= 0.0f)
@@ -90,9 +92,13 @@ void Debris::Update(float dltTime)
             }
         }
     }
+}
+
+void Debris::Update(float dltTime, int32_t first)
+{
     // Flight
     const auto h = pillar.GetHeight();
-    for (int32_t i = 0; i < flyCounter; i++)
+    for (int32_t i = first; i < flyCounter; i++)
     {
         // Updating the height position
         fly[i].ay += dltTime * fly[i].maxSpeed;
@@ -44,7 +44,10 @@ class Debris
 
     void Init();
 
-    void Update(float dltTime);
+    // Moves the flying models starting with first
+    void Update(float dltTime, int32_t first = 0);
+    // Picks up a model near a ship, looks at the ships and plays the sound, the new model flies in the same frame
+    void Spawn(float dltTime);
     void Draw(VDX9RENDER *rs);
 
     void SetGlobalAlpha(float a);
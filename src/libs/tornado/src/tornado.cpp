@@ -26,6 +26,7 @@ Tornado::Tornado() : particles(pillar), noiseCloud(pillar), debris(pillar)
     eventCounter = 0.0f;
     liveTime = 60.0f;
     galhpa = 1.0f;
+    isFaded = false;
     soundService = nullptr;
     sID = SOUND_INVALID_ID;
 }
@@ -104,8 +105,6 @@ void Tornado::Execute(uint32_t delta_time)
     noiseCloud.Update(dltTime);
     debris.Update(dltTime);
     eventCounter += dltTime;
-    if (eventCounter > 1.0f)
-        core.Event("TornadoDamage", "fff", eventCounter, pillar.GetX(0.0f), pillar.GetZ(0.0f));
     if (liveTime < 0.0f)
     {
         SetAlpha(galhpa);
@@ -113,12 +112,23 @@ void Tornado::Execute(uint32_t delta_time)
         if (galhpa < 0.0f)
         {
             galhpa = 0.0f;
-            core.Event("TornadoDelete");
-            core.EraseEntity(GetId());
+            isFaded = true;
         }
     }
     else
         liveTime -= dltTime;
+}
+
+void Tornado::FinishParallelExecute(uint32_t delta_time)
+{
+    debris.Spawn(delta_time * 0.001f);
+    if (eventCounter > 1.0f)
+        core.Event("TornadoDamage", "fff", eventCounter, pillar.GetX(0.0f), pillar.GetZ(0.0f));
+    if (isFaded)
+    {
+        core.Event("TornadoDelete");
+        core.EraseEntity(GetId());
+    }
     if (soundService && sID != SOUND_INVALID_ID)
     {
         const auto pos = CVECTOR(pillar.GetX(0.0f), 0.0f, pillar.GetZ(0.0f));
@@ -30,6 +30,13 @@ class Tornado : public Entity
     void Realize(uint32_t delta_time);
     uint64_t ProcessMessage(MESSAGE &message) override;
 
+    // Execute moves only the own pillar, particles and debris, the rest follows on the main thread
+    [[nodiscard]] ExecutePolicy GetExecutePolicy() const override
+    {
+        return ExecutePolicy::parallel;
+    }
+    void FinishParallelExecute(uint32_t delta_time) override;
+
     void ProcessStage(Stage stage, uint32_t delta) override
     {
         switch (stage)
@@ -67,6 +74,7 @@ class Tornado : public Entity
 
     float liveTime;
     float galhpa;
+    bool isFaded;
 
     int32_t ib, vb;
 };
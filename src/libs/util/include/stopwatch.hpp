@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cassert>
+
+#include <chrono>
+#include <cstddef>
+#include <utility>
+
+namespace storm
+{
+
+/**
+ * \brief Time spent in the measured parts of a benchmark, summed over all of its runs
+ */
+class Stopwatch final
+{
+  public:
+    using clock = std::chrono::steady_clock;
+
+    // runs the callable and adds its time, returns what the callable returns
+    template <typename Callable> decltype(auto) measure(Callable &&callable)
+    {
+        const Lap lap(elapsed_);
+        return std::forward<Callable>(callable)();
+    }
+
+    // average time of one of the runs
+    template <typename Period> double average(size_t runs = 1) const
+    {
+        assert(runs > 0);
+        return std::chrono::duration<double, Period>(elapsed_).count() / static_cast<double>(runs);
+    }
+
+    double milliseconds(size_t runs = 1) const
+    {
+        return average<std::milli>(runs);
+    }
+
+    double microseconds(size_t runs = 1) const
+    {
+        return average<std::micro>(runs);
+    }
+
+    double nanoseconds(size_t runs = 1) const
+    {
+        return average<std::nano>(runs);
+    }
+
+  private:
+    class Lap final
+    {
+      public:
+        explicit Lap(clock::duration &elapsed) : elapsed_(elapsed), start_(clock::now())
+        {
+        }
+
+        ~Lap()
+        {
+            elapsed_ += clock::now() - start_;
+        }
+
+        Lap(const Lap &) = delete;
+        Lap &operator=(const Lap &) = delete;
+
+      private:
+        clock::duration &elapsed_;
+        clock::time_point start_;
+    };
+
+    clock::duration elapsed_{};
+};
+
+} // namespace storm
@@ -4,7 +4,9 @@
 
 #include <algorithm>
 #include <cctype>
+#include <cstdint>
 #include <string>
+#include <string_view>
 
 namespace storm
 {
@@ -215,4 +217,29 @@ struct iStrComparator
         return iEquals(left, right);
     }
 };
+
+// Same as iStrHasher and iStrComparator without copies, for lookups by std::string_view or const char *
+struct iStrViewHasher
+{
+    using is_transparent = void;
+
+    size_t operator()(const std::string_view &key) const noexcept
+    {
+        uint64_t hash = 14695981039346656037ull;
+        for (const auto c : key)
+            hash = (hash ^ static_cast<uint8_t>(std::toupper(c))) * 1099511628211ull;
+        return static_cast<size_t>(hash);
+    }
+};
+
+struct iStrViewComparator
+{
+    using is_transparent = void;
+
+    bool operator()(const std::string_view &left, const std::string_view &right) const noexcept
+    {
+        return left.size() == right.size() &&
+               std::equal(left.begin(), left.end(), right.begin(), detail::is_iequal{});
+    }
+};
 } // namespace storm
@@ -0,0 +1,33 @@
+#include "stopwatch.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <thread>
+
+using namespace storm;
+
+TEST_CASE("Stopwatch", "[utils]")
+{
+    Stopwatch stopwatch;
+    CHECK(stopwatch.nanoseconds() == 0.0);
+
+    SECTION("Measure returns the result of the callable")
+    {
+        int calls = 0;
+        CHECK(stopwatch.measure([&] { return ++calls; }) == 1);
+        stopwatch.measure([&] { calls++; });
+        CHECK(calls == 2);
+    }
+
+    SECTION("Time adds up over the runs")
+    {
+        using namespace std::chrono_literals;
+        for (int i = 0; i < 4; i++)
+            stopwatch.measure([] { std::this_thread::sleep_for(2ms); });
+
+        CHECK(stopwatch.milliseconds() >= 8.0);
+        CHECK(stopwatch.milliseconds(4) >= 2.0);
+        CHECK(stopwatch.microseconds(4) == Approx(stopwatch.milliseconds() * 250.0));
+        CHECK(stopwatch.nanoseconds(4) == Approx(stopwatch.microseconds(4) * 1000.0));
+    }
+}
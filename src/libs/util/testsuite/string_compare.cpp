@@ -8,6 +8,8 @@
 
 #include <catch2/catch.hpp>
 
+#include <unordered_map>
+
 TEST_CASE("Case-insensitive string comparison", "[utils]")
 {
     using namespace storm;
@@ -95,3 +97,22 @@ TEST_CASE("Case-insensitive string comparison", "[utils]")
         }
     }
 }
+
+TEST_CASE("Case-insensitive string hashing", "[utils]")
+{
+    using namespace storm;
+    using namespace std::string_view_literals;
+
+    const iStrViewHasher hasher;
+    const iStrViewComparator comparator;
+
+    CHECK(hasher("mYsTrInG"sv) == hasher("MYSTRING"sv));
+    CHECK(comparator("mYsTrInG"sv, "MYSTRING"sv));
+    CHECK_FALSE(comparator("mystring"sv, "mystrings"sv));
+    CHECK_FALSE(comparator("mystring"sv, "m_string"sv));
+
+    std::unordered_map<std::string_view, int, iStrViewHasher, iStrViewComparator> map{{"MyString", 1}};
+    CHECK(map.find("MYSTRING") != map.end());
+    CHECK(map.find("mystring"sv)->second == 1);
+    CHECK(map.find("m_string") == map.end());
+}
@@ -7,6 +7,9 @@
 #include "iv_buffer_manager.h"
 #include "math_inlines.h"
 
+#include <algorithm>
+#include <iterator>
+
 CREATE_CLASS(WaterRings)
 
 //------------------------------------------------------------------------------------
@@ -26,6 +29,7 @@ bool WaterRings::Init()
 {
     // GUARD(WaterRings::Init())
 
+    core.AddToLayer(EXECUTE, GetId(), 65551);
     core.AddToLayer(REALIZE, GetId(), 65551);
 
     const auto seaID = core.GetEntityId("sea");
@@ -49,12 +53,31 @@ bool WaterRings::Init()
         rings[i].firstUpdate = true;
         rings[i].x = 0.f;
         rings[i].z = 0.f;
+        UpdateGrid(i);
     }
 
     return true;
     // UNGUARD
 }
 
+//------------------------------------------------------------------------------------
+void WaterRings::Execute(uint32_t _dTime)
+{
+    if (!sea)
+        return;
+
+    for (auto i = 0; i < waterrings::MAX_RINGS; i++)
+    {
+        // check if ring needs to be removed
+        if (rings[i].activeTime > (waterrings::FADE_IN_TIME + waterrings::FADE_OUT_TIME))
+            rings[i].active = false;
+        UpdateGrid(i);
+
+        if (rings[i].active)
+            rings[i].activeTime += _dTime;
+    }
+}
+
 //------------------------------------------------------------------------------------
 void WaterRings::Realize(uint32_t _dTime)
 {
@@ -68,14 +91,15 @@ void WaterRings::Realize(uint32_t _dTime)
     int32_t vOffset;
     for (auto i = 0; i < waterrings::MAX_RINGS; i++)
     {
-        // check if ring needs to be removed
-        if (rings[i].activeTime > (waterrings::FADE_IN_TIME + waterrings::FADE_OUT_TIME))
-            rings[i].active = false;
         ivManager->GetPointers(rings[i].ivIndex, static_cast<uint16_t **>(&iPointer), (void **)&vPointer, &vOffset);
-        UpdateGrid(i, iPointer, vPointer, vOffset);
-
-        if (rings[i].active)
-            rings[i].activeTime += _dTime;
+        Assert(iPointer);
+        Assert(vPointer);
+        if (rings[i].firstUpdate)
+        {
+            FillIndexes(iPointer, vOffset);
+            rings[i].firstUpdate = false;
+        }
+        std::copy(std::begin(rings[i].vertices), std::end(rings[i].vertices), vPointer);
     }
     ivManager->UnlockBuffers();
 
@@ -134,32 +158,29 @@ uint64_t WaterRings::ProcessMessage(MESSAGE &message)
 }
 
 //------------------------------------------------------------------------------------
-void WaterRings::UpdateGrid(int _ringI, uint16_t *_iPointer, RING_VERTEX *_vPointer, int32_t _vOffset)
+void WaterRings::FillIndexes(uint16_t *_iPointer, int32_t _vOffset) const
 {
-    Assert(_iPointer);
-    Assert(_vPointer);
+    uint16_t *indexes = _iPointer;
+    for (int z = 0; z < waterrings::GRID_STEPS_COUNT - 1; ++z)
+        for (int x = 0; x < waterrings::GRID_STEPS_COUNT - 1; ++x)
+        {
+            *(indexes++) = static_cast<uint16_t>(_vOffset + waterrings::GRID_STEPS_COUNT * z + x);
+            *(indexes++) = static_cast<uint16_t>(_vOffset + waterrings::GRID_STEPS_COUNT * (z + 1) + x);
+            *(indexes++) = static_cast<uint16_t>(_vOffset + waterrings::GRID_STEPS_COUNT * (z + 1) + x + 1);
+
+            *(indexes++) = static_cast<uint16_t>(_vOffset + waterrings::GRID_STEPS_COUNT * z + x);
+            *(indexes++) = static_cast<uint16_t>(_vOffset + waterrings::GRID_STEPS_COUNT * (z + 1) + x + 1);
+            *(indexes++) = static_cast<uint16_t>(_vOffset + waterrings::GRID_STEPS_COUNT * z + x + 1);
+        }
+}
 
+//------------------------------------------------------------------------------------
+void WaterRings::UpdateGrid(int _ringI)
+{
     float a;
     tRing *ring = &rings[_ringI];
     int x, z;
 
-    if (ring->firstUpdate)
-    {
-        uint16_t *indexes = _iPointer;
-        for (z = 0; z < waterrings::GRID_STEPS_COUNT - 1; ++z)
-            for (x = 0; x < waterrings::GRID_STEPS_COUNT - 1; ++x)
-            {
-                *(indexes++) = static_cast<uint16_t>(_vOffset + waterrings::GRID_STEPS_COUNT * z + x);
-                *(indexes++) = static_cast<uint16_t>(_vOffset + waterrings::GRID_STEPS_COUNT * (z + 1) + x);
-                *(indexes++) = static_cast<uint16_t>(_vOffset + waterrings::GRID_STEPS_COUNT * (z + 1) + x + 1);
-
-                *(indexes++) = static_cast<uint16_t>(_vOffset + waterrings::GRID_STEPS_COUNT * z + x);
-                *(indexes++) = static_cast<uint16_t>(_vOffset + waterrings::GRID_STEPS_COUNT * (z + 1) + x + 1);
-                *(indexes++) = static_cast<uint16_t>(_vOffset + waterrings::GRID_STEPS_COUNT * z + x + 1);
-            }
-        ring->firstUpdate = false;
-    }
-
     if (ring->activeTime < waterrings::FADE_IN_TIME)
         a = static_cast<float>(ring->activeTime) / waterrings::FADE_IN_TIME;
     else
@@ -167,7 +188,7 @@ void WaterRings::UpdateGrid(int _ringI, uint16_t *_iPointer, RING_VERTEX *_vPoin
 
     const float midX = (waterrings::GRID_STEPS_COUNT - 1) / 2.f;
     const float midZ = (waterrings::GRID_STEPS_COUNT - 1) / 2.f;
-    RING_VERTEX *ringVertex = _vPointer;
+    RING_VERTEX *ringVertex = ring->vertices;
     float gX, gZ;
     if (ring->active)
     {
@@ -44,6 +44,8 @@ struct tRing
     tRingState state;
     bool firstUpdate;
     float cosA, sinA;
+    // built in execute, copied to the buffer in realize
+    RING_VERTEX vertices[waterrings::GRID_STEPS_COUNT * waterrings::GRID_STEPS_COUNT];
 };
 
 class WaterRings : public Entity
@@ -52,15 +54,23 @@ class WaterRings : public Entity
     WaterRings();
     ~WaterRings() override;
     bool Init() override;
+    void Execute(uint32_t dTime);
     void Realize(uint32_t dTime);
     uint64_t ProcessMessage(MESSAGE &message) override;
 
+    // execute only ages own rings and lays them on the sea
+    [[nodiscard]] ExecutePolicy GetExecutePolicy() const override
+    {
+        return ExecutePolicy::parallel;
+    }
+
     void ProcessStage(Stage stage, uint32_t delta) override
     {
         switch (stage)
         {
-            // case Stage::execute:
-            //    Execute(delta); break;
+        case Stage::execute:
+            Execute(delta);
+            break;
         case Stage::realize:
             Realize(delta);
             break;
@@ -72,7 +82,8 @@ class WaterRings : public Entity
     }
 
   private:
-    void UpdateGrid(int _ringI, uint16_t *iPointer, RING_VERTEX *vPointer, int32_t vOffset);
+    void UpdateGrid(int _ringI);
+    void FillIndexes(uint16_t *iPointer, int32_t vOffset) const;
 
     VDX9RENDER *renderService;
     SEA_BASE *sea;
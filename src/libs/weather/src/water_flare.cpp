@@ -32,7 +32,6 @@ bool WATERFLARE::Init()
     // GUARD(bool WATERFLARE::Init())
 
     core.AddToLayer(REALIZE, GetId(), -1);
-    core.AddToLayer(EXECUTE, GetId(), -1);
 
     SetDevice();
 
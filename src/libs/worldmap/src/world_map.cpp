@@ -67,6 +67,7 @@ WorldMap::WorldMap() : rs{}, aDate{}
     object[WDMAP_MAXOBJECTS - 1].next = -1;
     wdmObjects->wm = this;
     camera = nullptr;
+    clouds = nullptr;
     srand(duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count());
     encTime = 0.0f;
     aStorm = nullptr;
@@ -132,7 +133,8 @@ bool WorldMap::Init()
     AddPObject(sea, 10);
     AddLObject(sea, -1);
     // create clouds
-    AddLObject(AddObject(new WdmClouds()), 10000);
+    clouds = new WdmClouds();
+    AddLObject(AddObject(clouds), 10000);
     rs->ProgressView();
     // Create a camera
     camera = new WdmCameraStdCtrl();
@@ -364,6 +366,9 @@ bool WorldMap::Init()
 // Execution
 void WorldMap::Execute(uint32_t delta_time)
 {
+    // clouds touch only themselves and read the wind
+    if (clouds && !clouds->killMe)
+        clouds->Update(clouds->isEnablePause && wdmObjects->isPause ? 0.0f : 0.001f * delta_time);
 }
 
 void WorldMap::Realize(uint32_t delta_time)
@@ -468,7 +473,7 @@ void WorldMap::Realize(uint32_t delta_time)
     // execute all objects
     for (auto i = firstObject; i >= 0; i = object[i].next)
     {
-        if (!object[i].ro->killMe)
+        if (!object[i].ro->killMe && object[i].ro != clouds)
             object[i].ro->Update(object[i].ro->isEnablePause && wdmObjects->isPause ? 0.0f : dltTime);
         isKill |= object[i].ro->killMe;
     }
@@ -817,6 +822,8 @@ void WorldMap::DeleteObject(WdmRenderObject *obj)
         if (object[j].ro == obj)
             FreeObject(firstLrObject, j);
     }
+    if (obj == clouds)
+        clouds = nullptr;
     delete obj;
 }
 
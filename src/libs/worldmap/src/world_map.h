@@ -18,6 +18,7 @@
 class ATTRIBUTES;
 class MESSAGE;
 class WdmRenderObject;
+class WdmClouds;
 class WdmRenderModel;
 class VDX9RENDER;
 class WdmCamera;
@@ -50,6 +51,12 @@ class WorldMap : public Entity
     // Execution
     void Execute(uint32_t delta_time);
     void Realize(uint32_t delta_time);
+
+    // execute only moves the clouds, the other objects are updated in realize
+    [[nodiscard]] ExecutePolicy GetExecutePolicy() const override
+    {
+        return ExecutePolicy::parallel;
+    }
     // Messages
     uint64_t ProcessMessage(MESSAGE &message) override;
     // Changing an attribute
@@ -133,6 +140,7 @@ class WorldMap : public Entity
     // Render service
     VDX9RENDER *rs;
     WdmCamera *camera;
+    WdmClouds *clouds;
 
     ATTRIBUTES *aStorm;
     ATTRIBUTES *aEncounter;
@@ -118,9 +118,13 @@ void CXI_CONTEXTHELP::LoadIni(INIFILE *ini1, const char *name1, INIFILE *ini2, c
             throw std::runtime_error("allocate memory error");
         std::memset(m_pHelpList, 0, sizeof(HELPEntity) * m_helpQuantity);
         ini1->ReadString(name1, "helpstr", param, sizeof(param) - 1, "");
-        char nodeName[sizeof(param)], stringName[sizeof(param)];
+        char nodeName[sizeof(param)];
+        // every entry scans its string name into its own slot, so the names stay valid until they are resolved
+        std::vector<char> stringNameSlots(m_helpQuantity * sizeof(param));
+        std::vector<const char *> stringNames(m_helpQuantity);
         for (i = 0; i < m_helpQuantity; i++)
         {
+            auto *stringName = &stringNameSlots[i * sizeof(param)];
             sscanf(param, "%[^,],%[^,]", nodeName, stringName);
             if (nodeName[0] != 0)
             {
@@ -128,10 +132,17 @@ void CXI_CONTEXTHELP::LoadIni(INIFILE *ini1, const char *name1, INIFILE *ini2, c
                 if ((m_pHelpList[i].nodeName = new char[len]) == nullptr)
                     throw std::runtime_error("allocate memory error");
                 memcpy(m_pHelpList[i].nodeName, nodeName, len);
-                m_pHelpList[i].idHelpString = pStringService->GetStringNum(stringName);
+                stringNames[i] = stringName;
             }
             ini1->ReadStringNext(name1, "helpstr", param, sizeof(param) - 1);
         }
+
+        // resolve all help strings at once
+        std::vector<int32_t> stringNums(m_helpQuantity);
+        pStringService->GetStringNums(stringNames.data(), stringNums.data(), m_helpQuantity);
+        for (i = 0; i < m_helpQuantity; i++)
+            if (m_pHelpList[i].nodeName != nullptr)
+                m_pHelpList[i].idHelpString = stringNums[i];
     }
     else
     {
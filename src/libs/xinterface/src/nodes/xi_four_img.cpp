@@ -353,6 +353,8 @@ void CXI_FOURIMAGE::LoadIni(INIFILE *ini1, const char *name1, INIFILE *ini2, con
         for (i = 0; i < m_nTexturesQuantity; i++)
             m_nTextureId[i] = pPictureService->GetTextureID(m_sGroupName[i]);
 
+        // the string names of all pictures are resolved together after the loop
+        const char *oneStrNames[4]{}, *twoStrNames[4]{};
         for (i = 0; i < 4; i++)
         {
             sprintf_s(param, "pic%d", i + 1);
@@ -384,7 +386,7 @@ void CXI_FOURIMAGE::LoadIni(INIFILE *ini1, const char *name1, INIFILE *ini2, con
                 else
                 {
                     m_pOneStr[i] = nullptr;
-                    m_oneStr[i] = pStringService->GetStringNum(tmps);
+                    oneStrNames[i] = tmps;
                 }
                 tmps = pAttrTmp->GetAttribute("str2");
                 if (tmps != nullptr && *tmps == '#')
@@ -398,7 +400,7 @@ void CXI_FOURIMAGE::LoadIni(INIFILE *ini1, const char *name1, INIFILE *ini2, con
                 else
                 {
                     m_pTwoStr[i] = nullptr;
-                    m_twoStr[i] = pStringService->GetStringNum(tmps);
+                    twoStrNames[i] = tmps;
                 }
             }
             else
@@ -419,6 +421,15 @@ void CXI_FOURIMAGE::LoadIni(INIFILE *ini1, const char *name1, INIFILE *ini2, con
                     m_twoTexID[i] = 0;
             }
         }
+
+        int32_t oneStrNums[4], twoStrNums[4];
+        pStringService->GetStringNums(oneStrNames, oneStrNums, 4);
+        pStringService->GetStringNums(twoStrNames, twoStrNums, 4);
+        for (i = 0; i < 4; i++)
+        {
+            m_oneStr[i] = oneStrNums[i];
+            m_twoStr[i] = twoStrNums[i];
+        }
     }
 
     const auto bRelativeRect = !GetIniLong(ini1, name1, ini2, name2, "bAbsoluteRectangle");
@@ -708,7 +719,11 @@ void CXI_FOURIMAGE::ChangeItem(int nItemNum)
     auto *pAttribute = core.Entity_GetAttributeClass(g_idInterface, "FourImage");
     if (pAttribute != nullptr)
     {
-        for (auto i = (nItemNum == -1 ? 0 : nItemNum); i < (nItemNum == -1 ? 4 : nItemNum + 1); i++)
+        // the string names of the changed pictures are resolved together after the loop
+        const auto first = nItemNum == -1 ? 0 : nItemNum;
+        const auto last = nItemNum == -1 ? 4 : nItemNum + 1;
+        const char *oneStrNames[4]{}, *twoStrNames[4]{};
+        for (auto i = first; i < last; i++)
         {
             if (m_pOneStr[i] != nullptr)
             {
@@ -749,7 +764,7 @@ void CXI_FOURIMAGE::ChangeItem(int nItemNum)
                     memcpy(m_pOneStr[i], &sptr[1], len);
                 }
                 else
-                    m_oneStr[i] = pStringService->GetStringNum(sptr);
+                    oneStrNames[i] = sptr;
 
                 sptr = pAttrTmp->GetAttribute("str2");
                 if (sptr != nullptr && *sptr == '#')
@@ -762,7 +777,7 @@ void CXI_FOURIMAGE::ChangeItem(int nItemNum)
                     memcpy(m_pTwoStr[i], &sptr[1], len);
                 }
                 else
-                    m_twoStr[i] = pStringService->GetStringNum(sptr);
+                    twoStrNames[i] = sptr;
             }
             else
             {
@@ -775,6 +790,15 @@ void CXI_FOURIMAGE::ChangeItem(int nItemNum)
             }
         }
 
+        int32_t oneStrNums[4], twoStrNums[4];
+        pStringService->GetStringNums(&oneStrNames[first], &oneStrNums[first], last - first);
+        pStringService->GetStringNums(&twoStrNames[first], &twoStrNums[first], last - first);
+        for (auto i = first; i < last; i++)
+        {
+            m_oneStr[i] = oneStrNums[i];
+            m_twoStr[i] = twoStrNums[i];
+        }
+
         FillVertex();
     }
 }
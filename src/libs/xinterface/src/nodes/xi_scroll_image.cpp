@@ -527,7 +527,8 @@ void CXI_SCROLLIMAGE::LoadIni(INIFILE *ini1, const char *name1, INIFILE *ini2, c
             }
         }
 
-        // get all scroll entity
+        // get all scroll entity, the string names are resolved together after the loop
+        std::vector<const char *> stringNames(m_Image.size() * 2);
         for (i = 0; i < m_Image.size(); i++)
         {
             char attrName[256];
@@ -558,7 +559,7 @@ void CXI_SCROLLIMAGE::LoadIni(INIFILE *ini1, const char *name1, INIFILE *ini2, c
                         m_Image[i].string1 = std::string_view(sStringName).substr(1);
                     }
                     else
-                        m_Image[i].str1 = pStringService->GetStringNum(sStringName);
+                        stringNames[i * 2] = sStringName;
                 }
 
                 // set two string
@@ -570,7 +571,7 @@ void CXI_SCROLLIMAGE::LoadIni(INIFILE *ini1, const char *name1, INIFILE *ini2, c
                         m_Image[i].string2 = std::string_view(sStringName).substr(1);
                     }
                     else
-                        m_Image[i].str2 = pStringService->GetStringNum(sStringName);
+                        stringNames[i * 2 + 1] = sStringName;
                 }
 
                 // set pictures
@@ -600,6 +601,14 @@ void CXI_SCROLLIMAGE::LoadIni(INIFILE *ini1, const char *name1, INIFILE *ini2, c
                 }
             }
         }
+
+        std::vector<int32_t> stringNums(stringNames.size());
+        pStringService->GetStringNums(stringNames.data(), stringNums.data(), stringNames.size());
+        for (i = 0; i < m_Image.size(); i++)
+        {
+            m_Image[i].str1 = stringNums[i * 2];
+            m_Image[i].str2 = stringNums[i * 2 + 1];
+        }
     }
 
     // get border picture
@@ -1247,7 +1256,8 @@ void CXI_SCROLLIMAGE::RefreshScroll()
             }
         }
 
-        // get all scroll entity
+        // get all scroll entity, the string names are resolved together after the loop
+        std::vector<const char *> stringNames(m_Image.size() * 2);
         for (i = 0; i < m_Image.size(); i++)
         {
             char attrName[256];
@@ -1278,7 +1288,7 @@ void CXI_SCROLLIMAGE::RefreshScroll()
                         m_Image[i].string1 = std::string_view(sStringName).substr(1);
                     }
                     else
-                        m_Image[i].str1 = pStringService->GetStringNum(sStringName);
+                        stringNames[i * 2] = sStringName;
                 }
 
                 // set two string
@@ -1290,7 +1300,7 @@ void CXI_SCROLLIMAGE::RefreshScroll()
                         m_Image[i].string2 = std::string_view(sStringName).substr(1);
                     }
                     else
-                        m_Image[i].str2 = pStringService->GetStringNum(sStringName);
+                        stringNames[i * 2 + 1] = sStringName;
                 }
 
                 // set pictures
@@ -1320,6 +1330,14 @@ void CXI_SCROLLIMAGE::RefreshScroll()
                 }
             }
         }
+
+        std::vector<int32_t> stringNums(stringNames.size());
+        pStringService->GetStringNums(stringNames.data(), stringNums.data(), stringNames.size());
+        for (i = 0; i < m_Image.size(); i++)
+        {
+            m_Image[i].str1 = stringNums[i * 2];
+            m_Image[i].str2 = stringNums[i * 2 + 1];
+        }
     }
 
     if (m_nCurImage >= m_Image.size() - m_nNotUsedQuantity)
@@ -3,6 +3,7 @@
 #include "string_compare.hpp"
 
 #include <stdio.h>
+#include <vector>
 
 CXI_STRCOLLECTION::CXI_STRCOLLECTION()
 {
@@ -84,12 +85,16 @@ void CXI_STRCOLLECTION::LoadIni(INIFILE *ini1, const char *name1, INIFILE *ini2,
         // Set strings
         int a_fc, r_fc, g_fc, b_fc;
         int a_bc, r_bc, g_bc, b_bc;
-        char strName[sizeof(param)];
         char strState[sizeof(param)];
         char fontName[sizeof(param)];
+        // every string scans its name into its own slot, the names are resolved together after the loop
+        std::vector<char> strNameSlots(m_nStr * sizeof(param));
+        std::vector<const char *> strNames(m_nStr);
         ini->ReadString(name, "string", param, sizeof(param) - 1, "");
         for (i = 0; i < m_nStr; i++)
         {
+            auto *strName = &strNameSlots[i * sizeof(param)];
+
             // set all parameters to zero
             m_pStrDescr[i] = {};
             m_pStrDescr[i].nFontNum = -1;
@@ -126,10 +131,15 @@ void CXI_STRCOLLECTION::LoadIni(INIFILE *ini1, const char *name1, INIFILE *ini2,
             if (strName[0] == '#')
                 DublicateString(m_pStrDescr[i].strStr, &strName[1]);
             else
-                m_pStrDescr[i].strNum = pStringService->GetStringNum(strName);
+                strNames[i] = strName;
 
             ini->ReadStringNext(name, "string", param, sizeof(param) - 1);
         }
+
+        std::vector<int32_t> strNums(m_nStr);
+        pStringService->GetStringNums(strNames.data(), strNums.data(), m_nStr);
+        for (i = 0; i < m_nStr; i++)
+            m_pStrDescr[i].strNum = strNums[i];
     }
 }
 
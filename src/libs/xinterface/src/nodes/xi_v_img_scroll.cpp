@@ -3,6 +3,8 @@
 #include "core.h"
 #include "string_compare.hpp"
 
+#include <vector>
+
 #define MAXIMAGEQUANTITY 100
 
 int32_t GetTexFromEvent(VDATA *vdat);
@@ -530,7 +532,8 @@ void CXI_VIMAGESCROLL::LoadIni(INIFILE *ini1, const char *name1, INIFILE *ini2,
             }
         }
 
-        // get all scroll entity
+        // get all scroll entity, the string names are resolved together after the loop
+        std::vector<const char *> stringNames(m_nListSize * m_nStringQuantity);
         for (i = 0; i < m_nListSize; i++)
         {
             char attrName[256];
@@ -601,7 +604,7 @@ void CXI_VIMAGESCROLL::LoadIni(INIFILE *ini1, const char *name1, INIFILE *ini2,
                         memcpy(m_Image[i].strSelf[k], &(sStringName[1]), len);
                     }
                     else
-                        m_Image[i].strNum[k] = pStringService->GetStringNum(sStringName);
+                        stringNames[i * m_nStringQuantity + k] = sStringName;
                 }
 
                 // set pictures
@@ -632,6 +635,12 @@ void CXI_VIMAGESCROLL::LoadIni(INIFILE *ini1, const char *name1, INIFILE *ini2,
                 }
             }
         }
+
+        std::vector<int32_t> stringNums(stringNames.size());
+        pStringService->GetStringNums(stringNames.data(), stringNums.data(), stringNames.size());
+        for (i = 0; i < m_nListSize; i++)
+            for (k = 0; k < m_nStringQuantity; k++)
+                m_Image[i].strNum[k] = stringNums[i * m_nStringQuantity + k];
     }
     else
     {
@@ -1297,7 +1306,8 @@ void CXI_VIMAGESCROLL::RefreshScroll()
             }
         }
 
-        // get all scroll entity
+        // get all scroll entity, the string names are resolved together after the loop
+        std::vector<const char *> stringNames(m_nListSize * m_nStringQuantity);
         for (i = 0; i < m_nListSize; i++)
         {
             char attrName[256];
@@ -1368,7 +1378,7 @@ void CXI_VIMAGESCROLL::RefreshScroll()
                         memcpy(m_Image[i].strSelf[k], &(sStringName[1]), len);
                     }
                     else
-                        m_Image[i].strNum[k] = pStringService->GetStringNum(sStringName);
+                        stringNames[i * m_nStringQuantity + k] = sStringName;
                 }
 
                 // set pictures
@@ -1399,6 +1409,12 @@ void CXI_VIMAGESCROLL::RefreshScroll()
                 }
             }
         }
+
+        std::vector<int32_t> stringNums(stringNames.size());
+        pStringService->GetStringNums(stringNames.data(), stringNums.data(), stringNames.size());
+        for (i = 0; i < m_nListSize; i++)
+            for (k = 0; k < m_nStringQuantity; k++)
+                m_Image[i].strNum[k] = stringNums[i * m_nStringQuantity + k];
     }
 
     if (m_nCurImage >= m_nListSize - m_nNotUsedQuantity)
@@ -17,6 +17,8 @@ class VSTRSERVICE : public SERVICE
 
     virtual char *GetString(const char *stringName, char *sBuffer = nullptr, std::size_t bufferSize = 0) = 0;
     virtual int32_t GetStringNum(const char *stringName) = 0;
+    // GetStringNum for all strings a node or a form uses, stringNums[i] is -1 if stringNames[i] is not found
+    virtual void GetStringNums(const char *const *stringNames, int32_t *stringNums, size_t count) = 0;
     virtual char *GetString(int32_t strNum) = 0;
     virtual char *GetStringName(int32_t strNum) = 0;
 
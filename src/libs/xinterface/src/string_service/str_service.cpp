@@ -93,8 +93,6 @@ STRSERVICE::STRSERVICE()
     m_psStrName = nullptr;
     m_psString = nullptr;
 
-    m_pUsersBlocks = nullptr;
-
     g_StringServicePointer = this;
     m_nDialogSourceFile = -1;
 }
@@ -126,31 +124,24 @@ STRSERVICE::~STRSERVICE()
     STORM_DELETE(m_sLanguage);
     STORM_DELETE(m_sLanguageDir);
 
-    while (m_pUsersBlocks != nullptr)
+    m_UsersBlocks.clear();
+}
+
+STRSERVICE::UsersStringBlock::~UsersStringBlock()
+{
+    if (psStrName != nullptr)
     {
-        auto *pUSB = m_pUsersBlocks;
-        m_pUsersBlocks = m_pUsersBlocks->next;
-        if (pUSB->psStrName != nullptr)
-        {
-            for (i = 0; i < pUSB->nStringsQuantity; i++)
-                if (pUSB->psStrName[i] != nullptr)
-                    delete pUSB->psStrName[i];
-            delete pUSB->psStrName;
-            pUSB->psStrName = nullptr;
-        }
-        if (pUSB->psString != nullptr)
-        {
-            for (i = 0; i < pUSB->nStringsQuantity; i++)
-                if (pUSB->psString[i] != nullptr)
-                    delete pUSB->psString[i];
-            delete pUSB->psString;
-            pUSB->psString = nullptr;
-        }
-        delete pUSB->fileName;
-        pUSB->nStringsQuantity = 0;
-        delete pUSB;
-        pUSB = nullptr;
+        for (int32_t i = 0; i < nStringsQuantity; i++)
+            delete[] psStrName[i];
+        delete[] psStrName;
     }
+    if (psString != nullptr)
+    {
+        for (int32_t i = 0; i < nStringsQuantity; i++)
+            delete[] psString[i];
+        delete[] psString;
+    }
+    delete[] fileName;
 }
 
 bool STRSERVICE::Init()
@@ -292,6 +283,7 @@ void STRSERVICE::SetLanguage(const char *sLanguage)
     //====================================================================
 
     // delete old stringes
+    m_StringIndex.clear();
     if (m_psString != nullptr)
     {
         for (i = 0; i < m_nStringQuantity; i++)
@@ -378,76 +370,51 @@ void STRSERVICE::SetLanguage(const char *sLanguage)
         // next string
         ini->ReadStringNext(nullptr, "string", param, sizeof(param) - 1);
     }
+    BuildStringIndex(m_StringIndex, m_psStrName, m_nStringQuantity);
 
     // end of search
 
     // =======================================================================
     // Re-reading user files
     // =======================================================================
-    auto *const pOldURoot = m_pUsersBlocks;
-    m_pUsersBlocks = nullptr;
-    for (auto *pUSB = pOldURoot; pUSB != nullptr; pUSB = pUSB->next)
+    auto oldUsersBlocks = std::move(m_UsersBlocks);
+    m_UsersBlocks.clear();
+    for (const auto &[oldID, pUSB] : oldUsersBlocks)
     {
         if (pUSB->nref <= 0)
             continue;
         const int32_t newID = OpenUsersStringFile(pUSB->fileName);
-        UsersStringBlock *pUTmp;
-        for (pUTmp = m_pUsersBlocks; pUTmp != nullptr; pUTmp = pUTmp->next)
-            if (pUTmp->blockID == newID)
-                break;
+        auto *const pUTmp = GetUsersBlock(newID);
         if (pUTmp == nullptr)
         {
             core.Trace("Error: Can`t reinit user language file %s", pUSB->fileName);
             continue;
         }
 
+        // the users keep the old ID
+        auto node = m_UsersBlocks.extract(newID);
+        node.key() = pUSB->blockID;
+        m_UsersBlocks.insert(std::move(node));
         pUTmp->blockID = pUSB->blockID;
         pUTmp->nref = pUSB->nref;
         if (pUTmp->nStringsQuantity != pUSB->nStringsQuantity)
         {
             core.Trace("Warning: user strings file %s have different size for new language %s", pUTmp->fileName,
                        m_sLanguage);
-            int itmp1, itmp2;
-            for (itmp1 = 0; itmp1 < pUTmp->nStringsQuantity; itmp1++)
+            for (int32_t itmp = 0; itmp < pUTmp->nStringsQuantity; itmp++)
             {
-                if (pUTmp->psStrName[itmp1] == nullptr)
-                    continue;
-                for (itmp2 = 0; itmp2 < pUSB->nStringsQuantity; itmp2++)
-                {
-                    if (pUSB->psStrName[itmp2] == nullptr)
-                        continue;
-                    if (storm::iEquals(pUSB->psStrName[itmp2], pUTmp->psStrName[itmp1]))
-                        break;
-                }
-                if (itmp2 >= pUSB->nStringsQuantity)
-                    core.Trace(">>> string <%s> not found into strings file", pUTmp->psStrName[itmp1]);
+                if (pUTmp->psStrName[itmp] != nullptr && !pUSB->index.contains(pUTmp->psStrName[itmp]))
+                    core.Trace(">>> string <%s> not found into strings file", pUTmp->psStrName[itmp]);
             }
-
-            for (itmp1 = 0; itmp1 < pUSB->nStringsQuantity; itmp1++)
+            for (int32_t itmp = 0; itmp < pUSB->nStringsQuantity; itmp++)
             {
-                if (pUSB->psStrName[itmp1] == nullptr)
-                    continue;
-                for (int itmp2 = 0; itmp2 < pUTmp->nStringsQuantity; itmp2++)
-                {
-                    if (pUTmp->psStrName[itmp2] == nullptr)
-                        continue;
-                    if (storm::iEquals(pUTmp->psStrName[itmp2], pUSB->psStrName[itmp1]))
-                        break;
-                }
-                if (itmp2 >= pUTmp->nStringsQuantity)
-                    core.Trace(">>> string <%s> is new into strings file", pUSB->psStrName[itmp1]);
+                if (pUSB->psStrName[itmp] != nullptr && !pUTmp->index.contains(pUSB->psStrName[itmp]))
+                    core.Trace(">>> string <%s> is new into strings file", pUSB->psStrName[itmp]);
             }
         }
     }
     // Delete old user files
-    UsersStringBlock *pNewURoot = m_pUsersBlocks;
-    m_pUsersBlocks = pOldURoot;
-    while (m_pUsersBlocks)
-    {
-        m_pUsersBlocks->nref = 1;
-        CloseUsersStringFile(m_pUsersBlocks->blockID);
-    }
-    m_pUsersBlocks = pNewURoot;
+    oldUsersBlocks.clear();
     //=======================================================================
 
     // UNGUARD
@@ -464,23 +431,20 @@ char *STRSERVICE::GetString(const char *stringName, char *sBuffer, size_t buffer
 {
     // GUARD(char* STRSERVICE::GetString(const char* stringName, char* sBuffer, size_t bufferSize))
 
-    if (stringName != nullptr)
-        for (int i = 0; i < m_nStringQuantity; i++)
-            if (storm::iEquals(m_psStrName[i], stringName))
-            {
-                auto len = strlen(m_psString[i]) + 1;
-                if (sBuffer == nullptr)
-                    bufferSize = 0;
-                if (bufferSize < len)
-                    len = bufferSize;
+    const auto i = GetStringNum(stringName);
+    if (i < 0)
+        return nullptr;
 
-                if (len > 0)
-                    strcpy_s(sBuffer, bufferSize, m_psString[i]);
+    auto len = strlen(m_psString[i]) + 1;
+    if (sBuffer == nullptr)
+        bufferSize = 0;
+    if (bufferSize < len)
+        len = bufferSize;
 
-                return m_psString[i];
-            }
+    if (len > 0)
+        strcpy_s(sBuffer, bufferSize, m_psString[i]);
 
-    return nullptr;
+    return m_psString[i];
     // UNGUARD
 }
 
@@ -534,14 +498,24 @@ int32_t STRSERVICE::GetStringNum(const char *stringName)
     // GUARD(int32_t STRSERVICE::GetStringNum(const char* stringName))
 
     if (stringName != nullptr)
-        for (int32_t i = 0; i < m_nStringQuantity; i++)
-            if (storm::iEquals(m_psStrName[i], stringName))
-                return i;
+        if (const auto it = m_StringIndex.find(stringName); it != m_StringIndex.end())
+            return it->second;
     return -1L;
 
     // UNGUARD
 }
 
+void STRSERVICE::GetStringNums(const char *const *stringNames, int32_t *stringNums, size_t count)
+{
+    // one walk over the keys against the index, without a virtual call per key
+    const auto end = m_StringIndex.end();
+    for (size_t i = 0; i < count; i++)
+    {
+        const auto it = stringNames[i] != nullptr ? m_StringIndex.find(stringNames[i]) : end;
+        stringNums[i] = it != end ? it->second : -1;
+    }
+}
+
 char *STRSERVICE::GetString(int32_t strNum)
 {
     // GUARD(char* STRSERVICE::GetString(int32_t strNum))
@@ -572,20 +546,13 @@ int32_t STRSERVICE::OpenUsersStringFile(const char *fileName)
         return -1;
     }
 
-    UsersStringBlock *pPrev = nullptr;
-    UsersStringBlock *itUSB;
-    for (itUSB = m_pUsersBlocks; itUSB != nullptr; itUSB = itUSB->next)
+    for (const auto &[id, itUSB] : m_UsersBlocks)
     {
         if (itUSB->fileName != nullptr && storm::iEquals(itUSB->fileName, fileName))
         {
-            break;
+            itUSB->nref++;
+            return itUSB->blockID;
         }
-        pPrev = itUSB;
-    }
-    if (itUSB != nullptr)
-    {
-        itUSB->nref++;
-        return itUSB->blockID;
     }
 
     auto pUSB = std::make_unique<UsersStringBlock>();
@@ -665,103 +632,64 @@ int32_t STRSERVICE::OpenUsersStringFile(const char *fileName)
 
     STORM_DELETE(fileBuf);
 
+    BuildStringIndex(pUSB->index, pUSB->psStrName, pUSB->nStringsQuantity);
     const int32_t block_id = pUSB->blockID;
-    pUSB->next = nullptr;
-    if (pPrev == nullptr)
-    {
-        m_pUsersBlocks = pUSB.release();
-    }
-    else
-    {
-        pPrev->next = pUSB.release();
-    }
+    m_UsersBlocks.emplace(block_id, std::move(pUSB));
     return block_id;
 }
 
 void STRSERVICE::CloseUsersStringFile(int32_t id)
 {
-    int i;
     if (id == -1)
         return;
 
-    UsersStringBlock *pPrev = nullptr;
-    UsersStringBlock *pUSB;
-    for (pUSB = m_pUsersBlocks; pUSB != nullptr; pUSB = pUSB->next)
-    {
-        if (pUSB->blockID == id)
-            break;
-        pPrev = pUSB;
-    }
+    auto *pUSB = GetUsersBlock(id);
     if (pUSB == nullptr)
         return;
     pUSB->nref--;
     if (pUSB->nref > 0)
         return;
 
-    if (pPrev == nullptr)
-        m_pUsersBlocks = pUSB->next;
-    else
-        pPrev->next = pUSB->next;
-
-    if (pUSB->fileName != nullptr)
-    {
-        delete pUSB->fileName;
-        pUSB->fileName = nullptr;
-    }
-    if (pUSB->psStrName != nullptr)
-    {
-        for (i = 0; i < pUSB->nStringsQuantity; i++)
-            if (pUSB->psStrName[i] != nullptr)
-                delete pUSB->psStrName[i];
-        delete pUSB->psStrName;
-        pUSB->psStrName = nullptr;
-    }
-    if (pUSB->psString != nullptr)
-    {
-        for (i = 0; i < pUSB->nStringsQuantity; i++)
-            if (pUSB->psString[i] != nullptr)
-                delete pUSB->psString[i];
-        delete pUSB->psString;
-        pUSB->psString = nullptr;
-    }
-    delete pUSB;
+    m_UsersBlocks.erase(id);
 }
 
 char *STRSERVICE::TranslateFromUsers(int32_t id, const char *inStr)
 {
-    int i;
     if (inStr == nullptr || id == -1)
         return nullptr;
-    UsersStringBlock *pUSB;
-    for (pUSB = m_pUsersBlocks; pUSB != nullptr; pUSB = pUSB->next)
-        if (pUSB->blockID == id)
-            break;
+    const auto *pUSB = GetUsersBlock(id);
     if (pUSB == nullptr)
         return nullptr;
 
-    for (i = 0; i < pUSB->nStringsQuantity; i++)
-        if (pUSB->psStrName[i] != nullptr && storm::iEquals(pUSB->psStrName[i], inStr))
-            break;
-    if (i < pUSB->nStringsQuantity)
-        return pUSB->psString[i];
+    if (const auto it = pUSB->index.find(inStr); it != pUSB->index.end())
+        return pUSB->psString[it->second];
     return nullptr;
 }
 
 int32_t STRSERVICE::GetFreeUsersID() const
 {
     int id;
-    for (id = 0;; id++)
+    for (id = 0; m_UsersBlocks.contains(id); id++)
     {
-        UsersStringBlock *pUSB;
-        for (pUSB = m_pUsersBlocks; pUSB != nullptr; pUSB = pUSB->next)
-            if (pUSB->blockID == id)
-                break;
-        if (pUSB == nullptr)
-            break;
     }
     return id;
 }
 
+STRSERVICE::UsersStringBlock *STRSERVICE::GetUsersBlock(int32_t id) const
+{
+    const auto it = m_UsersBlocks.find(id);
+    return it != m_UsersBlocks.end() ? it->second.get() : nullptr;
+}
+
+void STRSERVICE::BuildStringIndex(StringIndex &index, char **psStrName, int32_t nStringQuantity)
+{
+    index.clear();
+    index.reserve(nStringQuantity);
+    for (int32_t i = 0; i < nStringQuantity; i++)
+        if (psStrName[i] != nullptr)
+            index.try_emplace(psStrName[i], i);
+}
+
 bool STRSERVICE::GetNextUsersString(char *src, int32_t &idx, char **strName, char **strData) const
 {
     char *tmpStr;
@@ -3,21 +3,30 @@
 #include "vma.hpp"
 
 #include "script_libriary.h"
+#include "string_compare.hpp"
 #include "../string_service.h"
 
+#include <memory>
+#include <string_view>
+#include <unordered_map>
+
 //-----------SDEVICE-----------
 class STRSERVICE : public VSTRSERVICE
 {
+    // String number by its name, the first one if names repeat
+    using StringIndex = std::unordered_map<std::string_view, int32_t, storm::iStrViewHasher, storm::iStrViewComparator>;
+
     struct UsersStringBlock
     {
-        int32_t nref;
-        char *fileName;
-        int32_t blockID;
-        int32_t nStringsQuantity;
-        char **psStrName;
-        char **psString;
-
-        UsersStringBlock *next;
+        int32_t nref = 0;
+        char *fileName = nullptr;
+        int32_t blockID = 0;
+        int32_t nStringsQuantity = 0;
+        char **psStrName = nullptr;
+        char **psString = nullptr;
+        StringIndex index;
+
+        ~UsersStringBlock();
     };
 
   public:
@@ -35,6 +44,7 @@ class STRSERVICE : public VSTRSERVICE
 
     char *GetString(const char *stringName, char *sBuffer = nullptr, std::size_t bufferSize = 0) override;
     int32_t GetStringNum(const char *stringName) override;
+    void GetStringNums(const char *const *stringNames, int32_t *stringNums, size_t count) override;
     char *GetString(int32_t strNum) override;
     char *GetStringName(int32_t strNum) override;
 
@@ -53,6 +63,8 @@ class STRSERVICE : public VSTRSERVICE
     void LoadIni();
     int32_t GetFreeUsersID() const;
     bool GetNextUsersString(char *src, int32_t &idx, char **strName, char **strData) const;
+    UsersStringBlock *GetUsersBlock(int32_t id) const;
+    static void BuildStringIndex(StringIndex &index, char **psStrName, int32_t nStringQuantity);
 
   protected:
     char *m_sLanguage;
@@ -62,8 +74,10 @@ class STRSERVICE : public VSTRSERVICE
     int32_t m_nStringQuantity;
     char **m_psStrName;
     char **m_psString;
+    StringIndex m_StringIndex;
 
-    UsersStringBlock *m_pUsersBlocks;
+    // by block ID
+    std::unordered_map<int32_t, std::unique_ptr<UsersStringBlock>> m_UsersBlocks;
 
     int32_t m_nDialogSourceFile;
 };
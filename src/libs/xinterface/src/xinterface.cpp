@@ -2859,10 +2859,14 @@ char *XINTERFACE::SaveFileFind(int32_t saveNum, char *buffer, size_t bufSize, in
             fio->_CreateDirectory(sSavePath);
         }
 
-        // start save file finding
+        // start save file finding, after the save written in the background took its place
+        core.WaitStateSaving();
         const auto vFilePaths = fio->_GetFsPathsByMask(sSavePath, nullptr, true);
         for (std::filesystem::path filePath : vFilePaths)
         {
+            // a save that was interrupted leaves its temporary file
+            if (filePath.extension() == ".tmp")
+                continue;
             AddFindData(filePath);
         }
         // common part
@@ -2932,6 +2936,8 @@ void XINTERFACE::DeleteSaveFile(const char *fileName)
     {
         sprintf(param, "%s\\%s", sSavePath, fileName);
     }
+    // the slot may be the one still written in the background
+    core.WaitStateSaving();
     fio->_DeleteFile(param);
 }
 